@@ -0,0 +1,194 @@
+#include "logger.hpp"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+namespace pldm
+{
+
+namespace logging
+{
+
+namespace
+{
+
+/** @brief Number of messages written at once */
+constexpr size_t batchSize = 64;
+
+/** @brief Write all of a buffer, what the file descriptor fails to take is
+ *         lost, there is nowhere else to report it
+ */
+void writeAll(int fd, const char* data, size_t size)
+{
+    while (size)
+    {
+        auto rc = ::write(fd, data, size);
+        if (rc < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return;
+        }
+        data += rc;
+        size -= rc;
+    }
+}
+
+} // namespace
+
+Logger::Logger(int fd) : fd(fd)
+{
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+Logger::~Logger()
+{
+    flush();
+    io.reset();
+    if (eventFd >= 0)
+    {
+        close(eventFd);
+    }
+}
+
+void Logger::attach(sdeventplus::Event& event)
+{
+    eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventFd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Failed to create the logger eventfd");
+    }
+    io = std::make_unique<sdeventplus::source::IO>(
+        event, eventFd, EPOLLIN,
+        [this](sdeventplus::source::IO&, int, uint32_t) { drain(); });
+    io->set_priority(SD_EVENT_PRIORITY_IDLE);
+    attached.store(true, std::memory_order_release);
+}
+
+void Logger::write(std::string_view message)
+{
+    if (!attached.load(std::memory_order_acquire))
+    {
+        writeAll(fd, message.data(), message.size());
+        return;
+    }
+
+    if (!push(message))
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (!signalled.exchange(true, std::memory_order_acq_rel))
+    {
+        uint64_t one = 1;
+        if (::write(eventFd, &one, sizeof(one)) != sizeof(one))
+        {
+            // Signalled again by the next message
+            signalled.store(false, std::memory_order_release);
+        }
+    }
+}
+
+bool Logger::push(std::string_view message)
+{
+    auto pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    while (true)
+    {
+        slot = &slots[pos % queueSize];
+        auto sequence = slot->sequence.load(std::memory_order_acquire);
+        if (sequence == pos)
+        {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                                 std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (sequence < pos)
+        {
+            // The message a lap behind is not written yet
+            return false;
+        }
+        else
+        {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->length = message.size();
+    std::memcpy(slot->data.data(), message.data(), message.size());
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+void Logger::drain()
+{
+    // A failed read leaves the eventfd readable, and the event loop drains
+    // the queue again
+    uint64_t count = 0;
+    [[maybe_unused]] auto rc = read(eventFd, &count, sizeof(count));
+    // The messages queued from now on wake up the event loop again
+    signalled.exchange(false, std::memory_order_acq_rel);
+    flush();
+}
+
+void Logger::flush()
+{
+    std::array<char, batchSize * maxMessageSize> batch;
+    while (true)
+    {
+        size_t size = 0;
+        size_t count = 0;
+        for (; count < batchSize; ++count)
+        {
+            auto& slot = slots[dequeuePos % queueSize];
+            if (slot.sequence.load(std::memory_order_acquire) !=
+                dequeuePos + 1)
+            {
+                break;
+            }
+            std::memcpy(batch.data() + size, slot.data.data(), slot.length);
+            size += slot.length;
+            slot.sequence.store(dequeuePos + queueSize,
+                                std::memory_order_release);
+            ++dequeuePos;
+        }
+        if (!count)
+        {
+            break;
+        }
+        writeAll(fd, batch.data(), size);
+    }
+
+    auto lost = dropped.load(std::memory_order_relaxed);
+    if (lost != droppedReported)
+    {
+        Message message(Level::Warning);
+        message.append("Dropped ");
+        message.append(lost - droppedReported);
+        message.append(" log messages, the queue was full");
+        auto text = message.finish();
+        writeAll(fd, text.data(), text.size());
+        droppedReported = lost;
+    }
+}
+
+Logger& getLogger()
+{
+    static Logger logger(STDERR_FILENO);
+    return logger;
+}
+
+} // namespace logging
+
+} // namespace pldm
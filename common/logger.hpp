@@ -0,0 +1,301 @@
+#pragma once
+
+#include "config.h"
+
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace pldm
+{
+
+namespace logging
+{
+
+/** @brief Levels of the log messages, the lower the more severe */
+enum class Level : uint8_t
+{
+    Error,
+    Warning,
+    Info,
+    Debug,
+};
+
+/** @brief Messages above this level are compiled out */
+constexpr Level maxLevel = static_cast<Level>(LOG_LEVEL);
+
+/** @brief Size of a message, longer ones are truncated */
+constexpr size_t maxMessageSize = 256;
+
+/** @brief Number of messages the logger queues at most, the messages logged
+ *         when the queue is full are dropped
+ */
+constexpr size_t queueSize = 256;
+
+/** @struct Hex
+ *
+ *  An integer to log in hexadecimal
+ */
+struct Hex
+{
+    uint64_t value;
+};
+
+template <typename T>
+Hex hex(T value)
+{
+    return Hex{static_cast<uint64_t>(value)};
+}
+
+/** @class Message
+ *
+ *  A log message, formatted in place without allocating. Each line starts
+ *  with the syslog priority of its level, which journald reads the priority
+ *  from.
+ */
+class Message
+{
+  public:
+    explicit Message(Level level)
+    {
+        static constexpr std::array<char, 4> priorities{'3', '4', '6', '7'};
+        data[0] = '<';
+        data[1] = priorities[static_cast<size_t>(level)];
+        data[2] = '>';
+        length = 3;
+    }
+
+    void append(std::string_view text)
+    {
+        auto count = std::min(text.size(), capacity() - length);
+        std::memcpy(data.data() + length, text.data(), count);
+        length += count;
+    }
+
+    void append(const char* text)
+    {
+        append(std::string_view(text));
+    }
+
+    void append(const std::string& text)
+    {
+        append(std::string_view(text));
+    }
+
+    void append(char c)
+    {
+        append(std::string_view(&c, 1));
+    }
+
+    void append(bool value)
+    {
+        append(value ? std::string_view("true") : std::string_view("false"));
+    }
+
+    template <typename T>
+        requires std::is_integral_v<T>
+    void append(T value)
+    {
+        appendNumber(static_cast<std::conditional_t<std::is_signed_v<T>,
+                                                    int64_t, uint64_t>>(value),
+                     10);
+    }
+
+    template <typename T>
+        requires std::is_enum_v<T>
+    void append(T value)
+    {
+        append(static_cast<std::underlying_type_t<T>>(value));
+    }
+
+    void append(Hex value)
+    {
+        append("0x");
+        appendNumber(value.value, 16);
+    }
+
+    /** @brief End the line, and get the message */
+    std::string_view finish()
+    {
+        data[length++] = '\n';
+        return {data.data(), length};
+    }
+
+  private:
+    /** @brief Room for the message, the newline excluded */
+    static constexpr size_t capacity()
+    {
+        return maxMessageSize - 1;
+    }
+
+    template <typename T>
+    void appendNumber(T value, int base)
+    {
+        auto [end, ec] = std::to_chars(data.data() + length,
+                                       data.data() + capacity(), value, base);
+        if (ec == std::errc())
+        {
+            length = end - data.data();
+        }
+    }
+
+    std::array<char, maxMessageSize> data;
+    size_t length;
+};
+
+/** @class Logger
+ *
+ *  Writes the log messages to a file descriptor, stderr for the daemon. Until
+ *  it is attached to an event loop a message is written when it is logged.
+ *  Once attached, the messages are queued and written from the event loop
+ *  when it has nothing more urgent to do, in batches, so that logging does
+ *  not block the thread that logs.
+ *
+ *  The messages may be logged from any thread. The queue is a bounded ring of
+ *  messages, producers claim a slot with an atomic counter and the event loop
+ *  is the only consumer. The first message queued after a drain wakes up the
+ *  event loop.
+ */
+class Logger
+{
+  public:
+    Logger() = delete;
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+    Logger(Logger&&) = delete;
+    Logger& operator=(Logger&&) = delete;
+
+    /** @brief Constructor
+     *
+     *  @param[in] fd - file descriptor the messages are written to
+     */
+    explicit Logger(int fd);
+
+    /** @brief Write the messages still queued */
+    ~Logger();
+
+    /** @brief Queue the messages from now on, and write them from the event
+     *         loop, at the lowest priority
+     *
+     *  @param[in] event - the event loop
+     */
+    void attach(sdeventplus::Event& event);
+
+    /** @brief Log a message made of the arguments, if the level is enabled
+     *
+     *  @param[in] args - strings, integers, or hex() of integers
+     */
+    template <Level level, typename... Args>
+    void log(const Args&... args)
+    {
+        if constexpr (level <= maxLevel)
+        {
+            Message message(level);
+            (message.append(args), ...);
+            write(message.finish());
+        }
+    }
+
+    /** @brief Write the messages queued, from the thread of the event loop
+     */
+    void flush();
+
+    /** @brief Get the number of messages dropped because the queue was full
+     */
+    uint64_t getDropped() const
+    {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+  private:
+    /** @struct Slot
+     *
+     *  A message of the queue. The sequence number tells if the slot is free
+     *  for the producer of a position, or holds the message for the consumer
+     */
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        size_t length;
+        std::array<char, maxMessageSize> data;
+    };
+
+    /** @brief Queue a message, or write it if the logger is not attached */
+    void write(std::string_view message);
+
+    /** @brief Queue a message
+     *
+     *  @return false if the queue is full
+     */
+    bool push(std::string_view message);
+
+    /** @brief Write the messages queued, from the event loop */
+    void drain();
+
+    int fd;
+    std::array<Slot, queueSize> slots;
+    std::atomic<size_t> enqueuePos{0}; //!< position of the next message
+    size_t dequeuePos = 0;             //!< position of the next to write
+    std::atomic<bool> signalled{false};
+    std::atomic<uint64_t> dropped{0};
+    uint64_t droppedReported = 0;
+
+    std::atomic<bool> attached{false};
+    int eventFd = -1;
+    std::unique_ptr<sdeventplus::source::IO> io;
+};
+
+/** @brief Get the logger of the process, which writes to stderr */
+Logger& getLogger();
+
+/** @brief Log a message with the logger of the process, calls above the
+ *         maximum level compile to nothing
+ */
+template <Level level, typename... Args>
+inline void log(const Args&... args)
+{
+    if constexpr (level <= maxLevel)
+    {
+        getLogger().log<level>(args...);
+    }
+}
+
+template <typename... Args>
+inline void error(const Args&... args)
+{
+    log<Level::Error>(args...);
+}
+
+template <typename... Args>
+inline void warning(const Args&... args)
+{
+    log<Level::Warning>(args...);
+}
+
+template <typename... Args>
+inline void info(const Args&... args)
+{
+    log<Level::Info>(args...);
+}
+
+template <typename... Args>
+inline void debug(const Args&... args)
+{
+    log<Level::Debug>(args...);
+}
+
+} // namespace logging
+
+} // namespace pldm
@@ -0,0 +1,213 @@
+#include "common/logger.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <sdeventplus/event.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::logging;
+
+/** @brief Read what is in a non-blocking pipe */
+static std::string readAll(int fd)
+{
+    std::string text;
+    std::array<char, 4096> buffer;
+    ssize_t rc = 0;
+    while ((rc = read(fd, buffer.data(), buffer.size())) > 0)
+    {
+        text.append(buffer.data(), rc);
+    }
+    return text;
+}
+
+static size_t countLines(const std::string& text)
+{
+    return std::count(text.begin(), text.end(), '\n');
+}
+
+class LoggerTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(pipe2(fds.data(), O_NONBLOCK | O_CLOEXEC), 0);
+        logger = std::make_unique<Logger>(fds[1]);
+    }
+
+    void TearDown() override
+    {
+        logger.reset();
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    std::array<int, 2> fds{};
+    std::unique_ptr<Logger> logger;
+};
+
+TEST(Message, Format)
+{
+    enum class Kind : uint8_t
+    {
+        Fan = 7
+    };
+
+    Message message(Level::Warning);
+    message.append("EID = ");
+    message.append(uint8_t(9));
+    message.append(" RC = ");
+    message.append(-5);
+    message.append(' ');
+    message.append(hex(0xbeef));
+    message.append(' ');
+    message.append(true);
+    message.append(' ');
+    message.append(std::string("fan0"));
+    message.append(' ');
+    message.append(Kind::Fan);
+    EXPECT_EQ(message.finish(), "<4>EID = 9 RC = -5 0xbeef true fan0 7\n");
+
+    EXPECT_EQ(Message(Level::Error).finish(), "<3>\n");
+    EXPECT_EQ(Message(Level::Info).finish(), "<6>\n");
+    EXPECT_EQ(Message(Level::Debug).finish(), "<7>\n");
+}
+
+TEST(Message, Truncated)
+{
+    Message message(Level::Info);
+    message.append(std::string(2 * maxMessageSize, 'x'));
+    message.append(12345);
+    auto text = message.finish();
+    EXPECT_EQ(text.size(), maxMessageSize);
+    EXPECT_EQ(text.back(), '\n');
+    EXPECT_EQ(text.substr(0, 4), "<6>x");
+}
+
+TEST_F(LoggerTest, WrittenWhenNotAttached)
+{
+    logger->log<Level::Error>("Failed to send the response, RC= ", -32);
+    logger->log<Level::Info>("Getting the response. PLDM RC = ", hex(0));
+    EXPECT_EQ(readAll(fds[0]), "<3>Failed to send the response, RC= -32\n"
+                               "<6>Getting the response. PLDM RC = 0x0\n");
+}
+
+TEST_F(LoggerTest, LevelsAboveTheMaximumCompiledOut)
+{
+    logger->log<Level::Error>("error");
+    logger->log<Level::Debug>("debug");
+    auto text = readAll(fds[0]);
+    EXPECT_EQ(text.find("<7>debug\n") != std::string::npos,
+              Level::Debug <= maxLevel);
+    EXPECT_NE(text.find("<3>error\n"), std::string::npos);
+}
+
+TEST_F(LoggerTest, QueuedUntilTheEventLoopRuns)
+{
+    auto event = sdeventplus::Event::get_new();
+    logger->attach(event);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        logger->log<Level::Error>("message ", i);
+    }
+    EXPECT_EQ(readAll(fds[0]), "");
+
+    event.run(std::nullopt);
+    EXPECT_EQ(readAll(fds[0]),
+              "<3>message 0\n<3>message 1\n<3>message 2\n");
+
+    // The event loop is woken up again by the next message
+    logger->log<Level::Error>("message ", 3);
+    event.run(std::nullopt);
+    EXPECT_EQ(readAll(fds[0]), "<3>message 3\n");
+}
+
+TEST_F(LoggerTest, DroppedWhenTheQueueIsFull)
+{
+    auto event = sdeventplus::Event::get_new();
+    logger->attach(event);
+
+    for (size_t i = 0; i < queueSize + 10; ++i)
+    {
+        logger->log<Level::Error>("message ", i);
+    }
+    EXPECT_EQ(logger->getDropped(), 10u);
+
+    event.run(std::nullopt);
+    auto text = readAll(fds[0]);
+    EXPECT_EQ(countLines(text), queueSize + 1);
+    EXPECT_NE(text.find("<3>message 0\n"), std::string::npos);
+    EXPECT_EQ(text.find("<3>message " + std::to_string(queueSize) + "\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("<4>Dropped 10 log messages"), std::string::npos);
+
+    // The queue has room again
+    logger->log<Level::Error>("message");
+    logger->flush();
+    EXPECT_EQ(readAll(fds[0]), "<3>message\n");
+}
+
+TEST_F(LoggerTest, LoggedFromThreads)
+{
+    constexpr size_t threadCount = 4;
+    constexpr size_t perThread = 1000;
+
+    auto event = sdeventplus::Event::get_new();
+    logger->attach(event);
+
+    std::atomic<size_t> done{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([this, t, &done]() {
+            for (size_t i = 0; i < perThread; ++i)
+            {
+                logger->log<Level::Error>("thread ", t, " message ", i);
+            }
+            ++done;
+        });
+    }
+
+    // The consumer drains as the threads log
+    std::string text;
+    while (done < threadCount)
+    {
+        logger->flush();
+        text += readAll(fds[0]);
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    logger->flush();
+    text += readAll(fds[0]);
+
+    // Each message is written whole, on a line of its own
+    size_t messages = 0;
+    size_t begin = 0;
+    for (auto end = text.find('\n'); end != std::string::npos;
+         begin = end + 1, end = text.find('\n', begin))
+    {
+        auto line = text.substr(begin, end - begin);
+        if (line.starts_with("<3>thread "))
+        {
+            ++messages;
+        }
+        else
+        {
+            EXPECT_TRUE(line.starts_with("<4>Dropped ")) << line;
+        }
+    }
+    EXPECT_EQ(begin, text.size());
+    EXPECT_EQ(messages + logger->getDropped(), threadCount * perThread);
+}
@@ -29,6 +29,10 @@ class MockdBusHandler : public pldm::utils::DBusHandler
     MOCK_METHOD(std::string, getService, (const char*, const char*),
                 (const override));
 
+    MOCK_METHOD(pldm::utils::MapperGetSubTreeResponse, getSubtree,
+                (const char*, int, const std::vector<std::string>&),
+                (const override));
+
     MOCK_METHOD(void, setDbusProperty,
                 (const pldm::utils::DBusMapping&,
                  const pldm::utils::PropertyValue&),
@@ -907,6 +907,151 @@ TEST(FindStateSensorPDR, testNoMatchCompositeSensor)
     pldm_pdr_destroy(repo);
 }
 
+/** @brief Add a state effecter or sensor PDR to a repo
+ *
+ *  @return record handle of the PDR
+ */
+static uint32_t addStatePDR(pldm_pdr* repo, uint8_t pdrType,
+                            uint16_t entityType,
+                            const std::vector<uint16_t>& stateSetIds)
+{
+    // Effecter and sensor PDRs have the same layout up to the composite count
+    std::vector<uint8_t> pdr(sizeof(struct pldm_state_effecter_pdr) -
+                             sizeof(uint8_t) +
+                             stateSetIds.size() *
+                                 sizeof(struct state_effecter_possible_states));
+    auto rec = reinterpret_cast<pldm_state_effecter_pdr*>(pdr.data());
+    rec->hdr.type = pdrType;
+    rec->entity_type = entityType;
+    rec->composite_effecter_count = stateSetIds.size();
+    uint8_t* start = rec->possible_states;
+    if (pdrType == PLDM_STATE_SENSOR_PDR)
+    {
+        auto sensor = reinterpret_cast<pldm_state_sensor_pdr*>(pdr.data());
+        sensor->composite_sensor_count = stateSetIds.size();
+        start = sensor->possible_states;
+        pdr.resize(pdr.size() - (rec->possible_states - start));
+    }
+    for (auto stateSetId : stateSetIds)
+    {
+        auto state = reinterpret_cast<state_effecter_possible_states*>(start);
+        state->state_set_id = stateSetId;
+        state->possible_states_size = 1;
+        start += sizeof(struct state_effecter_possible_states);
+    }
+    return pldm_pdr_add(repo, pdr.data(), pdr.size(), 0, false, 1);
+}
+
+TEST(StatePDRIndex, testMatchesLinearSearch)
+{
+    auto repo = pldm_pdr_init();
+    addStatePDR(repo, PLDM_STATE_EFFECTER_PDR, 33, {196});
+    addStatePDR(repo, PLDM_STATE_EFFECTER_PDR, 33, {197, 196, 196});
+    addStatePDR(repo, PLDM_STATE_EFFECTER_PDR, 34, {196});
+    addStatePDR(repo, PLDM_STATE_SENSOR_PDR, 33, {196});
+    addStatePDR(repo, PLDM_STATE_SENSOR_PDR, 33, {1, 196});
+
+    StatePDRIndex index(repo);
+    for (uint16_t entityType : {33, 34, 35})
+    {
+        for (uint16_t stateSetId : {1, 196, 197})
+        {
+            EXPECT_EQ(index.find(PLDM_STATE_EFFECTER_PDR,
+                                 {entityType, stateSetId}),
+                      findStateEffecterPDR(1, entityType, stateSetId, repo));
+            EXPECT_EQ(
+                index.find(PLDM_STATE_SENSOR_PDR, {entityType, stateSetId}),
+                findStateSensorPDR(1, entityType, stateSetId, repo));
+        }
+    }
+    EXPECT_EQ(index.find(PLDM_STATE_EFFECTER_PDR, {33, 196}).size(), 2);
+    EXPECT_EQ(index.find(PLDM_STATE_SENSOR_PDR, {33, 196}).size(), 2);
+    EXPECT_TRUE(index.find(PLDM_STATE_SENSOR_PDR, {33, 197}).empty());
+
+    pldm_pdr_destroy(repo);
+}
+
+TEST(StatePDRIndex, testRepoChanges)
+{
+    auto repo = pldm_pdr_init();
+    StatePDRIndex index(repo);
+    EXPECT_TRUE(index.find(PLDM_STATE_EFFECTER_PDR, {33, 196}).empty());
+
+    auto handle = addStatePDR(repo, PLDM_STATE_EFFECTER_PDR, 33, {196});
+    EXPECT_EQ(index.find(PLDM_STATE_EFFECTER_PDR, {33, 196}).size(), 1);
+
+    addStatePDR(repo, PLDM_STATE_EFFECTER_PDR, 33, {196});
+    EXPECT_EQ(index.find(PLDM_STATE_EFFECTER_PDR, {33, 196}).size(), 2);
+
+    pldm_delete_by_record_handle(repo, handle, false);
+    auto pdrs = index.find(PLDM_STATE_EFFECTER_PDR, {33, 196});
+    EXPECT_EQ(pdrs, findStateEffecterPDR(1, 33, 196, repo));
+    EXPECT_EQ(pdrs.size(), 1);
+
+    pldm_pdr_remove_pdrs_by_terminus_handle(1, repo);
+    EXPECT_TRUE(index.find(PLDM_STATE_EFFECTER_PDR, {33, 196}).empty());
+
+    pldm_pdr_destroy(repo);
+}
+
+TEST(StatePDRIndex, testBatchFind)
+{
+    auto repo = pldm_pdr_init();
+    addStatePDR(repo, PLDM_STATE_SENSOR_PDR, 33, {196});
+    addStatePDR(repo, PLDM_STATE_SENSOR_PDR, 34, {197});
+
+    StatePDRIndex index(repo);
+    std::vector<StatePDRKey> keys{{34, 197}, {35, 196}, {33, 196}};
+    auto pdrs = index.find(PLDM_STATE_SENSOR_PDR, keys);
+    ASSERT_EQ(pdrs.size(), keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        EXPECT_EQ(pdrs[i], findStateSensorPDR(1, keys[i].entityType,
+                                              keys[i].stateSetId, repo));
+    }
+    EXPECT_TRUE(pdrs[1].empty());
+
+    pldm_pdr_destroy(repo);
+}
+
+TEST(StatePDRIndex, testLargeRepo)
+{
+    constexpr uint16_t entityTypes = 100;
+    constexpr uint16_t stateSets = 50;
+    auto repo = pldm_pdr_init();
+    for (uint16_t entityType = 0; entityType < entityTypes; ++entityType)
+    {
+        for (uint16_t stateSetId = 0; stateSetId < stateSets; ++stateSetId)
+        {
+            addStatePDR(repo, PLDM_STATE_EFFECTER_PDR, entityType,
+                        {stateSetId});
+            addStatePDR(repo, PLDM_STATE_SENSOR_PDR, entityType,
+                        {stateSetId});
+        }
+    }
+    ASSERT_EQ(pldm_pdr_get_record_count(repo), 2 * entityTypes * stateSets);
+
+    std::vector<StatePDRKey> keys;
+    for (uint16_t entityType = 0; entityType < entityTypes; entityType += 10)
+    {
+        keys.push_back({entityType, stateSets - 1});
+    }
+
+    StatePDRIndex index(repo);
+    auto pdrs = index.find(PLDM_STATE_SENSOR_PDR, keys);
+    ASSERT_EQ(pdrs.size(), keys.size());
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        EXPECT_EQ(pdrs[i].size(), 1);
+        EXPECT_EQ(pdrs[i], findStateSensorPDR(1, keys[i].entityType,
+                                              keys[i].stateSetId, repo));
+    }
+    // A second lookup on the same index
+    EXPECT_EQ(index.find(PLDM_STATE_SENSOR_PDR, keys), pdrs);
+
+    pldm_pdr_destroy(repo);
+}
+
 TEST(toString, allTestCases)
 {
     variable_field buffer{};
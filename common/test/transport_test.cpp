@@ -0,0 +1,207 @@
+#include "libpldm/base.h"
+
+#include "common/transport.hpp"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::transport;
+
+/** @brief Build a PLDM message of the given size */
+static std::vector<uint8_t> makeMsg(MessageType msgType, size_t size)
+{
+    std::vector<uint8_t> msg(size);
+    pldm_header_info header{};
+    header.msg_type = msgType;
+    header.instance = 1;
+    header.pldm_type = PLDM_BASE;
+    header.command = PLDM_GET_TID;
+    pack_pldm_header(&header, reinterpret_cast<pldm_msg_hdr*>(msg.data()));
+    for (size_t i = sizeof(pldm_msg_hdr); i < size; ++i)
+    {
+        msg[i] = static_cast<uint8_t>(i);
+    }
+    return msg;
+}
+
+/** @brief Check if a message can be received on the transport */
+static bool readable(const Transport& transport)
+{
+    struct pollfd pfd
+    {
+        transport.getFd(), POLLIN, 0
+    };
+    return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+}
+
+TEST(Loopback, RequestResponse)
+{
+    Loopback requester(8);
+    Loopback responder(9);
+    requester.connect(responder);
+    EXPECT_FALSE(readable(responder));
+
+    auto request = makeMsg(PLDM_REQUEST, sizeof(pldm_msg_hdr));
+    EXPECT_EQ(requester.sendRequest(9, request.data(), request.size()), 0);
+    EXPECT_TRUE(readable(responder));
+    EXPECT_FALSE(readable(requester));
+
+    Message msg{};
+    ASSERT_EQ(responder.recv(msg), 0);
+    EXPECT_EQ(msg.eid, 8);
+    EXPECT_EQ(msg.pldm, request);
+    EXPECT_FALSE(readable(responder));
+
+    auto response = makeMsg(PLDM_RESPONSE, sizeof(pldm_msg_hdr) + 2);
+    auto expected = response;
+    EXPECT_EQ(responder.sendResponse(msg.eid, 5, std::move(response)), 0);
+
+    ASSERT_EQ(requester.recv(msg), 0);
+    EXPECT_EQ(msg.eid, 9);
+    EXPECT_EQ(msg.tag, 5);
+    EXPECT_EQ(msg.pldm, expected);
+    EXPECT_EQ(requester.recv(msg), -EAGAIN);
+}
+
+TEST(Loopback, ResponseIsNotCopied)
+{
+    Loopback requester(8);
+    Loopback responder(9);
+    requester.connect(responder);
+
+    auto response = makeMsg(PLDM_RESPONSE, 4096);
+    auto data = response.data();
+    EXPECT_EQ(responder.sendResponse(8, 0, std::move(response)), 0);
+
+    Message msg{};
+    ASSERT_EQ(requester.recv(msg), 0);
+    EXPECT_EQ(msg.pldm.data(), data);
+}
+
+TEST(Loopback, MessagesInOrder)
+{
+    Loopback requester(8);
+    Loopback responder(9);
+    requester.connect(responder);
+
+    for (size_t size = sizeof(pldm_msg_hdr); size < 16; ++size)
+    {
+        auto request = makeMsg(PLDM_REQUEST, size);
+        EXPECT_EQ(requester.sendRequest(9, request.data(), request.size()),
+                  0);
+    }
+    Message msg{};
+    for (size_t size = sizeof(pldm_msg_hdr); size < 16; ++size)
+    {
+        ASSERT_EQ(responder.recv(msg), 0);
+        EXPECT_EQ(msg.pldm.size(), size);
+    }
+    EXPECT_FALSE(readable(responder));
+}
+
+TEST(Loopback, Disconnected)
+{
+    Loopback requester(8);
+    auto request = makeMsg(PLDM_REQUEST, sizeof(pldm_msg_hdr));
+    EXPECT_EQ(requester.sendRequest(9, request.data(), request.size()),
+              -ENOTCONN);
+
+    {
+        Loopback responder(9);
+        requester.connect(responder);
+        EXPECT_EQ(requester.sendRequest(9, request.data(), request.size()),
+                  0);
+    }
+    EXPECT_EQ(requester.sendRequest(9, request.data(), request.size()),
+              -ENOTCONN);
+}
+
+class MctpDemuxTest : public testing::Test
+{
+  protected:
+    MctpDemuxTest()
+    {
+        socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sockets.data());
+        transport = std::make_unique<MctpDemux>(sockets[0]);
+    }
+
+    ~MctpDemuxTest()
+    {
+        if (sockets[1] >= 0)
+        {
+            close(sockets[1]);
+        }
+    }
+
+    std::array<int, 2> sockets{};
+    std::unique_ptr<MctpDemux> transport;
+};
+
+TEST_F(MctpDemuxTest, SendPrefixesEidAndType)
+{
+    auto request = makeMsg(PLDM_REQUEST, sizeof(pldm_msg_hdr) + 1);
+    EXPECT_EQ(transport->sendRequest(9, request.data(), request.size()), 0);
+
+    std::array<uint8_t, 64> buffer{};
+    auto length = recv(sockets[1], buffer.data(), buffer.size(), 0);
+    ASSERT_EQ(length, static_cast<ssize_t>(request.size() + 2));
+    EXPECT_EQ(buffer[0], 9);
+    EXPECT_EQ(buffer[1], MCTP_MSG_TYPE_PLDM);
+    EXPECT_TRUE(std::equal(request.begin(), request.end(), &buffer[2]));
+
+    // The mctp-demux daemon owns the tags, the tag of the response is
+    // dropped
+    auto response = makeMsg(PLDM_RESPONSE, sizeof(pldm_msg_hdr) + 1);
+    EXPECT_EQ(transport->sendResponse(10, 3, std::vector<uint8_t>(response)),
+              0);
+    length = recv(sockets[1], buffer.data(), buffer.size(), 0);
+    ASSERT_EQ(length, static_cast<ssize_t>(response.size() + 2));
+    EXPECT_EQ(buffer[0], 10);
+    EXPECT_TRUE(std::equal(response.begin(), response.end(), &buffer[2]));
+}
+
+TEST_F(MctpDemuxTest, RecvStripsEidAndType)
+{
+    auto request = makeMsg(PLDM_REQUEST, sizeof(pldm_msg_hdr) + 1);
+    std::vector<uint8_t> framed{9, MCTP_MSG_TYPE_PLDM};
+    framed.insert(framed.end(), request.begin(), request.end());
+    ASSERT_EQ(send(sockets[1], framed.data(), framed.size(), 0),
+              static_cast<ssize_t>(framed.size()));
+
+    Message msg{};
+    ASSERT_EQ(transport->recv(msg), 0);
+    EXPECT_EQ(msg.eid, 9);
+    EXPECT_EQ(msg.tag, 0);
+    EXPECT_EQ(msg.pldm, request);
+}
+
+TEST_F(MctpDemuxTest, RecvBadMessages)
+{
+    // Not a PLDM message
+    std::vector<uint8_t> framed{9, 0x7e, 0, 0, 0};
+    send(sockets[1], framed.data(), framed.size(), 0);
+    Message msg{};
+    EXPECT_EQ(transport->recv(msg), -EBADMSG);
+
+    // Too short for the PLDM header
+    framed = {9, MCTP_MSG_TYPE_PLDM, 0};
+    send(sockets[1], framed.data(), framed.size(), 0);
+    EXPECT_EQ(transport->recv(msg), -EBADMSG);
+
+    // Both have been consumed
+    EXPECT_FALSE(readable(*transport));
+
+    // The daemon has gone away
+    close(sockets[1]);
+    sockets[1] = -1;
+    EXPECT_EQ(transport->recv(msg), -EPIPE);
+}
@@ -0,0 +1,370 @@
+#include "transport.hpp"
+
+#include "libpldm/base.h"
+
+#include <linux/mctp.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <iostream>
+#include <system_error>
+
+namespace pldm
+{
+
+namespace transport
+{
+
+std::optional<Type> toType(std::string_view name)
+{
+    if (name == "mctp-demux")
+    {
+        return Type::MctpDemux;
+    }
+    if (name == "af-mctp")
+    {
+        return Type::AfMctp;
+    }
+    if (name == "loopback")
+    {
+        return Type::Loopback;
+    }
+    return std::nullopt;
+}
+
+SocketTransport::SocketTransport(int fd) : fd(fd), currentSendbuffSize(-1)
+{
+    socklen_t optlen = sizeof(currentSendbuffSize);
+    if (-1 == getsockopt(fd, SOL_SOCKET, SO_SNDBUF, &currentSendbuffSize,
+                         &optlen))
+    {
+        currentSendbuffSize = -1;
+        std::cerr << "Error calling getsockopt, errno = " << errno << "\n";
+    }
+}
+
+SocketTransport::~SocketTransport()
+{
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+}
+
+void SocketTransport::growSendBuffer(size_t size)
+{
+    if (currentSendbuffSize < 0 || (size_t)currentSendbuffSize >= size)
+    {
+        return;
+    }
+
+    currentSendbuffSize = size;
+    if (-1 == setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &currentSendbuffSize,
+                         sizeof(currentSendbuffSize)))
+    {
+        std::cerr << "Tx: Error calling setsockopt, errno = " << errno
+                  << "\n";
+    }
+}
+
+/** @brief Open the socket to the mctp-demux daemon
+ *
+ *  @throw std::system_error if the socket can't be connected
+ */
+static int openMctpDemux()
+{
+    int fd = pldm_open();
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Failed to connect to mctp-demux");
+    }
+    return fd;
+}
+
+MctpDemux::MctpDemux() : SocketTransport(openMctpDemux())
+{}
+
+int MctpDemux::send(mctp_eid_t eid, const uint8_t* msg, size_t len)
+{
+    growSendBuffer(len);
+
+    uint8_t mctpHdr[] = {eid, MCTP_MSG_TYPE_PLDM};
+    struct iovec iov[2]
+    {};
+    iov[0].iov_base = mctpHdr;
+    iov[0].iov_len = sizeof(mctpHdr);
+    iov[1].iov_base = const_cast<uint8_t*>(msg);
+    iov[1].iov_len = len;
+
+    struct msghdr hdr
+    {};
+    hdr.msg_iov = iov;
+    hdr.msg_iovlen = sizeof(iov) / sizeof(iov[0]);
+    if (-1 == sendmsg(fd, &hdr, 0))
+    {
+        return -errno;
+    }
+    return 0;
+}
+
+int MctpDemux::sendRequest(mctp_eid_t eid, const uint8_t* msg, size_t len)
+{
+    return send(eid, msg, len);
+}
+
+int MctpDemux::sendResponse(mctp_eid_t eid, uint8_t /*tag*/,
+                            std::vector<uint8_t>&& msg)
+{
+    return send(eid, msg.data(), msg.size());
+}
+
+int MctpDemux::recv(Message& msg)
+{
+    ssize_t peekedLength = ::recv(fd, nullptr, 0, MSG_PEEK | MSG_TRUNC);
+    if (0 == peekedLength)
+    {
+        // The mctp-demux daemon has closed the socket
+        return -EPIPE;
+    }
+    else if (peekedLength < 0)
+    {
+        return -errno;
+    }
+
+    uint8_t mctpHdr[2]{};
+    if ((size_t)peekedLength < sizeof(mctpHdr) + sizeof(pldm_msg_hdr))
+    {
+        // read and discard
+        ::recv(fd, mctpHdr, sizeof(mctpHdr), 0);
+        return -EBADMSG;
+    }
+
+    msg.pldm.resize(peekedLength - sizeof(mctpHdr));
+    struct iovec iov[2]
+    {};
+    iov[0].iov_base = mctpHdr;
+    iov[0].iov_len = sizeof(mctpHdr);
+    iov[1].iov_base = msg.pldm.data();
+    iov[1].iov_len = msg.pldm.size();
+
+    struct msghdr hdr
+    {};
+    hdr.msg_iov = iov;
+    hdr.msg_iovlen = sizeof(iov) / sizeof(iov[0]);
+    ssize_t length = recvmsg(fd, &hdr, 0);
+    if (length < 0)
+    {
+        return -errno;
+    }
+    if (length != peekedLength || MCTP_MSG_TYPE_PLDM != mctpHdr[1])
+    {
+        return -EBADMSG;
+    }
+
+    msg.eid = mctpHdr[0];
+    msg.tag = 0;
+    return 0;
+}
+
+/** @brief Open an AF_MCTP socket
+ *
+ *  @param[in] listen - bind the socket to the PLDM message type
+ *
+ *  @throw std::system_error if the socket can't be opened or bound
+ */
+static int openAfMctp(bool listen)
+{
+    int fd = pldm_open_af_mctp();
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Failed to open the AF_MCTP socket");
+    }
+
+    if (listen)
+    {
+        struct sockaddr_mctp addr
+        {};
+        addr.smctp_family = AF_MCTP;
+        addr.smctp_network = MCTP_NET_ANY;
+        addr.smctp_addr.s_addr = MCTP_ADDR_ANY;
+        addr.smctp_type = MCTP_MSG_TYPE_PLDM;
+        if (-1 == bind(fd, reinterpret_cast<struct sockaddr*>(&addr),
+                       sizeof(addr)))
+        {
+            auto error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(),
+                                    "Failed to bind the AF_MCTP socket");
+        }
+    }
+    return fd;
+}
+
+AfMctp::AfMctp(bool listen) : SocketTransport(openAfMctp(listen))
+{}
+
+int AfMctp::send(mctp_eid_t eid, uint8_t tag, const uint8_t* msg, size_t len)
+{
+    growSendBuffer(len + sizeof(MCTP_MSG_TYPE_PLDM));
+
+    uint8_t msgType = MCTP_MSG_TYPE_PLDM;
+    struct iovec iov[2]
+    {};
+    iov[0].iov_base = &msgType;
+    iov[0].iov_len = sizeof(msgType);
+    iov[1].iov_base = const_cast<uint8_t*>(msg);
+    iov[1].iov_len = len;
+
+    struct sockaddr_mctp addr
+    {};
+    addr.smctp_family = AF_MCTP;
+    addr.smctp_network = MCTP_NET_ANY;
+    addr.smctp_addr.s_addr = eid;
+    addr.smctp_type = MCTP_MSG_TYPE_PLDM;
+    addr.smctp_tag = tag;
+
+    struct msghdr hdr
+    {};
+    hdr.msg_name = &addr;
+    hdr.msg_namelen = sizeof(addr);
+    hdr.msg_iov = iov;
+    hdr.msg_iovlen = sizeof(iov) / sizeof(iov[0]);
+    if (-1 == sendmsg(fd, &hdr, 0))
+    {
+        return -errno;
+    }
+    return 0;
+}
+
+int AfMctp::sendRequest(mctp_eid_t eid, const uint8_t* msg, size_t len)
+{
+    return send(eid, MCTP_TAG_OWNER, msg, len);
+}
+
+int AfMctp::sendResponse(mctp_eid_t eid, uint8_t tag,
+                         std::vector<uint8_t>&& msg)
+{
+    return send(eid, tag & MCTP_TAG_MASK, msg.data(), msg.size());
+}
+
+int AfMctp::recv(Message& msg)
+{
+    ssize_t peekedLength = ::recv(fd, nullptr, 0, MSG_PEEK | MSG_TRUNC);
+    if (peekedLength < 0)
+    {
+        return -errno;
+    }
+
+    uint8_t msgType = 0;
+    if ((size_t)peekedLength < sizeof(msgType) + sizeof(pldm_msg_hdr))
+    {
+        // read and discard
+        ::recv(fd, &msgType, sizeof(msgType), 0);
+        return -EBADMSG;
+    }
+
+    msg.pldm.resize(peekedLength - sizeof(msgType));
+    struct iovec iov[2]
+    {};
+    iov[0].iov_base = &msgType;
+    iov[0].iov_len = sizeof(msgType);
+    iov[1].iov_base = msg.pldm.data();
+    iov[1].iov_len = msg.pldm.size();
+
+    struct sockaddr_mctp addr
+    {};
+    struct msghdr hdr
+    {};
+    hdr.msg_name = &addr;
+    hdr.msg_namelen = sizeof(addr);
+    hdr.msg_iov = iov;
+    hdr.msg_iovlen = sizeof(iov) / sizeof(iov[0]);
+    ssize_t length = recvmsg(fd, &hdr, 0);
+    if (length < 0)
+    {
+        return -errno;
+    }
+    if (length != peekedLength || MCTP_MSG_TYPE_PLDM != msgType)
+    {
+        return -EBADMSG;
+    }
+
+    msg.eid = addr.smctp_addr.s_addr;
+    msg.tag = addr.smctp_tag;
+    return 0;
+}
+
+Loopback::Loopback(mctp_eid_t eid) :
+    eid(eid), fd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK | EFD_SEMAPHORE))
+{
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Failed to create the loopback eventfd");
+    }
+}
+
+Loopback::~Loopback()
+{
+    if (peer)
+    {
+        peer->peer = nullptr;
+    }
+    close(fd);
+}
+
+void Loopback::connect(Loopback& other)
+{
+    peer = &other;
+    other.peer = this;
+}
+
+int Loopback::deliver(uint8_t tag, std::vector<uint8_t>&& msg)
+{
+    if (!peer)
+    {
+        return -ENOTCONN;
+    }
+
+    peer->inbox.push_back(Message{eid, tag, std::move(msg)});
+    uint64_t count = 1;
+    if (sizeof(count) != write(peer->fd, &count, sizeof(count)))
+    {
+        auto error = errno;
+        peer->inbox.pop_back();
+        return -error;
+    }
+    return 0;
+}
+
+int Loopback::sendRequest(mctp_eid_t /*eid*/, const uint8_t* msg, size_t len)
+{
+    return deliver(0, std::vector<uint8_t>(msg, msg + len));
+}
+
+int Loopback::sendResponse(mctp_eid_t /*eid*/, uint8_t tag,
+                           std::vector<uint8_t>&& msg)
+{
+    return deliver(tag, std::move(msg));
+}
+
+int Loopback::recv(Message& msg)
+{
+    uint64_t count = 0;
+    if (sizeof(count) != read(fd, &count, sizeof(count)))
+    {
+        return -errno;
+    }
+
+    msg = std::move(inbox.front());
+    inbox.pop_front();
+    return 0;
+}
+
+} // namespace transport
+
+} // namespace pldm
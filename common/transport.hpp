@@ -0,0 +1,239 @@
+#pragma once
+
+#include "libpldm/requester/pldm.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace pldm
+{
+
+namespace transport
+{
+
+constexpr uint8_t MCTP_MSG_TYPE_PLDM = 1;
+
+/** @brief MCTP transports PLDM messages are exchanged on */
+enum class Type
+{
+    MctpDemux, //!< userspace mctp-demux daemon, over its abstract socket
+    AfMctp,    //!< kernel AF_MCTP socket
+    Loopback,  //!< in-process, for tests and benchmarks
+};
+
+/** @brief Get the transport type from its name
+ *
+ *  @param[in] name - "mctp-demux", "af-mctp" or "loopback"
+ *
+ *  @return the transport type, std::nullopt if the name is not known
+ */
+std::optional<Type> toType(std::string_view name);
+
+/** @struct Message
+ *
+ *  PLDM message received on a transport
+ */
+struct Message
+{
+    mctp_eid_t eid; //!< MCTP endpoint ID the message came from
+    uint8_t tag;    //!< MCTP message tag, echoed back in the response
+    std::vector<uint8_t> pldm; //!< PLDM message, starting with its header
+};
+
+/** @class Transport
+ *
+ *  Sends and receives the PLDM messages, without the MCTP framing. The
+ *  transport is owned by the event loop, it is not thread safe.
+ */
+class Transport
+{
+  public:
+    Transport() = default;
+    Transport(const Transport&) = delete;
+    Transport& operator=(const Transport&) = delete;
+    Transport(Transport&&) = delete;
+    Transport& operator=(Transport&&) = delete;
+    virtual ~Transport() = default;
+
+    /** @brief Get the fd to poll, readable when a message can be received */
+    virtual int getFd() const = 0;
+
+    /** @brief Send a PLDM request, the message tag is owned by this end
+     *
+     *  @param[in] eid - MCTP endpoint ID of the responder
+     *  @param[in] msg - PLDM request message
+     *  @param[in] len - size of the PLDM request message
+     *
+     *  @return 0 on success, -errno on failure
+     */
+    virtual int sendRequest(mctp_eid_t eid, const uint8_t* msg,
+                            size_t len) = 0;
+
+    /** @brief Send a PLDM response
+     *
+     *  @param[in] eid - MCTP endpoint ID of the requester
+     *  @param[in] tag - message tag of the request
+     *  @param[in] msg - PLDM response message, the transport may take it
+     *
+     *  @return 0 on success, -errno on failure
+     */
+    virtual int sendResponse(mctp_eid_t eid, uint8_t tag,
+                             std::vector<uint8_t>&& msg) = 0;
+
+    /** @brief Receive a PLDM message
+     *
+     *  @param[out] msg - the message received
+     *
+     *  @return 0 on success, -EPIPE if the peer has gone away, -EBADMSG if a
+     *          message was read but was not a PLDM message, -errno on other
+     *          failures
+     */
+    virtual int recv(Message& msg) = 0;
+};
+
+/** @class SocketTransport
+ *
+ *  Transport over a socket, the send buffer of the socket is grown to fit
+ *  the largest message sent.
+ */
+class SocketTransport : public Transport
+{
+  public:
+    /** @brief Take ownership of a socket
+     *
+     *  @param[in] fd - the socket
+     */
+    explicit SocketTransport(int fd);
+
+    ~SocketTransport() override;
+
+    int getFd() const override
+    {
+        return fd;
+    }
+
+  protected:
+    /** @brief Grow the send buffer of the socket to fit a message
+     *
+     *  @param[in] size - size of the message
+     */
+    void growSendBuffer(size_t size);
+
+    int fd;                 //!< the socket
+    int currentSendbuffSize; //!< send buffer size, -1 if it is not known
+};
+
+/** @class MctpDemux
+ *
+ *  Transport through the mctp-demux daemon, the messages are prefixed with
+ *  the MCTP endpoint ID and message type. The daemon owns the message tags.
+ */
+class MctpDemux : public SocketTransport
+{
+  public:
+    /** @brief Connect to the mctp-demux daemon for the PLDM messages
+     *
+     *  @throw std::system_error if the socket can't be connected
+     */
+    MctpDemux();
+
+    /** @brief Take ownership of a socket already connected
+     *
+     *  @param[in] fd - the socket
+     */
+    explicit MctpDemux(int fd) : SocketTransport(fd)
+    {}
+
+    int sendRequest(mctp_eid_t eid, const uint8_t* msg, size_t len) override;
+    int sendResponse(mctp_eid_t eid, uint8_t tag,
+                     std::vector<uint8_t>&& msg) override;
+    int recv(Message& msg) override;
+
+  private:
+    /** @brief Send a message prefixed with the endpoint ID and message type */
+    int send(mctp_eid_t eid, const uint8_t* msg, size_t len);
+};
+
+/** @class AfMctp
+ *
+ *  Transport over a kernel AF_MCTP socket, the endpoints are addressed with
+ *  sockaddr_mctp and there is no hop through a userspace daemon. The kernel
+ *  allocates the tags of the requests and routes their responses back.
+ */
+class AfMctp : public SocketTransport
+{
+  public:
+    /** @brief Open an AF_MCTP socket
+     *
+     *  @param[in] listen - bind the socket to the PLDM message type so that
+     *                      it receives the requests of the other endpoints,
+     *                      only one socket can be bound
+     *
+     *  @throw std::system_error if the socket can't be opened or bound
+     */
+    explicit AfMctp(bool listen);
+
+    int sendRequest(mctp_eid_t eid, const uint8_t* msg, size_t len) override;
+    int sendResponse(mctp_eid_t eid, uint8_t tag,
+                     std::vector<uint8_t>&& msg) override;
+    int recv(Message& msg) override;
+
+  private:
+    /** @brief Send a message to an endpoint with the given tag */
+    int send(mctp_eid_t eid, uint8_t tag, const uint8_t* msg, size_t len);
+};
+
+/** @class Loopback
+ *
+ *  In-process transport between two connected ends. The messages are queued
+ *  to the peer as they are, responses are moved without a copy, and an
+ *  eventfd makes the receiving end pollable. Both ends must run on the same
+ *  thread.
+ */
+class Loopback : public Transport
+{
+  public:
+    /** @brief Constructor
+     *
+     *  @param[in] eid - MCTP endpoint ID of this end, the peer receives the
+     *                   messages from it
+     *
+     *  @throw std::system_error if the eventfd can't be created
+     */
+    explicit Loopback(mctp_eid_t eid);
+
+    ~Loopback() override;
+
+    /** @brief Connect the two ends
+     *
+     *  @param[in] peer - the other end
+     */
+    void connect(Loopback& peer);
+
+    int getFd() const override
+    {
+        return fd;
+    }
+
+    int sendRequest(mctp_eid_t eid, const uint8_t* msg, size_t len) override;
+    int sendResponse(mctp_eid_t eid, uint8_t tag,
+                     std::vector<uint8_t>&& msg) override;
+    int recv(Message& msg) override;
+
+  private:
+    /** @brief Queue a message to the peer and wake it up */
+    int deliver(uint8_t tag, std::vector<uint8_t>&& msg);
+
+    mctp_eid_t eid;             //!< MCTP endpoint ID of this end
+    int fd;                     //!< eventfd, counts the messages queued
+    Loopback* peer = nullptr;   //!< the other end
+    std::deque<Message> inbox; //!< messages received from the peer
+};
+
+} // namespace transport
+
+} // namespace pldm
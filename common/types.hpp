@@ -2,6 +2,7 @@
 
 #include <stdint.h>
 
+#include <map>
 #include <set>
 #include <string>
 #include <variant>
@@ -55,4 +56,18 @@ using SensorInfo =
 
 } // namespace pdr
 
+namespace fw_update
+{
+
+using DescriptorType = uint16_t;
+using DescriptorData = std::vector<uint8_t>;
+//!< Descriptors of a firmware device, as found in a firmware device ID record
+//!< or in the QueryDeviceIdentifiers response
+using Descriptors = std::map<DescriptorType, DescriptorData>;
+//!< Descriptors of the firmware devices, keyed by EID
+using DeviceDescriptorMap = std::map<pdr::EID, Descriptors>;
+using ComponentIndex = size_t;
+
+} // namespace fw_update
+
 } // namespace pldm
@@ -503,35 +503,100 @@ int emitStateSensorEventSignal(uint8_t tid, uint16_t sensorId,
     return PLDM_SUCCESS;
 }
 
-uint16_t findStateSensorId(const pldm_pdr* pdrRepo, uint8_t tid,
-                           uint16_t entityType, uint16_t entityInstance,
-                           uint16_t containerId, uint16_t stateSetId)
+void StatePDRIndex::add(uint8_t pdrType, uint16_t entityType,
+                        uint8_t compositeCount, const uint8_t* possibleStates,
+                        const uint8_t* data, uint32_t size)
+{
+    for (uint8_t i = 0; i < compositeCount; ++i)
+    {
+        auto states = reinterpret_cast<const state_effecter_possible_states*>(
+            possibleStates);
+        auto& pdrs =
+            index[makeKey(pdrType, {entityType, states->state_set_id})];
+        // A PDR is reported once even if several of its composite
+        // effecters/sensors use the state set
+        if (pdrs.empty() || pdrs.back().first != data)
+        {
+            pdrs.emplace_back(data, size);
+        }
+        possibleStates += sizeof(states->state_set_id) +
+                          sizeof(states->possible_states_size) +
+                          states->possible_states_size;
+    }
+}
+
+void StatePDRIndex::refresh()
 {
-    auto pdrs = findStateSensorPDR(tid, entityType, stateSetId, pdrRepo);
-    for (auto pdr : pdrs)
+    auto repoGeneration = pldm_pdr_get_generation(repo);
+    if (built && generation == repoGeneration)
     {
-        auto sensorPdr = reinterpret_cast<pldm_state_sensor_pdr*>(pdr.data());
-        auto compositeSensorCount = sensorPdr->composite_sensor_count;
-        auto possible_states_start = sensorPdr->possible_states;
+        return;
+    }
+
+    index.clear();
+    uint8_t* outData = nullptr;
+    uint32_t size{};
+    const pldm_pdr_record* record{};
+    while ((record = pldm_pdr_find_record_by_type(
+                repo, PLDM_STATE_EFFECTER_PDR, record, &outData, &size)))
+    {
+        auto pdr = reinterpret_cast<const pldm_state_effecter_pdr*>(outData);
+        add(PLDM_STATE_EFFECTER_PDR, pdr->entity_type,
+            pdr->composite_effecter_count, pdr->possible_states, outData,
+            size);
+    }
+    record = nullptr;
+    while ((record = pldm_pdr_find_record_by_type(
+                repo, PLDM_STATE_SENSOR_PDR, record, &outData, &size)))
+    {
+        auto pdr = reinterpret_cast<const pldm_state_sensor_pdr*>(outData);
+        add(PLDM_STATE_SENSOR_PDR, pdr->entity_type,
+            pdr->composite_sensor_count, pdr->possible_states, outData, size);
+    }
+
+    generation = repoGeneration;
+    built = true;
+}
 
-        for (auto sensors = 0x00; sensors < compositeSensorCount; sensors++)
+std::vector<std::vector<uint8_t>> StatePDRIndex::find(uint8_t pdrType,
+                                                      const StatePDRKey& key)
+{
+    refresh();
+
+    std::vector<std::vector<uint8_t>> pdrs;
+    auto it = index.find(makeKey(pdrType, key));
+    if (it != index.end())
+    {
+        pdrs.reserve(it->second.size());
+        for (const auto& [data, size] : it->second)
         {
-            auto possibleStates =
-                reinterpret_cast<state_sensor_possible_states*>(
-                    possible_states_start);
-            auto setId = possibleStates->state_set_id;
-            auto possibleStateSize = possibleStates->possible_states_size;
-            if (entityType == sensorPdr->entity_type &&
-                entityInstance == sensorPdr->entity_instance &&
-                stateSetId == setId && containerId == sensorPdr->container_id)
-            {
-                return sensorPdr->sensor_id;
-            }
-            possible_states_start +=
-                possibleStateSize + sizeof(setId) + sizeof(possibleStateSize);
+            pdrs.emplace_back(data, data + size);
         }
     }
-    return PLDM_INVALID_EFFECTER_ID;
+    return pdrs;
+}
+
+std::vector<std::vector<std::vector<uint8_t>>>
+    StatePDRIndex::find(uint8_t pdrType, const std::vector<StatePDRKey>& keys)
+{
+    std::vector<std::vector<std::vector<uint8_t>>> pdrs;
+    pdrs.reserve(keys.size());
+    for (const auto& key : keys)
+    {
+        pdrs.emplace_back(find(pdrType, key));
+    }
+    return pdrs;
+}
+
+uint16_t findStateSensorId(const pldm_pdr* pdrRepo, uint8_t /*tid*/,
+                           uint16_t entityType, uint16_t entityInstance,
+                           uint16_t containerId, uint16_t stateSetId)
+{
+    uint16_t sensorId = PLDM_INVALID_EFFECTER_ID;
+    pldm_pdr_find_state_sensor_id(
+        pdrRepo, pldm_entity{entityType, entityInstance, containerId},
+        stateSetId, &sensorId);
+    return sensorId;
 }
 
 void printBuffer(bool isTx, const std::vector<uint8_t>& buffer)
@@ -19,6 +19,7 @@
 #include <filesystem>
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -310,6 +311,94 @@ std::vector<std::vector<uint8_t>> findStateSensorPDR(uint8_t tid,
                                                      uint16_t stateSetId,
                                                      const pldm_pdr* repo);
 
+/** @struct StatePDRKey
+ *
+ *  Lookup key of the state effecter and state sensor PDRs, the entity type
+ *  and one of the state sets of the PDR.
+ */
+struct StatePDRKey
+{
+    uint16_t entityType;
+    uint16_t stateSetId;
+};
+
+/** @class StatePDRIndex
+ *
+ *  Index of the state effecter and state sensor PDRs of a PDR repo, keyed by
+ *  PDR type, entity type and state set ID. The index is built on the first
+ *  lookup and rebuilt on the next lookup after records are added to or
+ *  removed from the repo, lookups in between don't walk the repo.
+ */
+class StatePDRIndex
+{
+  public:
+    StatePDRIndex() = delete;
+    StatePDRIndex(const StatePDRIndex&) = delete;
+    StatePDRIndex& operator=(const StatePDRIndex&) = delete;
+    StatePDRIndex(StatePDRIndex&&) = default;
+    StatePDRIndex& operator=(StatePDRIndex&&) = default;
+    ~StatePDRIndex() = default;
+
+    /** @brief Constructor
+     *
+     *  @param[in] repo - pointer to the PDR repo to index
+     */
+    explicit StatePDRIndex(const pldm_pdr* repo) : repo(repo)
+    {}
+
+    /** @brief Find the PDRs of a type matching a key
+     *
+     *  @param[in] pdrType - PLDM_STATE_EFFECTER_PDR or PLDM_STATE_SENSOR_PDR
+     *  @param[in] key - entity type and state set ID
+     *
+     *  @return the matching PDRs, in the order of the repo
+     */
+    std::vector<std::vector<uint8_t>> find(uint8_t pdrType,
+                                           const StatePDRKey& key);
+
+    /** @brief Find the PDRs of a type matching each of a set of keys
+     *
+     *  @param[in] pdrType - PLDM_STATE_EFFECTER_PDR or PLDM_STATE_SENSOR_PDR
+     *  @param[in] keys - entity types and state set IDs
+     *
+     *  @return the matching PDRs of every key, in the order of the keys
+     */
+    std::vector<std::vector<std::vector<uint8_t>>>
+        find(uint8_t pdrType, const std::vector<StatePDRKey>& keys);
+
+  private:
+    /** @brief Rebuild the index if the repo changed since it was built */
+    void refresh();
+
+    /** @brief Add the state set IDs of a PDR to the index
+     *
+     *  @param[in] pdrType - type of the PDR
+     *  @param[in] entityType - entity type of the PDR
+     *  @param[in] compositeCount - number of composite effecters/sensors
+     *  @param[in] possibleStates - possible states of the PDR
+     *  @param[in] data - the PDR
+     *  @param[in] size - size of the PDR
+     */
+    void add(uint8_t pdrType, uint16_t entityType, uint8_t compositeCount,
+             const uint8_t* possibleStates, const uint8_t* data,
+             uint32_t size);
+
+    /** @brief Make the index key of a PDR */
+    static uint64_t makeKey(uint8_t pdrType, const StatePDRKey& key)
+    {
+        return (static_cast<uint64_t>(pdrType) << 32) |
+               (static_cast<uint64_t>(key.entityType) << 16) | key.stateSetId;
+    }
+
+    /** @brief PDR data within the repo */
+    using PDRView = std::pair<const uint8_t*, uint32_t>;
+
+    const pldm_pdr* repo;
+    std::unordered_map<uint64_t, std::vector<PDRView>> index;
+    bool built = false;
+    uint32_t generation = 0;
+};
+
 /** @brief Find sensor id from a state sensor PDR
  *
  *  @param[in] pdrRepo - PDR repository
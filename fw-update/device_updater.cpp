@@ -0,0 +1,597 @@
+#include "device_updater.hpp"
+
+#include "libpldm/firmware_update.h"
+
+#include "pldmd/handler.hpp"
+
+#include <functional>
+#include <iostream>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+using pldm::responder::CmdHandler;
+
+void DeviceUpdater::startFwUpdateFlow()
+{
+    startTime = std::chrono::steady_clock::now();
+    updateInProgress = true;
+
+    auto instanceId = requester.getInstanceId(eid);
+    const auto& compImageSetVersion = fwDeviceIDRecord.compImageSetVersion;
+    variable_field compImgSetVerStrInfo{};
+    compImgSetVerStrInfo.ptr =
+        reinterpret_cast<const uint8_t*>(compImageSetVersion.data());
+    compImgSetVerStrInfo.length =
+        static_cast<uint8_t>(compImageSetVersion.size());
+
+    Request request(sizeof(pldm_msg_hdr) + sizeof(pldm_request_update_req) +
+                    compImgSetVerStrInfo.length);
+    auto requestMsg = reinterpret_cast<pldm_msg*>(request.data());
+    auto rc = encode_request_update_req(
+        instanceId, maxTransferSize,
+        fwDeviceIDRecord.applicableComponents.size(),
+        PLDM_FWUP_MIN_OUTSTANDING_REQ, fwDeviceIDRecord.fwDevicePkgData.size(),
+        fwDeviceIDRecord.compImageSetVersionStrType,
+        compImgSetVerStrInfo.length, &compImgSetVerStrInfo, requestMsg,
+        sizeof(pldm_request_update_req) + compImgSetVerStrInfo.length);
+    if (rc)
+    {
+        requester.markFree(eid, instanceId);
+        std::cerr << "encode_request_update_req failed, EID=" << unsigned(eid)
+                  << ", RC=" << rc << "\n";
+        updateDone(false);
+        return;
+    }
+
+    rc = handler.registerRequest(
+        eid, instanceId, PLDM_FWUP, PLDM_REQUEST_UPDATE, std::move(request),
+        std::move(std::bind_front(&DeviceUpdater::requestUpdate, this)));
+    if (rc)
+    {
+        std::cerr << "Failed to send RequestUpdate, EID=" << unsigned(eid)
+                  << ", RC=" << rc << "\n";
+        updateDone(false);
+    }
+}
+
+void DeviceUpdater::requestUpdate(mctp_eid_t eid, const pldm_msg* response,
+                                  size_t respMsgLen)
+{
+    if (response == nullptr || !respMsgLen)
+    {
+        std::cerr << "No response received for RequestUpdate, EID="
+                  << unsigned(eid) << "\n";
+        updateDone(false);
+        return;
+    }
+
+    uint8_t completionCode = 0;
+    uint16_t fdMetaDataLen = 0;
+    uint8_t fdWillSendPkgData = 0;
+    auto rc = decode_request_update_resp(response, respMsgLen, &completionCode,
+                                         &fdMetaDataLen, &fdWillSendPkgData);
+    if (rc || completionCode)
+    {
+        std::cerr << "RequestUpdate failed, EID=" << unsigned(eid)
+                  << ", RC=" << rc << ", CC=" << unsigned(completionCode)
+                  << "\n";
+        updateDone(false);
+        return;
+    }
+
+    sendPassCompTableRequest(0);
+}
+
+void DeviceUpdater::sendPassCompTableRequest(size_t offset)
+{
+    componentOffset = offset;
+    const auto& applicableComponents = fwDeviceIDRecord.applicableComponents;
+    const auto& comp =
+        package.getComponentImageInfos()[applicableComponents[offset]];
+
+    uint8_t transferFlag = PLDM_MIDDLE;
+    if (applicableComponents.size() == 1)
+    {
+        transferFlag = PLDM_START_AND_END;
+    }
+    else if (offset == 0)
+    {
+        transferFlag = PLDM_START;
+    }
+    else if (offset == applicableComponents.size() - 1)
+    {
+        transferFlag = PLDM_END;
+    }
+
+    auto instanceId = requester.getInstanceId(eid);
+    variable_field compVerStrInfo{};
+    compVerStrInfo.ptr = reinterpret_cast<const uint8_t*>(comp.version.data());
+    compVerStrInfo.length = static_cast<uint8_t>(comp.version.size());
+
+    Request request(sizeof(pldm_msg_hdr) +
+                    sizeof(pldm_pass_component_table_req) +
+                    compVerStrInfo.length);
+    auto requestMsg = reinterpret_cast<pldm_msg*>(request.data());
+    // The component parameter table of the FD is not queried, so the
+    // ComponentClassificationIndex is always 0
+    auto rc = encode_pass_component_table_req(
+        instanceId, transferFlag, comp.classification, comp.identifier, 0,
+        comp.comparisonStamp, comp.versionStrType, compVerStrInfo.length,
+        &compVerStrInfo, requestMsg,
+        sizeof(pldm_pass_component_table_req) + compVerStrInfo.length);
+    if (rc)
+    {
+        requester.markFree(eid, instanceId);
+        std::cerr << "encode_pass_component_table_req failed, EID="
+                  << unsigned(eid) << ", RC=" << rc << "\n";
+        updateDone(false);
+        return;
+    }
+
+    rc = handler.registerRequest(
+        eid, instanceId, PLDM_FWUP, PLDM_PASS_COMPONENT_TABLE,
+        std::move(request),
+        std::move(std::bind_front(&DeviceUpdater::passCompTable, this)));
+    if (rc)
+    {
+        std::cerr << "Failed to send PassComponentTable, EID=" << unsigned(eid)
+                  << ", RC=" << rc << "\n";
+        updateDone(false);
+    }
+}
+
+void DeviceUpdater::passCompTable(mctp_eid_t eid, const pldm_msg* response,
+                                  size_t respMsgLen)
+{
+    if (response == nullptr || !respMsgLen)
+    {
+        std::cerr << "No response received for PassComponentTable, EID="
+                  << unsigned(eid) << "\n";
+        updateDone(false);
+        return;
+    }
+
+    uint8_t completionCode = 0;
+    uint8_t compResponse = 0;
+    uint8_t compResponseCode = 0;
+    auto rc =
+        decode_pass_component_table_resp(response, respMsgLen, &completionCode,
+                                         &compResponse, &compResponseCode);
+    if (rc || completionCode)
+    {
+        std::cerr << "PassComponentTable failed, EID=" << unsigned(eid)
+                  << ", RC=" << rc << ", CC=" << unsigned(completionCode)
+                  << "\n";
+        updateDone(false);
+        return;
+    }
+    // The FD tells in the UpdateComponent response whether the component is
+    // updated, a component that may not be updateable is still passed on.
+    if (compResponse != PLDM_CR_COMP_CAN_BE_UPDATED)
+    {
+        std::cerr << "Component may not be updateable, EID=" << unsigned(eid)
+                  << ", COMP_RESP_CODE=" << unsigned(compResponseCode)
+                  << "\n";
+    }
+
+    if (componentOffset + 1 < fwDeviceIDRecord.applicableComponents.size())
+    {
+        sendPassCompTableRequest(componentOffset + 1);
+    }
+    else
+    {
+        sendUpdateComponentRequest(0);
+    }
+}
+
+void DeviceUpdater::sendUpdateComponentRequest(size_t offset)
+{
+    pldmRequest.reset();
+    componentOffset = offset;
+    const auto& comp = package.getComponentImageInfos()
+        [fwDeviceIDRecord.applicableComponents[offset]];
+
+    auto instanceId = requester.getInstanceId(eid);
+    variable_field compVerStrInfo{};
+    compVerStrInfo.ptr = reinterpret_cast<const uint8_t*>(comp.version.data());
+    compVerStrInfo.length = static_cast<uint8_t>(comp.version.size());
+
+    // Request a forced update if ComponentOptions asks for it
+    bitfield32_t updateOptionFlags{};
+    updateOptionFlags.bits.bit0 = comp.options.bits.bit0;
+
+    Request request(sizeof(pldm_msg_hdr) + sizeof(pldm_update_component_req) +
+                    compVerStrInfo.length);
+    auto requestMsg = reinterpret_cast<pldm_msg*>(request.data());
+    auto rc = encode_update_component_req(
+        instanceId, comp.classification, comp.identifier, 0,
+        comp.comparisonStamp, comp.size, updateOptionFlags,
+        comp.versionStrType, compVerStrInfo.length, &compVerStrInfo,
+        requestMsg, sizeof(pldm_update_component_req) + compVerStrInfo.length);
+    if (rc)
+    {
+        requester.markFree(eid, instanceId);
+        std::cerr << "encode_update_component_req failed, EID="
+                  << unsigned(eid) << ", RC=" << rc << "\n";
+        updateDone(false);
+        return;
+    }
+
+    rc = handler.registerRequest(
+        eid, instanceId, PLDM_FWUP, PLDM_UPDATE_COMPONENT, std::move(request),
+        std::move(std::bind_front(&DeviceUpdater::updateComponent, this)));
+    if (rc)
+    {
+        std::cerr << "Failed to send UpdateComponent, EID=" << unsigned(eid)
+                  << ", RC=" << rc << "\n";
+        updateDone(false);
+    }
+}
+
+void DeviceUpdater::updateComponent(mctp_eid_t eid, const pldm_msg* response,
+                                    size_t respMsgLen)
+{
+    if (response == nullptr || !respMsgLen)
+    {
+        std::cerr << "No response received for UpdateComponent, EID="
+                  << unsigned(eid) << "\n";
+        updateDone(false);
+        return;
+    }
+
+    uint8_t completionCode = 0;
+    uint8_t compCompatibilityResp = 0;
+    uint8_t compCompatibilityRespCode = 0;
+    bitfield32_t updateOptionFlagsEnabled{};
+    uint16_t timeBeforeReqFWData = 0;
+    auto rc = decode_update_component_resp(
+        response, respMsgLen, &completionCode, &compCompatibilityResp,
+        &compCompatibilityRespCode, &updateOptionFlagsEnabled,
+        &timeBeforeReqFWData);
+    if (rc || completionCode)
+    {
+        std::cerr << "UpdateComponent failed, EID=" << unsigned(eid)
+                  << ", RC=" << rc << ", CC=" << unsigned(completionCode)
+                  << "\n";
+        updateDone(false);
+        return;
+    }
+    if (compCompatibilityResp != PLDM_CCR_COMP_CAN_BE_UPDATED)
+    {
+        std::cerr << "Component cannot be updated, EID=" << unsigned(eid)
+                  << ", COMP_COMPATIBILITY_RESP_CODE="
+                  << unsigned(compCompatibilityRespCode) << "\n";
+        updateDone(false);
+        return;
+    }
+
+    componentImage = package.getComponentImage(
+        fwDeviceIDRecord.applicableComponents[componentOffset]);
+    startFdTimer();
+}
+
+Response DeviceUpdater::handleRequest(uint8_t command, const pldm_msg* request,
+                                      size_t reqMsgLen)
+{
+    if (fdTimer.isRunning())
+    {
+        startFdTimer();
+    }
+
+    switch (command)
+    {
+        case PLDM_REQUEST_FIRMWARE_DATA:
+            return requestFwData(request, reqMsgLen);
+        case PLDM_TRANSFER_COMPLETE:
+            return transferComplete(request, reqMsgLen);
+        case PLDM_VERIFY_COMPLETE:
+            return verifyComplete(request, reqMsgLen);
+        case PLDM_APPLY_COMPLETE:
+            return applyComplete(request, reqMsgLen);
+        default:
+            return CmdHandler::ccOnlyResponse(request,
+                                              PLDM_ERROR_UNSUPPORTED_PLDM_CMD);
+    }
+}
+
+Response DeviceUpdater::requestFwData(const pldm_msg* request,
+                                      size_t payloadLength)
+{
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    auto rc = decode_request_firmware_data_req(request, payloadLength, &offset,
+                                               &length);
+    if (rc)
+    {
+        return CmdHandler::ccOnlyResponse(request, rc);
+    }
+
+    if (componentImage.empty())
+    {
+        return CmdHandler::ccOnlyResponse(request,
+                                          PLDM_FWUP_COMMAND_NOT_EXPECTED);
+    }
+    if (length < PLDM_FWUP_BASELINE_TRANSFER_SIZE || length > maxTransferSize)
+    {
+        return CmdHandler::ccOnlyResponse(request,
+                                          PLDM_FWUP_INVALID_TRANSFER_LENGTH);
+    }
+    // The FD may read up to one baseline transfer past the end of the image,
+    // the part beyond the image is zero padded.
+    if (static_cast<uint64_t>(offset) + length >
+        componentImage.size() + PLDM_FWUP_BASELINE_TRANSFER_SIZE)
+    {
+        return CmdHandler::ccOnlyResponse(request, PLDM_FWUP_DATA_OUT_OF_RANGE);
+    }
+
+    constexpr size_t ccSize = sizeof(uint8_t);
+    Response response;
+    response.reserve(sizeof(pldm_msg_hdr) + ccSize + length);
+    response.resize(sizeof(pldm_msg_hdr) + ccSize);
+    auto responseMsg = reinterpret_cast<pldm_msg*>(response.data());
+    rc = encode_request_firmware_data_resp(request->hdr.instance_id,
+                                           PLDM_SUCCESS, responseMsg, ccSize);
+    if (rc)
+    {
+        return CmdHandler::ccOnlyResponse(request, rc);
+    }
+
+    if (offset < componentImage.size())
+    {
+        auto portion = componentImage.subspan(
+            offset, std::min<size_t>(length, componentImage.size() - offset));
+        response.insert(response.end(), portion.begin(), portion.end());
+        bytesTransferred += portion.size();
+    }
+    response.resize(sizeof(pldm_msg_hdr) + ccSize + length);
+
+    return response;
+}
+
+Response DeviceUpdater::transferComplete(const pldm_msg* request,
+                                         size_t payloadLength)
+{
+    uint8_t transferResult = 0;
+    auto rc =
+        decode_transfer_complete_req(request, payloadLength, &transferResult);
+    if (rc)
+    {
+        return CmdHandler::ccOnlyResponse(request, rc);
+    }
+    if (componentImage.empty())
+    {
+        return CmdHandler::ccOnlyResponse(request,
+                                          PLDM_FWUP_COMMAND_NOT_EXPECTED);
+    }
+
+    componentImage = {};
+    if (transferResult != PLDM_FWUP_TRANSFER_SUCCESS)
+    {
+        std::cerr << "Component transfer failed, EID=" << unsigned(eid)
+                  << ", TRANSFER_RESULT=" << unsigned(transferResult) << "\n";
+        updateDone(false);
+    }
+
+    return CmdHandler::ccOnlyResponse(request, PLDM_SUCCESS);
+}
+
+Response DeviceUpdater::verifyComplete(const pldm_msg* request,
+                                       size_t payloadLength)
+{
+    uint8_t verifyResult = 0;
+    auto rc = decode_verify_complete_req(request, payloadLength, &verifyResult);
+    if (rc)
+    {
+        return CmdHandler::ccOnlyResponse(request, rc);
+    }
+    if (!updateInProgress)
+    {
+        return CmdHandler::ccOnlyResponse(request,
+                                          PLDM_FWUP_COMMAND_NOT_EXPECTED);
+    }
+
+    if (verifyResult != PLDM_FWUP_VERIFY_SUCCESS)
+    {
+        std::cerr << "Component verification failed, EID=" << unsigned(eid)
+                  << ", VERIFY_RESULT=" << unsigned(verifyResult) << "\n";
+        updateDone(false);
+    }
+
+    return CmdHandler::ccOnlyResponse(request, PLDM_SUCCESS);
+}
+
+Response DeviceUpdater::applyComplete(const pldm_msg* request,
+                                      size_t payloadLength)
+{
+    uint8_t applyResult = 0;
+    bitfield16_t compActivationModification{};
+    auto rc = decode_apply_complete_req(request, payloadLength, &applyResult,
+                                        &compActivationModification);
+    if (rc)
+    {
+        return CmdHandler::ccOnlyResponse(request, rc);
+    }
+    if (!updateInProgress)
+    {
+        return CmdHandler::ccOnlyResponse(request,
+                                          PLDM_FWUP_COMMAND_NOT_EXPECTED);
+    }
+
+    if (applyResult != PLDM_FWUP_APPLY_SUCCESS &&
+        applyResult != PLDM_FWUP_APPLY_SUCCESS_WITH_ACTIVATION_METHOD)
+    {
+        std::cerr << "Component apply failed, EID=" << unsigned(eid)
+                  << ", APPLY_RESULT=" << unsigned(applyResult) << "\n";
+        updateDone(false);
+        return CmdHandler::ccOnlyResponse(request, PLDM_SUCCESS);
+    }
+
+    // The next request goes out once the ApplyComplete response is sent
+    fdTimer.stop();
+    if (componentOffset + 1 < fwDeviceIDRecord.applicableComponents.size())
+    {
+        pldmRequest = std::make_unique<sdeventplus::source::Defer>(
+            event, std::bind(&DeviceUpdater::sendUpdateComponentRequest, this,
+                             componentOffset + 1));
+    }
+    else
+    {
+        pldmRequest = std::make_unique<sdeventplus::source::Defer>(
+            event,
+            std::bind(&DeviceUpdater::sendActivateFirmwareRequest, this));
+    }
+
+    return CmdHandler::ccOnlyResponse(request, PLDM_SUCCESS);
+}
+
+void DeviceUpdater::sendActivateFirmwareRequest()
+{
+    pldmRequest.reset();
+    auto instanceId = requester.getInstanceId(eid);
+    Request request(sizeof(pldm_msg_hdr) + sizeof(pldm_activate_firmware_req));
+    auto requestMsg = reinterpret_cast<pldm_msg*>(request.data());
+    auto rc = encode_activate_firmware_req(
+        instanceId, PLDM_NOT_ACTIVATE_SELF_CONTAINED_COMPONENTS, requestMsg,
+        sizeof(pldm_activate_firmware_req));
+    if (rc)
+    {
+        requester.markFree(eid, instanceId);
+        std::cerr << "encode_activate_firmware_req failed, EID="
+                  << unsigned(eid) << ", RC=" << rc << "\n";
+        updateDone(false);
+        return;
+    }
+
+    rc = handler.registerRequest(
+        eid, instanceId, PLDM_FWUP, PLDM_ACTIVATE_FIRMWARE, std::move(request),
+        std::move(std::bind_front(&DeviceUpdater::activateFirmware, this)));
+    if (rc)
+    {
+        std::cerr << "Failed to send ActivateFirmware, EID=" << unsigned(eid)
+                  << ", RC=" << rc << "\n";
+        updateDone(false);
+    }
+}
+
+void DeviceUpdater::activateFirmware(mctp_eid_t eid, const pldm_msg* response,
+                                     size_t respMsgLen)
+{
+    if (response == nullptr || !respMsgLen)
+    {
+        std::cerr << "No response received for ActivateFirmware, EID="
+                  << unsigned(eid) << "\n";
+        updateDone(false);
+        return;
+    }
+
+    uint8_t completionCode = 0;
+    uint16_t estimatedTimeForActivation = 0;
+    auto rc = decode_activate_firmware_resp(
+        response, respMsgLen, &completionCode, &estimatedTimeForActivation);
+    if (rc || (completionCode &&
+               completionCode != PLDM_FWUP_ACTIVATION_NOT_REQUIRED))
+    {
+        std::cerr << "ActivateFirmware failed, EID=" << unsigned(eid)
+                  << ", RC=" << rc << ", CC=" << unsigned(completionCode)
+                  << "\n";
+        updateDone(false);
+        return;
+    }
+
+    updateDone(true);
+}
+
+std::chrono::steady_clock::duration DeviceUpdater::getElapsedTime() const
+{
+    return (updateInProgress ? std::chrono::steady_clock::now() : endTime) -
+           startTime;
+}
+
+void DeviceUpdater::startFdTimer()
+{
+    try
+    {
+        fdTimer.start(
+            std::chrono::duration_cast<std::chrono::microseconds>(fdTimeout));
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cerr << "Failed to start the FD timer, EID=" << unsigned(eid)
+                  << ", ERROR=" << e.what() << "\n";
+    }
+}
+
+void DeviceUpdater::fdTimedOut()
+{
+    std::cerr << "Timed out waiting for the FD request, EID=" << unsigned(eid)
+              << "\n";
+
+    auto instanceId = requester.getInstanceId(eid);
+    Request request(sizeof(pldm_msg_hdr) + PLDM_CANCEL_UPDATE_REQ_BYTES);
+    auto requestMsg = reinterpret_cast<pldm_msg*>(request.data());
+    auto rc = encode_cancel_update_req(instanceId, requestMsg,
+                                       PLDM_CANCEL_UPDATE_REQ_BYTES);
+    if (rc)
+    {
+        requester.markFree(eid, instanceId);
+        std::cerr << "encode_cancel_update_req failed, EID=" << unsigned(eid)
+                  << ", RC=" << rc << "\n";
+    }
+    else
+    {
+        // The update is over before the response comes back, the response
+        // handler does not refer to the DeviceUpdater as it can be gone by
+        // then.
+        rc = handler.registerRequest(
+            eid, instanceId, PLDM_FWUP, PLDM_CANCEL_UPDATE, std::move(request),
+            [](mctp_eid_t eid, const pldm_msg* response, size_t respMsgLen) {
+                if (response == nullptr || !respMsgLen)
+                {
+                    std::cerr << "No response received for CancelUpdate, EID="
+                              << unsigned(eid) << "\n";
+                    return;
+                }
+                uint8_t completionCode = 0;
+                bool8_t nonFunctioningComponentIndication = 0;
+                bitfield64_t nonFunctioningComponentBitmap{};
+                auto rc = decode_cancel_update_resp(
+                    response, respMsgLen, &completionCode,
+                    &nonFunctioningComponentIndication,
+                    &nonFunctioningComponentBitmap);
+                if (rc || completionCode)
+                {
+                    std::cerr << "CancelUpdate failed, EID=" << unsigned(eid)
+                              << ", RC=" << rc
+                              << ", CC=" << unsigned(completionCode) << "\n";
+                }
+            });
+        if (rc)
+        {
+            std::cerr << "Failed to send CancelUpdate, EID=" << unsigned(eid)
+                      << ", RC=" << rc << "\n";
+        }
+    }
+
+    updateDone(false);
+}
+
+void DeviceUpdater::updateDone(bool status)
+{
+    if (!updateInProgress)
+    {
+        return;
+    }
+    updateInProgress = false;
+    componentImage = {};
+    fdTimer.stop();
+    endTime = std::chrono::steady_clock::now();
+    updateCompleteHandler(eid, status);
+}
+
+} // namespace fw_update
+
+} // namespace pldm
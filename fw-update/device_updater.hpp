@@ -0,0 +1,252 @@
+#pragma once
+
+#include "libpldm/firmware_update.h"
+
+#include "common/types.hpp"
+#include "package_parser.hpp"
+#include "pldmd/dbus_impl_requester.hpp"
+#include "requester/handler.hpp"
+
+#include <sdbusplus/timer.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/event.hpp>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+/** @brief Callback invoked when the update of a firmware device ends
+ *
+ *  @param[in] eid - endpoint ID of the firmware device
+ *  @param[in] status - true if the update succeeded, false otherwise
+ */
+using UpdateCompleteHandler = std::function<void(mctp_eid_t eid, bool status)>;
+
+/** @class DeviceUpdater
+ *
+ *  @brief Runs the firmware update flow of one firmware device (FD).
+ *
+ *  The update agent side requests (RequestUpdate, PassComponentTable,
+ *  UpdateComponent and ActivateFirmware) are sent through the shared requester
+ *  handler, so several DeviceUpdater objects can update their FDs at the same
+ *  time. The requests initiated by the FD (RequestFirmwareData,
+ *  TransferComplete, VerifyComplete and ApplyComplete) are routed to
+ *  handleRequest by the update manager. The FD is given up on, and sent
+ *  CancelUpdate, if it does not send its next request within the FD timeout.
+ */
+class DeviceUpdater
+{
+  public:
+    DeviceUpdater() = delete;
+    DeviceUpdater(const DeviceUpdater&) = delete;
+    DeviceUpdater& operator=(const DeviceUpdater&) = delete;
+    DeviceUpdater(DeviceUpdater&&) = delete;
+    DeviceUpdater& operator=(DeviceUpdater&&) = delete;
+    ~DeviceUpdater() = default;
+
+    /** @brief Constructor
+     *
+     *  @param[in] eid - endpoint ID of the firmware device
+     *  @param[in] event - reference to PLDM daemon's main event loop
+     *  @param[in] package - firmware update package
+     *  @param[in] fwDeviceIDRecord - firmware device ID record matching the FD
+     *  @param[in] maxTransferSize - maximum size of the image portion the FD
+     *                               can request with RequestFirmwareData
+     *  @param[in] fdTimeout - time the FD has to send its next request, once
+     *                         it drives the component update
+     *  @param[in] requester - reference to Requester object
+     *  @param[in] handler - PLDM request handler
+     *  @param[in] updateCompleteHandler - invoked when the update ends
+     */
+    explicit DeviceUpdater(
+        mctp_eid_t eid, sdeventplus::Event& event, const Package& package,
+        const FirmwareDeviceIDRecord& fwDeviceIDRecord,
+        uint32_t maxTransferSize, std::chrono::milliseconds fdTimeout,
+        pldm::dbus_api::Requester& requester,
+        pldm::requester::Handler<pldm::requester::Request>& handler,
+        UpdateCompleteHandler updateCompleteHandler) :
+        eid(eid),
+        event(event), package(package), fwDeviceIDRecord(fwDeviceIDRecord),
+        maxTransferSize(maxTransferSize), fdTimeout(fdTimeout),
+        requester(requester), handler(handler),
+        updateCompleteHandler(updateCompleteHandler),
+        fdTimer(event.get(), std::bind(&DeviceUpdater::fdTimedOut, this))
+    {}
+
+    /** @brief Start the firmware update flow, by sending RequestUpdate */
+    void startFwUpdateFlow();
+
+    /** @brief Handle a request initiated by the FD
+     *
+     *  @param[in] command - PLDM firmware update command
+     *  @param[in] request - PLDM request message
+     *  @param[in] reqMsgLen - PLDM request message payload length
+     *
+     *  @return PLDM response message
+     */
+    Response handleRequest(uint8_t command, const pldm_msg* request,
+                           size_t reqMsgLen);
+
+    /** @brief Handler for RequestUpdate response
+     *
+     *  @param[in] eid - remote MCTP endpoint
+     *  @param[in] response - PLDM response message
+     *  @param[in] respMsgLen - Response message length
+     */
+    void requestUpdate(mctp_eid_t eid, const pldm_msg* response,
+                       size_t respMsgLen);
+
+    /** @brief Handler for PassComponentTable response
+     *
+     *  @param[in] eid - remote MCTP endpoint
+     *  @param[in] response - PLDM response message
+     *  @param[in] respMsgLen - Response message length
+     */
+    void passCompTable(mctp_eid_t eid, const pldm_msg* response,
+                       size_t respMsgLen);
+
+    /** @brief Handler for UpdateComponent response
+     *
+     *  @param[in] eid - remote MCTP endpoint
+     *  @param[in] response - PLDM response message
+     *  @param[in] respMsgLen - Response message length
+     */
+    void updateComponent(mctp_eid_t eid, const pldm_msg* response,
+                         size_t respMsgLen);
+
+    /** @brief Handler for ActivateFirmware response
+     *
+     *  @param[in] eid - remote MCTP endpoint
+     *  @param[in] response - PLDM response message
+     *  @param[in] respMsgLen - Response message length
+     */
+    void activateFirmware(mctp_eid_t eid, const pldm_msg* response,
+                          size_t respMsgLen);
+
+    /** @brief Handler for RequestFirmwareData request
+     *
+     *  The image portion is copied straight from the package mapping into the
+     *  response message.
+     *
+     *  @param[in] request - PLDM request message
+     *  @param[in] payloadLength - PLDM request message payload length
+     *
+     *  @return PLDM response message
+     */
+    Response requestFwData(const pldm_msg* request, size_t payloadLength);
+
+    /** @brief Handler for TransferComplete request
+     *
+     *  @param[in] request - PLDM request message
+     *  @param[in] payloadLength - PLDM request message payload length
+     *
+     *  @return PLDM response message
+     */
+    Response transferComplete(const pldm_msg* request, size_t payloadLength);
+
+    /** @brief Handler for VerifyComplete request
+     *
+     *  @param[in] request - PLDM request message
+     *  @param[in] payloadLength - PLDM request message payload length
+     *
+     *  @return PLDM response message
+     */
+    Response verifyComplete(const pldm_msg* request, size_t payloadLength);
+
+    /** @brief Handler for ApplyComplete request
+     *
+     *  @param[in] request - PLDM request message
+     *  @param[in] payloadLength - PLDM request message payload length
+     *
+     *  @return PLDM response message
+     */
+    Response applyComplete(const pldm_msg* request, size_t payloadLength);
+
+    /** @brief Get the number of image bytes served to the FD */
+    uint64_t getBytesTransferred() const
+    {
+        return bytesTransferred;
+    }
+
+    /** @brief Get the time spent updating the FD
+     *
+     *  @return time from RequestUpdate to the end of the update, or to now
+     *          if the update is in progress
+     */
+    std::chrono::steady_clock::duration getElapsedTime() const;
+
+  private:
+    /** @brief Send PassComponentTable for the component at offset
+     *
+     *  @param[in] offset - offset in the applicable components of the record
+     */
+    void sendPassCompTableRequest(size_t offset);
+
+    /** @brief Send UpdateComponent for the component at offset
+     *
+     *  @param[in] offset - offset in the applicable components of the record
+     */
+    void sendUpdateComponentRequest(size_t offset);
+
+    /** @brief Send ActivateFirmware */
+    void sendActivateFirmwareRequest();
+
+    /** @brief Arm the FD timer, or re-arm it if it is running */
+    void startFdTimer();
+
+    /** @brief Give up on the FD that stopped sending its requests, by
+     *         sending CancelUpdate
+     */
+    void fdTimedOut();
+
+    /** @brief End the update of the FD
+     *
+     *  @param[in] status - true if the update succeeded, false otherwise
+     */
+    void updateDone(bool status);
+
+    const mctp_eid_t eid;
+    sdeventplus::Event& event;
+    const Package& package;
+    const FirmwareDeviceIDRecord& fwDeviceIDRecord;
+    const uint32_t maxTransferSize;
+    const std::chrono::milliseconds fdTimeout;
+    pldm::dbus_api::Requester& requester;
+    pldm::requester::Handler<pldm::requester::Request>& handler;
+    UpdateCompleteHandler updateCompleteHandler;
+
+    /** @brief Expires when the FD does not send its next request in time,
+     *         runs from the UpdateComponent response to ApplyComplete
+     */
+    phosphor::Timer fdTimer;
+
+    /** @brief Offset in the applicable components of the component being
+     *         passed or updated
+     */
+    size_t componentOffset = 0;
+
+    /** @brief Image of the component being transferred, empty when the FD is
+     *         not expected to request firmware data
+     */
+    std::span<const uint8_t> componentImage;
+
+    /** @brief Sends the next request once the response to the FD's request
+     *         is out
+     */
+    std::unique_ptr<sdeventplus::source::Defer> pldmRequest;
+
+    bool updateInProgress = false;
+    uint64_t bytesTransferred = 0;
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point endTime;
+};
+
+} // namespace fw_update
+
+} // namespace pldm
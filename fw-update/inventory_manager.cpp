@@ -0,0 +1,122 @@
+#include "inventory_manager.hpp"
+
+#include "libpldm/firmware_update.h"
+
+#include <functional>
+#include <iostream>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+void InventoryManager::discover(const std::vector<mctp_eid_t>& eids)
+{
+    for (auto eid : eids)
+    {
+        uint8_t instanceId = 0;
+        try
+        {
+            instanceId = requester.getInstanceId(eid);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "No instance ID for QueryDeviceIdentifiers, EID="
+                      << unsigned(eid) << ", ERROR=" << e.what() << "\n";
+            continue;
+        }
+
+        Request request(sizeof(pldm_msg_hdr) +
+                        PLDM_QUERY_DEVICE_IDENTIFIERS_REQ_BYTES);
+        auto requestMsg = reinterpret_cast<pldm_msg*>(request.data());
+        auto rc = encode_query_device_identifiers_req(
+            instanceId, PLDM_QUERY_DEVICE_IDENTIFIERS_REQ_BYTES, requestMsg);
+        if (rc)
+        {
+            requester.markFree(eid, instanceId);
+            std::cerr << "encode_query_device_identifiers_req failed, EID="
+                      << unsigned(eid) << ", RC=" << rc << "\n";
+            continue;
+        }
+
+        rc = handler.registerRequest(
+            eid, instanceId, PLDM_FWUP, PLDM_QUERY_DEVICE_IDENTIFIERS,
+            std::move(request),
+            std::move(
+                std::bind_front(&InventoryManager::queryDeviceIdentifiers,
+                                this)));
+        if (rc)
+        {
+            std::cerr << "Failed to send QueryDeviceIdentifiers, EID="
+                      << unsigned(eid) << ", RC=" << rc << "\n";
+        }
+    }
+}
+
+void InventoryManager::remove(const std::vector<mctp_eid_t>& eids)
+{
+    for (auto eid : eids)
+    {
+        descriptorMap.erase(eid);
+    }
+}
+
+void InventoryManager::queryDeviceIdentifiers(mctp_eid_t eid,
+                                              const pldm_msg* response,
+                                              size_t respMsgLen)
+{
+    if (response == nullptr || !respMsgLen)
+    {
+        std::cerr << "No response received for QueryDeviceIdentifiers, EID="
+                  << unsigned(eid) << "\n";
+        return;
+    }
+
+    uint8_t completionCode = 0;
+    uint32_t deviceIdentifiersLen = 0;
+    uint8_t descriptorCount = 0;
+    uint8_t* descriptorPtr = nullptr;
+    auto rc = decode_query_device_identifiers_resp(
+        response, respMsgLen, &completionCode, &deviceIdentifiersLen,
+        &descriptorCount, &descriptorPtr);
+    if (rc || completionCode)
+    {
+        std::cerr << "QueryDeviceIdentifiers failed, EID=" << unsigned(eid)
+                  << ", RC=" << rc << ", CC=" << unsigned(completionCode)
+                  << "\n";
+        return;
+    }
+
+    Descriptors descriptors;
+    size_t descriptorsLen = deviceIdentifiersLen;
+    for (uint8_t i = 0; i < descriptorCount; ++i)
+    {
+        uint16_t descriptorType = 0;
+        variable_field descriptorData{};
+        rc = decode_descriptor_type_length_value(
+            descriptorPtr, descriptorsLen, &descriptorType, &descriptorData);
+        if (rc)
+        {
+            std::cerr << "Failed to decode the device descriptor, EID="
+                      << unsigned(eid) << ", RC=" << rc << "\n";
+            return;
+        }
+        descriptors.emplace(
+            descriptorType,
+            DescriptorData(descriptorData.ptr,
+                           descriptorData.ptr + descriptorData.length));
+
+        auto descriptorLen = sizeof(pldm_descriptor_tlv().descriptor_type) +
+                             sizeof(pldm_descriptor_tlv().descriptor_length) +
+                             descriptorData.length;
+        descriptorPtr += descriptorLen;
+        descriptorsLen -= descriptorLen;
+    }
+
+    descriptorMap[eid] = std::move(descriptors);
+}
+
+} // namespace fw_update
+
+} // namespace pldm
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "libpldm/base.h"
+
+#include "common/types.hpp"
+#include "pldmd/dbus_impl_requester.hpp"
+#include "requester/handler.hpp"
+
+#include <vector>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+/** @class InventoryManager
+ *
+ *  @brief Discovers the firmware devices (FD) on MCTP.
+ *
+ *  Sends QueryDeviceIdentifiers to the endpoints and keeps the descriptors
+ *  they report, the update manager matches them against the firmware device
+ *  ID records of a package.
+ */
+class InventoryManager
+{
+  public:
+    InventoryManager() = delete;
+    InventoryManager(const InventoryManager&) = delete;
+    InventoryManager& operator=(const InventoryManager&) = delete;
+    InventoryManager(InventoryManager&&) = delete;
+    InventoryManager& operator=(InventoryManager&&) = delete;
+    ~InventoryManager() = default;
+
+    /** @brief Constructor
+     *
+     *  @param[in] requester - reference to Requester object
+     *  @param[in] handler - PLDM request handler
+     */
+    explicit InventoryManager(
+        pldm::dbus_api::Requester& requester,
+        pldm::requester::Handler<pldm::requester::Request>& handler) :
+        requester(requester),
+        handler(handler)
+    {}
+
+    /** @brief Query the identifiers of the FDs, the descriptors of an
+     *         endpoint already known are refreshed
+     *
+     *  @param[in] eids - MCTP endpoint IDs of the FDs
+     */
+    void discover(const std::vector<mctp_eid_t>& eids);
+
+    /** @brief Forget the FDs that went away
+     *
+     *  @param[in] eids - MCTP endpoint IDs of the FDs
+     */
+    void remove(const std::vector<mctp_eid_t>& eids);
+
+    /** @brief Handler for QueryDeviceIdentifiers response
+     *
+     *  @param[in] eid - remote MCTP endpoint
+     *  @param[in] response - PLDM response message
+     *  @param[in] respMsgLen - Response message length
+     */
+    void queryDeviceIdentifiers(mctp_eid_t eid, const pldm_msg* response,
+                                size_t respMsgLen);
+
+    /** @brief Get the descriptors of the FDs discovered */
+    const DeviceDescriptorMap& getDescriptorMap() const
+    {
+        return descriptorMap;
+    }
+
+  private:
+    pldm::dbus_api::Requester& requester;
+    pldm::requester::Handler<pldm::requester::Request>& handler;
+    DeviceDescriptorMap descriptorMap;
+};
+
+} // namespace fw_update
+
+} // namespace pldm
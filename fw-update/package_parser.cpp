@@ -0,0 +1,286 @@
+#include "package_parser.hpp"
+
+#include "libpldm/utils.h"
+
+#include "common/utils.hpp"
+
+#include <endian.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+namespace
+{
+
+/** @brief Read a little endian field of the package header */
+template <typename T>
+T readLE(const uint8_t* ptr)
+{
+    T value{};
+    std::memcpy(&value, ptr, sizeof(value));
+    if constexpr (sizeof(T) == sizeof(uint16_t))
+    {
+        return le16toh(value);
+    }
+    else
+    {
+        return le32toh(value);
+    }
+}
+
+} // namespace
+
+Package::Package(const std::filesystem::path& path)
+{
+    pldm::utils::CustomFD fd(open(path.c_str(), O_RDONLY));
+    if (fd() < 0)
+    {
+        throw std::runtime_error("Failed to open the package " +
+                                 path.string());
+    }
+
+    struct stat sb
+    {};
+    if (fstat(fd(), &sb) < 0 || sb.st_size == 0)
+    {
+        throw std::runtime_error("Failed to get the size of the package " +
+                                 path.string());
+    }
+
+    // The mapping stays valid after the fd is closed
+    auto addr = mmap(nullptr, sb.st_size, PROT_READ, MAP_PRIVATE, fd(), 0);
+    if (addr == MAP_FAILED)
+    {
+        throw std::runtime_error("Failed to map the package " +
+                                 path.string());
+    }
+    pkg = static_cast<const uint8_t*>(addr);
+    pkgSize = sb.st_size;
+
+    try
+    {
+        parse();
+    }
+    catch (const std::exception&)
+    {
+        munmap(const_cast<uint8_t*>(pkg), pkgSize);
+        throw;
+    }
+}
+
+Package::~Package()
+{
+    munmap(const_cast<uint8_t*>(pkg), pkgSize);
+}
+
+void Package::parse()
+{
+    pldm_package_header_information headerInfo{};
+    variable_field versionStr{};
+    auto rc = decode_pldm_package_header_info(pkg, pkgSize, &headerInfo,
+                                              &versionStr);
+    if (rc)
+    {
+        throw std::runtime_error(
+            "Failed to decode the package header information, RC = " +
+            std::to_string(rc));
+    }
+
+    size_t headerSize = headerInfo.package_header_size;
+    if (headerSize > pkgSize ||
+        headerSize < sizeof(headerInfo) + versionStr.length + sizeof(uint8_t) +
+                         sizeof(uint16_t) + sizeof(uint32_t))
+    {
+        throw std::runtime_error("Invalid package header size " +
+                                 std::to_string(headerSize));
+    }
+
+    // PackageHeaderChecksum is the CRC32 of the rest of the package header
+    size_t headerEnd = headerSize - sizeof(uint32_t);
+    if (crc32(pkg, headerEnd) != readLE<uint32_t>(pkg + headerEnd))
+    {
+        throw std::runtime_error("Package header checksum mismatch");
+    }
+
+    packageVersion.assign(reinterpret_cast<const char*>(versionStr.ptr),
+                          versionStr.length);
+
+    size_t offset = sizeof(headerInfo) + versionStr.length;
+    uint8_t recordCount = pkg[offset];
+    offset += sizeof(recordCount);
+    fwDeviceIDRecords.reserve(recordCount);
+    for (uint8_t i = 0; i < recordCount; ++i)
+    {
+        offset += parseFwDeviceIDRecord(
+            offset, headerEnd, headerInfo.component_bitmap_bit_length);
+    }
+
+    if (offset + sizeof(uint16_t) > headerEnd)
+    {
+        throw std::runtime_error("Package header too short for the component "
+                                 "image information");
+    }
+    auto componentCount = readLE<uint16_t>(pkg + offset);
+    offset += sizeof(componentCount);
+    componentImageInfos.reserve(componentCount);
+    for (uint16_t i = 0; i < componentCount; ++i)
+    {
+        pldm_component_image_information info{};
+        variable_field compVersionStr{};
+        rc = decode_pldm_comp_image_info(pkg + offset, headerEnd - offset,
+                                         &info, &compVersionStr);
+        if (rc)
+        {
+            throw std::runtime_error(
+                "Failed to decode the component image information, RC = " +
+                std::to_string(rc));
+        }
+        if (static_cast<uint64_t>(info.comp_location_offset) + info.comp_size >
+            pkgSize)
+        {
+            throw std::runtime_error(
+                "Component image beyond the end of the package, index = " +
+                std::to_string(i));
+        }
+
+        componentImageInfos.emplace_back(ComponentImageInfo{
+            info.comp_classification, info.comp_identifier,
+            info.comp_comparison_stamp, info.comp_options,
+            info.requested_comp_activation_method, info.comp_location_offset,
+            info.comp_size, info.comp_version_string_type,
+            std::string(reinterpret_cast<const char*>(compVersionStr.ptr),
+                        compVersionStr.length)});
+        offset += sizeof(info) + compVersionStr.length;
+    }
+
+    if (offset != headerEnd)
+    {
+        throw std::runtime_error("Package header size mismatch");
+    }
+
+    for (const auto& record : fwDeviceIDRecords)
+    {
+        if (record.applicableComponents.empty() ||
+            record.applicableComponents.back() >= componentImageInfos.size())
+        {
+            throw std::runtime_error("Invalid ApplicableComponents in the "
+                                     "firmware device ID record");
+        }
+    }
+}
+
+size_t Package::parseFwDeviceIDRecord(size_t offset, size_t headerEnd,
+                                      uint16_t bitmapBitLength)
+{
+    pldm_firmware_device_id_record record{};
+    variable_field applicableComponents{};
+    variable_field compImageSetVersionStr{};
+    variable_field recordDescriptors{};
+    variable_field fwDevicePkgData{};
+
+    if (offset >= headerEnd)
+    {
+        throw std::runtime_error("Package header too short for the firmware "
+                                 "device ID records");
+    }
+    auto rc = decode_firmware_device_id_record(
+        pkg + offset, headerEnd - offset, bitmapBitLength, &record,
+        &applicableComponents, &compImageSetVersionStr, &recordDescriptors,
+        &fwDevicePkgData);
+    if (rc)
+    {
+        throw std::runtime_error(
+            "Failed to decode the firmware device ID record, RC = " +
+            std::to_string(rc));
+    }
+
+    FirmwareDeviceIDRecord entry{};
+    entry.deviceUpdateOptionFlags = record.device_update_option_flags;
+    entry.compImageSetVersionStrType =
+        record.comp_image_set_version_string_type;
+    entry.compImageSetVersion.assign(
+        reinterpret_cast<const char*>(compImageSetVersionStr.ptr),
+        compImageSetVersionStr.length);
+    if (fwDevicePkgData.length)
+    {
+        entry.fwDevicePkgData = {fwDevicePkgData.ptr, fwDevicePkgData.length};
+    }
+
+    for (size_t byte = 0; byte < applicableComponents.length; ++byte)
+    {
+        for (size_t bit = 0; bit < 8; ++bit)
+        {
+            if (applicableComponents.ptr[byte] & (1 << bit))
+            {
+                entry.applicableComponents.emplace_back(byte * 8 + bit);
+            }
+        }
+    }
+
+    auto descriptorPtr = recordDescriptors.ptr;
+    auto descriptorsLen = recordDescriptors.length;
+    for (uint8_t i = 0; i < record.descriptor_count; ++i)
+    {
+        uint16_t descriptorType = 0;
+        variable_field descriptorData{};
+        rc = decode_descriptor_type_length_value(
+            descriptorPtr, descriptorsLen, &descriptorType, &descriptorData);
+        if (rc)
+        {
+            throw std::runtime_error(
+                "Failed to decode the record descriptor, RC = " +
+                std::to_string(rc));
+        }
+        entry.descriptors.emplace(
+            descriptorType,
+            DescriptorData(descriptorData.ptr,
+                           descriptorData.ptr + descriptorData.length));
+
+        auto descriptorLen = sizeof(pldm_descriptor_tlv().descriptor_type) +
+                             sizeof(pldm_descriptor_tlv().descriptor_length) +
+                             descriptorData.length;
+        descriptorPtr += descriptorLen;
+        descriptorsLen -= descriptorLen;
+    }
+
+    fwDeviceIDRecords.emplace_back(std::move(entry));
+    return record.record_length;
+}
+
+std::span<const uint8_t> Package::getComponentImage(ComponentIndex index) const
+{
+    const auto& info = componentImageInfos.at(index);
+    return {pkg + info.offset, info.size};
+}
+
+std::optional<size_t> Package::matchDevice(const Descriptors& descriptors) const
+{
+    for (size_t index = 0; index < fwDeviceIDRecords.size(); ++index)
+    {
+        const auto& recordDescriptors = fwDeviceIDRecords[index].descriptors;
+        if (std::all_of(recordDescriptors.begin(), recordDescriptors.end(),
+                        [&descriptors](const auto& descriptor) {
+                            auto it = descriptors.find(descriptor.first);
+                            return it != descriptors.end() &&
+                                   it->second == descriptor.second;
+                        }))
+        {
+            return index;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace fw_update
+
+} // namespace pldm
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "libpldm/firmware_update.h"
+
+#include "common/types.hpp"
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+/** @struct FirmwareDeviceIDRecord
+ *
+ *  Firmware device ID record of the package, identifies the firmware devices
+ *  the record applies to and the component images to be sent to them.
+ */
+struct FirmwareDeviceIDRecord
+{
+    bitfield32_t deviceUpdateOptionFlags;
+    std::vector<ComponentIndex> applicableComponents;
+    uint8_t compImageSetVersionStrType;
+    std::string compImageSetVersion;
+    Descriptors descriptors;
+    std::span<const uint8_t> fwDevicePkgData;
+};
+
+/** @struct ComponentImageInfo
+ *
+ *  Component image information of the package, the image itself is the
+ *  [offset, offset + size) range of the package.
+ */
+struct ComponentImageInfo
+{
+    uint16_t classification;
+    uint16_t identifier;
+    uint32_t comparisonStamp;
+    bitfield16_t options;
+    bitfield16_t requestedActivationMethod;
+    uint32_t offset;
+    uint32_t size;
+    uint8_t versionStrType;
+    std::string version;
+};
+
+using FirmwareDeviceIDRecords = std::vector<FirmwareDeviceIDRecord>;
+using ComponentImageInfos = std::vector<ComponentImageInfo>;
+
+/** @class Package
+ *
+ *  @brief PLDM firmware update package, memory mapped read-only.
+ *
+ *  The package header is parsed once, when the package is opened, into the
+ *  firmware device ID records and the component image information. The
+ *  component images are never read into memory, they are handed out as
+ *  slices of the mapping.
+ */
+class Package
+{
+  public:
+    Package() = delete;
+    Package(const Package&) = delete;
+    Package& operator=(const Package&) = delete;
+    Package(Package&&) = delete;
+    Package& operator=(Package&&) = delete;
+    ~Package();
+
+    /** @brief Map and parse the firmware update package
+     *
+     *  @param[in] path - path of the PLDM firmware update package
+     *
+     *  @throw std::runtime_error if the package cannot be mapped or the
+     *         package header is invalid
+     */
+    explicit Package(const std::filesystem::path& path);
+
+    /** @brief Get the package version string */
+    const std::string& getPackageVersion() const
+    {
+        return packageVersion;
+    }
+
+    /** @brief Get the firmware device ID records of the package */
+    const FirmwareDeviceIDRecords& getFwDeviceIDRecords() const
+    {
+        return fwDeviceIDRecords;
+    }
+
+    /** @brief Get the component image information of the package */
+    const ComponentImageInfos& getComponentImageInfos() const
+    {
+        return componentImageInfos;
+    }
+
+    /** @brief Get the component image
+     *
+     *  @param[in] index - index of the component in the package
+     *
+     *  @return the component image, a view into the package mapping
+     */
+    std::span<const uint8_t> getComponentImage(ComponentIndex index) const;
+
+    /** @brief Find the firmware device ID record matching a firmware device
+     *
+     *  A record matches if every descriptor of the record is reported by the
+     *  firmware device with the same value.
+     *
+     *  @param[in] descriptors - descriptors reported by the firmware device
+     *
+     *  @return index of the first matching record, std::nullopt if none
+     */
+    std::optional<size_t> matchDevice(const Descriptors& descriptors) const;
+
+  private:
+    /** @brief Parse the package header of the mapped package
+     *
+     *  @throw std::runtime_error if the package header is invalid
+     */
+    void parse();
+
+    /** @brief Parse the firmware device ID record at offset
+     *
+     *  @param[in] offset - offset of the record in the package
+     *  @param[in] headerEnd - offset of the package header checksum
+     *  @param[in] bitmapBitLength - ComponentBitmapBitLength of the package
+     *
+     *  @return length of the record
+     */
+    size_t parseFwDeviceIDRecord(size_t offset, size_t headerEnd,
+                                 uint16_t bitmapBitLength);
+
+    const uint8_t* pkg = nullptr; //!< start of the mapping
+    size_t pkgSize = 0;           //!< size of the mapping
+    std::string packageVersion;
+    FirmwareDeviceIDRecords fwDeviceIDRecords;
+    ComponentImageInfos componentImageInfos;
+};
+
+} // namespace fw_update
+
+} // namespace pldm
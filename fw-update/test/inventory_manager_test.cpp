@@ -0,0 +1,130 @@
+#include "libpldm/base.h"
+#include "libpldm/firmware_update.h"
+
+#include "common/transport.hpp"
+#include "common/utils.hpp"
+#include "fw-update/inventory_manager.hpp"
+#include "package_builder.hpp"
+#include "pldmd/dbus_impl_requester.hpp"
+#include "requester/handler.hpp"
+
+#include <sys/socket.h>
+
+#include <sdeventplus/event.hpp>
+
+#include <array>
+#include <map>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::fw_update;
+using namespace pldm::fw_update::test;
+
+class InventoryManagerTest : public testing::Test
+{
+  protected:
+    InventoryManagerTest() :
+        event(sdeventplus::Event::get_default()),
+        dbusImplReq(pldm::utils::DBusHandler::getBus(),
+                    "/xyz/openbmc_project/pldm")
+    {
+        socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sockets.data());
+        transport = std::make_unique<pldm::transport::MctpDemux>(sockets[0]);
+    }
+
+    ~InventoryManagerTest()
+    {
+        close(sockets[1]);
+    }
+
+    /** @brief Answer the requests sent to the FDs, with the payloads keyed
+     *         by EID
+     */
+    void respond(pldm::requester::Handler<pldm::requester::Request>& handler,
+                 const std::map<mctp_eid_t, std::vector<uint8_t>>& payloads)
+    {
+        std::array<uint8_t, 4096> buffer{};
+        ssize_t length = 0;
+        while ((length = recv(sockets[1], buffer.data(), buffer.size(),
+                              MSG_DONTWAIT)) > 0)
+        {
+            // MCTP demux framing: EID and message type precede the message
+            mctp_eid_t eid = buffer[0];
+            auto request = reinterpret_cast<const pldm_msg*>(&buffer[2]);
+            ASSERT_EQ(request->hdr.type, PLDM_FWUP);
+            ASSERT_EQ(request->hdr.command, PLDM_QUERY_DEVICE_IDENTIFIERS);
+
+            const auto& payload = payloads.at(eid);
+            std::vector<uint8_t> response(sizeof(pldm_msg_hdr));
+            pldm_header_info header{};
+            header.msg_type = PLDM_RESPONSE;
+            header.instance = request->hdr.instance_id;
+            header.pldm_type = PLDM_FWUP;
+            header.command = PLDM_QUERY_DEVICE_IDENTIFIERS;
+            pack_pldm_header(&header,
+                             reinterpret_cast<pldm_msg_hdr*>(response.data()));
+            response.insert(response.end(), payload.begin(), payload.end());
+            handler.handleResponse(
+                eid, request->hdr.instance_id, PLDM_FWUP,
+                PLDM_QUERY_DEVICE_IDENTIFIERS,
+                reinterpret_cast<const pldm_msg*>(response.data()),
+                payload.size());
+        }
+    }
+
+    std::array<int, 2> sockets{};
+    std::unique_ptr<pldm::transport::MctpDemux> transport;
+    sdeventplus::Event event;
+    pldm::dbus_api::Requester dbusImplReq;
+};
+
+TEST_F(InventoryManagerTest, DiscoverAndRemove)
+{
+    const Descriptors deviceA{
+        {PLDM_FWUP_IANA_ENTERPRISE_ID, {0x0A, 0x0B, 0x0C, 0x0D}},
+        {PLDM_FWUP_UUID,
+         {0x16, 0x20, 0x23, 0xC9, 0x3E, 0xC5, 0x41, 0x15, 0x95, 0xF4, 0x48,
+          0x70, 0x1D, 0x49, 0xD6, 0x75}}};
+    const Descriptors deviceB{
+        {PLDM_FWUP_IANA_ENTERPRISE_ID, {0x01, 0x02, 0x03, 0x04}}};
+
+    pldm::requester::Handler<pldm::requester::Request> handler(
+        *transport, event, dbusImplReq, false);
+    InventoryManager inventory(dbusImplReq, handler);
+
+    inventory.discover({8, 9, 10});
+    respond(handler, {{8, buildDeviceIdentifiers(deviceA)},
+                      {9, buildDeviceIdentifiers(deviceB)},
+                      {10, {PLDM_ERROR_UNSUPPORTED_PLDM_CMD}}});
+
+    // The FD that does not support firmware update is left out
+    DeviceDescriptorMap expected{{8, deviceA}, {9, deviceB}};
+    EXPECT_EQ(inventory.getDescriptorMap(), expected);
+
+    // Rediscovered with new descriptors
+    inventory.discover({9});
+    respond(handler, {{9, buildDeviceIdentifiers(deviceA)}});
+    expected[9] = deviceA;
+    EXPECT_EQ(inventory.getDescriptorMap(), expected);
+
+    inventory.remove({8, 11});
+    expected.erase(8);
+    EXPECT_EQ(inventory.getDescriptorMap(), expected);
+}
+
+TEST_F(InventoryManagerTest, MalformedResponse)
+{
+    pldm::requester::Handler<pldm::requester::Request> handler(
+        *transport, event, dbusImplReq, false);
+    InventoryManager inventory(dbusImplReq, handler);
+
+    // The descriptor is shorter than its length says
+    auto payload = buildDeviceIdentifiers(
+        {{PLDM_FWUP_IANA_ENTERPRISE_ID, {0x0A, 0x0B, 0x0C, 0x0D}}});
+    payload[1 + sizeof(uint32_t) + 1 + sizeof(uint16_t)] = 8;
+
+    inventory.discover({8});
+    respond(handler, {{8, payload}});
+    EXPECT_TRUE(inventory.getDescriptorMap().empty());
+}
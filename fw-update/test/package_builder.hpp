@@ -0,0 +1,186 @@
+#pragma once
+
+#include "libpldm/firmware_update.h"
+#include "libpldm/utils.h"
+
+#include "common/types.hpp"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+namespace test
+{
+
+struct TestRecord
+{
+    Descriptors descriptors;
+    std::vector<ComponentIndex> applicableComponents;
+    std::string compImageSetVersion;
+};
+
+struct TestComponent
+{
+    uint16_t identifier;
+    std::string version;
+    std::vector<uint8_t> image;
+};
+
+/** @brief Build a PLDM firmware update package, header format version 1 */
+inline std::vector<uint8_t>
+    buildPackage(const std::vector<TestRecord>& records,
+                 const std::vector<TestComponent>& components,
+                 const std::string& packageVersion = "TestPackage")
+{
+    std::vector<uint8_t> pkg;
+    auto put8 = [&pkg](uint8_t value) { pkg.emplace_back(value); };
+    auto put16 = [&pkg](uint16_t value) {
+        pkg.emplace_back(value & 0xFF);
+        pkg.emplace_back(value >> 8);
+    };
+    auto put32 = [&pkg](uint32_t value) {
+        for (size_t i = 0; i < sizeof(value); ++i)
+        {
+            pkg.emplace_back((value >> (8 * i)) & 0xFF);
+        }
+    };
+    auto putStr = [&pkg](const std::string& str) {
+        pkg.insert(pkg.end(), str.begin(), str.end());
+    };
+
+    constexpr uint8_t uuid[PLDM_FWUP_UUID_LENGTH] = {
+        0xF0, 0x18, 0x87, 0x8C, 0xCB, 0x7D, 0x49, 0x43,
+        0x98, 0x00, 0xA0, 0x2F, 0x05, 0x9A, 0xCA, 0x02};
+    uint16_t bitmapBitLength =
+        (components.size() / PLDM_FWUP_COMPONENT_BITMAP_MULTIPLE + 1) *
+        PLDM_FWUP_COMPONENT_BITMAP_MULTIPLE;
+
+    pkg.insert(pkg.end(), std::begin(uuid), std::end(uuid));
+    put8(0x01);
+    auto headerSizeOffset = pkg.size();
+    put16(0);
+    pkg.insert(pkg.end(), PLDM_TIMESTAMP104_SIZE, 0);
+    put16(bitmapBitLength);
+    put8(PLDM_STR_TYPE_ASCII);
+    put8(packageVersion.size());
+    putStr(packageVersion);
+
+    put8(records.size());
+    for (const auto& record : records)
+    {
+        std::vector<uint8_t> bitmap(bitmapBitLength / 8, 0);
+        for (auto index : record.applicableComponents)
+        {
+            bitmap[index / 8] |= 1 << (index % 8);
+        }
+        size_t descriptorsLength = 0;
+        for (const auto& [type, data] : record.descriptors)
+        {
+            descriptorsLength += sizeof(uint16_t) * 2 + data.size();
+        }
+
+        put16(sizeof(pldm_firmware_device_id_record) + bitmap.size() +
+              record.compImageSetVersion.size() + descriptorsLength);
+        put8(record.descriptors.size());
+        put32(0);
+        put8(PLDM_STR_TYPE_ASCII);
+        put8(record.compImageSetVersion.size());
+        put16(0);
+        pkg.insert(pkg.end(), bitmap.begin(), bitmap.end());
+        putStr(record.compImageSetVersion);
+        for (const auto& [type, data] : record.descriptors)
+        {
+            put16(type);
+            put16(data.size());
+            pkg.insert(pkg.end(), data.begin(), data.end());
+        }
+    }
+
+    size_t headerSize = pkg.size() + sizeof(uint16_t) + sizeof(uint32_t);
+    for (const auto& component : components)
+    {
+        headerSize +=
+            sizeof(pldm_component_image_information) + component.version.size();
+    }
+
+    put16(components.size());
+    uint32_t imageOffset = headerSize;
+    for (const auto& component : components)
+    {
+        put16(PLDM_COMP_FIRMWARE_OR_BIOS);
+        put16(component.identifier);
+        put32(PLDM_FWUP_INVALID_COMPONENT_COMPARISON_TIMESTAMP);
+        put16(0);
+        put16(0);
+        put32(imageOffset);
+        put32(component.image.size());
+        put8(PLDM_STR_TYPE_ASCII);
+        put8(component.version.size());
+        putStr(component.version);
+        imageOffset += component.image.size();
+    }
+
+    pkg[headerSizeOffset] = headerSize & 0xFF;
+    pkg[headerSizeOffset + 1] = headerSize >> 8;
+    put32(crc32(pkg.data(), pkg.size()));
+
+    for (const auto& component : components)
+    {
+        pkg.insert(pkg.end(), component.image.begin(), component.image.end());
+    }
+    return pkg;
+}
+
+/** @brief Build the payload of a QueryDeviceIdentifiers response */
+inline std::vector<uint8_t>
+    buildDeviceIdentifiers(const Descriptors& descriptors)
+{
+    std::vector<uint8_t> tlvs;
+    for (const auto& [type, data] : descriptors)
+    {
+        tlvs.emplace_back(type & 0xFF);
+        tlvs.emplace_back(type >> 8);
+        tlvs.emplace_back(data.size() & 0xFF);
+        tlvs.emplace_back(data.size() >> 8);
+        tlvs.insert(tlvs.end(), data.begin(), data.end());
+    }
+
+    std::vector<uint8_t> payload{PLDM_SUCCESS};
+    for (size_t i = 0; i < sizeof(uint32_t); ++i)
+    {
+        payload.emplace_back((tlvs.size() >> (8 * i)) & 0xFF);
+    }
+    payload.emplace_back(descriptors.size());
+    payload.insert(payload.end(), tlvs.begin(), tlvs.end());
+    return payload;
+}
+
+/** @brief Write a package to a temporary file
+ *
+ *  @return path of the file, to be removed by the caller
+ */
+inline std::filesystem::path writePackage(const std::vector<uint8_t>& pkg)
+{
+    char tmpfile[] = "/tmp/pldm_fw_update_pkg.XXXXXX";
+    int fd = mkstemp(tmpfile);
+    close(fd);
+    std::ofstream stream(tmpfile, std::ios::binary);
+    stream.write(reinterpret_cast<const char*>(pkg.data()), pkg.size());
+    return tmpfile;
+}
+
+} // namespace test
+
+} // namespace fw_update
+
+} // namespace pldm
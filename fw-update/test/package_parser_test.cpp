@@ -0,0 +1,110 @@
+#include "libpldm/firmware_update.h"
+
+#include "fw-update/package_parser.hpp"
+#include "package_builder.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace pldm::fw_update;
+using namespace pldm::fw_update::test;
+
+namespace fs = std::filesystem;
+
+static const Descriptors ianaDescriptor{
+    {PLDM_FWUP_IANA_ENTERPRISE_ID, {0x0A, 0x0B, 0x0C, 0x0D}}};
+static const Descriptors pciDescriptors{
+    {PLDM_FWUP_PCI_VENDOR_ID, {0x14, 0x10}},
+    {PLDM_FWUP_IANA_ENTERPRISE_ID, {0x01, 0x02, 0x03, 0x04}}};
+
+TEST(Package, GoodPath)
+{
+    std::vector<TestComponent> components{
+        {0x000A, "CompA_v1", std::vector<uint8_t>(100, 0xAA)},
+        {0x000B, "CompB_v1", std::vector<uint8_t>(300, 0xBB)},
+        {0x000C, "CompC_v1", std::vector<uint8_t>(7, 0xCC)}};
+    std::vector<TestRecord> records{{ianaDescriptor, {0, 2}, "SetA_v1"},
+                                    {pciDescriptors, {1}, "SetB_v1"}};
+    auto path = writePackage(buildPackage(records, components, "Pkg_v1"));
+
+    Package package(path);
+    EXPECT_EQ(package.getPackageVersion(), "Pkg_v1");
+
+    const auto& parsedRecords = package.getFwDeviceIDRecords();
+    ASSERT_EQ(parsedRecords.size(), 2);
+    EXPECT_EQ(parsedRecords[0].compImageSetVersion, "SetA_v1");
+    EXPECT_EQ(parsedRecords[0].applicableComponents,
+              std::vector<ComponentIndex>({0, 2}));
+    EXPECT_EQ(parsedRecords[0].descriptors, ianaDescriptor);
+    EXPECT_EQ(parsedRecords[1].compImageSetVersion, "SetB_v1");
+    EXPECT_EQ(parsedRecords[1].applicableComponents,
+              std::vector<ComponentIndex>({1}));
+    EXPECT_EQ(parsedRecords[1].descriptors, pciDescriptors);
+
+    const auto& infos = package.getComponentImageInfos();
+    ASSERT_EQ(infos.size(), components.size());
+    for (size_t i = 0; i < components.size(); ++i)
+    {
+        EXPECT_EQ(infos[i].identifier, components[i].identifier);
+        EXPECT_EQ(infos[i].version, components[i].version);
+        EXPECT_EQ(infos[i].size, components[i].image.size());
+        auto image = package.getComponentImage(i);
+        EXPECT_EQ(std::vector<uint8_t>(image.begin(), image.end()),
+                  components[i].image);
+    }
+
+    fs::remove(path);
+}
+
+TEST(Package, MatchDevice)
+{
+    std::vector<TestComponent> components{
+        {0x000A, "CompA_v1", std::vector<uint8_t>(16, 0xAA)}};
+    std::vector<TestRecord> records{{ianaDescriptor, {0}, "SetA_v1"},
+                                    {pciDescriptors, {0}, "SetB_v1"}};
+    auto path = writePackage(buildPackage(records, components));
+    Package package(path);
+
+    EXPECT_EQ(package.matchDevice(ianaDescriptor), 0);
+    // The device may report more descriptors than the record has
+    Descriptors device{pciDescriptors};
+    device.emplace(PLDM_FWUP_UUID, DescriptorData(16, 0x01));
+    EXPECT_EQ(package.matchDevice(device), 1);
+
+    Descriptors otherVendor{
+        {PLDM_FWUP_IANA_ENTERPRISE_ID, {0x0A, 0x0B, 0x0C, 0x0E}}};
+    EXPECT_EQ(package.matchDevice(otherVendor), std::nullopt);
+    EXPECT_EQ(package.matchDevice({}), std::nullopt);
+
+    fs::remove(path);
+}
+
+TEST(Package, BadPath)
+{
+    std::vector<TestComponent> components{
+        {0x000A, "CompA_v1", std::vector<uint8_t>(16, 0xAA)}};
+    std::vector<TestRecord> records{{ianaDescriptor, {0}, "SetA_v1"}};
+    auto pkg = buildPackage(records, components);
+
+    EXPECT_THROW(Package("/tmp/pldm_fw_update_no_such_pkg"),
+                 std::runtime_error);
+
+    // Corrupted package header
+    auto corrupted = pkg;
+    corrupted[sizeof(pldm_package_header_information) + 2] ^= 0xFF;
+    auto path = writePackage(corrupted);
+    EXPECT_THROW(Package{path}, std::runtime_error);
+    fs::remove(path);
+
+    // Component image truncated
+    auto truncated = pkg;
+    truncated.resize(pkg.size() - 1);
+    path = writePackage(truncated);
+    EXPECT_THROW(Package{path}, std::runtime_error);
+    fs::remove(path);
+
+    // Record applicable to a component not in the package
+    records[0].applicableComponents = {1};
+    path = writePackage(buildPackage(records, components));
+    EXPECT_THROW(Package{path}, std::runtime_error);
+    fs::remove(path);
+}
@@ -0,0 +1,576 @@
+#include "libpldm/base.h"
+#include "libpldm/firmware_update.h"
+
+#include "common/transport.hpp"
+#include "common/utils.hpp"
+#include "fw-update/inventory_manager.hpp"
+#include "fw-update/update_manager.hpp"
+#include "fw-update/watch.hpp"
+#include "package_builder.hpp"
+#include "pldmd/dbus_impl_requester.hpp"
+#include "requester/handler.hpp"
+
+#include <endian.h>
+#include <sys/socket.h>
+
+#include <sdeventplus/event.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <optional>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::fw_update;
+using namespace pldm::fw_update::test;
+using namespace std::chrono;
+
+namespace fs = std::filesystem;
+
+/** @brief Build a PLDM firmware update message */
+static std::vector<uint8_t> makeMsg(MessageType msgType, uint8_t instanceId,
+                                    uint8_t command,
+                                    const std::vector<uint8_t>& payload)
+{
+    std::vector<uint8_t> msg(sizeof(pldm_msg_hdr));
+    pldm_header_info header{};
+    header.msg_type = msgType;
+    header.instance = instanceId;
+    header.pldm_type = PLDM_FWUP;
+    header.command = command;
+    pack_pldm_header(&header, reinterpret_cast<pldm_msg_hdr*>(msg.data()));
+    msg.insert(msg.end(), payload.begin(), payload.end());
+    return msg;
+}
+
+/** @class EmulatedFirmwareDevice
+ *
+ *  In-process firmware device (FD), answers the update agent's requests and
+ *  pulls the component images with RequestFirmwareData, transferSize bytes at
+ *  a time.
+ */
+class EmulatedFirmwareDevice
+{
+  public:
+    explicit EmulatedFirmwareDevice(uint32_t transferSize,
+                                    const Descriptors& descriptors = {}) :
+        transferSize(transferSize),
+        descriptors(descriptors)
+    {}
+
+    std::vector<uint8_t> handleRequest(const pldm_msg* request,
+                                       size_t /*payloadLength*/)
+    {
+        auto instanceId = request->hdr.instance_id;
+        auto command = request->hdr.command;
+        switch (command)
+        {
+            case PLDM_QUERY_DEVICE_IDENTIFIERS:
+                return makeMsg(PLDM_RESPONSE, instanceId, command,
+                               buildDeviceIdentifiers(descriptors));
+            case PLDM_REQUEST_UPDATE:
+            {
+                auto req = reinterpret_cast<const pldm_request_update_req*>(
+                    request->payload);
+                transferSize =
+                    std::min(transferSize, le32toh(req->max_transfer_size));
+                return makeMsg(PLDM_RESPONSE, instanceId, command,
+                               {PLDM_SUCCESS, 0, 0, 0});
+            }
+            case PLDM_PASS_COMPONENT_TABLE:
+                ++componentsPassed;
+                return makeMsg(PLDM_RESPONSE, instanceId, command,
+                               {PLDM_SUCCESS, PLDM_CR_COMP_CAN_BE_UPDATED, 0});
+            case PLDM_UPDATE_COMPONENT:
+            {
+                auto req = reinterpret_cast<const pldm_update_component_req*>(
+                    request->payload);
+                imageSize = le32toh(req->comp_image_size);
+                images.emplace_back();
+                images.back().reserve(imageSize);
+                state = PLDM_FD_STATE_DOWNLOAD;
+                return makeMsg(PLDM_RESPONSE, instanceId, command,
+                               {PLDM_SUCCESS, PLDM_CCR_COMP_CAN_BE_UPDATED, 0,
+                                0, 0, 0, 0, 0, 0});
+            }
+            case PLDM_ACTIVATE_FIRMWARE:
+                activated = true;
+                return makeMsg(PLDM_RESPONSE, instanceId, command,
+                               {PLDM_SUCCESS, 0, 0});
+            case PLDM_CANCEL_UPDATE:
+                cancelled = true;
+                state = PLDM_FD_STATE_IDLE;
+                return makeMsg(PLDM_RESPONSE, instanceId, command,
+                               {PLDM_SUCCESS, 0, 0, 0, 0, 0, 0, 0, 0, 0});
+            default:
+                return makeMsg(PLDM_RESPONSE, instanceId, command,
+                               {PLDM_ERROR_UNSUPPORTED_PLDM_CMD});
+        }
+    }
+
+    /** @brief Next request of the FD, if it is not waiting for a response */
+    std::optional<std::vector<uint8_t>> nextRequest()
+    {
+        if (waitingResponse)
+        {
+            return std::nullopt;
+        }
+
+        switch (state)
+        {
+            case PLDM_FD_STATE_DOWNLOAD:
+                if (images.back().size() < imageSize)
+                {
+                    uint32_t offset = images.back().size();
+                    uint32_t length = std::max<uint32_t>(
+                        PLDM_FWUP_BASELINE_TRANSFER_SIZE,
+                        std::min(transferSize, imageSize - offset));
+                    pldm_request_firmware_data_req req{htole32(offset),
+                                                       htole32(length)};
+                    auto ptr = reinterpret_cast<const uint8_t*>(&req);
+                    return sendRequest(
+                        PLDM_REQUEST_FIRMWARE_DATA,
+                        std::vector<uint8_t>(ptr, ptr + sizeof(req)));
+                }
+                return sendRequest(PLDM_TRANSFER_COMPLETE,
+                                   {PLDM_FWUP_TRANSFER_SUCCESS});
+            case PLDM_FD_STATE_VERIFY:
+                return sendRequest(PLDM_VERIFY_COMPLETE,
+                                   {PLDM_FWUP_VERIFY_SUCCESS});
+            case PLDM_FD_STATE_APPLY:
+                return sendRequest(PLDM_APPLY_COMPLETE,
+                                   {PLDM_FWUP_APPLY_SUCCESS, 0, 0});
+            default:
+                return std::nullopt;
+        }
+    }
+
+    void handleResponse(const pldm_msg* response, size_t payloadLength)
+    {
+        waitingResponse = false;
+        ASSERT_GE(payloadLength, 1);
+        ASSERT_EQ(response->payload[0], PLDM_SUCCESS);
+        switch (response->hdr.command)
+        {
+            case PLDM_REQUEST_FIRMWARE_DATA:
+            {
+                auto& image = images.back();
+                auto length = std::min<size_t>(payloadLength - 1,
+                                               imageSize - image.size());
+                image.insert(image.end(), response->payload + 1,
+                             response->payload + 1 + length);
+                ++dataRequests;
+                break;
+            }
+            case PLDM_TRANSFER_COMPLETE:
+                state = PLDM_FD_STATE_VERIFY;
+                break;
+            case PLDM_VERIFY_COMPLETE:
+                state = PLDM_FD_STATE_APPLY;
+                break;
+            case PLDM_APPLY_COMPLETE:
+                state = PLDM_FD_STATE_READY_XFER;
+                break;
+        }
+    }
+
+    uint32_t transferSize;
+    Descriptors descriptors;
+    uint8_t state = PLDM_FD_STATE_IDLE;
+    uint32_t imageSize = 0;
+    std::vector<std::vector<uint8_t>> images;
+    size_t componentsPassed = 0;
+    size_t dataRequests = 0;
+    bool activated = false;
+    bool cancelled = false;
+
+  private:
+    std::vector<uint8_t> sendRequest(uint8_t command,
+                                     const std::vector<uint8_t>& payload)
+    {
+        waitingResponse = true;
+        instanceId = (instanceId + 1) % 32;
+        return makeMsg(PLDM_REQUEST, instanceId, command, payload);
+    }
+
+    bool waitingResponse = false;
+    uint8_t instanceId = 0;
+};
+
+class UpdateManagerTest : public testing::Test
+{
+  protected:
+    UpdateManagerTest() :
+        event(sdeventplus::Event::get_default()),
+        dbusImplReq(pldm::utils::DBusHandler::getBus(),
+                    "/xyz/openbmc_project/pldm")
+    {
+        socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sockets.data());
+        transport = std::make_unique<pldm::transport::MctpDemux>(sockets[0]);
+    }
+
+    ~UpdateManagerTest()
+    {
+        close(sockets[1]);
+    }
+
+    /** @brief Deliver the requests the update agent sent to the FDs */
+    void deliverUARequests(
+        pldm::requester::Handler<pldm::requester::Request>& handler,
+        std::map<mctp_eid_t, EmulatedFirmwareDevice>& devices)
+    {
+        std::array<uint8_t, 4096> buffer{};
+        ssize_t length = 0;
+        while ((length = recv(sockets[1], buffer.data(), buffer.size(),
+                              MSG_DONTWAIT)) > 0)
+        {
+            // MCTP demux framing: EID and message type precede the message
+            mctp_eid_t eid = buffer[0];
+            auto request = reinterpret_cast<const pldm_msg*>(&buffer[2]);
+            auto response = devices.at(eid).handleRequest(
+                request, length - 2 - sizeof(pldm_msg_hdr));
+            handler.handleResponse(
+                eid, request->hdr.instance_id, PLDM_FWUP, request->hdr.command,
+                reinterpret_cast<const pldm_msg*>(response.data()),
+                response.size() - sizeof(pldm_msg_hdr));
+        }
+    }
+
+    /** @brief Run the updates to the end, the FDs taking turns */
+    void runUpdate(UpdateManager& manager,
+                   pldm::requester::Handler<pldm::requester::Request>& handler,
+                   std::map<mctp_eid_t, EmulatedFirmwareDevice>& devices)
+    {
+        for (size_t rounds = 0; manager.updateInProgress(); ++rounds)
+        {
+            ASSERT_LT(rounds, 10000000) << "firmware update stalled";
+            deliverUARequests(handler, devices);
+            for (auto& [eid, device] : devices)
+            {
+                auto request = device.nextRequest();
+                if (!request)
+                {
+                    continue;
+                }
+                auto requestMsg =
+                    reinterpret_cast<const pldm_msg*>(request->data());
+                auto response = manager.handleRequest(
+                    eid, requestMsg->hdr.command, requestMsg,
+                    request->size() - sizeof(pldm_msg_hdr));
+                device.handleResponse(
+                    reinterpret_cast<const pldm_msg*>(response.data()),
+                    response.size() - sizeof(pldm_msg_hdr));
+            }
+            // Dispatch the requests deferred by the update agent
+            sd_event_run(event.get(), 0);
+        }
+    }
+
+    std::array<int, 2> sockets{};
+    std::unique_ptr<pldm::transport::MctpDemux> transport;
+    sdeventplus::Event event;
+    pldm::dbus_api::Requester dbusImplReq;
+};
+
+static std::vector<uint8_t> makeImage(size_t size, uint8_t seed)
+{
+    std::vector<uint8_t> image(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        image[i] = static_cast<uint8_t>(seed + i * 7);
+    }
+    return image;
+}
+
+static const Descriptors deviceA{
+    {PLDM_FWUP_IANA_ENTERPRISE_ID, {0x0A, 0x0B, 0x0C, 0x0D}}};
+static const Descriptors deviceB{
+    {PLDM_FWUP_IANA_ENTERPRISE_ID, {0x01, 0x02, 0x03, 0x04}}};
+static const Descriptors deviceUnknown{
+    {PLDM_FWUP_IANA_ENTERPRISE_ID, {0x0F, 0x0F, 0x0F, 0x0F}}};
+
+TEST_F(UpdateManagerTest, ConcurrentUpdates)
+{
+    std::vector<TestComponent> components{
+        {0x000A, "CompA_v1", makeImage(10000, 1)},
+        {0x000B, "CompB_v1", makeImage(4099, 2)},
+        {0x000C, "CompC_v1", makeImage(5, 3)}};
+    std::vector<TestRecord> records{{deviceA, {0, 2}, "SetA_v1"},
+                                    {deviceB, {1}, "SetB_v1"}};
+    auto path = writePackage(buildPackage(records, components));
+
+    pldm::requester::Handler<pldm::requester::Request> handler(
+        *transport, event, dbusImplReq, false);
+    UpdateManager manager(event, dbusImplReq, handler, 1024);
+
+    std::map<mctp_eid_t, EmulatedFirmwareDevice> devices;
+    devices.emplace(8, EmulatedFirmwareDevice(256));
+    devices.emplace(9, EmulatedFirmwareDevice(4096));
+    devices.emplace(10, EmulatedFirmwareDevice(64));
+    devices.emplace(11, EmulatedFirmwareDevice(64));
+
+    EXPECT_EQ(manager.processPackage(path, {{8, deviceA},
+                                            {9, deviceA},
+                                            {10, deviceB},
+                                            {11, deviceUnknown}}),
+              3);
+    EXPECT_EQ(manager.processPackage(path, {{8, deviceA}}), -1);
+    runUpdate(manager, handler, devices);
+
+    for (mctp_eid_t eid : {8, 9})
+    {
+        const auto& device = devices.at(eid);
+        EXPECT_TRUE(manager.getUpdateStatus(eid));
+        EXPECT_TRUE(device.activated);
+        EXPECT_EQ(device.componentsPassed, 2);
+        ASSERT_EQ(device.images.size(), 2);
+        EXPECT_EQ(device.images[0], components[0].image);
+        EXPECT_EQ(device.images[1], components[2].image);
+    }
+    // The transfer size is capped by the maximum transfer size of the UA
+    EXPECT_EQ(devices.at(9).transferSize, 1024);
+
+    EXPECT_TRUE(manager.getUpdateStatus(10));
+    EXPECT_TRUE(devices.at(10).activated);
+    ASSERT_EQ(devices.at(10).images.size(), 1);
+    EXPECT_EQ(devices.at(10).images[0], components[1].image);
+
+    EXPECT_FALSE(manager.getUpdateStatus(11));
+    EXPECT_EQ(devices.at(11).state, PLDM_FD_STATE_IDLE);
+    EXPECT_TRUE(devices.at(11).images.empty());
+
+    fs::remove(path);
+}
+
+TEST_F(UpdateManagerTest, RequestFirmwareDataBounds)
+{
+    constexpr uint32_t imageSize = 100;
+    std::vector<TestComponent> components{
+        {0x000A, "CompA_v1", makeImage(imageSize, 1)}};
+    std::vector<TestRecord> records{{deviceA, {0}, "SetA_v1"}};
+    auto path = writePackage(buildPackage(records, components));
+
+    pldm::requester::Handler<pldm::requester::Request> handler(
+        *transport, event, dbusImplReq, false);
+    UpdateManager manager(event, dbusImplReq, handler, 64);
+    std::map<mctp_eid_t, EmulatedFirmwareDevice> devices;
+    devices.emplace(8, EmulatedFirmwareDevice(64));
+
+    auto requestFwData = [&manager](mctp_eid_t eid, uint32_t offset,
+                                    uint32_t length) {
+        pldm_request_firmware_data_req req{htole32(offset), htole32(length)};
+        auto ptr = reinterpret_cast<const uint8_t*>(&req);
+        auto request = makeMsg(PLDM_REQUEST, 1, PLDM_REQUEST_FIRMWARE_DATA,
+                               std::vector<uint8_t>(ptr, ptr + sizeof(req)));
+        return manager.handleRequest(
+            eid, PLDM_REQUEST_FIRMWARE_DATA,
+            reinterpret_cast<const pldm_msg*>(request.data()), sizeof(req));
+    };
+    auto completionCode = [](const std::vector<uint8_t>& response) {
+        return response[sizeof(pldm_msg_hdr)];
+    };
+
+    // Not updating this EID
+    EXPECT_EQ(completionCode(requestFwData(9, 0, 32)),
+              PLDM_FWUP_COMMAND_NOT_EXPECTED);
+
+    ASSERT_EQ(manager.processPackage(path, {{8, deviceA}}), 1);
+    // No UpdateComponent yet
+    EXPECT_EQ(completionCode(requestFwData(8, 0, 32)),
+              PLDM_FWUP_COMMAND_NOT_EXPECTED);
+
+    while (devices.at(8).state != PLDM_FD_STATE_DOWNLOAD)
+    {
+        deliverUARequests(handler, devices);
+    }
+
+    EXPECT_EQ(completionCode(requestFwData(8, 0, 31)),
+              PLDM_FWUP_INVALID_TRANSFER_LENGTH);
+    EXPECT_EQ(completionCode(requestFwData(8, 0, 65)),
+              PLDM_FWUP_INVALID_TRANSFER_LENGTH);
+    EXPECT_EQ(completionCode(requestFwData(8, imageSize - 31, 64)),
+              PLDM_FWUP_DATA_OUT_OF_RANGE);
+
+    // The portion beyond the end of the image is zero padded
+    auto response = requestFwData(8, imageSize - 10, 32);
+    ASSERT_EQ(response.size(), sizeof(pldm_msg_hdr) + 1 + 32);
+    EXPECT_EQ(completionCode(response), PLDM_SUCCESS);
+    auto data = response.begin() + sizeof(pldm_msg_hdr) + 1;
+    EXPECT_TRUE(std::equal(data, data + 10, components[0].image.end() - 10));
+    EXPECT_TRUE(std::all_of(data + 10, response.end(),
+                            [](uint8_t byte) { return byte == 0; }));
+
+    runUpdate(manager, handler, devices);
+    EXPECT_TRUE(manager.getUpdateStatus(8));
+    EXPECT_EQ(devices.at(8).images[0], components[0].image);
+
+    fs::remove(path);
+}
+
+TEST_F(UpdateManagerTest, PackageWrittenToTheWatchedDirectory)
+{
+    std::vector<TestComponent> components{
+        {0x000A, "CompA_v1", makeImage(3000, 1)}};
+    std::vector<TestRecord> records{{deviceA, {0}, "SetA_v1"}};
+    auto pkg = buildPackage(records, components);
+
+    pldm::requester::Handler<pldm::requester::Request> handler(
+        *transport, event, dbusImplReq, false);
+    InventoryManager inventory(dbusImplReq, handler);
+    UpdateManager manager(event, dbusImplReq, handler, 1024);
+
+    std::map<mctp_eid_t, EmulatedFirmwareDevice> devices;
+    devices.emplace(8, EmulatedFirmwareDevice(256, deviceA));
+    devices.emplace(9, EmulatedFirmwareDevice(256, deviceB));
+
+    // The descriptors the package is matched against are the ones the FDs
+    // report
+    inventory.discover({8, 9});
+    deliverUARequests(handler, devices);
+    ASSERT_EQ(inventory.getDescriptorMap(),
+              (DeviceDescriptorMap{{8, deviceA}, {9, deviceB}}));
+
+    auto dir = fs::temp_directory_path() / "pldm_fw_update_watch_test";
+    fs::remove_all(dir);
+    Watch watch(event, dir, [&](const fs::path& path) {
+        manager.processPackage(path, inventory.getDescriptorMap());
+    });
+    ASSERT_TRUE(fs::is_directory(dir));
+
+    std::ofstream(dir / "package", std::ios::binary)
+        .write(reinterpret_cast<const char*>(pkg.data()), pkg.size());
+    for (size_t i = 0; i < 100 && !manager.updateInProgress(); ++i)
+    {
+        sd_event_run(event.get(), 10000);
+    }
+    ASSERT_TRUE(manager.updateInProgress());
+    runUpdate(manager, handler, devices);
+
+    EXPECT_TRUE(manager.getUpdateStatus(8));
+    EXPECT_TRUE(devices.at(8).activated);
+    ASSERT_EQ(devices.at(8).images.size(), 1);
+    EXPECT_EQ(devices.at(8).images[0], components[0].image);
+    EXPECT_FALSE(devices.at(9).activated);
+    EXPECT_TRUE(devices.at(9).images.empty());
+
+    fs::remove_all(dir);
+}
+
+TEST_F(UpdateManagerTest, FirmwareDeviceTimeout)
+{
+    constexpr auto fdTimeout = milliseconds(200);
+    std::vector<TestComponent> components{
+        {0x000A, "CompA_v1", makeImage(1000, 1)}};
+    std::vector<TestRecord> records{{deviceA, {0}, "SetA_v1"}};
+    auto path = writePackage(buildPackage(records, components));
+
+    pldm::requester::Handler<pldm::requester::Request> handler(
+        *transport, event, dbusImplReq, false);
+    UpdateManager manager(event, dbusImplReq, handler, 64, fdTimeout);
+    std::map<mctp_eid_t, EmulatedFirmwareDevice> devices;
+    devices.emplace(8, EmulatedFirmwareDevice(64));
+
+    ASSERT_EQ(manager.processPackage(path, {{8, deviceA}}), 1);
+    while (devices.at(8).state != PLDM_FD_STATE_DOWNLOAD)
+    {
+        deliverUARequests(handler, devices);
+    }
+
+    auto sendFdRequest = [&manager, &devices]() {
+        auto& device = devices.at(8);
+        auto request = device.nextRequest();
+        ASSERT_TRUE(request);
+        auto requestMsg = reinterpret_cast<const pldm_msg*>(request->data());
+        auto response =
+            manager.handleRequest(8, requestMsg->hdr.command, requestMsg,
+                                  request->size() - sizeof(pldm_msg_hdr));
+        device.handleResponse(
+            reinterpret_cast<const pldm_msg*>(response.data()),
+            response.size() - sizeof(pldm_msg_hdr));
+    };
+    auto runFor = [this](milliseconds duration) {
+        auto end = steady_clock::now() + duration;
+        while (steady_clock::now() < end)
+        {
+            sd_event_run(event.get(), 10000);
+        }
+    };
+
+    // Each request of the FD gives it another timeout
+    for (size_t i = 0; i < 4; ++i)
+    {
+        runFor(fdTimeout / 2);
+        sendFdRequest();
+    }
+    EXPECT_TRUE(manager.updateInProgress());
+    EXPECT_FALSE(devices.at(8).cancelled);
+
+    // The FD goes quiet, the UA cancels the update
+    runFor(fdTimeout * 2);
+    deliverUARequests(handler, devices);
+    EXPECT_FALSE(manager.updateInProgress());
+    EXPECT_FALSE(manager.getUpdateStatus(8));
+    EXPECT_TRUE(devices.at(8).cancelled);
+
+    // The FD requests that come late are not expected
+    auto request = makeMsg(PLDM_REQUEST, 1, PLDM_TRANSFER_COMPLETE,
+                           {PLDM_FWUP_TRANSFER_SUCCESS});
+    auto response = manager.handleRequest(
+        8, PLDM_TRANSFER_COMPLETE,
+        reinterpret_cast<const pldm_msg*>(request.data()), 1);
+    EXPECT_EQ(response[sizeof(pldm_msg_hdr)], PLDM_FWUP_COMMAND_NOT_EXPECTED);
+
+    // The next package is taken
+    devices.clear();
+    devices.emplace(8, EmulatedFirmwareDevice(64));
+    ASSERT_EQ(manager.processPackage(path, {{8, deviceA}}), 1);
+    runUpdate(manager, handler, devices);
+    EXPECT_TRUE(manager.getUpdateStatus(8));
+    EXPECT_EQ(devices.at(8).images[0], components[0].image);
+
+    fs::remove(path);
+}
+
+TEST_F(UpdateManagerTest, RequestsByTransferSize)
+{
+    constexpr size_t imageSize = 1024 * 1024;
+    constexpr size_t numDevices = 4;
+    std::vector<TestComponent> components{
+        {0x000A, "CompA_v1", makeImage(imageSize, 1)}};
+    std::vector<TestRecord> records{{deviceA, {0}, "SetA_v1"}};
+    auto path = writePackage(buildPackage(records, components));
+
+    for (uint32_t transferSize = PLDM_FWUP_BASELINE_TRANSFER_SIZE;
+         transferSize <= 4096; transferSize *= 2)
+    {
+        pldm::requester::Handler<pldm::requester::Request> handler(
+            *transport, event, dbusImplReq, false);
+        UpdateManager manager(event, dbusImplReq, handler, transferSize);
+        std::map<mctp_eid_t, EmulatedFirmwareDevice> devices;
+        DeviceDescriptorMap descriptors;
+        for (mctp_eid_t eid = 8; eid < 8 + numDevices; ++eid)
+        {
+            devices.emplace(eid, EmulatedFirmwareDevice(transferSize));
+            descriptors.emplace(eid, deviceA);
+        }
+
+        ASSERT_EQ(manager.processPackage(path, descriptors), numDevices);
+        runUpdate(manager, handler, devices);
+
+        size_t requests = 0;
+        for (const auto& [eid, device] : devices)
+        {
+            EXPECT_TRUE(manager.getUpdateStatus(eid));
+            ASSERT_EQ(device.images.size(), 1);
+            EXPECT_EQ(device.images[0], components[0].image);
+            requests += device.dataRequests;
+        }
+        EXPECT_EQ(requests,
+                  numDevices * ((imageSize + transferSize - 1) / transferSize));
+    }
+
+    fs::remove(path);
+}
@@ -0,0 +1,102 @@
+#include "update_manager.hpp"
+
+#include "pldmd/handler.hpp"
+
+#include <chrono>
+#include <iostream>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+int UpdateManager::processPackage(const std::filesystem::path& packageFilePath,
+                                  const DeviceDescriptorMap& devices)
+{
+    if (updateInProgress())
+    {
+        std::cerr << "Firmware update already in progress, PACKAGE="
+                  << packageFilePath << "\n";
+        return -1;
+    }
+
+    deviceUpdaterMap.clear();
+    updateStatus.clear();
+    completedUpdates = 0;
+    package.reset();
+
+    try
+    {
+        package = std::make_unique<Package>(packageFilePath);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Failed to parse the firmware update package, PACKAGE="
+                  << packageFilePath << ", ERROR=" << e.what() << "\n";
+        return -1;
+    }
+
+    for (const auto& [eid, descriptors] : devices)
+    {
+        auto recordIndex = package->matchDevice(descriptors);
+        if (!recordIndex)
+        {
+            continue;
+        }
+        deviceUpdaterMap.emplace(
+            eid, std::make_unique<DeviceUpdater>(
+                     eid, event, *package,
+                     package->getFwDeviceIDRecords()[*recordIndex],
+                     maxTransferSize, fdTimeout, requester, handler,
+                     std::bind_front(&UpdateManager::updateDeviceCompletion,
+                                     this)));
+    }
+
+    if (deviceUpdaterMap.empty())
+    {
+        std::cerr << "No firmware device matches the package, PACKAGE="
+                  << packageFilePath << "\n";
+        return 0;
+    }
+
+    for (auto& [eid, deviceUpdater] : deviceUpdaterMap)
+    {
+        deviceUpdater->startFwUpdateFlow();
+    }
+
+    return deviceUpdaterMap.size();
+}
+
+Response UpdateManager::handleRequest(mctp_eid_t eid, uint8_t command,
+                                      const pldm_msg* request,
+                                      size_t reqMsgLen)
+{
+    auto it = deviceUpdaterMap.find(eid);
+    if (it == deviceUpdaterMap.end())
+    {
+        return pldm::responder::CmdHandler::ccOnlyResponse(
+            request, PLDM_FWUP_COMMAND_NOT_EXPECTED);
+    }
+    return it->second->handleRequest(command, request, reqMsgLen);
+}
+
+void UpdateManager::updateDeviceCompletion(mctp_eid_t eid, bool status)
+{
+    // The DeviceUpdater is still on the call stack, it is only released when
+    // the next package is processed.
+    updateStatus[eid] = status;
+    ++completedUpdates;
+
+    const auto& deviceUpdater = deviceUpdaterMap.at(eid);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deviceUpdater->getElapsedTime());
+    std::cerr << "Firmware update " << (status ? "completed" : "failed")
+              << ", EID=" << unsigned(eid)
+              << ", BYTES=" << deviceUpdater->getBytesTransferred()
+              << ", TIME_MS=" << elapsed.count() << "\n";
+}
+
+} // namespace fw_update
+
+} // namespace pldm
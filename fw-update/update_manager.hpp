@@ -0,0 +1,131 @@
+#pragma once
+
+#include "config.h"
+
+#include "libpldm/base.h"
+
+#include "common/types.hpp"
+#include "device_updater.hpp"
+#include "package_parser.hpp"
+#include "pldmd/dbus_impl_requester.hpp"
+#include "requester/handler.hpp"
+
+#include <sdeventplus/event.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <memory>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+/** @class UpdateManager
+ *
+ *  @brief PLDM firmware update agent (UA).
+ *
+ *  Opens a firmware update package and updates every firmware device (FD)
+ *  matched by one of its firmware device ID records. The FDs are updated in
+ *  parallel, each one by its own DeviceUpdater, and all of them pull their
+ *  component images from the single mapping of the package.
+ */
+class UpdateManager
+{
+  public:
+    UpdateManager() = delete;
+    UpdateManager(const UpdateManager&) = delete;
+    UpdateManager& operator=(const UpdateManager&) = delete;
+    UpdateManager(UpdateManager&&) = delete;
+    UpdateManager& operator=(UpdateManager&&) = delete;
+    ~UpdateManager() = default;
+
+    /** @brief Constructor
+     *
+     *  @param[in] event - reference to PLDM daemon's main event loop
+     *  @param[in] requester - reference to Requester object
+     *  @param[in] handler - PLDM request handler
+     *  @param[in] maxTransferSize - maximum size of the image portion a FD
+     *                               can request with RequestFirmwareData
+     *  @param[in] fdTimeout - time a FD has to send its next request, once
+     *                         it drives the component update
+     */
+    explicit UpdateManager(
+        sdeventplus::Event& event, pldm::dbus_api::Requester& requester,
+        pldm::requester::Handler<pldm::requester::Request>& handler,
+        uint32_t maxTransferSize,
+        std::chrono::milliseconds fdTimeout =
+            std::chrono::seconds(FW_UPDATE_FD_TIMEOUT)) :
+        event(event),
+        requester(requester), handler(handler),
+        maxTransferSize(maxTransferSize), fdTimeout(fdTimeout)
+    {}
+
+    /** @brief Start the update of the firmware devices with a package
+     *
+     *  @param[in] packageFilePath - path of the firmware update package
+     *  @param[in] devices - descriptors of the firmware devices, as reported
+     *                       by QueryDeviceIdentifiers
+     *
+     *  @return number of firmware devices being updated, a negative value if
+     *          an update is already in progress or the package is invalid
+     */
+    int processPackage(const std::filesystem::path& packageFilePath,
+                       const DeviceDescriptorMap& devices);
+
+    /** @brief Handle a firmware update request initiated by a FD
+     *
+     *  @param[in] eid - endpoint ID of the FD
+     *  @param[in] command - PLDM firmware update command
+     *  @param[in] request - PLDM request message
+     *  @param[in] reqMsgLen - PLDM request message payload length
+     *
+     *  @return PLDM response message
+     */
+    Response handleRequest(mctp_eid_t eid, uint8_t command,
+                           const pldm_msg* request, size_t reqMsgLen);
+
+    /** @brief Check if firmware devices are being updated */
+    bool updateInProgress() const
+    {
+        return completedUpdates < deviceUpdaterMap.size();
+    }
+
+    /** @brief Get the result of the last update of a FD
+     *
+     *  @param[in] eid - endpoint ID of the FD
+     *
+     *  @return true if the update succeeded, false if it failed or is in
+     *          progress
+     */
+    bool getUpdateStatus(mctp_eid_t eid) const
+    {
+        auto it = updateStatus.find(eid);
+        return it != updateStatus.end() && it->second;
+    }
+
+  private:
+    /** @brief Record the end of the update of a FD
+     *
+     *  @param[in] eid - endpoint ID of the FD
+     *  @param[in] status - true if the update succeeded, false otherwise
+     */
+    void updateDeviceCompletion(mctp_eid_t eid, bool status);
+
+    sdeventplus::Event& event;
+    pldm::dbus_api::Requester& requester;
+    pldm::requester::Handler<pldm::requester::Request>& handler;
+    const uint32_t maxTransferSize;
+    const std::chrono::milliseconds fdTimeout;
+
+    std::unique_ptr<Package> package;
+    std::map<mctp_eid_t, std::unique_ptr<DeviceUpdater>> deviceUpdaterMap;
+    std::map<mctp_eid_t, bool> updateStatus;
+    size_t completedUpdates = 0;
+};
+
+} // namespace fw_update
+
+} // namespace pldm
@@ -0,0 +1,64 @@
+#include "watch.hpp"
+
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <system_error>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+Watch::Watch(sdeventplus::Event& event, const std::filesystem::path& dir,
+             Callback callback) :
+    dir(dir),
+    callback(std::move(callback)), fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+{
+    if (fd() < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "inotify_init1 failed");
+    }
+
+    std::filesystem::create_directories(dir);
+    if (inotify_add_watch(fd(), dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) <
+        0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "inotify_add_watch failed, DIR=" +
+                                    dir.string());
+    }
+
+    io = std::make_unique<sdeventplus::source::IO>(
+        event, fd(), EPOLLIN,
+        [this](sdeventplus::source::IO&, int, uint32_t) {
+            processEvents();
+        });
+}
+
+void Watch::processEvents()
+{
+    alignas(inotify_event) std::array<char, 4096> buffer;
+    ssize_t bytes = 0;
+    while ((bytes = read(fd(), buffer.data(), buffer.size())) > 0)
+    {
+        for (auto ptr = buffer.data(); ptr < buffer.data() + bytes;)
+        {
+            auto event = reinterpret_cast<const inotify_event*>(ptr);
+            if (event->len && !(event->mask & IN_ISDIR))
+            {
+                callback(dir / event->name);
+            }
+            ptr += sizeof(inotify_event) + event->len;
+        }
+    }
+}
+
+} // namespace fw_update
+
+} // namespace pldm
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "common/utils.hpp"
+
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+/** @class Watch
+ *
+ *  @brief Watches a directory for firmware update packages.
+ *
+ *  The callback is invoked with the path of each file written to, or moved
+ *  into, the directory.
+ */
+class Watch
+{
+  public:
+    using Callback = std::function<void(const std::filesystem::path&)>;
+
+    Watch() = delete;
+    Watch(const Watch&) = delete;
+    Watch& operator=(const Watch&) = delete;
+    Watch(Watch&&) = delete;
+    Watch& operator=(Watch&&) = delete;
+    ~Watch() = default;
+
+    /** @brief Constructor, the directory is created if it does not exist
+     *
+     *  @param[in] event - reference to PLDM daemon's main event loop
+     *  @param[in] dir - directory to watch
+     *  @param[in] callback - invoked with the path of each new package
+     *
+     *  @throw std::system_error if the directory cannot be watched
+     */
+    Watch(sdeventplus::Event& event, const std::filesystem::path& dir,
+          Callback callback);
+
+  private:
+    /** @brief Read the inotify events and invoke the callback */
+    void processEvents();
+
+    std::filesystem::path dir;
+    Callback callback;
+    pldm::utils::CustomFD fd;
+    std::unique_ptr<sdeventplus::source::IO> io;
+};
+
+} // namespace fw_update
+
+} // namespace pldm
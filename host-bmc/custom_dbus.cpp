@@ -9,21 +9,18 @@ namespace dbus
 
 void CustomDBus::setLocationCode(const std::string& path, std::string value)
 {
-    if (location.find(path) == location.end())
-    {
-        location.emplace(path,
-                         std::make_unique<LocationIntf>(
-                             pldm::utils::DBusHandler::getBus(), path.c_str()));
-    }
+    auto& intf = objects[path].location;
+    auto skipSignal = implement(path, intf);
 
-    location.at(path)->locationCode(value);
+    intf->locationCode(value, skipSignal);
 }
 
 std::string CustomDBus::getLocationCode(const std::string& path) const
 {
-    if (location.find(path) != location.end())
+    auto it = objects.find(path);
+    if (it != objects.end() && it->second.location)
     {
-        return location.at(path)->locationCode();
+        return it->second.location->locationCode();
     }
 
     return {};
@@ -40,21 +37,18 @@ void CustomDBus::setOperationalStatus(const std::string& path, bool status,
             associations{{"health_rollup", "critical", parentChassis}};
         setAssociations(path, associations);
     }
-    if (operationalStatus.find(path) == operationalStatus.end())
-    {
-        operationalStatus.emplace(
-            path, std::make_unique<OperationalStatusIntf>(
-                      pldm::utils::DBusHandler::getBus(), path.c_str()));
-    }
+    auto& intf = objects[path].operationalStatus;
+    auto skipSignal = implement(path, intf);
 
-    operationalStatus.at(path)->functional(status);
+    intf->functional(status, skipSignal);
 }
 
 bool CustomDBus::getOperationalStatus(const std::string& path) const
 {
-    if (operationalStatus.find(path) != operationalStatus.end())
+    auto it = objects.find(path);
+    if (it != objects.end() && it->second.operationalStatus)
     {
-        return operationalStatus.at(path)->functional();
+        return it->second.operationalStatus->functional();
     }
 
     return false;
@@ -63,146 +57,94 @@ bool CustomDBus::getOperationalStatus(const std::string& path) const
 void CustomDBus::updateItemPresentStatus(const std::string& path,
                                          bool isPresent)
 {
-    if (presentStatus.find(path) == presentStatus.end())
+    auto& intf = objects[path].presentStatus;
+    if (!intf)
     {
-        presentStatus.emplace(
-            path, std::make_unique<ItemIntf>(pldm::utils::DBusHandler::getBus(),
-                                             path.c_str()));
+        auto skipSignal = implement(path, intf);
         std::filesystem::path ObjectPath(path);
 
         // Hardcode the present dbus property to true
-        presentStatus.at(path)->present(true);
+        intf->present(true, skipSignal);
 
         // Set the pretty name dbus property to the filename
         // form the dbus path object
-        presentStatus.at(path)->prettyName(ObjectPath.filename());
+        intf->prettyName(ObjectPath.filename(), skipSignal);
     }
     else
     {
         // object is already created
-        presentStatus.at(path)->present(isPresent);
+        intf->present(isPresent);
     }
 }
 
 void CustomDBus::implementChassisInterface(const std::string& path)
 {
-    if (chassis.find(path) == chassis.end())
-    {
-        chassis.emplace(path,
-                        std::make_unique<ItemChassis>(
-                            pldm::utils::DBusHandler::getBus(), path.c_str()));
-    }
+    implement(path, objects[path].chassis);
 }
 
 void CustomDBus::implementPCIeSlotInterface(const std::string& path)
 {
-    if (pcieSlot.find(path) == pcieSlot.end())
-    {
-        pcieSlot.emplace(
-            path, std::make_unique<ItemSlot>(pldm::utils::DBusHandler::getBus(),
-                                             path.c_str()));
-    }
+    implement(path, objects[path].pcieSlot);
 }
 
 void CustomDBus::implementMotherboardInterface(const std::string& path)
 {
-    if (motherboard.find(path) == motherboard.end())
-    {
-        motherboard.emplace(
-            path, std::make_unique<ItemMotherboard>(
-                      pldm::utils::DBusHandler::getBus(), path.c_str()));
-    }
+    implement(path, objects[path].motherboard);
 }
+
 void CustomDBus::implementPowerSupplyInterface(const std::string& path)
 {
-    if (powersupply.find(path) == powersupply.end())
-    {
-        powersupply.emplace(
-            path, std::make_unique<ItemPowerSupply>(
-                      pldm::utils::DBusHandler::getBus(), path.c_str()));
-    }
+    implement(path, objects[path].powersupply);
 }
 
 void CustomDBus::implementFanInterface(const std::string& path)
 {
-    if (fan.find(path) == fan.end())
-    {
-        fan.emplace(
-            path, std::make_unique<ItemFan>(pldm::utils::DBusHandler::getBus(),
-                                            path.c_str()));
-    }
+    implement(path, objects[path].fan);
 }
 
 void CustomDBus::implementConnecterInterface(const std::string& path)
 {
-    if (connector.find(path) == connector.end())
-    {
-        connector.emplace(
-            path, std::make_unique<ItemConnector>(
-                      pldm::utils::DBusHandler::getBus(), path.c_str()));
-    }
+    implement(path, objects[path].connector);
 }
 
 void CustomDBus::implementVRMInterface(const std::string& path)
 {
-    if (vrm.find(path) == vrm.end())
-    {
-        vrm.emplace(
-            path, std::make_unique<ItemVRM>(pldm::utils::DBusHandler::getBus(),
-                                            path.c_str()));
-    }
+    implement(path, objects[path].vrm);
 }
 
 void CustomDBus::implementCpuCoreInterface(const std::string& path)
 {
-    if (cpuCore.find(path) == cpuCore.end())
+    auto& intf = objects[path].cpuCore;
+    if (!intf)
     {
-        cpuCore.emplace(
-            path, std::make_unique<CoreIntf>(pldm::utils::DBusHandler::getBus(),
-                                             path.c_str()));
+        implement(path, intf);
         implementObjectEnableIface(path);
     }
 }
 
 void CustomDBus::implementFabricAdapter(const std::string& path)
 {
-    if (fabricAdapter.find(path) == fabricAdapter.end())
-    {
-        fabricAdapter.emplace(
-            path, std::make_unique<ItemFabricAdapter>(
-                      pldm::utils::DBusHandler::getBus(), path.c_str()));
-    }
+    implement(path, objects[path].fabricAdapter);
 }
 
 void CustomDBus::implementBoard(const std::string& path)
 {
-    if (board.find(path) == board.end())
-    {
-        board.emplace(path,
-                      std::make_unique<ItemBoard>(
-                          pldm::utils::DBusHandler::getBus(), path.c_str()));
-    }
+    implement(path, objects[path].board);
 }
 
 void CustomDBus::implementObjectEnableIface(const std::string& path)
 {
-    if (_enabledStatus.find(path) == _enabledStatus.end())
+    auto& intf = objects[path].enabledStatus;
+    if (!intf)
     {
-        _enabledStatus.emplace(
-            path, std::make_unique<EnableIface>(
-                      pldm::utils::DBusHandler::getBus(), path.c_str()));
-        _enabledStatus.at(path)->enabled(false);
+        auto skipSignal = implement(path, intf);
+        intf->enabled(false, skipSignal);
     }
 }
 
 void CustomDBus::implementGlobalInterface(const std::string& path)
 {
-    if (global.find(path) == global.end())
-    {
-        global.emplace(path,
-                       std::make_unique<ItemGlobal>(
-                           pldm::utils::DBusHandler::getBus(), path.c_str()));
-    }
+    implement(path, objects[path].global);
 }
 
 void CustomDBus::implementLicInterfaces(
@@ -212,56 +154,44 @@ void CustomDBus::implementLicInterfaces(
     const sdbusplus::com::ibm::License::Entry::server::LicenseEntry::
         AuthorizationType& authtype)
 {
-    if (codLic.find(path) == codLic.end())
-    {
-        codLic.emplace(
-            path, std::make_unique<LicIntf>(pldm::utils::DBusHandler::getBus(),
-                                            path.c_str()));
-    }
-
-    codLic.at(path)->authDeviceNumber(authdevno);
-    codLic.at(path)->name(name);
-    codLic.at(path)->serialNumber(serialno);
-    codLic.at(path)->expirationTime(exptime);
-    codLic.at(path)->type(type);
-    codLic.at(path)->authorizationType(authtype);
+    auto& intf = objects[path].codLic;
+    auto skipSignal = implement(path, intf);
+
+    intf->authDeviceNumber(authdevno, skipSignal);
+    intf->name(name, skipSignal);
+    intf->serialNumber(serialno, skipSignal);
+    intf->expirationTime(exptime, skipSignal);
+    intf->type(type, skipSignal);
+    intf->authorizationType(authtype, skipSignal);
 }
 
 void CustomDBus::setAvailabilityState(const std::string& path,
                                       const bool& state)
 {
-    if (availabilityState.find(path) == availabilityState.end())
-    {
-        availabilityState.emplace(
-            path, std::make_unique<AvailabilityIntf>(
-                      pldm::utils::DBusHandler::getBus(), path.c_str()));
-    }
+    auto& intf = objects[path].availabilityState;
+    auto skipSignal = implement(path, intf);
 
-    availabilityState.at(path)->available(state);
+    intf->available(state, skipSignal);
 }
 void CustomDBus::setAsserted(
     const std::string& path, const pldm_entity& entity, bool value,
     pldm::host_effecters::HostEffecterParser* hostEffecterParser,
     uint8_t mctpEid, bool isTriggerStateEffecterStates)
 {
-    if (ledGroup.find(path) == ledGroup.end())
-    {
-        ledGroup.emplace(
-            path, std::make_unique<Group>(pldm::utils::DBusHandler::getBus(),
-                                          path.c_str(), hostEffecterParser,
-                                          entity, mctpEid));
-    }
+    auto& intf = objects[path].ledGroup;
+    implement(path, intf, hostEffecterParser, entity, mctpEid);
 
-    ledGroup.at(path)->setStateEffecterStatesFlag(isTriggerStateEffecterStates);
+    intf->setStateEffecterStatesFlag(isTriggerStateEffecterStates);
 
-    ledGroup.at(path)->asserted(value);
+    intf->asserted(value);
 }
 
 bool CustomDBus::getAsserted(const std::string& path) const
 {
-    if (ledGroup.find(path) != ledGroup.end())
+    auto it = objects.find(path);
+    if (it != objects.end() && it->second.ledGroup)
     {
-        return ledGroup.at(path)->asserted();
+        return it->second.ledGroup->asserted();
     }
 
     return false;
@@ -320,9 +250,10 @@ bool Group::asserted(bool value)
 const std::vector<std::tuple<std::string, std::string, std::string>>
     CustomDBus::getAssociations(const std::string& path)
 {
-    if (associations.find(path) != associations.end())
+    auto it = objects.find(path);
+    if (it != objects.end() && it->second.associations)
     {
-        return associations.at(path)->associations();
+        return it->second.associations->associations();
     }
     return {};
 }
@@ -332,20 +263,25 @@ void CustomDBus::setAssociations(const std::string& path, Associations assoc)
     using PropVariant = sdbusplus::xyz::openbmc_project::Association::server::
         Definitions::PropertiesVariant;
 
-    if (associations.find(path) == associations.end())
+    auto& intf = objects[path].associations;
+    if (!intf)
     {
         PropVariant value{std::move(assoc)};
         std::map<std::string, PropVariant> properties;
         properties.emplace("Associations", std::move(value));
 
-        associations.emplace(path, std::make_unique<AssociationsIntf>(
-                                       pldm::utils::DBusHandler::getBus(),
-                                       path.c_str(), properties));
+        // Not an object<>, it is announced only by publish()
+        intf = std::make_unique<AssociationsIntf>(bus, path.c_str(),
+                                                  properties, deferred);
+        if (deferred)
+        {
+            pending[path].emplace_back(AssociationsIntf::interface);
+        }
     }
     else
     {
         // object already created , so just update the associations
-        auto currentAssociations = getAssociations(path);
+        auto currentAssociations = intf->associations();
         std::vector<std::tuple<std::string, std::string, std::string>>
             newAssociations;
         newAssociations.reserve(currentAssociations.size() + assoc.size());
@@ -354,8 +290,23 @@ void CustomDBus::setAssociations(const std::string& path, Associations assoc)
                                currentAssociations.end());
         newAssociations.insert(newAssociations.end(), assoc.begin(),
                                assoc.end());
-        associations.at(path)->associations(newAssociations);
+        intf->associations(newAssociations);
+    }
+}
+
+void CustomDBus::deferPublication()
+{
+    deferred = true;
+}
+
+void CustomDBus::publish()
+{
+    deferred = false;
+    for (const auto& [path, interfaces] : pending)
+    {
+        bus.emit_interfaces_added(path.c_str(), interfaces);
     }
+    pending.clear();
 }
 
 } // namespace dbus
@@ -31,6 +31,8 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace pldm
 {
@@ -97,12 +99,15 @@ class Group : public AssertedIntf
 
     Group(sdbusplus::bus::bus& bus, const std::string& objPath,
           pldm::host_effecters::HostEffecterParser* hostEffecterParser,
-          const pldm_entity entity, uint8_t mctpEid) :
+          const pldm_entity entity, uint8_t mctpEid, bool deferSignal = false) :
         AssertedIntf(bus, objPath.c_str(), true),
         hostEffecterParser(hostEffecterParser), entity(entity), mctpEid(mctpEid)
     {
-        // Emit deferred signal.
-        emit_object_added();
+        if (!deferSignal)
+        {
+            // Emit deferred signal.
+            emit_object_added();
+        }
     }
 
     /** @brief Property SET Override function
@@ -133,17 +138,57 @@ class Group : public AssertedIntf
     bool isTriggerStateEffecterStates = false;
 };
 
+/** @struct Object
+ *  @brief The interfaces hosted on one object path, an interface is nullptr
+ *  until it is implemented.
+ */
+struct Object
+{
+    std::unique_ptr<LocationIntf> location;
+    std::unique_ptr<OperationalStatusIntf> operationalStatus;
+    std::unique_ptr<Group> ledGroup;
+    std::unique_ptr<AssociationsIntf> associations;
+    std::unique_ptr<AvailabilityIntf> availabilityState;
+    std::unique_ptr<ItemIntf> presentStatus;
+    std::unique_ptr<CoreIntf> cpuCore;
+    std::unique_ptr<LicIntf> codLic;
+    std::unique_ptr<EnableIface> enabledStatus;
+    std::unique_ptr<ItemChassis> chassis;
+    std::unique_ptr<ItemConnector> connector;
+    std::unique_ptr<ItemFan> fan;
+    std::unique_ptr<ItemVRM> vrm;
+    std::unique_ptr<ItemMotherboard> motherboard;
+    std::unique_ptr<ItemSlot> pcieSlot;
+    std::unique_ptr<ItemPowerSupply> powersupply;
+    std::unique_ptr<ItemFabricAdapter> fabricAdapter;
+    std::unique_ptr<ItemBoard> board;
+    std::unique_ptr<ItemGlobal> global;
+};
+
 /** @class CustomDBus
  *  @brief This is a custom D-Bus object, used to add D-Bus interface and
  * update the corresponding properties value.
+ *
+ * The interfaces are announced as they are implemented, unless the
+ * publication is deferred. The interfaces implemented while it is deferred
+ * are announced by publish(), with one InterfacesAdded signal per object
+ * path, and their initial property values are set without signals.
  */
 class CustomDBus
 {
   private:
-    CustomDBus()
+    CustomDBus() : CustomDBus(pldm::utils::DBusHandler::getBus())
     {}
 
   public:
+    /** @brief Constructor
+     *
+     *  @param[in] bus - the bus to host the objects on, used by the tests,
+     *                   getCustomDBus() hosts them on the default bus
+     */
+    explicit CustomDBus(sdbusplus::bus::bus& bus) : bus(bus)
+    {}
+
     CustomDBus(const CustomDBus&) = delete;
     CustomDBus(CustomDBus&&) = delete;
     CustomDBus& operator=(const CustomDBus&) = delete;
@@ -317,36 +362,59 @@ class CustomDBus
      */
     void setAvailabilityState(const std::string& path, const bool& state);
 
+    /** @brief Defer the signals of the interfaces implemented from now on,
+     *         until publish() is called
+     */
+    void deferPublication();
+
+    /** @brief Announce the interfaces implemented since deferPublication(),
+     *         with one InterfacesAdded signal per object path, and announce
+     *         the interfaces implemented from now on as they are implemented
+     */
+    void publish();
+
   private:
-    std::map<ObjectPath, std::unique_ptr<LocationIntf>> location;
-
-    std::map<ObjectPath, std::unique_ptr<OperationalStatusIntf>>
-        operationalStatus;
-    std::unordered_map<ObjectPath, std::unique_ptr<Group>> ledGroup;
-
-    std::unordered_map<ObjectPath, std::unique_ptr<AssociationsIntf>>
-        associations;
-    std::map<ObjectPath, std::unique_ptr<AvailabilityIntf>> availabilityState;
-
-    std::unordered_map<ObjectPath, std::unique_ptr<ItemIntf>> presentStatus;
-    std::unordered_map<ObjectPath, std::unique_ptr<CoreIntf>> cpuCore;
-    std::unordered_map<ObjectPath, std::unique_ptr<LicIntf>> codLic;
-
-    /** @brief Used to hold the objects which will contain EnableIface */
-    std::unordered_map<ObjectPath, std::unique_ptr<EnableIface>> _enabledStatus;
-    std::unordered_map<ObjectPath, std::unique_ptr<ItemChassis>> chassis;
-    std::unordered_map<ObjectPath, std::unique_ptr<ItemConnector>> connector;
-    std::unordered_map<ObjectPath, std::unique_ptr<ItemFan>> fan;
-    std::unordered_map<ObjectPath, std::unique_ptr<ItemVRM>> vrm;
-    std::unordered_map<ObjectPath, std::unique_ptr<ItemMotherboard>>
-        motherboard;
-    std::unordered_map<ObjectPath, std::unique_ptr<ItemSlot>> pcieSlot;
-    std::unordered_map<ObjectPath, std::unique_ptr<ItemPowerSupply>>
-        powersupply;
-    std::unordered_map<ObjectPath, std::unique_ptr<ItemFabricAdapter>>
-        fabricAdapter;
-    std::unordered_map<ObjectPath, std::unique_ptr<ItemBoard>> board;
-    std::unordered_map<ObjectPath, std::unique_ptr<ItemGlobal>> global;
+    /** @brief Implement an interface of an object if it is not implemented
+     *
+     *  @param[in] path - The object path
+     *  @param[in,out] intf - The interface in the object
+     *  @param[in] args - The constructor arguments of the interface following
+     *                    the path
+     *
+     *  @return true if the interface has been implemented and its signal is
+     *          deferred, its properties are then initialized without signals
+     */
+    template <typename Intf, typename... Args>
+    bool implement(const std::string& path, std::unique_ptr<Intf>& intf,
+                   Args&&... args)
+    {
+        if (intf)
+        {
+            return false;
+        }
+
+        intf = std::make_unique<Intf>(bus, path.c_str(),
+                                      std::forward<Args>(args)..., deferred);
+        if (deferred)
+        {
+            pending[path].emplace_back(Intf::interface);
+        }
+        return deferred;
+    }
+
+    sdbusplus::bus::bus& bus;
+
+    /** @brief The objects hosted, by object path */
+    std::unordered_map<ObjectPath, Object> objects;
+
+    /** @brief true while the publication is deferred */
+    bool deferred = false;
+
+    /** @brief The interfaces not announced yet, by object path. The paths
+     *  are sorted so that the parent objects are announced before their
+     *  children.
+     */
+    std::map<ObjectPath, std::vector<std::string>> pending;
 };
 
 } // namespace dbus
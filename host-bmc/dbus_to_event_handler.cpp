@@ -4,6 +4,8 @@
 
 #include "libpldmresponder/pdr.hpp"
 
+#include <cstddef>
+
 namespace pldm
 {
 
@@ -17,6 +19,11 @@ using namespace sdbusplus::bus::match::rules;
 namespace state_sensor
 {
 const std::vector<uint8_t> pdrTypes{PLDM_STATE_SENSOR_PDR};
+// Offset of the event state of a state sensor event in the PlatformEventMessage
+// request payload, the previous event state follows it
+constexpr auto eventStateOffset =
+    offsetof(pldm_platform_event_message_req, event_data) +
+    offsetof(pldm_sensor_event_data, event_class) + 1;
 
 DbusToPLDMEvent::DbusToPLDMEvent(
     int mctp_fd, uint8_t mctp_eid, Requester& requester,
@@ -25,27 +32,10 @@ DbusToPLDMEvent::DbusToPLDMEvent(
     mctp_eid(mctp_eid), requester(requester), handler(handler)
 {}
 
-void DbusToPLDMEvent::sendEventMsg(uint8_t eventType,
-                                   const std::vector<uint8_t>& eventDataVec)
+void DbusToPLDMEvent::sendEventMsg(
+    const pldm::requester::PreparedRequest& request)
 {
     auto instanceId = requester.getInstanceId(mctp_eid);
-    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
-                                    PLDM_PLATFORM_EVENT_MESSAGE_MIN_REQ_BYTES +
-                                    eventDataVec.size());
-    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
-
-    auto rc = encode_platform_event_message_req(
-        instanceId, 1 /*formatVersion*/, 0 /*tId*/, eventType,
-        eventDataVec.data(), eventDataVec.size(), request,
-        eventDataVec.size() + PLDM_PLATFORM_EVENT_MESSAGE_MIN_REQ_BYTES);
-    if (rc != PLDM_SUCCESS)
-    {
-        requester.markFree(mctp_eid, instanceId);
-        std::cerr << "Failed to encode_platform_event_message_req, rc = " << rc
-                  << std::endl;
-        return;
-    }
-
     auto platformEventMessageResponseHandler = [](mctp_eid_t /*eid*/,
                                                   const pldm_msg* response,
                                                   size_t respMsgLen) {
@@ -68,9 +58,9 @@ void DbusToPLDMEvent::sendEventMsg(uint8_t eventType,
         }
     };
 
-    rc = handler->registerRequest(
-        mctp_eid, instanceId, PLDM_PLATFORM, PLDM_PLATFORM_EVENT_MESSAGE,
-        std::move(requestMsg), std::move(platformEventMessageResponseHandler));
+    auto rc = handler->registerRequest(
+        mctp_eid, instanceId, request,
+        std::move(platformEventMessageResponseHandler));
     if (rc)
     {
         std::cerr << "Failed to send the platform event message \n";
@@ -106,14 +96,32 @@ void DbusToPLDMEvent::sendStateSensorEvent(SensorId sensorId,
         eventData->event_class[1] = PLDM_SENSOR_UNKNOWN;
         eventData->event_class[2] = PLDM_SENSOR_UNKNOWN;
 
+        // The event message is encoded once, only the event states vary
+        pldm::requester::PreparedRequest request(
+            PLDM_PLATFORM, PLDM_PLATFORM_EVENT_MESSAGE,
+            PLDM_PLATFORM_EVENT_MESSAGE_MIN_REQ_BYTES + sensorEventSize);
+        auto rc = request.encode([&sensorEventDataVec](uint8_t instanceId,
+                                                       pldm_msg* msg) {
+            return encode_platform_event_message_req(
+                instanceId, 1 /*formatVersion*/, 0 /*tId*/, PLDM_SENSOR_EVENT,
+                sensorEventDataVec.data(), sensorEventDataVec.size(), msg,
+                sensorEventDataVec.size() +
+                    PLDM_PLATFORM_EVENT_MESSAGE_MIN_REQ_BYTES);
+        });
+        if (rc != PLDM_SUCCESS)
+        {
+            std::cerr << "Failed to encode_platform_event_message_req, rc = "
+                      << rc << std::endl;
+            continue;
+        }
+
         const auto& dbusMapping = dbusMappings[offset];
         const auto& dbusValueMapping = dbusValMaps[offset];
         auto stateSensorMatch = std::make_unique<sdbusplus::bus::match::match>(
             pldm::utils::DBusHandler::getBus(),
             propertiesChanged(dbusMapping.objectPath.c_str(),
                               dbusMapping.interface.c_str()),
-            [this, sensorEventDataVec, dbusValueMapping,
-             dbusMapping](auto& msg) mutable {
+            [this, request, dbusValueMapping, dbusMapping](auto& msg) mutable {
                 DbusChangedProps props{};
                 std::string intf;
                 msg.read(intf, props);
@@ -150,13 +158,11 @@ void DbusToPLDMEvent::sendStateSensorEvent(SensorId sensorId,
 
                     if (findValue)
                     {
-                        auto eventData =
-                            reinterpret_cast<struct pldm_sensor_event_data*>(
-                                sensorEventDataVec.data());
-                        eventData->event_class[1] = itr.first;
-                        eventData->event_class[2] = itr.first;
-                        this->sendEventMsg(PLDM_SENSOR_EVENT,
-                                           sensorEventDataVec);
+                        request.setField<uint8_t>(eventStateOffset,
+                                                  itr.first);
+                        request.setField<uint8_t>(eventStateOffset + 1,
+                                                  itr.first);
+                        this->sendEventMsg(request);
                         break;
                     }
                 }
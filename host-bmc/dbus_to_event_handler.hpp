@@ -5,6 +5,7 @@
 #include "libpldmresponder/pdr_utils.hpp"
 #include "pldmd/dbus_impl_requester.hpp"
 #include "requester/handler.hpp"
+#include "requester/prepared_request.hpp"
 
 #include <map>
 
@@ -62,12 +63,10 @@ class DbusToPLDMEvent
         SensorId sensorId,
         const pldm::responder::pdr_utils::DbusObjMaps& dbusMaps);
 
-    /** @brief Send all of sensor event
-     *  @param[in] eventType - PLDM Event types
-     *  @param[in] eventDataVec - std::vector, contains send event data
+    /** @brief Send a platform event message
+     *  @param[in] request - the encoded PlatformEventMessage request
      */
-    void sendEventMsg(uint8_t eventType,
-                      const std::vector<uint8_t>& eventDataVec);
+    void sendEventMsg(const pldm::requester::PreparedRequest& request);
 
     /** @brief fd of MCTP communications socket */
     int mctp_fd;
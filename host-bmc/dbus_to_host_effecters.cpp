@@ -7,6 +7,8 @@
 #include <xyz/openbmc_project/Common/error.hpp>
 #include <xyz/openbmc_project/State/OperatingSystem/Status/server.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <fstream>
 #include <iostream>
 
@@ -250,31 +252,185 @@ int HostEffecterParser::sendSetStateEffecterStates(
     std::vector<set_effecter_state_field>& stateField,
     std::function<bool(bool)> callBack, bool value)
 {
-    auto instanceId = requester->getInstanceId(mctpEid);
+    if (compEffCnt < 1 || compEffCnt > 8 || stateField.size() < compEffCnt)
+    {
+        std::cerr << "Invalid composite effecter count for effecter "
+                  << effecterId << ", count " << (unsigned)compEffCnt
+                  << "\n";
+        return PLDM_ERROR_INVALID_DATA;
+    }
 
-    std::vector<uint8_t> requestMsg(
-        sizeof(pldm_msg_hdr) + sizeof(effecterId) + sizeof(compEffCnt) +
-            sizeof(set_effecter_state_field) * compEffCnt,
-        0);
-    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
-    auto rc = encode_set_state_effecter_states_req(
-        instanceId, effecterId, compEffCnt, stateField.data(), request);
+    auto& buffer = writeBuffers[{mctpEid, effecterId}];
+    if (buffer.stateField.size() < compEffCnt)
+    {
+        buffer.stateField.resize(compEffCnt, {PLDM_NO_CHANGE, 0});
+        buffer.lastState.resize(compEffCnt);
+        buffer.request.reset();
+    }
 
-    if (rc != PLDM_SUCCESS)
+    // A later write to a composite effecter replaces the pending one
+    for (uint8_t i = 0; i < compEffCnt; i++)
+    {
+        if (stateField[i].set_request == PLDM_REQUEST_SET)
+        {
+            buffer.stateField[i] = stateField[i];
+        }
+    }
+    if (callBack)
+    {
+        buffer.callBacks.emplace_back(std::move(callBack), value);
+    }
+
+    if (!buffer.timer)
+    {
+        buffer.timer = std::make_unique<phosphor::Timer>(
+            event.get(), [this, mctpEid, effecterId]() {
+                flushEffecterWrites(mctpEid, effecterId);
+            });
+    }
+
+    // The window opens with the first pending write. While a request is in
+    // flight the writes wait for its response, so they reach the host in
+    // order.
+    if (!buffer.inFlight && !buffer.timer->isEnabled())
+    {
+        try
+        {
+            buffer.timer->start(
+                duration_cast<std::chrono::microseconds>(coalesceWindow));
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << "Failed to start the effecter write timer, ERROR="
+                      << e.what() << "\n";
+            flushEffecterWrites(mctpEid, effecterId);
+        }
+    }
+    return PLDM_SUCCESS;
+}
+
+void HostEffecterParser::resetHostStates()
+{
+    // The buffers stay, a request may be in flight
+    for (auto& [key, buffer] : writeBuffers)
+    {
+        std::fill(buffer.lastState.begin(), buffer.lastState.end(),
+                  std::nullopt);
+    }
+}
+
+void HostEffecterParser::flushEffecterWrites(uint8_t mctpEid,
+                                             uint16_t effecterId)
+{
+    auto& buffer = writeBuffers.at({mctpEid, effecterId});
+    if (buffer.inFlight)
     {
-        std::cerr
-            << "Message encode SetStateEffecterStates failure. PLDM error code = "
-            << std::hex << std::showbase << rc << "\n";
-        requester->markFree(mctpEid, instanceId);
-        return rc;
+        return;
+    }
+
+    auto stateField = buffer.stateField;
+    auto callBacks = std::move(buffer.callBacks);
+    buffer.callBacks.clear();
+    std::fill(buffer.stateField.begin(), buffer.stateField.end(),
+              set_effecter_state_field{PLDM_NO_CHANGE, 0});
+
+    // Drop the writes of the state the host already has
+    bool changed = false;
+    for (size_t i = 0; i < stateField.size(); i++)
+    {
+        if (stateField[i].set_request != PLDM_REQUEST_SET)
+        {
+            continue;
+        }
+        if (buffer.lastState[i] == stateField[i].effecter_state)
+        {
+            stateField[i] = {PLDM_NO_CHANGE, 0};
+            continue;
+        }
+        buffer.lastState[i] = stateField[i].effecter_state;
+        changed = true;
+    }
+
+    if (!changed)
+    {
+        for (auto& [callBack, value] : callBacks)
+        {
+            callBack(value);
+        }
+        return;
+    }
+
+    // The states set by a failed request are not known anymore, so the next
+    // write to them is not dropped
+    auto forgetStates = [this, mctpEid, effecterId, stateField]() {
+        auto& buffer = writeBuffers.at({mctpEid, effecterId});
+        for (size_t i = 0; i < stateField.size(); i++)
+        {
+            if (stateField[i].set_request == PLDM_REQUEST_SET)
+            {
+                buffer.lastState[i].reset();
+            }
+        }
+    };
+
+    auto compEffCnt = static_cast<uint8_t>(stateField.size());
+    if (!buffer.request)
+    {
+        buffer.request.emplace(PLDM_PLATFORM, PLDM_SET_STATE_EFFECTER_STATES,
+                               sizeof(effecterId) + sizeof(compEffCnt) +
+                                   sizeof(set_effecter_state_field) *
+                                       compEffCnt);
+        auto rc = buffer.request->encode(
+            [effecterId, compEffCnt, &stateField](uint8_t instanceId,
+                                                  pldm_msg* request) {
+                return encode_set_state_effecter_states_req(
+                    instanceId, effecterId, compEffCnt, stateField.data(),
+                    request);
+            });
+        if (rc != PLDM_SUCCESS)
+        {
+            std::cerr << "Message encode SetStateEffecterStates failure. "
+                      << "PLDM error code = " << std::hex << std::showbase
+                      << rc << "\n";
+            buffer.request.reset();
+            forgetStates();
+            return;
+        }
+    }
+    for (size_t i = 0; i < stateField.size(); i++)
+    {
+        auto offset = offsetof(pldm_set_state_effecter_states_req, field) +
+                      i * sizeof(set_effecter_state_field);
+        buffer.request->setField(offset, stateField[i].set_request);
+        buffer.request->setField(offset + 1, stateField[i].effecter_state);
     }
 
     auto setStateEffecterStatesRespHandler =
-        [=](mctp_eid_t /*eid*/, const pldm_msg* response, size_t respMsgLen) {
+        [this, mctpEid, effecterId, forgetStates,
+         callBacks = std::move(callBacks)](mctp_eid_t /*eid*/,
+                                           const pldm_msg* response,
+                                           size_t respMsgLen) mutable {
+            auto& buffer = writeBuffers.at({mctpEid, effecterId});
+            buffer.inFlight = false;
+
+            // Send the writes made while this request was in flight
+            bool pending = !buffer.callBacks.empty() ||
+                           std::any_of(buffer.stateField.begin(),
+                                       buffer.stateField.end(),
+                                       [](const auto& field) {
+                                           return field.set_request ==
+                                                  PLDM_REQUEST_SET;
+                                       });
+            if (pending && !buffer.timer->isEnabled())
+            {
+                buffer.timer->start(std::chrono::microseconds(0));
+            }
+
             if (response == nullptr || !respMsgLen)
             {
                 std::cerr << "Failed to receive response for "
                           << "setStateEffecterStates command \n";
+                forgetStates();
                 return;
             }
             uint8_t completionCode{};
@@ -294,24 +450,28 @@ int HostEffecterParser::sendSetStateEffecterStates(
                           << "\n";
                 pldm::utils::reportError(
                     "xyz.openbmc_project.bmc.pldm.SetHostEffecterFailed");
+                forgetStates();
             }
             else
             {
-                if (callBack)
+                for (auto& [callBack, value] : callBacks)
                 {
                     callBack(value);
                 }
             }
         };
 
-    rc = handler->registerRequest(
-        mctpEid, instanceId, PLDM_PLATFORM, PLDM_SET_STATE_EFFECTER_STATES,
-        std::move(requestMsg), std::move(setStateEffecterStatesRespHandler));
+    auto instanceId = requester->getInstanceId(mctpEid);
+    buffer.inFlight = true;
+    auto rc = handler->registerRequest(
+        mctpEid, instanceId, *buffer.request,
+        std::move(setStateEffecterStatesRespHandler));
     if (rc)
     {
         std::cerr << "Failed to send request to set an effecter on Host \n";
+        buffer.inFlight = false;
+        forgetStates();
     }
-    return rc;
 }
 
 int HostEffecterParser::setHostStateEffecter(
@@ -1,10 +1,21 @@
 #pragma once
 
+#include "config.h"
+
 #include "common/types.hpp"
 #include "common/utils.hpp"
 #include "pldmd/dbus_impl_requester.hpp"
 #include "requester/handler.hpp"
+#include "requester/prepared_request.hpp"
+
+#include <sdbusplus/timer.hpp>
+#include <sdeventplus/event.hpp>
 
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -53,11 +64,42 @@ struct EffecterInfo
         dbusInfo; //!< D-Bus information for the effecter id
 };
 
+/** @struct EffecterWriteBuffer
+ *
+ *  The writes to a host state effecter not yet sent to the host. They are
+ *  folded into one composite SetStateEffecterStates request when the
+ *  coalescing window ends, and only one request per effecter is in flight so
+ *  the host applies the writes in the order they were made.
+ */
+struct EffecterWriteBuffer
+{
+    /** @brief Fields of the next request, PLDM_NO_CHANGE where no write is
+     *         pending
+     */
+    std::vector<set_effecter_state_field> stateField;
+    /** @brief State last sent to the host per composite effecter, unknown
+     *         until it is set or if the host failed to set it
+     */
+    std::vector<std::optional<uint8_t>> lastState;
+    /** @brief Called with their value once the pending writes are set */
+    std::vector<std::pair<std::function<bool(bool)>, bool>> callBacks;
+    /** @brief SetStateEffecterStates request, encoded when it is first sent,
+     *         only the state fields are patched in for the next ones
+     */
+    std::optional<pldm::requester::PreparedRequest> request;
+    bool inFlight = false;                 //!< a request is awaiting response
+    std::unique_ptr<phosphor::Timer> timer; //!< ends the coalescing window
+};
+
 /** @class HostEffecterParser
  *
  *  @brief This class parses the Host Effecter json file and monitors for the
  *         D-Bus changes for the effecters. Upon change, calls the corresponding
  *         setStateEffecterStates on the host
+ *
+ *  The changes made to an effecter within the coalescing window are folded
+ *  into one composite setStateEffecterStates, writes of the state the host
+ *  already has are dropped.
  */
 class HostEffecterParser
 {
@@ -76,14 +118,21 @@ class HostEffecterParser
      *  @param[in] dbusHandler - D-bus Handler
      *  @param[in] jsonPath - path for the json file
      *  @param[in] handler - PLDM request handler
+     *  @param[in] event - reference to PLDM daemon's main event loop
+     *  @param[in] coalesceWindow - time the writes to an effecter are
+     *                              collected before they are sent
      */
     explicit HostEffecterParser(
         pldm::dbus_api::Requester* requester, int fd, const pldm_pdr* repo,
         pldm::utils::DBusHandler* const dbusHandler,
         const std::string& jsonPath,
-        pldm::requester::Handler<pldm::requester::Request>* handler) :
+        pldm::requester::Handler<pldm::requester::Request>* handler,
+        sdeventplus::Event& event,
+        std::chrono::milliseconds coalesceWindow =
+            std::chrono::milliseconds(HOST_EFFECTER_COALESCE_WINDOW_MS)) :
         requester(requester),
-        sockFd(fd), pdrRepo(repo), dbusHandler(dbusHandler), handler(handler)
+        sockFd(fd), pdrRepo(repo), dbusHandler(dbusHandler), handler(handler),
+        event(event), coalesceWindow(coalesceWindow)
     {
         try
         {
@@ -169,11 +218,30 @@ class HostEffecterParser
 
     const pldm_pdr* getPldmPDR();
 
+    /* @brief Queue writes to a host state effecter, they are sent with the
+     *        other writes to the effecter made within the coalescing window
+     *
+     * @param[in] mctpEid - host mctp eid
+     * @param[in] effecterId - host effecter id
+     * @param[in] compEffCnt - composite effecter count
+     * @param[in] stateField - vector of state fields equal to composite
+     *                         effecter count in number
+     * @param[in] callBack - called with value once the host has set the
+     *                       states
+     * @param[in] value - value to call callBack with
+     * @return - PLDM status code
+     */
     int sendSetStateEffecterStates(
         uint8_t mctpEid, uint16_t effecterId, uint8_t compEffCnt,
         std::vector<set_effecter_state_field>& stateField,
         std::function<bool(bool)> callBack = nullptr, bool value = false);
 
+    /* @brief Forget the states last sent to the host effecters, the host
+     *        lost them when it was powered off. The next write to each
+     *        effecter is sent even if it is of the state last sent.
+     */
+    void resetHostStates();
+
   protected:
     pldm::dbus_api::Requester*
         requester;           //!< Reference to Requester to obtain instance id
@@ -186,6 +254,19 @@ class HostEffecterParser
     const pldm::utils::DBusHandler* dbusHandler; //!< D-bus Handler
     /** @brief PLDM request handler */
     pldm::requester::Handler<pldm::requester::Request>* handler;
+    sdeventplus::Event& event; //!< reference to PLDM daemon's main event loop
+    std::chrono::milliseconds coalesceWindow; //!< coalescing window
+    /** @brief Pending writes, keyed by host mctp eid and effecter id */
+    std::map<std::pair<uint8_t, uint16_t>, EffecterWriteBuffer> writeBuffers;
+
+  private:
+    /* @brief Send the pending writes to an effecter in one request, the
+     *        writes of the state the host already has are dropped
+     *
+     * @param[in] mctpEid - host mctp eid
+     * @param[in] effecterId - host effecter id
+     */
+    void flushEffecterWrites(uint8_t mctpEid, uint16_t effecterId);
 };
 
 } // namespace host_effecters
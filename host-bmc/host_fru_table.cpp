@@ -0,0 +1,278 @@
+#include "host_fru_table.hpp"
+
+#include "libpldm/base.h"
+#include "libpldm/platform.h"
+#include "libpldm/utils.h"
+#include "oem/ibm/libpldm/fru.h"
+
+#include <endian.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace pldm
+{
+
+namespace hostbmc
+{
+
+constexpr size_t recordHdrSize = sizeof(pldm_fru_record_data_format) -
+                                 sizeof(pldm_fru_record_tlv);
+constexpr size_t fieldHdrSize = sizeof(pldm_fru_record_tlv) - 1;
+
+void FruRecordTable::clear(size_t numRecords, size_t length)
+{
+    table.clear();
+    records.clear();
+    fieldOffsets.clear();
+    parsed = 0;
+    this->numRecords = numRecords;
+    this->length = length;
+}
+
+bool FruRecordTable::append(const uint8_t* data, size_t length)
+{
+    if (length > this->length + sizeof(uint32_t) - table.size())
+    {
+        return false;
+    }
+    table.insert(table.end(), data, data + length);
+    parse();
+    return true;
+}
+
+bool FruRecordTable::checksumValid() const
+{
+    if (table.size() != length + sizeof(uint32_t))
+    {
+        return false;
+    }
+    uint32_t checksum = 0;
+    std::copy_n(table.begin() + length, sizeof(checksum),
+                reinterpret_cast<uint8_t*>(&checksum));
+    return le32toh(checksum) == crc32(table.data(), length);
+}
+
+void FruRecordTable::parse()
+{
+    while (!complete() && table.size() - parsed >= recordHdrSize)
+    {
+        auto record =
+            reinterpret_cast<const pldm_fru_record_data_format*>(&table[parsed]);
+
+        // Check the record is whole before indexing it, the rest of it comes
+        // with the next part otherwise
+        size_t offset = parsed + recordHdrSize;
+        for (uint8_t i = 0; i < record->num_fru_fields; ++i)
+        {
+            if (table.size() - offset < fieldHdrSize)
+            {
+                return;
+            }
+            offset += fieldHdrSize + table[offset + 1];
+            if (offset > table.size())
+            {
+                return;
+            }
+        }
+
+        Record entry{};
+        entry.offset = parsed;
+        entry.firstField = fieldOffsets.size();
+        entry.rsi = le16toh(record->record_set_id);
+        entry.recordType = record->record_type;
+        entry.numFields = record->num_fru_fields;
+        entry.encodingType = record->encoding_type;
+
+        offset = parsed + recordHdrSize;
+        for (uint8_t i = 0; i < entry.numFields; ++i)
+        {
+            fieldOffsets.push_back(offset);
+            offset += fieldHdrSize + table[offset + 1];
+        }
+        records.push_back(entry);
+        parsed = offset;
+    }
+}
+
+FruRecordTable::Field FruRecordTable::getField(const Record& record,
+                                               size_t index) const
+{
+    auto tlv = reinterpret_cast<const pldm_fru_record_tlv*>(
+        &table[fieldOffsets[record.firstField + index]]);
+    return {tlv->type, tlv->length, tlv->value};
+}
+
+void FruTableReader::read(mctp_eid_t eid, size_t numRecords, size_t length,
+                          Callback&& callback)
+{
+    // The responses to an abandoned read are dropped
+    ++readId;
+    table.clear(numRecords, length);
+    this->callback = std::move(callback);
+
+    if (requestPart(eid, 0, PLDM_GET_FIRSTPART) != PLDM_SUCCESS)
+    {
+        done(false);
+    }
+}
+
+int FruTableReader::requestPart(mctp_eid_t eid, uint32_t transferHandle,
+                                uint8_t transferOpFlag)
+{
+    auto instanceId = requester.getInstanceId(eid);
+    Request requestMsg(sizeof(pldm_msg_hdr) +
+                       PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES);
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    auto rc = encode_get_fru_record_table_req(
+        instanceId, transferHandle, transferOpFlag, request,
+        requestMsg.size() - sizeof(pldm_msg_hdr));
+    if (rc != PLDM_SUCCESS)
+    {
+        requester.markFree(eid, instanceId);
+        std::cerr << "Failed to encode_get_fru_record_table_req, rc = " << rc
+                  << std::endl;
+        return rc;
+    }
+
+    rc = handler->registerRequest(
+        eid, instanceId, PLDM_FRU, PLDM_GET_FRU_RECORD_TABLE,
+        std::move(requestMsg),
+        [this, id = readId](mctp_eid_t eid, const pldm_msg* response,
+                            size_t respMsgLen) {
+            processPart(eid, id, response, respMsgLen);
+        });
+    if (rc != PLDM_SUCCESS)
+    {
+        std::cerr << "Failed to send the GetFRURecordTable request\n";
+    }
+    return rc;
+}
+
+void FruTableReader::processPart(mctp_eid_t eid, size_t id,
+                                 const pldm_msg* response, size_t respMsgLen)
+{
+    if (id != readId)
+    {
+        return;
+    }
+    if (response == nullptr || !respMsgLen)
+    {
+        std::cerr << "Failed to receive response for the Get FRU Record "
+                     "Table\n";
+        done(false);
+        return;
+    }
+
+    uint8_t cc = 0;
+    uint32_t nextDataTransferHandle = 0;
+    uint8_t transferFlag = 0;
+    variable_field part{};
+    auto rc = decode_get_fru_record_table_resp_part(
+        response, respMsgLen, &cc, &nextDataTransferHandle, &transferFlag,
+        &part);
+    if (rc != PLDM_SUCCESS || cc != PLDM_SUCCESS)
+    {
+        std::cerr
+            << "Failed to decode get fru record table resp, Message Error: "
+            << "rc=" << rc << ",cc=" << (int)cc << std::endl;
+        done(false);
+        return;
+    }
+
+    if (!table.append(part.ptr, part.length))
+    {
+        std::cerr << "The FRU record table is longer than its length, "
+                  << table.size() + part.length << " bytes\n";
+        done(false);
+        return;
+    }
+
+    if (transferFlag == PLDM_END || transferFlag == PLDM_START_AND_END)
+    {
+        if (!table.complete())
+        {
+            std::cerr << "Failed to parse the FRU record table, "
+                      << table.getRecords().size() << " records in "
+                      << table.size() << " bytes\n";
+            done(false);
+            return;
+        }
+        if (!table.checksumValid())
+        {
+            std::cerr << "Bad checksum of the FRU record table, "
+                      << table.size() << " bytes\n";
+            done(false);
+            return;
+        }
+        done(true);
+        return;
+    }
+
+    if (!part.length)
+    {
+        std::cerr << "Empty part of the FRU record table\n";
+        done(false);
+        return;
+    }
+
+    if (requestPart(eid, nextDataTransferHandle, PLDM_GET_NEXTPART) !=
+        PLDM_SUCCESS)
+    {
+        done(false);
+    }
+}
+
+void FruTableReader::done(bool success)
+{
+    ++readId;
+    if (callback)
+    {
+        auto callback = std::move(this->callback);
+        this->callback = nullptr;
+        callback(success);
+    }
+}
+
+RecordSetIds
+    getRecordSetIds(const std::vector<std::vector<uint8_t>>& fruRecordSetPDRs)
+{
+    RecordSetIds recordSetIds;
+    recordSetIds.reserve(fruRecordSetPDRs.size());
+    for (const auto& pdr : fruRecordSetPDRs)
+    {
+        auto fruPdr = reinterpret_cast<const pldm_pdr_fru_record_set*>(
+            pdr.data() + sizeof(pldm_pdr_hdr));
+        pldm_entity entity{le16toh(fruPdr->entity_type),
+                           le16toh(fruPdr->entity_instance),
+                           le16toh(fruPdr->container_id)};
+        recordSetIds.emplace(entityKey(entity), le16toh(fruPdr->fru_rsi));
+    }
+    return recordSetIds;
+}
+
+LocationCodes getLocationCodes(const FruRecordTable& table)
+{
+    LocationCodes locationCodes;
+    for (const auto& record : table.getRecords())
+    {
+        if (record.recordType != PLDM_FRU_RECORD_TYPE_OEM)
+        {
+            continue;
+        }
+        for (size_t i = 0; i < record.numFields; ++i)
+        {
+            auto field = table.getField(record, i);
+            if (field.type == PLDM_OEM_FRU_FIELD_TYPE_LOCATION_CODE)
+            {
+                locationCodes[record.rsi].assign(
+                    reinterpret_cast<const char*>(field.value), field.length);
+            }
+        }
+    }
+    return locationCodes;
+}
+
+} // namespace hostbmc
+
+} // namespace pldm
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "libpldm/fru.h"
+#include "libpldm/pdr.h"
+
+#include "pldmd/dbus_impl_requester.hpp"
+#include "requester/handler.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pldm
+{
+
+namespace hostbmc
+{
+
+/** @class FruRecordTable
+ *
+ *  FRU record table of a terminus, kept flat as it was received with the
+ *  offsets of its records and fields. The table is parsed incrementally, the
+ *  records completed by each part are indexed as the part is appended.
+ */
+class FruRecordTable
+{
+  public:
+    /** @struct Record
+     *
+     *  A FRU record of the table
+     */
+    struct Record
+    {
+        uint32_t offset;      //!< offset of the record in the table
+        uint32_t firstField;  //!< index of the offset of its first field
+        uint16_t rsi;         //!< FRU record set identifier
+        uint8_t recordType;   //!< FRU record type
+        uint8_t numFields;    //!< number of FRU fields
+        uint8_t encodingType; //!< encoding type of the FRU fields
+    };
+
+    /** @struct Field
+     *
+     *  A FRU field of a record, the value points into the table and is valid
+     *  until the table is modified
+     */
+    struct Field
+    {
+        uint8_t type;         //!< FRU field type
+        uint8_t length;       //!< length of the value
+        const uint8_t* value; //!< value of the field
+    };
+
+    /** @brief Discard the table, to receive a new one
+     *
+     *  @param[in] numRecords - number of records of the new table, the bytes
+     *                          following them are the pad bytes and checksum
+     *  @param[in] length - length of the records and pad bytes of the new
+     *                      table, the checksum follows them
+     */
+    void clear(size_t numRecords, size_t length);
+
+    /** @brief Append a part of the table and parse the records it completes
+     *
+     *  @param[in] data - the part of the table
+     *  @param[in] length - size of the part
+     *
+     *  @return false if the part goes past the end of the table, it is not
+     *          appended then
+     */
+    bool append(const uint8_t* data, size_t length);
+
+    /** @brief Check if all the records of the table have been received */
+    bool complete() const
+    {
+        return records.size() == numRecords;
+    }
+
+    /** @brief Check if the whole table has been received, with the checksum
+     *         of its records and pad bytes
+     */
+    bool checksumValid() const;
+
+    /** @brief The records received so far, in the order of the table */
+    const std::vector<Record>& getRecords() const
+    {
+        return records;
+    }
+
+    /** @brief Get a field of a record
+     *
+     *  @param[in] record - the record
+     *  @param[in] index - index of the field in the record
+     *
+     *  @return the field
+     */
+    Field getField(const Record& record, size_t index) const;
+
+    /** @brief Size of the table received so far */
+    size_t size() const
+    {
+        return table.size();
+    }
+
+  private:
+    /** @brief Parse the records of the table completed so far */
+    void parse();
+
+    std::vector<uint8_t> table;         //!< the table as received
+    std::vector<Record> records;        //!< the records parsed
+    std::vector<uint32_t> fieldOffsets; //!< the offsets of the fields parsed
+    size_t parsed = 0;     //!< offset of the first record not parsed yet
+    size_t numRecords = 0; //!< number of records of the table
+    size_t length = 0;     //!< length of the records and pad bytes
+};
+
+/** @class FruTableReader
+ *
+ *  Reads the FRU record table of a terminus with GetFRURecordTable, part by
+ *  part, following the data transfer handles. The size of the parts is the
+ *  choice of the terminus, each part is parsed as it arrives.
+ */
+class FruTableReader
+{
+  public:
+    /** @brief Called once the table is read, with true if it was read whole */
+    using Callback = std::function<void(bool)>;
+
+    /** @brief Constructor
+     *
+     *  @param[in] requester - reference to Requester object
+     *  @param[in] handler - PLDM request handler
+     */
+    FruTableReader(pldm::dbus_api::Requester& requester,
+                   pldm::requester::Handler<pldm::requester::Request>* handler) :
+        requester(requester), handler(handler)
+    {}
+
+    /** @brief Read the FRU record table of a terminus, a read in progress is
+     *         abandoned. The read fails if the terminus sends more than the
+     *         table, or if the checksum of the table does not match.
+     *
+     *  @param[in] eid - MCTP endpoint ID of the terminus
+     *  @param[in] numRecords - number of records of the table, from the
+     *                          GetFRURecordTableMetadata response
+     *  @param[in] length - FRUTableLength of the table, from the
+     *                      GetFRURecordTableMetadata response
+     *  @param[in] callback - called once the table is read
+     */
+    void read(mctp_eid_t eid, size_t numRecords, size_t length,
+              Callback&& callback);
+
+    /** @brief The table read */
+    const FruRecordTable& getTable() const
+    {
+        return table;
+    }
+
+  private:
+    /** @brief Request a part of the table
+     *
+     *  @param[in] eid - MCTP endpoint ID of the terminus
+     *  @param[in] transferHandle - data transfer handle of the part
+     *  @param[in] transferOpFlag - PLDM_GET_FIRSTPART or PLDM_GET_NEXTPART
+     *
+     *  @return PLDM_SUCCESS if the request is sent
+     */
+    int requestPart(mctp_eid_t eid, uint32_t transferHandle,
+                    uint8_t transferOpFlag);
+
+    /** @brief Process a part of the table, request the next one if any */
+    void processPart(mctp_eid_t eid, size_t readId, const pldm_msg* response,
+                     size_t respMsgLen);
+
+    /** @brief End the read and call the callback */
+    void done(bool success);
+
+    pldm::dbus_api::Requester& requester;
+    pldm::requester::Handler<pldm::requester::Request>* handler;
+    FruRecordTable table;
+    Callback callback;
+    size_t readId = 0; //!< identifies the read the responses belong to
+};
+
+/** @brief Record set IDs of the FRU record set PDRs, keyed by entityKey */
+using RecordSetIds = std::unordered_map<uint64_t, uint16_t>;
+
+/** @brief Location codes of the FRU record sets, keyed by record set ID */
+using LocationCodes = std::unordered_map<uint16_t, std::string>;
+
+/** @brief Key identifying an entity in a FRU record set PDR
+ *
+ *  @param[in] entity - the entity
+ *
+ *  @return entity type, entity instance number and container ID of the entity
+ */
+inline uint64_t entityKey(const pldm_entity& entity)
+{
+    return (static_cast<uint64_t>(entity.entity_type) << 32) |
+           (static_cast<uint64_t>(entity.entity_instance_num) << 16) |
+           entity.entity_container_id;
+}
+
+/** @brief Index the FRU record set PDRs by the entity they describe
+ *
+ *  @param[in] fruRecordSetPDRs - the FRU record set PDRs
+ *
+ *  @return the record set ID of each entity, the first PDR of an entity wins
+ */
+RecordSetIds getRecordSetIds(
+    const std::vector<std::vector<uint8_t>>& fruRecordSetPDRs);
+
+/** @brief Collect the location codes of the OEM records of a FRU record table
+ *
+ *  @param[in] table - the FRU record table
+ *
+ *  @return the location code of each record set, the last one of a record set
+ *          wins
+ */
+LocationCodes getLocationCodes(const FruRecordTable& table);
+
+} // namespace hostbmc
+
+} // namespace pldm
@@ -99,6 +99,7 @@ HostPDRHandler::HostPDRHandler(
     bmcEntityTree(bmcEntityTree), hostEffecterParser(hostEffecterParser),
     requester(requester), handler(handler),
     associationsParser(associationsParser),
+    fruTableReader(requester, handler), stateSensorReader(requester, handler),
     oemPlatformHandler(oemPlatformHandler)
 {
     mergedHostParents = false;
@@ -140,7 +141,7 @@ HostPDRHandler::HostPDRHandler(
         pldm::utils::DBusHandler::getBus(),
         propertiesChanged("/xyz/openbmc_project/state/host0",
                           "xyz.openbmc_project.State.Host"),
-        [this, repo, entityTree, bmcEntityTree,
+        [this, repo, entityTree,
          oemPlatformHandler](sdbusplus::message::message& msg) {
             DbusChangedProps props{};
             std::string intf;
@@ -170,14 +171,19 @@ HostPDRHandler::HostPDRHandler(
                     // state of all the dbus objects to false
                     this->setPresenceFrus();
                     pldm_pdr_remove_remote_pdrs(repo);
-                    pldm_entity_association_tree_destroy_root(entityTree);
-                    pldm_entity_association_tree_copy_root(bmcEntityTree,
-                                                           entityTree);
+                    // The BMC entities stay as they are, the nodes the FRU
+                    // handler holds remain valid
+                    pldm_entity_association_tree_remove_remote_nodes(
+                        entityTree);
                     this->sensorMap.clear();
                     this->stateSensorPDRs.clear();
                     this->responseReceived = false;
                     this->mergedHostParents = false;
-                    this->objMapIndex = objPathMap.begin();
+                    // The host lost the states of its effecters
+                    if (this->hostEffecterParser)
+                    {
+                        this->hostEffecterParser->resetHostStates();
+                    }
                 }
                 else if (propVal ==
                          "xyz.openbmc_project.State.Host.HostState.Running")
@@ -1154,7 +1160,8 @@ void HostPDRHandler::getFRURecordTableMetadataByHost(
         }
 
         // pass total to getFRURecordTableByHost
-        this->getFRURecordTableByHost(total, fruRecordSetPDRs);
+        this->getFRURecordTableByHost(total, fru_table_length,
+                                      fruRecordSetPDRs);
     };
 
     rc = handler->registerRequest(
@@ -1171,150 +1178,81 @@ void HostPDRHandler::getFRURecordTableMetadataByHost(
 }
 
 void HostPDRHandler::getFRURecordTableByHost(uint16_t& total_table_records,
+                                             uint32_t fru_table_length,
                                              const PDRList& fruRecordSetPDRs)
 {
-    fruRecordData.clear();
-
     if (!total_table_records)
     {
         std::cerr << "Failed to get fru record table." << std::endl;
         return;
     }
 
-    auto instanceId = requester.getInstanceId(mctp_eid);
-    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
-                                    PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES);
-
-    // send the getFruRecordTable command
-    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
-    auto rc = encode_get_fru_record_table_req(
-        instanceId, 0, PLDM_GET_FIRSTPART, request,
-        requestMsg.size() - sizeof(pldm_msg_hdr));
-    if (rc != PLDM_SUCCESS)
-    {
-        requester.markFree(mctp_eid, instanceId);
-        std::cerr << "Failed to encode_get_fru_record_table_req, rc = " << rc
-                  << std::endl;
-        return;
-    }
+    // The table is read in the parts the host sends it in, and parsed as they
+    // arrive
+    fruTableReader.read(mctp_eid, total_table_records, fru_table_length,
+                        [this, fruRecordSetPDRs](bool success) {
+                            if (success)
+                            {
+                                this->setLocationCode(
+                                    fruRecordSetPDRs,
+                                    fruTableReader.getTable());
+                            }
+                        });
+}
 
-    auto getFruRecordTableResponseHandler = [total_table_records, this,
-                                             fruRecordSetPDRs](
-                                                mctp_eid_t /*eid*/,
-                                                const pldm_msg* response,
-                                                size_t respMsgLen) {
-        if (response == nullptr || !respMsgLen)
-        {
-            std::cerr << "Failed to receive response for the Get FRU Record "
-                         "Table\n";
-            return;
-        }
+void HostPDRHandler::setLocationCode(
+    const PDRList& fruRecordSetPDRs,
+    const hostbmc::FruRecordTable& fruRecordTable)
+{
+    // Join the entities with their record sets, and the record sets with
+    // their location codes, each side indexed once
+    auto recordSetIds = hostbmc::getRecordSetIds(fruRecordSetPDRs);
+    auto locationCodes = hostbmc::getLocationCodes(fruRecordTable);
 
-        uint8_t cc = 0;
-        uint32_t next_data_transfer_handle = 0;
-        uint8_t transfer_flag = 0;
-        size_t fru_record_table_length = 0;
-        std::vector<uint8_t> fru_record_table_data(respMsgLen -
-                                                   sizeof(pldm_msg_hdr));
-        auto responsePtr = reinterpret_cast<const struct pldm_msg*>(response);
-        auto rc = decode_get_fru_record_table_resp(
-            responsePtr, respMsgLen - sizeof(pldm_msg_hdr), &cc,
-            &next_data_transfer_handle, &transfer_flag,
-            fru_record_table_data.data(), &fru_record_table_length);
+    CustomDBus::getCustomDBus().deferPublication();
 
-        if (rc != PLDM_SUCCESS || cc != PLDM_SUCCESS)
+    for (const auto& [path, node] : objPathMap)
+    {
+        auto rsi = recordSetIds.find(
+            hostbmc::entityKey(pldm_entity_extract(node)));
+        if (rsi == recordSetIds.end())
         {
-            std::cerr
-                << "Failed to decode get fru record table resp, Message Error: "
-                << "rc=" << rc << ",cc=" << (int)cc << std::endl;
-            return;
+            continue;
         }
-
-        fruRecordData = responder::pdr_utils::parseFruRecordTable(
-            fru_record_table_data.data(), fru_record_table_length);
-
-        if (total_table_records != fruRecordData.size())
+        auto locationCode = locationCodes.find(rsi->second);
+        if (locationCode != locationCodes.end())
         {
-            fruRecordData.clear();
-
-            std::cerr << "failed to parse fru recrod data format.\n";
-            return;
+            CustomDBus::getCustomDBus().setLocationCode(path,
+                                                        locationCode->second);
         }
-
-        this->setLocationCode(fruRecordSetPDRs, fruRecordData);
-    };
-
-    rc = handler->registerRequest(
-        mctp_eid, instanceId, PLDM_FRU, PLDM_GET_FRU_RECORD_TABLE,
-        std::move(requestMsg), std::move(getFruRecordTableResponseHandler));
-    if (rc != PLDM_SUCCESS)
-    {
-        std::cerr
-            << "Failed to send the the Set State Effecter States request\n";
     }
-}
 
-void HostPDRHandler::getPresentStateBySensorReadigs(
-    uint16_t sensorId, uint16_t type, uint16_t instance, uint16_t containerId,
-    uint8_t state, const std::string& path, pldm::pdr::StateSetId stateSetId)
+    CustomDBus::getCustomDBus().publish();
+}
+void HostPDRHandler::setOperationStatus()
 {
+    // The objects are joined with the sensors of their entities up front, the
+    // readings are then requested a window at a time
+    auto readings = hostbmc::getSensorReadings(
+        objPathMap, sensorMap,
+        [this](const pldm::pdr::TerminusID& tid) { return getValidity(tid); });
+    stateSensorReader.read(
+        mctp_eid, std::move(readings),
+        [this](std::vector<hostbmc::StateSensorReader::Result>& results) {
+            applySensorReadings(results);
+        });
+}
 
-    auto instanceId = requester.getInstanceId(mctp_eid);
-    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
-                                    PLDM_GET_STATE_SENSOR_READINGS_REQ_BYTES);
+void HostPDRHandler::applySensorReadings(
+    const std::vector<hostbmc::StateSensorReader::Result>& results)
+{
+    CustomDBus::getCustomDBus().deferPublication();
 
-    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
-    bitfield8_t bf;
-    bf.byte = 0;
-    auto rc = encode_get_state_sensor_readings_req(instanceId, sensorId, bf, 0,
-                                                   request);
-    if (rc != PLDM_SUCCESS)
+    for (const auto& [reading, state] : results)
     {
-        requester.markFree(mctp_eid, instanceId);
-        std::cerr << "Failed to encode_get_state_sensor_readings_req, rc = "
-                  << rc << std::endl;
-        state = PLDM_OPERATIONAL_NON_RECOVERABLE_ERROR;
-        return;
-    }
-
-    state = PLDM_SENSOR_UNKNOWN;
-    auto getStateSensorReadingsResponseHandler = [this, path, type, instance,
-                                                  containerId, &state,
-                                                  stateSetId](
-                                                     mctp_eid_t /*eid*/,
-                                                     const pldm_msg* response,
-                                                     size_t respMsgLen) {
-        if (response == nullptr || !respMsgLen)
-        {
-            std::cerr << "Failed to receive response for the Get FRU Record "
-                         "Table\n";
-            return;
-        }
-
-        uint8_t cc = 0;
-        uint8_t sensorCnt = 0;
-        std::array<get_sensor_state_field, 8> stateField{};
-        auto responsePtr = reinterpret_cast<const struct pldm_msg*>(response);
-        auto rc = decode_get_state_sensor_readings_resp(
-            responsePtr, respMsgLen - sizeof(pldm_msg_hdr), &cc, &sensorCnt,
-            stateField.data());
-        if (rc != PLDM_SUCCESS || cc != PLDM_SUCCESS)
-        {
-            std::cerr << "Faile to decode get state sensor readings resp, "
-                         "Message Error: "
-                      << "rc=" << rc << ",cc=" << (int)cc << std::endl;
-            state = PLDM_OPERATIONAL_NON_RECOVERABLE_ERROR;
-            return;
-        }
-
-        for (const auto& filed : stateField)
-        {
-            state = filed.present_state;
-            break;
-        }
-
-        if (stateSetId == PLDM_STATE_SET_OPERATIONAL_FAULT_STATUS ||
-            stateSetId == PLDM_STATE_SET_HEALTH_STATE)
+        const auto& path = reading.path;
+        if (reading.stateSetId == PLDM_STATE_SET_OPERATIONAL_FAULT_STATUS ||
+            reading.stateSetId == PLDM_STATE_SET_HEALTH_STATE)
         {
             // set the dbus property only when its not a composite sensor
             // and the state set it PLDM_STATE_SET_OPERATIONAL_FAULT_STATUS
@@ -1323,14 +1261,13 @@ void HostPDRHandler::getPresentStateBySensorReadigs(
             CustomDBus::getCustomDBus().setOperationalStatus(
                 path, state == PLDM_OPERATIONAL_NORMAL, getParentChassis(path));
         }
-        else if (stateSetId == PLDM_STATE_SET_IDENTIFY_STATE)
+        else if (reading.stateSetId == PLDM_STATE_SET_IDENTIFY_STATE)
         {
             auto ledGroupPath = updateLedGroupPath(path);
             if (!ledGroupPath.empty())
             {
-                pldm_entity entity{type, instance, containerId};
                 CustomDBus::getCustomDBus().setAsserted(
-                    ledGroupPath, entity,
+                    ledGroupPath, reading.entity,
                     state == PLDM_STATE_SET_IDENTIFY_STATE_ASSERTED,
                     hostEffecterParser, mctp_eid);
                 std::vector<std::tuple<std::string, std::string, std::string>>
@@ -1339,154 +1276,9 @@ void HostPDRHandler::getPresentStateBySensorReadigs(
                 CustomDBus::getCustomDBus().setAssociations(path, associations);
             }
         }
-
-        ++sensorMapIndex;
-        if (sensorMapIndex == sensorMap.end())
-        {
-            // std::cerr << "sensor map completed\n";
-            ++objMapIndex;
-            sensorMapIndex = sensorMap.begin();
-        }
-        setOperationStatus();
-    };
-
-    rc = handler->registerRequest(
-        mctp_eid, instanceId, PLDM_PLATFORM, PLDM_GET_STATE_SENSOR_READINGS,
-        std::move(requestMsg),
-        std::move(getStateSensorReadingsResponseHandler));
-    if (rc != PLDM_SUCCESS)
-    {
-        std::cerr << "Failed to get the State Sensor Readings request\n";
-    }
-
-    return;
-}
-
-uint16_t HostPDRHandler::getRSI(const PDRList& fruRecordSetPDRs,
-                                const pldm_entity& entity)
-{
-    uint16_t fruRSI = 0;
-
-    for (const auto& pdr : fruRecordSetPDRs)
-    {
-        auto fruPdr = reinterpret_cast<const pldm_pdr_fru_record_set*>(
-            const_cast<uint8_t*>(pdr.data()) + sizeof(pldm_pdr_hdr));
-
-        if (fruPdr->entity_type == entity.entity_type &&
-            fruPdr->entity_instance == entity.entity_instance_num &&
-            fruPdr->container_id == entity.entity_container_id)
-        {
-            fruRSI = fruPdr->fru_rsi;
-            break;
-        }
     }
 
-    return fruRSI;
-}
-
-void HostPDRHandler::setLocationCode(
-    const PDRList& fruRecordSetPDRs,
-    const std::vector<responder::pdr_utils::FruRecordDataFormat>& fruRecordData)
-{
-    for (auto& entity : objPathMap)
-    {
-        pldm_entity node = pldm_entity_extract(entity.second);
-        auto fruRSI = getRSI(fruRecordSetPDRs, node);
-
-        for (auto& data : fruRecordData)
-        {
-            if (fruRSI != data.fruRSI)
-            {
-                continue;
-            }
-
-            if (data.fruRecType == PLDM_FRU_RECORD_TYPE_OEM)
-            {
-                for (auto& tlv : data.fruTLV)
-                {
-                    if (tlv.fruFieldType ==
-                        PLDM_OEM_FRU_FIELD_TYPE_LOCATION_CODE)
-                    {
-                        CustomDBus::getCustomDBus().setLocationCode(
-                            entity.first,
-                            std::string(reinterpret_cast<const char*>(
-                                            tlv.fruFieldValue.data()),
-                                        tlv.fruFieldLen));
-                    }
-                }
-            }
-        }
-    }
-}
-void HostPDRHandler::setOperationStatus()
-{
-    if (objMapIndex != objPathMap.end())
-    {
-
-        pldm_entity node = pldm_entity_extract(objMapIndex->second);
-
-        bool valid = getValidity(sensorMapIndex->first.terminusID);
-        if (valid)
-        {
-            pldm::pdr::EntityInfo entityInfo{};
-            pldm::pdr::CompositeSensorStates compositeSensorStates{};
-            std::vector<pldm::pdr::StateSetId> stateSetIds{};
-            std::tie(entityInfo, compositeSensorStates, stateSetIds) =
-                sensorMapIndex->second;
-            const auto& [containerId, entityType, entityInstance] = entityInfo;
-
-            if (node.entity_type == entityType &&
-                node.entity_instance_num == entityInstance &&
-                node.entity_container_id == containerId)
-            {
-                if ((stateSetIds[0] == PLDM_STATE_SET_HEALTH_STATE ||
-                     stateSetIds[0] == PLDM_STATE_SET_OPERATIONAL_FAULT_STATUS))
-                {
-                    uint8_t state = 0;
-                    // set the dbus property only when its not a
-                    // composite sensor and the state set it
-                    // PLDM_STATE_SET_OPERATIONAL_FAULT_STATUS Get
-                    // sensorOpState property by the
-                    // getStateSensorReadings command.
-
-                    getPresentStateBySensorReadigs(
-                        sensorMapIndex->first.sensorID, entityType,
-                        entityInstance, containerId, state, objMapIndex->first,
-                        stateSetIds[0]);
-                    return;
-                }
-                if (stateSetIds[0] == PLDM_STATE_SET_IDENTIFY_STATE)
-                {
-                    uint8_t state = 0;
-                    getPresentStateBySensorReadigs(
-                        sensorMapIndex->first.sensorID, entityType,
-                        entityInstance, containerId, state, objMapIndex->first,
-                        stateSetIds[0]);
-                    return;
-                }
-            }
-            else
-            {
-                ++sensorMapIndex;
-                if (sensorMapIndex == sensorMap.end())
-                {
-                    ++objMapIndex;
-                    sensorMapIndex = sensorMap.begin();
-                }
-                setOperationStatus();
-            }
-        }
-        else
-        {
-            ++sensorMapIndex;
-            if (sensorMapIndex == sensorMap.end())
-            {
-                ++objMapIndex;
-                sensorMapIndex = sensorMap.begin();
-            }
-            setOperationStatus();
-        }
-    }
+    CustomDBus::getCustomDBus().publish();
 }
 
 bool HostPDRHandler::getValidity(const pldm::pdr::TerminusID& tid)
@@ -1512,10 +1304,11 @@ void HostPDRHandler::setPresentPropertyStatus(const std::string& path)
 
 void HostPDRHandler::createDbusObjects(const PDRList& fruRecordSetPDRs)
 {
-    getFRURecordTableMetadataByHost(fruRecordSetPDRs);
-    objMapIndex = objPathMap.begin();
+    // Announce the objects of the host entities together, once they are all
+    // created, rather than one signal per interface
+    CustomDBus::getCustomDBus().deferPublication();
 
-    sensorMapIndex = sensorMap.begin();
+    getFRURecordTableMetadataByHost(fruRecordSetPDRs);
 
     // update xyz.openbmc_project.State.Decorator.OperationalStatus
     setOperationStatus();
@@ -1570,47 +1363,18 @@ void HostPDRHandler::createDbusObjects(const PDRList& fruRecordSetPDRs)
         }
     }
     this->setFRUDynamicAssociations();
+
+    CustomDBus::getCustomDBus().publish();
 }
 void HostPDRHandler::setFRUDynamicAssociations()
 {
-    for (const auto& [leftPath, leftElement] : objPathMap)
+    // One update per object, with all of its associations
+    auto fruAssociations = hostbmc::utils::getFRUAssociations(
+        objPathMap, associationsParser->associationsInfoMap);
+    for (auto& [path, associations] : fruAssociations)
     {
-        // for each path, compare it with rest of the paths in the
-        // map
-        pldm_entity leftEntity = pldm_entity_extract(leftElement);
-        uint16_t leftEntityType = leftEntity.entity_type;
-        for (const auto& [rightPath, rightElement] : objPathMap)
-        {
-            pldm_entity rightEntity = pldm_entity_extract(rightElement);
-            uint16_t rightEntityType = rightEntity.entity_type;
-            // if leftpath is same as rightPath
-            // then both dbus objects are same, so
-            // no need to create any associations
-            if (leftPath == rightPath)
-            {
-                continue;
-            }
-            else if ((rightPath.string().find(leftPath) != std::string::npos) ||
-                     (leftPath.string().find(rightPath) != std::string::npos))
-            {
-                // this means left path dbus object is parent of the
-                // right path dbus object, something like this
-                // leftpath = /xyz/openbmc_project/system/chassis15363
-                // rightpath = /xyz/openbmc_project/system/chassis15363/fan1
-                auto key = std::make_pair(leftEntityType, rightEntityType);
-                if (associationsParser->associationsInfoMap.contains(key))
-                {
-                    auto value = associationsParser->associationsInfoMap[key];
-                    // we have some associations defined for this parent type &
-                    // child type
-                    std::vector<
-                        std::tuple<std::string, std::string, std::string>>
-                        associations{{value.first, value.second, rightPath}};
-                    CustomDBus::getCustomDBus().setAssociations(leftPath,
-                                                                associations);
-                }
-            }
-        }
+        CustomDBus::getCustomDBus().setAssociations(path,
+                                                    std::move(associations));
     }
 }
 
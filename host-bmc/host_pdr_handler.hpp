@@ -8,6 +8,8 @@
 #include "common/utils.hpp"
 #include "dbus_to_host_effecters.hpp"
 #include "host_associations_parser.hpp"
+#include "host_fru_table.hpp"
+#include "host_state_sensors.hpp"
 #include "libpldmresponder/event_parser.hpp"
 #include "libpldmresponder/oem_handler.hpp"
 #include "libpldmresponder/pdr_utils.hpp"
@@ -32,30 +34,6 @@ using EntityType = uint16_t;
 using ChangeEntry = uint32_t;
 using PDRRecordHandles = std::deque<ChangeEntry>;
 
-/** @struct SensorEntry
- *
- *  SensorEntry is a unique key which maps a sensorEventType request in the
- *  PlatformEventMessage command to a host sensor PDR. This struct is a key
- *  in a std::map, so implemented operator==and operator<.
- */
-struct SensorEntry
-{
-    pdr::TerminusID terminusID;
-    pdr::SensorID sensorID;
-
-    bool operator==(const SensorEntry& e) const
-    {
-        return ((terminusID == e.terminusID) && (sensorID == e.sensorID));
-    }
-
-    bool operator<(const SensorEntry& e) const
-    {
-        return ((terminusID < e.terminusID) ||
-                ((terminusID == e.terminusID) && (sensorID < e.sensorID)));
-    }
-};
-
-using HostStateSensorMap = std::map<SensorEntry, pdr::SensorInfo>;
 using PDRList = std::vector<std::vector<uint8_t>>;
 
 /** @class HostPDRHandler
@@ -242,20 +220,23 @@ class HostPDRHandler
     /** @brief Set Location Code in the dbus objects
      *
      *  @param[in] fruRecordSetPDRs - the Fru Record set PDR's
-     *  @param[in] fruRecordData - the Fru Record Data
+     *  @param[in] fruRecordTable - the Fru Record table of the host
      */
 
-    void setLocationCode(
-        const PDRList& fruRecordSetPDRs,
-        const std::vector<responder::pdr_utils::FruRecordDataFormat>&
-            fruRecordData);
+    void setLocationCode(const PDRList& fruRecordSetPDRs,
+                         const hostbmc::FruRecordTable& fruRecordTable);
     void setFRUDynamicAssociations();
 
     /** @brief Get FRU record table by host
+     *
+     *  @param[in] total - number of records of the table
+     *  @param[in] fru_table_length - length of the table, without its
+     *                                checksum
+     *  @param[in] fruRecordSetPDRs - the FRU record set PDRs
      *
      *  @return
      */
-    void getFRURecordTableByHost(uint16_t& total,
+    void getFRURecordTableByHost(uint16_t& total, uint32_t fru_table_length,
                                  const PDRList& fruRecordSetPDRs);
 
     /** @brief Create DBUS objects
@@ -264,32 +245,18 @@ class HostPDRHandler
      */
     void createDbusObjects(const PDRList& fruRecordSetPDRs);
 
-    /** @brief Get FRU Record Set Identifier from FRU Record data Format
-     *  @param[in] fruRecordSetPDRs - fru record set pdr
-     *  @param[in] entity           - PLDM entity information
+    /** @brief Read the host state sensors of the objects, to set their
+     *         OperationalStatus and Identify LED group
      *  @return
      */
-    uint16_t getRSI(const PDRList& fruRecordSetPDRs, const pldm_entity& entity);
-
-    /** @brief Get present state from state sensor readings
-     *  @param[in] sensorId     - state sensor Id
-     *  @param[in] type         - entity type
-     *  @param[in] instance     - entity instance num
-     *  @param[in] containerId  - entity container id
-     *
-     *  @param[out] state     - pldm operational fault status
-     *  @param[in] path       - object path
-     *  @param[in] stateSetId - state set Id
-     */
-    void getPresentStateBySensorReadigs(uint16_t sensorId, uint16_t type,
-                                        uint16_t instance, uint16_t containerId,
-                                        uint8_t state, const std::string& path,
-                                        pldm::pdr::StateSetId stateSetId);
+    void setOperationStatus();
 
-    /** @brief Set the OperationalStatus interface
-     *  @return
+    /** @brief Set the OperationalStatus and Identify LED group of the objects
+     *         from a batch of state sensor readings
+     *  @param[in] results - the readings and the states read
      */
-    void setOperationStatus();
+    void applySensorReadings(
+        const std::vector<hostbmc::StateSensorReader::Result>& results);
     /** @brief Get the Validity of a Terminus ID
      *
      *  @param[out] bool - true if valid, false otherwise
@@ -317,16 +284,13 @@ class HostPDRHandler
      */
     sdeventplus::Event& event;
 
-    /** @brief iterator to track the entries in the objPathMap */
-    ObjectPathMaps::iterator objMapIndex;
-
-    HostStateSensorMap::iterator sensorMapIndex;
-
     /** @brief pointer to BMC's primary PDR repo, host PDRs are added here */
     pldm_pdr* repo;
 
     pldm::responder::events::StateSensorHandler stateSensorHandler;
-    /** @brief Pointer to BMC's and Host's entity association tree */
+    /** @brief Pointer to BMC's and Host's entity association tree, the host
+     *         entities are removed when the host is powered off
+     */
     pldm_entity_association_tree* entityTree;
 
     /** @brief Pointer to BMC's entity association tree */
@@ -395,9 +359,12 @@ class HostPDRHandler
      */
     EntityAssociations entityAssociations;
 
-    /** @brief the vector of FRU Record Data Format
+    /** @brief Reads the FRU record table of the host
      */
-    std::vector<responder::pdr_utils::FruRecordDataFormat> fruRecordData;
+    hostbmc::FruTableReader fruTableReader;
+
+    /** @brief Reads the host state sensors of the objects */
+    hostbmc::StateSensorReader stateSensorReader;
 
     /** @OEM platform handler */
     pldm::responder::oem_platform::Handler* oemPlatformHandler;
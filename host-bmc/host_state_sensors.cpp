@@ -0,0 +1,218 @@
+#include "host_state_sensors.hpp"
+
+#include "libpldm/state_set.h"
+
+#include "host_fru_table.hpp"
+
+#include <array>
+#include <iostream>
+#include <unordered_map>
+
+namespace pldm
+{
+
+namespace hostbmc
+{
+
+std::vector<SensorReading> getSensorReadings(
+    const ObjectPathMaps& objPathMap, const HostStateSensorMap& sensorMap,
+    const std::function<bool(const pdr::TerminusID&)>& isValid)
+{
+    // Index the sensors to read by their entity
+    std::unordered_map<uint64_t,
+                       std::vector<HostStateSensorMap::const_pointer>>
+        entitySensors;
+    std::unordered_map<pdr::TerminusID, bool> validity;
+    for (const auto& sensor : sensorMap)
+    {
+        const auto& [entry, sensorInfo] = sensor;
+        const auto& [entityInfo, compositeSensorStates, stateSetIds] =
+            sensorInfo;
+        if (stateSetIds.empty() ||
+            (stateSetIds[0] != PLDM_STATE_SET_HEALTH_STATE &&
+             stateSetIds[0] != PLDM_STATE_SET_OPERATIONAL_FAULT_STATUS &&
+             stateSetIds[0] != PLDM_STATE_SET_IDENTIFY_STATE))
+        {
+            continue;
+        }
+
+        auto valid = validity.find(entry.terminusID);
+        if (valid == validity.end())
+        {
+            valid =
+                validity.emplace(entry.terminusID, isValid(entry.terminusID))
+                    .first;
+        }
+        if (!valid->second)
+        {
+            continue;
+        }
+
+        const auto& [containerId, entityType, entityInstance] = entityInfo;
+        entitySensors[entityKey({entityType, entityInstance, containerId})]
+            .push_back(&sensor);
+    }
+
+    std::vector<SensorReading> readings;
+    for (const auto& [path, node] : objPathMap)
+    {
+        auto entity = pldm_entity_extract(node);
+        auto sensors = entitySensors.find(entityKey(entity));
+        if (sensors == entitySensors.end())
+        {
+            continue;
+        }
+        for (auto sensor : sensors->second)
+        {
+            readings.push_back({sensor->first.sensorID,
+                                std::get<2>(sensor->second)[0], entity, path});
+        }
+    }
+    return readings;
+}
+
+StateSensorReader::StateSensorReader(
+    pldm::dbus_api::Requester& requester,
+    pldm::requester::Handler<pldm::requester::Request>* handler,
+    size_t maxInFlight) :
+    requester(requester),
+    handler(handler), maxInFlight(maxInFlight),
+    request(PLDM_PLATFORM, PLDM_GET_STATE_SENSOR_READINGS,
+            PLDM_GET_STATE_SENSOR_READINGS_REQ_BYTES)
+{
+    // Only the sensor ID differs between the requests
+    request.encode([](uint8_t instanceId, pldm_msg* msg) {
+        bitfield8_t rearm{};
+        return encode_get_state_sensor_readings_req(instanceId, 0, rearm, 0,
+                                                    msg);
+    });
+}
+
+void StateSensorReader::read(mctp_eid_t eid,
+                             std::vector<SensorReading>&& readings,
+                             BatchCallback&& callback)
+{
+    // The responses to an abandoned read are dropped
+    ++readId;
+    this->eid = eid;
+    this->readings = std::move(readings);
+    this->callback = std::move(callback);
+    batch.clear();
+    next = 0;
+    inFlight = 0;
+
+    handler->reserveSlots(eid);
+    fillWindow();
+}
+
+void StateSensorReader::fillWindow()
+{
+    while (inFlight < maxInFlight && next < readings.size())
+    {
+        auto rc = requestReading(next);
+        if (rc == PLDM_ERROR_NOT_READY)
+        {
+            // No instance ID is free, the next response frees one
+            if (!inFlight)
+            {
+                std::cerr << "No instance ID to read the host state sensors, "
+                          << readings.size() - next << " readings dropped\n";
+                next = readings.size();
+            }
+            break;
+        }
+        ++next;
+        if (rc == PLDM_SUCCESS)
+        {
+            ++inFlight;
+        }
+    }
+
+    if (!busy() || batch.size() >= maxInFlight)
+    {
+        flush();
+    }
+}
+
+int StateSensorReader::requestReading(size_t index)
+{
+    uint8_t instanceId = 0;
+    try
+    {
+        instanceId = requester.getInstanceId(eid);
+    }
+    catch (const std::exception& e)
+    {
+        return PLDM_ERROR_NOT_READY;
+    }
+
+    request.setField<uint16_t>(0, readings[index].sensorID);
+
+    auto rc = handler->registerRequest(
+        eid, instanceId, request,
+        [this, id = readId, index](mctp_eid_t /*eid*/,
+                                   const pldm_msg* response,
+                                   size_t respMsgLen) {
+            processReading(id, index, response, respMsgLen);
+        });
+    if (rc != PLDM_SUCCESS)
+    {
+        std::cerr << "Failed to get the State Sensor Readings request\n";
+    }
+    return rc;
+}
+
+void StateSensorReader::processReading(size_t id, size_t index,
+                                       const pldm_msg* response,
+                                       size_t respMsgLen)
+{
+    if (id != readId)
+    {
+        return;
+    }
+    --inFlight;
+
+    if (response == nullptr || !respMsgLen)
+    {
+        std::cerr << "Failed to receive response for the Get State Sensor "
+                     "Readings, sensor ID = "
+                  << readings[index].sensorID << "\n";
+        fillWindow();
+        return;
+    }
+
+    uint8_t cc = 0;
+    uint8_t sensorCnt = 0;
+    std::array<get_sensor_state_field, 8> stateField{};
+    auto rc = decode_get_state_sensor_readings_resp(
+        response, respMsgLen, &cc, &sensorCnt, stateField.data());
+    if (rc != PLDM_SUCCESS || cc != PLDM_SUCCESS)
+    {
+        std::cerr << "Failed to decode get state sensor readings resp, "
+                     "Message Error: "
+                  << "rc=" << rc << ",cc=" << (int)cc << std::endl;
+    }
+    else
+    {
+        batch.emplace_back(readings[index], stateField[0].present_state);
+    }
+
+    fillWindow();
+}
+
+void StateSensorReader::flush()
+{
+    if (batch.empty() || !callback)
+    {
+        return;
+    }
+    // The callback may start another read
+    auto results = std::move(batch);
+    batch.clear();
+    auto batchCallback = callback;
+    batchCallback(results);
+}
+
+} // namespace hostbmc
+
+} // namespace pldm
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "libpldm/pdr.h"
+#include "libpldm/platform.h"
+
+#include "common/types.hpp"
+#include "pldmd/dbus_impl_requester.hpp"
+#include "requester/handler.hpp"
+#include "requester/prepared_request.hpp"
+#include "utils.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pldm
+{
+
+/** @struct SensorEntry
+ *
+ *  SensorEntry is a unique key which maps a sensorEventType request in the
+ *  PlatformEventMessage command to a host sensor PDR. This struct is a key
+ *  in a std::map, so implemented operator==and operator<.
+ */
+struct SensorEntry
+{
+    pdr::TerminusID terminusID;
+    pdr::SensorID sensorID;
+
+    bool operator==(const SensorEntry& e) const
+    {
+        return ((terminusID == e.terminusID) && (sensorID == e.sensorID));
+    }
+
+    bool operator<(const SensorEntry& e) const
+    {
+        return ((terminusID < e.terminusID) ||
+                ((terminusID == e.terminusID) && (sensorID < e.sensorID)));
+    }
+};
+
+using HostStateSensorMap = std::map<SensorEntry, pdr::SensorInfo>;
+
+namespace hostbmc
+{
+
+/** @struct SensorReading
+ *
+ *  A host state sensor to read, and the object path of its entity
+ */
+struct SensorReading
+{
+    pdr::SensorID sensorID;     //!< state sensor ID
+    pdr::StateSetId stateSetId; //!< state set of the first sensor
+    pldm_entity entity;         //!< entity of the sensor
+    std::string path;           //!< object path of the entity
+};
+
+/** @brief Work out the state sensors to read for the objects of the host
+ *         entities
+ *
+ *  The objects are matched with the sensors of their entities that report
+ *  the operational fault status, the health state or the identify state,
+ *  rather than every object being compared with every sensor.
+ *
+ *  @param[in] objPathMap - maps an object path to pldm_entity from the BMC's
+ *                          entity association tree
+ *  @param[in] sensorMap - the host state sensors
+ *  @param[in] isValid - whether the PDRs of a terminus are valid, the sensors
+ *                       of invalid termini are not read
+ *
+ *  @return the readings, in the order of the object paths
+ */
+std::vector<SensorReading> getSensorReadings(
+    const ObjectPathMaps& objPathMap, const HostStateSensorMap& sensorMap,
+    const std::function<bool(const pdr::TerminusID&)>& isValid);
+
+/** @class StateSensorReader
+ *
+ *  Reads host state sensors with GetStateSensorReadings, keeping a bounded
+ *  number of requests in flight. The readings are handed over in batches, so
+ *  the D-Bus updates they lead to can be published together.
+ */
+class StateSensorReader
+{
+  public:
+    /** @brief A reading and the present state of its first sensor */
+    using Result = std::pair<SensorReading, uint8_t>;
+
+    /** @brief Called with each batch of the readings received */
+    using BatchCallback = std::function<void(std::vector<Result>&)>;
+
+    /** @brief Constructor
+     *
+     *  @param[in] requester - reference to Requester object
+     *  @param[in] handler - PLDM request handler
+     *  @param[in] maxInFlight - number of requests in flight at most, also the
+     *                           size of the batches
+     */
+    StateSensorReader(
+        pldm::dbus_api::Requester& requester,
+        pldm::requester::Handler<pldm::requester::Request>* handler,
+        size_t maxInFlight = 8);
+
+    /** @brief Read the state sensors of a terminus, a read in progress is
+     *         abandoned
+     *
+     *  @param[in] eid - MCTP endpoint ID of the terminus
+     *  @param[in] readings - the sensors to read
+     *  @param[in] callback - called with each batch of readings, the failed
+     *                        readings are left out
+     */
+    void read(mctp_eid_t eid, std::vector<SensorReading>&& readings,
+              BatchCallback&& callback);
+
+    /** @brief Check if readings are awaited */
+    bool busy() const
+    {
+        return inFlight || next < readings.size();
+    }
+
+  private:
+    /** @brief Send requests until the window is full or all are sent */
+    void fillWindow();
+
+    /** @brief Send the request of a reading
+     *
+     *  @param[in] index - index of the reading
+     *
+     *  @return PLDM_SUCCESS if the request is sent
+     */
+    int requestReading(size_t index);
+
+    /** @brief Process the response of a reading, and send the next requests
+     */
+    void processReading(size_t id, size_t index, const pldm_msg* response,
+                        size_t respMsgLen);
+
+    /** @brief Hand over the batch of readings received */
+    void flush();
+
+    pldm::dbus_api::Requester& requester;
+    pldm::requester::Handler<pldm::requester::Request>* handler;
+    size_t maxInFlight;
+    pldm::requester::PreparedRequest request; //!< GetStateSensorReadings
+    mctp_eid_t eid = 0;
+    std::vector<SensorReading> readings;
+    BatchCallback callback;
+    std::vector<Result> batch; //!< the readings received, not handed over
+    size_t next = 0;           //!< index of the next reading to request
+    size_t inFlight = 0;       //!< number of requests awaiting response
+    size_t readId = 0;         //!< identifies the read the responses belong to
+};
+
+} // namespace hostbmc
+
+} // namespace pldm
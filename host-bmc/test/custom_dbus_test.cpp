@@ -1,8 +1,16 @@
 #include "../custom_dbus.hpp"
 
+#include <sdbusplus/test/sdbus_mock.hpp>
+
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 using namespace pldm::dbus;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::StrEq;
 TEST(CustomDBus, LocationCode)
 {
     std::string tmpPath = "/abc/def";
@@ -34,3 +42,85 @@ TEST(CustomDBus, OperationalStatus)
     EXPECT_EQ(status, true);
     EXPECT_EQ(retStatus, true);
 }
+
+/** @brief Count the signals emitted on a mocked bus */
+class SignalCount
+{
+  public:
+    explicit SignalCount(NiceMock<sdbusplus::SdBusMock>& sdbusMock)
+    {
+        ON_CALL(sdbusMock, sd_bus_emit_object_added(_, _))
+            .WillByDefault(Invoke([this](sd_bus*, const char*) {
+                ++interfacesAdded;
+                return 0;
+            }));
+        ON_CALL(sdbusMock, sd_bus_emit_interfaces_added_strv(_, _, _))
+            .WillByDefault(Invoke([this](sd_bus*, const char*, char**) {
+                ++interfacesAdded;
+                return 0;
+            }));
+        ON_CALL(sdbusMock, sd_bus_emit_properties_changed_strv(_, _, _, _))
+            .WillByDefault(
+                Invoke([this](sd_bus*, const char*, const char*, char**) {
+                    ++propertiesChanged;
+                    return 0;
+                }));
+    }
+
+    size_t interfacesAdded = 0;
+    size_t propertiesChanged = 0;
+};
+
+/** @brief Implement the interfaces of a host FRU */
+static void implementFru(CustomDBus& customDBus, const std::string& path)
+{
+    customDBus.updateItemPresentStatus(path, true);
+    customDBus.implementFanInterface(path);
+    customDBus.setLocationCode(path, "U78DA.ND0.1234567-A0");
+    customDBus.setOperationalStatus(path, true, "");
+    customDBus.setAssociations(
+        path, {{"chassis", "all_fans", "/xyz/openbmc_project/inventory/sys"}});
+}
+
+TEST(CustomDBus, DeferredPublication)
+{
+    NiceMock<sdbusplus::SdBusMock> sdbusMock;
+    auto bus = sdbusplus::get_mocked_new(&sdbusMock);
+    SignalCount count(sdbusMock);
+    CustomDBus customDBus(bus);
+
+    std::string fan0 = "/xyz/openbmc_project/inventory/sys/fan0";
+    std::string fan1 = "/xyz/openbmc_project/inventory/sys/fan1";
+    customDBus.deferPublication();
+    implementFru(customDBus, fan0);
+    implementFru(customDBus, fan1);
+    EXPECT_EQ(count.interfacesAdded, 0);
+    EXPECT_EQ(count.propertiesChanged, 0);
+    EXPECT_EQ(customDBus.getLocationCode(fan0), "U78DA.ND0.1234567-A0");
+    EXPECT_EQ(customDBus.getOperationalStatus(fan1), true);
+
+    // One signal per object, with all of its interfaces
+    size_t interfaces = 0;
+    EXPECT_CALL(sdbusMock,
+                sd_bus_emit_interfaces_added_strv(_, StrEq(fan0), _))
+        .WillOnce(Invoke([&interfaces](sd_bus*, const char*, char** strv) {
+            for (; *strv; ++strv)
+            {
+                ++interfaces;
+            }
+            return 0;
+        }));
+    EXPECT_CALL(sdbusMock,
+                sd_bus_emit_interfaces_added_strv(_, StrEq(fan1), _))
+        .WillOnce(Return(0));
+    customDBus.publish();
+    EXPECT_EQ(interfaces, 5);
+
+    // Published already, a new value is signalled and the interfaces
+    // implemented afterwards are announced straight away
+    customDBus.setLocationCode(fan0, "U78DA.ND0.1234567-A1");
+    EXPECT_EQ(count.propertiesChanged, 1);
+    EXPECT_CALL(sdbusMock, sd_bus_emit_object_added(_, StrEq(fan0)))
+        .WillOnce(Return(0));
+    customDBus.setAvailabilityState(fan0, true);
+}
@@ -1,9 +1,17 @@
+#include "libpldm/platform.h"
+
 #include "common/test/mocked_utils.hpp"
+#include "common/transport.hpp"
 #include "common/utils.hpp"
 #include "host-bmc/dbus_to_host_effecters.hpp"
+#include "host-bmc/test/fake_host.hpp"
 
 #include <nlohmann/json.hpp>
+#include <sdeventplus/event.hpp>
 
+#include <array>
+#include <chrono>
+#include <functional>
 #include <iostream>
 
 #include <gtest/gtest.h>
@@ -11,24 +19,27 @@
 using namespace pldm::host_effecters;
 using namespace pldm::utils;
 using namespace pldm::dbus_api;
+using namespace std::chrono;
 
 class MockHostEffecterParser : public HostEffecterParser
 {
   public:
     MockHostEffecterParser(int fd, const pldm_pdr* repo,
                            DBusHandler* const dbusHandler,
-                           const std::string& jsonPath) :
-        HostEffecterParser(nullptr, fd, repo, dbusHandler, jsonPath, nullptr)
+                           const std::string& jsonPath,
+                           sdeventplus::Event& event) :
+        HostEffecterParser(nullptr, fd, repo, dbusHandler, jsonPath, nullptr,
+                           event)
     {}
 
-    MOCK_METHOD(void, setHostStateEffecter,
+    MOCK_METHOD(int, setHostStateEffecter,
                 (size_t, std::vector<set_effecter_state_field>&, uint16_t),
-                (const override));
+                (override));
 
     MOCK_METHOD(void, createHostEffecterMatch,
                 (const std::string&, const std::string&, size_t, size_t,
                  uint16_t),
-                (const override));
+                (override));
 
     const std::vector<EffecterInfo>& gethostEffecterInfo()
     {
@@ -40,8 +51,9 @@ TEST(HostEffecterParser, parseEffecterJsonGoodPath)
 {
     MockdBusHandler dbusHandler;
     int sockfd{};
-    MockHostEffecterParser hostEffecterParserGood(sockfd, nullptr, &dbusHandler,
-                                                  "./host_effecter_jsons/good");
+    auto event = sdeventplus::Event::get_default();
+    MockHostEffecterParser hostEffecterParserGood(
+        sockfd, nullptr, &dbusHandler, "./host_effecter_jsons/good", event);
     auto hostEffecterInfo = hostEffecterParserGood.gethostEffecterInfo();
     ASSERT_EQ(hostEffecterInfo.size(), 1);
     ASSERT_EQ(hostEffecterInfo[0].entityInstance, 0);
@@ -63,8 +75,9 @@ TEST(HostEffecterParser, parseEffecterJsonBadPath)
 {
     MockdBusHandler dbusHandler;
     int sockfd{};
-    MockHostEffecterParser hostEffecterParser(sockfd, nullptr, &dbusHandler,
-                                              "./host_effecter_jsons/no_json");
+    auto event = sdeventplus::Event::get_default();
+    MockHostEffecterParser hostEffecterParser(
+        sockfd, nullptr, &dbusHandler, "./host_effecter_jsons/no_json", event);
     ASSERT_THROW(
         hostEffecterParser.parseEffecterJson("./host_effecter_jsons/no_json"),
         std::exception);
@@ -77,8 +90,9 @@ TEST(HostEffecterParser, findNewStateValue)
 {
     MockdBusHandler dbusHandler;
     int sockfd{};
-    MockHostEffecterParser hostEffecterParser(sockfd, nullptr, &dbusHandler,
-                                              "./host_effecter_jsons/good");
+    auto event = sdeventplus::Event::get_default();
+    MockHostEffecterParser hostEffecterParser(
+        sockfd, nullptr, &dbusHandler, "./host_effecter_jsons/good", event);
 
     PropertyValue val1{std::in_place_type<std::string>,
                        "xyz.openbmc_project.Control.Boot.Mode.Modes.Regular"};
@@ -90,3 +104,260 @@ TEST(HostEffecterParser, findNewStateValue)
     ASSERT_THROW(hostEffecterParser.findNewStateValue(0, 0, val2),
                  std::exception);
 }
+
+class TestHostEffecterParser : public HostEffecterParser
+{
+  public:
+    TestHostEffecterParser(
+        Requester* requester,
+        pldm::requester::Handler<pldm::requester::Request>* handler,
+        sdeventplus::Event& event, milliseconds window) :
+        HostEffecterParser(requester, 0, nullptr, nullptr, "", handler, event,
+                           window)
+    {}
+
+    void createHostEffecterMatch(const std::string&, const std::string&,
+                                 size_t, size_t, uint16_t) override
+    {}
+};
+
+class HostEffecterCoalesceTest : public testing::Test
+{
+  protected:
+    HostEffecterCoalesceTest() :
+        event(sdeventplus::Event::get_default()), bmc(1), host(hostEid),
+        fakeHost(host, [this](const pldm_msg* request, size_t payloadLength,
+                              std::vector<uint8_t>& response) {
+            answerEffecterWrite(request, payloadLength, response);
+        }),
+        dbusImplReq(DBusHandler::getBus(), "/xyz/openbmc_project/pldm"),
+        handler(bmc, event, dbusImplReq, false, seconds(1), 0,
+                milliseconds(100)),
+        parser(&dbusImplReq, &handler, event, milliseconds(5))
+    {
+        bmc.connect(host);
+    }
+
+    /** @brief Run the event loop, the host and the BMC responses for the
+     *         given time
+     */
+    void run(milliseconds duration)
+    {
+        auto end = steady_clock::now() + duration;
+        while (steady_clock::now() < end)
+        {
+            sd_event_run(event.get(), 1000);
+            fakeHost.serve();
+            pldm::test::handleResponses(bmc, handler);
+        }
+    }
+
+    /** @brief Answer SetStateEffecterStates and record the request */
+    void answerEffecterWrite(const pldm_msg* request, size_t payloadLength,
+                             std::vector<uint8_t>& response)
+    {
+        uint16_t effecterId{};
+        uint8_t compEffCnt{};
+        std::array<set_effecter_state_field, 8> stateField{};
+        ASSERT_EQ(decode_set_state_effecter_states_req(
+                      request, payloadLength, &effecterId, &compEffCnt,
+                      stateField.data()),
+                  PLDM_SUCCESS);
+        requests.emplace_back(effecterId,
+                              std::vector<set_effecter_state_field>(
+                                  stateField.begin(),
+                                  stateField.begin() + compEffCnt));
+
+        response.resize(sizeof(pldm_msg_hdr) +
+                         PLDM_SET_STATE_EFFECTER_STATES_RESP_BYTES);
+        encode_set_state_effecter_states_resp(
+            request->hdr.instance_id, completionCode,
+            reinterpret_cast<pldm_msg*>(response.data()));
+    }
+
+    /** @brief Write a state to one of the composite effecters */
+    void write(uint16_t effecterId, uint8_t compEffCnt, uint8_t index,
+               uint8_t state, std::function<bool(bool)> callBack = nullptr)
+    {
+        std::vector<set_effecter_state_field> stateField(
+            compEffCnt, {PLDM_NO_CHANGE, 0});
+        stateField[index] = {PLDM_REQUEST_SET, state};
+        EXPECT_EQ(parser.sendSetStateEffecterStates(hostEid, effecterId,
+                                                    compEffCnt, stateField,
+                                                    callBack, true),
+                  PLDM_SUCCESS);
+    }
+
+    static constexpr mctp_eid_t hostEid = 9;
+    sdeventplus::Event event;
+    pldm::transport::Loopback bmc;
+    pldm::transport::Loopback host;
+    pldm::test::FakeHost fakeHost;
+    uint8_t completionCode = PLDM_SUCCESS; //!< completion code of the host
+    /** @brief SetStateEffecterStates requests the host got */
+    std::vector<std::pair<uint16_t, std::vector<set_effecter_state_field>>>
+        requests;
+    Requester dbusImplReq;
+    pldm::requester::Handler<pldm::requester::Request> handler;
+    TestHostEffecterParser parser;
+};
+
+TEST_F(HostEffecterCoalesceTest, burstFoldedIntoOneRequest)
+{
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        write(4, 2, 0, i % 2 ? 1 : 2);
+    }
+    write(4, 2, 1, 3);
+    run(milliseconds(50));
+
+    ASSERT_EQ(requests.size(), 1);
+    auto& [effecterId, stateField] = requests[0];
+    EXPECT_EQ(effecterId, 4);
+    ASSERT_EQ(stateField.size(), 2);
+    EXPECT_EQ(stateField[0].set_request, PLDM_REQUEST_SET);
+    EXPECT_EQ(stateField[0].effecter_state, 1);
+    EXPECT_EQ(stateField[1].set_request, PLDM_REQUEST_SET);
+    EXPECT_EQ(stateField[1].effecter_state, 3);
+}
+
+TEST_F(HostEffecterCoalesceTest, effectersNotMerged)
+{
+    write(4, 1, 0, 2);
+    write(5, 1, 0, 2);
+    run(milliseconds(50));
+    EXPECT_EQ(requests.size(), 2);
+}
+
+TEST_F(HostEffecterCoalesceTest, requestReusedAcrossWrites)
+{
+    write(4, 2, 0, 2);
+    run(milliseconds(50));
+    write(4, 2, 1, 3);
+    run(milliseconds(50));
+    // A write with more composite effecters than the request was prepared
+    // with
+    write(4, 3, 2, 1);
+    run(milliseconds(50));
+
+    ASSERT_EQ(requests.size(), 3);
+    const auto& second = requests[1].second;
+    ASSERT_EQ(second.size(), 2);
+    EXPECT_EQ(second[0].set_request, PLDM_NO_CHANGE);
+    EXPECT_EQ(second[1].set_request, PLDM_REQUEST_SET);
+    EXPECT_EQ(second[1].effecter_state, 3);
+    const auto& third = requests[2].second;
+    ASSERT_EQ(third.size(), 3);
+    EXPECT_EQ(third[0].set_request, PLDM_NO_CHANGE);
+    EXPECT_EQ(third[1].set_request, PLDM_NO_CHANGE);
+    EXPECT_EQ(third[2].set_request, PLDM_REQUEST_SET);
+    EXPECT_EQ(third[2].effecter_state, 1);
+}
+
+TEST_F(HostEffecterCoalesceTest, noOpWritesDropped)
+{
+    size_t called = 0;
+    auto callBack = [&called](bool) {
+        called++;
+        return true;
+    };
+
+    write(4, 1, 0, 2, callBack);
+    run(milliseconds(50));
+    ASSERT_EQ(requests.size(), 1);
+    EXPECT_EQ(called, 1);
+
+    // The host already has the state
+    write(4, 1, 0, 2, callBack);
+    run(milliseconds(50));
+    EXPECT_EQ(requests.size(), 1);
+    EXPECT_EQ(called, 2);
+
+    // Flipped and back within the window
+    write(4, 1, 0, 1);
+    write(4, 1, 0, 2);
+    run(milliseconds(50));
+    EXPECT_EQ(requests.size(), 1);
+}
+
+TEST_F(HostEffecterCoalesceTest, failedWriteNotDropped)
+{
+    completionCode = PLDM_ERROR;
+    write(4, 1, 0, 2);
+    run(milliseconds(50));
+    ASSERT_EQ(requests.size(), 1);
+
+    // The host failed to set the state, so the same write is sent again
+    completionCode = PLDM_SUCCESS;
+    write(4, 1, 0, 2);
+    run(milliseconds(50));
+    EXPECT_EQ(requests.size(), 2);
+}
+
+TEST_F(HostEffecterCoalesceTest, writeSentAgainAfterHostOff)
+{
+    write(4, 2, 0, 2);
+    write(4, 2, 1, 3);
+    write(5, 1, 0, 1);
+    run(milliseconds(50));
+    ASSERT_EQ(requests.size(), 2);
+
+    // The host powered off lost the states, the same writes are sent again
+    parser.resetHostStates();
+    write(4, 2, 0, 2);
+    write(5, 1, 0, 1);
+    run(milliseconds(50));
+    ASSERT_EQ(requests.size(), 4);
+    EXPECT_EQ(requests[2].second[0].set_request, PLDM_REQUEST_SET);
+    EXPECT_EQ(requests[2].second[1].set_request, PLDM_NO_CHANGE);
+    EXPECT_EQ(requests[3].second[0].effecter_state, 1);
+
+    // Known again once sent
+    write(4, 2, 0, 2);
+    run(milliseconds(50));
+    EXPECT_EQ(requests.size(), 4);
+}
+
+TEST_F(HostEffecterCoalesceTest, resetWithRequestInFlight)
+{
+    write(4, 1, 0, 1);
+    // Let the window end without the host answering
+    auto end = steady_clock::now() + milliseconds(20);
+    while (steady_clock::now() < end)
+    {
+        sd_event_run(event.get(), 1000);
+    }
+
+    parser.resetHostStates();
+    run(milliseconds(50));
+    ASSERT_EQ(requests.size(), 1);
+
+    write(4, 1, 0, 1);
+    run(milliseconds(50));
+    EXPECT_EQ(requests.size(), 2);
+}
+
+TEST_F(HostEffecterCoalesceTest, writesInOrderWithRequestInFlight)
+{
+    write(4, 1, 0, 1);
+    // Let the window end without the host answering
+    auto end = steady_clock::now() + milliseconds(20);
+    while (steady_clock::now() < end)
+    {
+        sd_event_run(event.get(), 1000);
+    }
+
+    // Held back until the response to the request in flight
+    write(4, 1, 0, 2);
+    write(4, 1, 0, 3);
+    end = steady_clock::now() + milliseconds(20);
+    while (steady_clock::now() < end)
+    {
+        sd_event_run(event.get(), 1000);
+    }
+
+    run(milliseconds(50));
+    ASSERT_EQ(requests.size(), 2);
+    EXPECT_EQ(requests[0].second[0].effecter_state, 1);
+    EXPECT_EQ(requests[1].second[0].effecter_state, 3);
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "libpldm/base.h"
+
+#include "common/transport.hpp"
+#include "requester/handler.hpp"
+#include "requester/request.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace pldm
+{
+namespace test
+{
+
+/** @class FakeHost
+ *
+ *  Host end of a loopback transport, answers each request it receives after
+ *  a configurable latency with the response built by a responder.
+ */
+class FakeHost
+{
+  public:
+    /** @brief Build the response to a request, no response is sent if it is
+     *         left empty
+     *
+     *  @param[in] request - the request message
+     *  @param[in] payloadLength - length of the request payload
+     *  @param[out] response - the response message, header included
+     */
+    using Responder = std::function<void(const pldm_msg* request,
+                                         size_t payloadLength,
+                                         std::vector<uint8_t>& response)>;
+
+    /** @brief Constructor
+     *
+     *  @param[in] transport - host end of the loopback transport
+     *  @param[in] responder - builds the responses
+     *  @param[in] latency - time a request waits before it is answered
+     */
+    FakeHost(pldm::transport::Loopback& transport, Responder&& responder,
+             std::chrono::microseconds latency = {}) :
+        transport(transport),
+        responder(std::move(responder)), latency(latency)
+    {}
+
+    /** @brief Answer the requests received that are due */
+    void serve()
+    {
+        auto now = std::chrono::steady_clock::now();
+        pldm::transport::Message msg{};
+        while (transport.recv(msg) == 0)
+        {
+            pending.emplace_back(now + latency, std::move(msg));
+            maxPending = std::max(maxPending, pending.size());
+        }
+
+        while (!pending.empty() && pending.front().first <= now)
+        {
+            auto request = std::move(pending.front().second);
+            pending.pop_front();
+            requests++;
+
+            std::vector<uint8_t> response;
+            responder(reinterpret_cast<const pldm_msg*>(request.pldm.data()),
+                      request.pldm.size() - sizeof(pldm_msg_hdr), response);
+            if (!response.empty())
+            {
+                transport.sendResponse(request.eid, request.tag,
+                                       std::move(response));
+            }
+        }
+    }
+
+    size_t requests = 0;   //!< number of requests answered
+    size_t maxPending = 0; //!< most requests awaiting response at once
+
+  private:
+    pldm::transport::Loopback& transport;
+    Responder responder;
+    std::chrono::microseconds latency;
+    std::deque<std::pair<std::chrono::steady_clock::time_point,
+                         pldm::transport::Message>>
+        pending;
+};
+
+/** @brief Hand the responses received at the BMC end of a loopback transport
+ *         over to the requester handler
+ *
+ *  @param[in] bmc - BMC end of the loopback transport
+ *  @param[in] handler - the requester handler
+ */
+inline void
+    handleResponses(pldm::transport::Loopback& bmc,
+                    pldm::requester::Handler<pldm::requester::Request>& handler)
+{
+    pldm::transport::Message msg{};
+    while (bmc.recv(msg) == 0)
+    {
+        auto response = reinterpret_cast<const pldm_msg*>(msg.pldm.data());
+        handler.handleResponse(msg.eid, response->hdr.instance_id,
+                               response->hdr.type, response->hdr.command,
+                               response,
+                               msg.pldm.size() - sizeof(pldm_msg_hdr));
+    }
+}
+
+} // namespace test
+} // namespace pldm
@@ -0,0 +1,524 @@
+#include "libpldm/base.h"
+#include "libpldm/entity.h"
+#include "libpldm/fru.h"
+#include "libpldm/platform.h"
+#include "libpldm/utils.h"
+#include "oem/ibm/libpldm/fru.h"
+
+#include "common/transport.hpp"
+#include "common/utils.hpp"
+#include "host-bmc/host_fru_table.hpp"
+#include "host-bmc/test/fake_host.hpp"
+
+#include <sdeventplus/event.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::hostbmc;
+using namespace pldm::utils;
+using namespace std::chrono;
+
+constexpr size_t recordHdrSize =
+    sizeof(pldm_fru_record_data_format) - sizeof(pldm_fru_record_tlv);
+
+/** @brief Location code of a record set */
+static std::string locationCode(uint16_t rsi)
+{
+    return "U78DA.ND0.WZS0001-P0-C" + std::to_string(rsi);
+}
+
+/** @brief Append a general record and an OEM record with the location code
+ *         of the record set to a FRU record table
+ *
+ *  @param[in,out] table - the FRU record table
+ *  @param[in] rsi - FRU record set identifier
+ */
+static void appendRecordSet(std::vector<uint8_t>& table, uint16_t rsi)
+{
+    std::vector<uint8_t> general{PLDM_FRU_FIELD_TYPE_NAME, 8};
+    general.insert(general.end(), 8, 'a' + rsi % 26);
+    general.insert(general.end(), {PLDM_FRU_FIELD_TYPE_SN, 12});
+    general.insert(general.end(), 12, '0' + rsi % 10);
+
+    auto code = locationCode(rsi);
+    std::vector<uint8_t> oem{PLDM_OEM_FRU_FIELD_TYPE_LOCATION_CODE,
+                             static_cast<uint8_t>(code.size())};
+    oem.insert(oem.end(), code.begin(), code.end());
+
+    for (auto [recordType, numFields, tlvs] :
+         {std::make_tuple(PLDM_FRU_RECORD_TYPE_GENERAL, 2, &general),
+          std::make_tuple(PLDM_FRU_RECORD_TYPE_OEM, 1, &oem)})
+    {
+        size_t currSize = table.size();
+        table.resize(currSize + recordHdrSize + tlvs->size());
+        encode_fru_record(table.data(), table.size(), &currSize, rsi,
+                          recordType, numFields, PLDM_FRU_ENCODING_ASCII,
+                          tlvs->data(), tlvs->size());
+    }
+}
+
+/** @brief Append the pad bytes and checksum to a FRU record table */
+static void appendChecksum(std::vector<uint8_t>& table)
+{
+    table.resize(table.size() + getNumPadBytes(table.size()), 0);
+    uint32_t checksum = crc32(table.data(), table.size());
+    auto ptr = reinterpret_cast<const uint8_t*>(&checksum);
+    table.insert(table.end(), ptr, ptr + sizeof(checksum));
+}
+
+/** @brief Build a FRU record table of at least the given size, with the
+ *         record sets of appendRecordSet from 1 on
+ *
+ *  @param[in] size - minimum size of the table
+ *  @param[out] numRecords - number of records in the table
+ */
+static std::vector<uint8_t> buildTable(size_t size, size_t& numRecords)
+{
+    std::vector<uint8_t> table;
+    numRecords = 0;
+    for (uint16_t rsi = 1; table.size() < size; ++rsi)
+    {
+        appendRecordSet(table, rsi);
+        numRecords += 2;
+    }
+    appendChecksum(table);
+    return table;
+}
+
+/** @brief FRUTableLength of a table, its size without the checksum */
+static size_t tableLength(const std::vector<uint8_t>& table)
+{
+    return table.size() - sizeof(uint32_t);
+}
+
+/** @brief Check the records of the table built by buildTable */
+static void checkRecords(const FruRecordTable& table, size_t numRecords)
+{
+    const auto& records = table.getRecords();
+    ASSERT_EQ(records.size(), numRecords);
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const auto& record = records[i];
+        uint16_t rsi = i / 2 + 1;
+        EXPECT_EQ(record.rsi, rsi);
+        if (i % 2)
+        {
+            EXPECT_EQ(record.recordType, PLDM_FRU_RECORD_TYPE_OEM);
+            ASSERT_EQ(record.numFields, 1);
+            auto field = table.getField(record, 0);
+            EXPECT_EQ(field.type, PLDM_OEM_FRU_FIELD_TYPE_LOCATION_CODE);
+            EXPECT_EQ(std::string(reinterpret_cast<const char*>(field.value),
+                                  field.length),
+                      locationCode(rsi));
+        }
+        else
+        {
+            EXPECT_EQ(record.recordType, PLDM_FRU_RECORD_TYPE_GENERAL);
+            ASSERT_EQ(record.numFields, 2);
+            EXPECT_EQ(table.getField(record, 0).type,
+                      PLDM_FRU_FIELD_TYPE_NAME);
+            EXPECT_EQ(table.getField(record, 1).type, PLDM_FRU_FIELD_TYPE_SN);
+            EXPECT_EQ(table.getField(record, 1).length, 12);
+        }
+    }
+}
+
+TEST(FruRecordTable, ParsedIncrementally)
+{
+    size_t numRecords = 0;
+    auto data = buildTable(4096, numRecords);
+
+    // Parts cutting through the record and field headers
+    for (size_t partSize : {1, 3, 7, 64, 4096 * 2})
+    {
+        FruRecordTable table;
+        table.clear(numRecords, tableLength(data));
+        for (size_t offset = 0; offset < data.size(); offset += partSize)
+        {
+            EXPECT_EQ(table.size(), offset);
+            EXPECT_TRUE(table.append(
+                &data[offset], std::min(partSize, data.size() - offset)));
+        }
+        EXPECT_TRUE(table.complete());
+        EXPECT_TRUE(table.checksumValid());
+        checkRecords(table, numRecords);
+    }
+}
+
+TEST(FruRecordTable, Truncated)
+{
+    size_t numRecords = 0;
+    auto data = buildTable(256, numRecords);
+
+    FruRecordTable table;
+    table.clear(numRecords, tableLength(data));
+    // The last record is cut, the pad bytes and checksum are missing
+    EXPECT_TRUE(table.append(data.data(), data.size() - 12));
+    EXPECT_FALSE(table.complete());
+    EXPECT_FALSE(table.checksumValid());
+    EXPECT_EQ(table.getRecords().size(), numRecords - 1);
+
+    table.clear(numRecords, tableLength(data));
+    EXPECT_TRUE(table.getRecords().empty());
+    EXPECT_EQ(table.size(), 0);
+}
+
+TEST(FruRecordTable, LongerThanLength)
+{
+    size_t numRecords = 0;
+    auto data = buildTable(256, numRecords);
+
+    FruRecordTable table;
+    table.clear(numRecords, tableLength(data));
+    EXPECT_FALSE(table.append(data.data(), data.size() + 1));
+    EXPECT_EQ(table.size(), 0);
+    EXPECT_TRUE(table.append(data.data(), data.size()));
+    EXPECT_FALSE(table.append(data.data(), 1));
+    EXPECT_EQ(table.size(), data.size());
+    EXPECT_TRUE(table.complete());
+    EXPECT_TRUE(table.checksumValid());
+}
+
+TEST(FruRecordTable, BadChecksum)
+{
+    size_t numRecords = 0;
+    auto data = buildTable(256, numRecords);
+    data[recordHdrSize + 2] ^= 1;
+
+    FruRecordTable table;
+    table.clear(numRecords, tableLength(data));
+    EXPECT_TRUE(table.append(data.data(), data.size()));
+    EXPECT_TRUE(table.complete());
+    EXPECT_FALSE(table.checksumValid());
+}
+
+/** @brief Build a FRU record set PDR */
+static std::vector<uint8_t> fruRecordSetPdr(const pldm_entity& entity,
+                                            uint16_t rsi)
+{
+    std::vector<uint8_t> pdr(sizeof(pldm_pdr_hdr) +
+                             sizeof(pldm_pdr_fru_record_set));
+    auto hdr = reinterpret_cast<pldm_pdr_hdr*>(pdr.data());
+    hdr->type = PLDM_PDR_FRU_RECORD_SET;
+    hdr->length = htole16(sizeof(pldm_pdr_fru_record_set));
+    auto fru = reinterpret_cast<pldm_pdr_fru_record_set*>(pdr.data() +
+                                                          sizeof(pldm_pdr_hdr));
+    fru->fru_rsi = htole16(rsi);
+    fru->entity_type = htole16(entity.entity_type);
+    fru->entity_instance = htole16(entity.entity_instance_num);
+    fru->container_id = htole16(entity.entity_container_id);
+    return pdr;
+}
+
+TEST(HostInventoryJoin, LocationCodes)
+{
+    std::vector<pldm_entity> entities{{PLDM_ENTITY_FAN, 1, 2},
+                                      {PLDM_ENTITY_FAN, 2, 2},
+                                      {PLDM_ENTITY_POWER_SUPPLY, 1, 2},
+                                      {PLDM_ENTITY_SLOT, 1, 3}};
+    std::vector<std::vector<uint8_t>> pdrs{fruRecordSetPdr(entities[0], 10),
+                                           fruRecordSetPdr(entities[1], 20),
+                                           fruRecordSetPdr(entities[2], 30),
+                                           // The first PDR of an entity wins
+                                           fruRecordSetPdr(entities[0], 40)};
+
+    auto recordSetIds = getRecordSetIds(pdrs);
+    EXPECT_EQ(recordSetIds.size(), 3);
+    EXPECT_EQ(recordSetIds.at(entityKey(entities[0])), 10);
+    EXPECT_EQ(recordSetIds.at(entityKey(entities[1])), 20);
+    EXPECT_EQ(recordSetIds.at(entityKey(entities[2])), 30);
+    // No FRU record set PDR
+    EXPECT_FALSE(recordSetIds.contains(entityKey(entities[3])));
+
+    // Record set 30 has no location code
+    std::vector<uint8_t> data;
+    appendRecordSet(data, 10);
+    appendRecordSet(data, 20);
+    appendChecksum(data);
+    FruRecordTable table;
+    table.clear(4, tableLength(data));
+    table.append(data.data(), data.size());
+
+    auto locationCodes = getLocationCodes(table);
+    EXPECT_EQ(locationCodes.size(), 2);
+    EXPECT_EQ(locationCodes.at(10), locationCode(10));
+    EXPECT_EQ(locationCodes.at(20), locationCode(20));
+    EXPECT_FALSE(locationCodes.contains(30));
+}
+
+/** @brief Location codes of the entities, found by scanning the PDRs and the
+ *         records for each entity as setLocationCode used to
+ */
+static std::vector<std::string>
+    scanLocationCodes(const std::vector<pldm_entity>& entities,
+                      const std::vector<std::vector<uint8_t>>& pdrs,
+                      const FruRecordTable& table)
+{
+    std::vector<std::string> codes(entities.size());
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+        uint16_t fruRSI = 0;
+        for (const auto& pdr : pdrs)
+        {
+            auto fruPdr = reinterpret_cast<const pldm_pdr_fru_record_set*>(
+                pdr.data() + sizeof(pldm_pdr_hdr));
+            if (fruPdr->entity_type == entities[i].entity_type &&
+                fruPdr->entity_instance == entities[i].entity_instance_num &&
+                fruPdr->container_id == entities[i].entity_container_id)
+            {
+                fruRSI = fruPdr->fru_rsi;
+                break;
+            }
+        }
+        for (const auto& record : table.getRecords())
+        {
+            if (fruRSI != record.rsi ||
+                record.recordType != PLDM_FRU_RECORD_TYPE_OEM)
+            {
+                continue;
+            }
+            for (size_t j = 0; j < record.numFields; ++j)
+            {
+                auto field = table.getField(record, j);
+                if (field.type == PLDM_OEM_FRU_FIELD_TYPE_LOCATION_CODE)
+                {
+                    codes[i].assign(reinterpret_cast<const char*>(field.value),
+                                    field.length);
+                }
+            }
+        }
+    }
+    return codes;
+}
+
+/** @brief Location codes of the entities, joined through the indexes */
+static std::vector<std::string>
+    joinLocationCodes(const std::vector<pldm_entity>& entities,
+                      const std::vector<std::vector<uint8_t>>& pdrs,
+                      const FruRecordTable& table)
+{
+    std::vector<std::string> codes(entities.size());
+    auto recordSetIds = getRecordSetIds(pdrs);
+    auto locationCodes = getLocationCodes(table);
+    for (size_t i = 0; i < entities.size(); ++i)
+    {
+        auto rsi = recordSetIds.find(entityKey(entities[i]));
+        if (rsi == recordSetIds.end())
+        {
+            continue;
+        }
+        auto code = locationCodes.find(rsi->second);
+        if (code != locationCodes.end())
+        {
+            codes[i] = code->second;
+        }
+    }
+    return codes;
+}
+
+TEST(HostInventoryJoin, MatchesScan)
+{
+    // Entities of a synthetic host inventory, a FRU record set PDR and a
+    // record set per entity, in a different order than the entities
+    constexpr size_t numFrus = 1000;
+    std::vector<pldm_entity> entities;
+    std::vector<std::vector<uint8_t>> pdrs;
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < numFrus; ++i)
+    {
+        pldm_entity entity{static_cast<uint16_t>(PLDM_ENTITY_FAN + i % 8),
+                           static_cast<uint16_t>(i / 8 + 1),
+                           static_cast<uint16_t>(i % 64 + 1)};
+        entities.push_back(entity);
+        uint16_t rsi = numFrus - i;
+        pdrs.push_back(fruRecordSetPdr(entity, rsi));
+        appendRecordSet(data, rsi);
+    }
+    appendChecksum(data);
+    FruRecordTable table;
+    table.clear(2 * numFrus, tableLength(data));
+    table.append(data.data(), data.size());
+    ASSERT_TRUE(table.complete());
+
+    auto joined = joinLocationCodes(entities, pdrs, table);
+    EXPECT_EQ(joined, scanLocationCodes(entities, pdrs, table));
+    EXPECT_EQ(joined.front(), locationCode(numFrus));
+}
+
+/** @brief Serve a FRU record table in parts
+ *
+ *  @param[in] table - the FRU record table
+ *  @param[in] partSize - size of the parts
+ *  @param[in] completionCode - completion code of the responses
+ *  @param[in] endless - start the table over instead of ending it
+ */
+static pldm::test::FakeHost::Responder
+    serveTable(const std::vector<uint8_t>& table, size_t partSize,
+               uint8_t completionCode = PLDM_SUCCESS, bool endless = false)
+{
+    return [&table, partSize, completionCode, endless,
+            first = true](const pldm_msg* request, size_t payloadLength,
+                          std::vector<uint8_t>& response) mutable {
+        uint32_t offset = 0;
+        uint8_t transferOpFlag = 0;
+        ASSERT_EQ(decode_get_fru_record_table_req(request, payloadLength,
+                                                  &offset, &transferOpFlag),
+                  PLDM_SUCCESS);
+        ASSERT_EQ(transferOpFlag,
+                  first ? PLDM_GET_FIRSTPART : PLDM_GET_NEXTPART);
+        ASSERT_LT(offset, table.size());
+
+        auto length = std::min(partSize, table.size() - offset);
+        uint32_t next = offset + length;
+        uint8_t flag = first ? PLDM_START : PLDM_MIDDLE;
+        if (next == table.size())
+        {
+            if (!endless)
+            {
+                flag = first ? PLDM_START_AND_END : PLDM_END;
+            }
+            next = 0;
+        }
+        first = false;
+
+        response.resize(sizeof(pldm_msg_hdr) +
+                        PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES + length);
+        encode_get_fru_record_table_resp(
+            request->hdr.instance_id, completionCode, next, flag,
+            reinterpret_cast<pldm_msg*>(response.data()));
+        std::copy_n(table.begin() + offset, length,
+                    response.begin() + sizeof(pldm_msg_hdr) +
+                        PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES);
+    };
+}
+
+class FruTableReaderTest : public testing::Test
+{
+  protected:
+    FruTableReaderTest() :
+        event(sdeventplus::Event::get_default()), bmc(1), host(hostEid),
+        dbusImplReq(DBusHandler::getBus(), "/xyz/openbmc_project/pldm"),
+        handler(bmc, event, dbusImplReq, false, seconds(1), 0,
+                milliseconds(100)),
+        reader(dbusImplReq, &handler)
+    {
+        bmc.connect(host);
+    }
+
+    /** @brief Read the table from the host, serving it in parts
+     *
+     *  @return the result of the read, std::nullopt if it did not end
+     */
+    std::optional<bool> read(pldm::test::FakeHost& fakeHost,
+                             size_t numRecords,
+                             size_t length)
+    {
+        std::optional<bool> result;
+        reader.read(hostEid, numRecords, length,
+                    [&result](bool success) { result = success; });
+
+        auto end = steady_clock::now() + seconds(10);
+        while (!result && steady_clock::now() < end)
+        {
+            sd_event_run(event.get(), 1000);
+            fakeHost.serve();
+            pldm::test::handleResponses(bmc, handler);
+        }
+        return result;
+    }
+
+    static constexpr mctp_eid_t hostEid = 9;
+    sdeventplus::Event event;
+    pldm::transport::Loopback bmc;
+    pldm::transport::Loopback host;
+    pldm::dbus_api::Requester dbusImplReq;
+    pldm::requester::Handler<pldm::requester::Request> handler;
+    FruTableReader reader;
+};
+
+TEST_F(FruTableReaderTest, MultipartTable)
+{
+    constexpr size_t tableSize = 1024 * 1024;
+    constexpr size_t partSize = 1024;
+    size_t numRecords = 0;
+    auto table = buildTable(tableSize, numRecords);
+    pldm::test::FakeHost fakeHost(host, serveTable(table, partSize));
+
+    auto result = read(fakeHost, numRecords, tableLength(table));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(*result);
+    EXPECT_EQ(fakeHost.requests, (table.size() + partSize - 1) / partSize);
+    EXPECT_EQ(reader.getTable().size(), table.size());
+    checkRecords(reader.getTable(), numRecords);
+}
+
+TEST_F(FruTableReaderTest, SinglePartTable)
+{
+    size_t numRecords = 0;
+    auto table = buildTable(512, numRecords);
+    pldm::test::FakeHost fakeHost(host, serveTable(table, table.size()));
+
+    auto result = read(fakeHost, numRecords, tableLength(table));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(*result);
+    EXPECT_EQ(fakeHost.requests, 1);
+    checkRecords(reader.getTable(), numRecords);
+}
+
+TEST_F(FruTableReaderTest, RecordsMissing)
+{
+    size_t numRecords = 0;
+    auto table = buildTable(4096, numRecords);
+    pldm::test::FakeHost fakeHost(host, serveTable(table, 1024));
+
+    auto result = read(fakeHost, numRecords + 1, tableLength(table));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_FALSE(*result);
+}
+
+TEST_F(FruTableReaderTest, ErrorCompletionCode)
+{
+    size_t numRecords = 0;
+    auto table = buildTable(4096, numRecords);
+    pldm::test::FakeHost fakeHost(host, serveTable(table, 1024, PLDM_ERROR));
+
+    auto result = read(fakeHost, numRecords, tableLength(table));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_FALSE(*result);
+    EXPECT_EQ(fakeHost.requests, 1);
+}
+
+TEST_F(FruTableReaderTest, EndlessTable)
+{
+    constexpr size_t partSize = 1024;
+    size_t numRecords = 0;
+    auto table = buildTable(4096, numRecords);
+    pldm::test::FakeHost fakeHost(
+        host, serveTable(table, partSize, PLDM_SUCCESS, true));
+
+    // The read fails at the first part past the end of the table
+    auto result = read(fakeHost, numRecords, tableLength(table));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_FALSE(*result);
+    EXPECT_EQ(fakeHost.requests, (table.size() + partSize - 1) / partSize + 1);
+}
+
+TEST_F(FruTableReaderTest, BadChecksum)
+{
+    size_t numRecords = 0;
+    auto table = buildTable(4096, numRecords);
+    table.back() ^= 1;
+    pldm::test::FakeHost fakeHost(host, serveTable(table, 1024));
+
+    auto result = read(fakeHost, numRecords, tableLength(table));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_FALSE(*result);
+    EXPECT_EQ(fakeHost.requests, (table.size() + 1023) / 1024);
+}
@@ -0,0 +1,194 @@
+#include "libpldm/base.h"
+#include "libpldm/entity.h"
+#include "libpldm/platform.h"
+#include "libpldm/state_set.h"
+
+#include "common/transport.hpp"
+#include "common/utils.hpp"
+#include "host-bmc/host_state_sensors.hpp"
+#include "host-bmc/test/fake_host.hpp"
+
+#include <sdeventplus/event.hpp>
+
+#include <chrono>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm;
+using namespace pldm::hostbmc;
+using namespace pldm::utils;
+using namespace std::chrono;
+
+TEST(SensorReadings, joinedByEntity)
+{
+    pldm_entity chassis{PLDM_ENTITY_SYSTEM_CHASSIS, 1, 0};
+    pldm_entity fan1{PLDM_ENTITY_FAN, 1, 0};
+    pldm_entity fan2{PLDM_ENTITY_FAN, 2, 0};
+    auto tree = pldm_entity_association_tree_init();
+    auto l1 = pldm_entity_association_tree_add(tree, &chassis, 1, nullptr,
+                                               PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                                               true, true);
+    auto l2a = pldm_entity_association_tree_add(
+        tree, &fan1, 1, l1, PLDM_ENTITY_ASSOCIAION_PHYSICAL, true, true);
+    auto l2b = pldm_entity_association_tree_add(
+        tree, &fan2, 2, l1, PLDM_ENTITY_ASSOCIAION_PHYSICAL, true, true);
+
+    const std::string chassisPath = "/xyz/openbmc_project/inventory/chassis1";
+    ObjectPathMaps objPathMap{{chassisPath, l1},
+                              {chassisPath + "/fan1", l2a},
+                              {chassisPath + "/fan2", l2b}};
+
+    auto entityInfo = [](pldm_entity_node* node) {
+        auto entity = pldm_entity_extract(node);
+        pdr::ContainerID containerId = entity.entity_container_id;
+        pdr::EntityType entityType = entity.entity_type;
+        pdr::EntityInstance entityInstance = entity.entity_instance_num;
+        return pdr::EntityInfo{containerId, entityType, entityInstance};
+    };
+    auto sensorInfo = [](const pdr::EntityInfo& entity,
+                         pdr::StateSetId stateSetId) {
+        return pdr::SensorInfo{entity, {}, {stateSetId}};
+    };
+
+    HostStateSensorMap sensorMap{
+        {{1, 10},
+         sensorInfo(entityInfo(l2b), PLDM_STATE_SET_OPERATIONAL_FAULT_STATUS)},
+        {{1, 11}, sensorInfo(entityInfo(l2b), PLDM_STATE_SET_IDENTIFY_STATE)},
+        {{1, 12}, sensorInfo(entityInfo(l1), PLDM_STATE_SET_HEALTH_STATE)},
+        // Not a state set the objects take
+        {{1, 13}, sensorInfo(entityInfo(l2a), PLDM_STATE_SET_AVAILABILITY)},
+        // Terminus with invalid PDRs
+        {{2, 14}, sensorInfo(entityInfo(l2a), PLDM_STATE_SET_HEALTH_STATE)},
+        // No object for the entity
+        {{1, 15},
+         sensorInfo({9, PLDM_ENTITY_FAN, 3}, PLDM_STATE_SET_HEALTH_STATE)}};
+
+    size_t validityChecks = 0;
+    auto readings = getSensorReadings(
+        objPathMap, sensorMap,
+        [&validityChecks](const pdr::TerminusID& tid) {
+            ++validityChecks;
+            return tid == 1;
+        });
+
+    // In the order of the object paths, then of the sensors
+    ASSERT_EQ(readings.size(), 3);
+    EXPECT_EQ(readings[0].sensorID, 12);
+    EXPECT_EQ(readings[0].path, chassisPath);
+    EXPECT_EQ(readings[0].stateSetId, PLDM_STATE_SET_HEALTH_STATE);
+    EXPECT_EQ(readings[1].sensorID, 10);
+    EXPECT_EQ(readings[1].path, chassisPath + "/fan2");
+    EXPECT_EQ(readings[2].sensorID, 11);
+    EXPECT_EQ(readings[2].stateSetId, PLDM_STATE_SET_IDENTIFY_STATE);
+    EXPECT_EQ(readings[2].entity.entity_type, PLDM_ENTITY_FAN);
+    EXPECT_EQ(readings[2].entity.entity_instance_num, 2);
+
+    // Once per terminus
+    EXPECT_EQ(validityChecks, 2);
+
+    pldm_entity_association_tree_destroy(tree);
+}
+
+/** @brief Answer GetStateSensorReadings with the low byte of the sensor ID
+ *         as the state
+ */
+static void answerSensorReading(const pldm_msg* request, size_t payloadLength,
+                                std::vector<uint8_t>& response)
+{
+    uint16_t sensorId = 0;
+    bitfield8_t rearm{};
+    uint8_t reserved = 0;
+    ASSERT_EQ(decode_get_state_sensor_readings_req(
+                  request, payloadLength, &sensorId, &rearm, &reserved),
+              PLDM_SUCCESS);
+
+    get_sensor_state_field field{PLDM_SENSOR_ENABLED,
+                                 static_cast<uint8_t>(sensorId),
+                                 PLDM_SENSOR_UNKNOWN, PLDM_SENSOR_UNKNOWN};
+    response.resize(sizeof(pldm_msg_hdr) +
+                    PLDM_GET_STATE_SENSOR_READINGS_MIN_RESP_BYTES +
+                    sizeof(get_sensor_state_field));
+    encode_get_state_sensor_readings_resp(
+        request->hdr.instance_id, PLDM_SUCCESS, 1, &field,
+        reinterpret_cast<pldm_msg*>(response.data()));
+}
+
+class StateSensorReaderTest : public testing::Test
+{
+  protected:
+    StateSensorReaderTest() :
+        event(sdeventplus::Event::get_default()), bmc(1), host(hostEid),
+        dbusImplReq(DBusHandler::getBus(), "/xyz/openbmc_project/pldm"),
+        handler(bmc, event, dbusImplReq, false, seconds(5), 0, seconds(1))
+    {
+        bmc.connect(host);
+    }
+
+    /** @brief Read the sensors from a host answering after the latency
+     *
+     *  @param[in] numSensors - number of sensors to read
+     *  @param[in] maxInFlight - number of requests in flight at most
+     *  @param[in] latency - response latency of the host
+     *  @param[out] batches - sizes of the batches handed over
+     */
+    void read(size_t numSensors, size_t maxInFlight, microseconds latency,
+              std::vector<size_t>& batches)
+    {
+        pldm::test::FakeHost fakeHost(host, answerSensorReading, latency);
+        StateSensorReader reader(dbusImplReq, &handler, maxInFlight);
+
+        std::vector<SensorReading> readings;
+        for (size_t i = 0; i < numSensors; ++i)
+        {
+            readings.push_back({static_cast<pdr::SensorID>(i + 1),
+                                PLDM_STATE_SET_HEALTH_STATE,
+                                {PLDM_ENTITY_FAN, static_cast<uint16_t>(i), 1},
+                                "/fan" + std::to_string(i)});
+        }
+
+        size_t received = 0;
+        reader.read(hostEid, std::move(readings),
+                    [&](std::vector<StateSensorReader::Result>& results) {
+                        batches.push_back(results.size());
+                        for (const auto& [reading, state] : results)
+                        {
+                            EXPECT_EQ(state,
+                                      static_cast<uint8_t>(reading.sensorID));
+                        }
+                        received += results.size();
+                    });
+
+        auto end = steady_clock::now() + seconds(30);
+        while (received < numSensors && steady_clock::now() < end)
+        {
+            sd_event_run(event.get(), 100);
+            fakeHost.serve();
+            pldm::test::handleResponses(bmc, handler);
+        }
+
+        EXPECT_EQ(received, numSensors);
+        EXPECT_FALSE(reader.busy());
+        EXPECT_LE(fakeHost.maxPending, maxInFlight);
+    }
+
+    static constexpr mctp_eid_t hostEid = 9;
+    sdeventplus::Event event;
+    pldm::transport::Loopback bmc;
+    pldm::transport::Loopback host;
+    pldm::dbus_api::Requester dbusImplReq;
+    pldm::requester::Handler<pldm::requester::Request> handler;
+};
+
+TEST_F(StateSensorReaderTest, batchedWithinWindow)
+{
+    std::vector<size_t> batches;
+    read(20, 4, microseconds(500), batches);
+
+    // Full batches, then the rest once all are read
+    ASSERT_FALSE(batches.empty());
+    for (size_t i = 0; i + 1 < batches.size(); ++i)
+    {
+        EXPECT_GE(batches[i], 4);
+    }
+}
@@ -102,3 +102,209 @@ TEST(EntityAssociation, addObjectPathEntityAssociations1)
     EXPECT_EQ(index, retObjectMaps.size());
     pldm_entity_association_tree_destroy(tree);
 }
+
+TEST(EntityAssociation, existingObjectPaths)
+{
+    pldm_entity entities[4]{};
+    entities[0].entity_type = PLDM_ENTITY_SYSTEM_CHASSIS;
+    entities[1].entity_type = PLDM_ENTITY_SYS_BOARD;
+    entities[1].entity_container_id = 1;
+    entities[2].entity_type = PLDM_ENTITY_FAN;
+    entities[2].entity_container_id = 2;
+    entities[3].entity_type = PLDM_ENTITY_FAN;
+    entities[3].entity_container_id = 2;
+
+    auto tree = pldm_entity_association_tree_init();
+    auto l1 = pldm_entity_association_tree_add(tree, &entities[0], 1, nullptr,
+                                               PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                                               true, true);
+    auto l2 = pldm_entity_association_tree_add(
+        tree, &entities[1], 1, l1, PLDM_ENTITY_ASSOCIAION_PHYSICAL, true, true);
+    auto l3a = pldm_entity_association_tree_add(
+        tree, &entities[2], 0, l2, PLDM_ENTITY_ASSOCIAION_PHYSICAL, true, true);
+    auto l3b = pldm_entity_association_tree_add(
+        tree, &entities[3], 1, l2, PLDM_ENTITY_ASSOCIAION_PHYSICAL, true, true);
+
+    EntityAssociations entityAssociations = {{l1, l2}, {l2, l3a, l3b}};
+    ObjectPathSet existingPaths{
+        "/xyz/openbmc_project/inventory/chassis1",
+        "/xyz/openbmc_project/inventory/chassis1/motherboard1/fan0"};
+
+    ObjectPathMaps objPathMap;
+    updateEntityAssociation(entityAssociations, tree, objPathMap, nullptr,
+                            existingPaths);
+
+    ObjectPathMaps retObjectMaps = {
+        {"/xyz/openbmc_project/inventory/chassis1/motherboard1", l2},
+        {"/xyz/openbmc_project/inventory/chassis1/motherboard1/fan1", l3b}};
+    EXPECT_EQ(objPathMap, retObjectMaps);
+
+    pldm_entity_association_tree_destroy(tree);
+}
+
+TEST(EntityAssociation, largeEntityTree)
+{
+    constexpr uint16_t dcms = 512;
+    constexpr uint16_t cpusPerDcm = 8;
+
+    pldm_entity chassis{PLDM_ENTITY_SYSTEM_CHASSIS, 0, 0};
+    pldm_entity board{PLDM_ENTITY_SYS_BOARD, 0, 1};
+    auto tree = pldm_entity_association_tree_init();
+    auto l1 = pldm_entity_association_tree_add(tree, &chassis, 1, nullptr,
+                                               PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                                               true, true);
+    auto l2 = pldm_entity_association_tree_add(
+        tree, &board, 1, l1, PLDM_ENTITY_ASSOCIAION_PHYSICAL, true, true);
+
+    EntityAssociations entityAssociations = {{l1, l2}, {l2}};
+    for (uint16_t dcm = 0; dcm < dcms; ++dcm)
+    {
+        pldm_entity dcmEntity{PLDM_ENTITY_PROC_MODULE, 0, 2};
+        auto l3 = pldm_entity_association_tree_add(
+            tree, &dcmEntity, dcm, l2, PLDM_ENTITY_ASSOCIAION_PHYSICAL, true,
+            true);
+        entityAssociations[1].push_back(l3);
+
+        Entities cpus{l3};
+        for (uint16_t cpu = 0; cpu < cpusPerDcm; ++cpu)
+        {
+            pldm_entity cpuEntity{PLDM_ENTITY_PROC, 0,
+                                  static_cast<uint16_t>(3 + dcm)};
+            cpus.push_back(pldm_entity_association_tree_add(
+                tree, &cpuEntity, cpu, l3, PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                true, true));
+        }
+        entityAssociations.emplace_back(std::move(cpus));
+    }
+
+    ObjectPathMaps objPathMap;
+    updateEntityAssociation(entityAssociations, tree, objPathMap, nullptr,
+                            {});
+
+    EXPECT_EQ(objPathMap.size(), 2 + dcms + dcms * cpusPerDcm);
+    EXPECT_TRUE(objPathMap.contains(
+        "/xyz/openbmc_project/inventory/chassis1/motherboard1/dcm511/cpu7"));
+
+    pldm_entity_association_tree_destroy(tree);
+}
+
+/** @brief Build a host entity tree of a chassis, a board, DCMs and CPUs, and
+ *         map its object paths
+ */
+static pldm_entity_association_tree* buildEntityTree(uint16_t dcms,
+                                                     uint16_t cpusPerDcm,
+                                                     ObjectPathMaps& objPathMap)
+{
+    pldm_entity chassis{PLDM_ENTITY_SYSTEM_CHASSIS, 0, 0};
+    pldm_entity board{PLDM_ENTITY_SYS_BOARD, 0, 1};
+    auto tree = pldm_entity_association_tree_init();
+    auto l1 = pldm_entity_association_tree_add(tree, &chassis, 1, nullptr,
+                                               PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                                               true, true);
+    auto l2 = pldm_entity_association_tree_add(
+        tree, &board, 1, l1, PLDM_ENTITY_ASSOCIAION_PHYSICAL, true, true);
+
+    EntityAssociations entityAssociations = {{l1, l2}, {l2}};
+    for (uint16_t dcm = 0; dcm < dcms; ++dcm)
+    {
+        pldm_entity dcmEntity{PLDM_ENTITY_PROC_MODULE, 0, 2};
+        auto l3 = pldm_entity_association_tree_add(
+            tree, &dcmEntity, dcm, l2, PLDM_ENTITY_ASSOCIAION_PHYSICAL, true,
+            true);
+        entityAssociations[1].push_back(l3);
+
+        Entities cpus{l3};
+        for (uint16_t cpu = 0; cpu < cpusPerDcm; ++cpu)
+        {
+            pldm_entity cpuEntity{PLDM_ENTITY_PROC, 0,
+                                  static_cast<uint16_t>(3 + dcm)};
+            cpus.push_back(pldm_entity_association_tree_add(
+                tree, &cpuEntity, cpu, l3, PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                true, true));
+        }
+        entityAssociations.emplace_back(std::move(cpus));
+    }
+
+    updateEntityAssociation(entityAssociations, tree, objPathMap, nullptr,
+                            {});
+    return tree;
+}
+
+static const AssociationsInfoMap associationsInfoMap{
+    {{PLDM_ENTITY_SYSTEM_CHASSIS, PLDM_ENTITY_SYS_BOARD},
+     {"containing", "contained_by"}},
+    {{PLDM_ENTITY_SYS_BOARD, PLDM_ENTITY_PROC_MODULE},
+     {"containing", "contained_by"}},
+    {{PLDM_ENTITY_SYSTEM_CHASSIS, PLDM_ENTITY_PROC},
+     {"containing", "contained_by"}},
+    {{PLDM_ENTITY_PROC, PLDM_ENTITY_PROC_MODULE}, {"parent", "child"}}};
+
+TEST(FRUAssociations, ancestorsOnly)
+{
+    ObjectPathMaps objPathMap;
+    auto tree = buildEntityTree(12, 2, objPathMap);
+
+    auto fruAssociations = getFRUAssociations(objPathMap, associationsInfoMap);
+
+    const std::string chassis = "/xyz/openbmc_project/inventory/chassis1";
+    const std::string board = chassis + "/motherboard1";
+    const std::string dcm1 = board + "/dcm1";
+
+    // The board, the DCMs and, skipping a level, the CPUs of the chassis
+    EXPECT_EQ(fruAssociations.at(chassis).size(), 1 + 12 * 2);
+    EXPECT_EQ(fruAssociations.at(chassis).front(),
+              std::make_tuple("containing", "contained_by", board));
+    EXPECT_EQ(fruAssociations.at(board).size(), 12);
+
+    // dcm1 is a prefix of dcm10 and dcm11, but not their ancestor
+    FRUAssociations::mapped_type expected{{"parent", "child", dcm1}};
+    EXPECT_EQ(fruAssociations.at(dcm1 + "/cpu0"), expected);
+    EXPECT_FALSE(fruAssociations.contains(dcm1));
+    EXPECT_EQ(fruAssociations.size(), 2 + 12 * 2);
+
+    pldm_entity_association_tree_destroy(tree);
+}
+
+/** @brief The associations found by comparing every pair of object paths */
+static FRUAssociations allPairsAssociations(const ObjectPathMaps& objPathMap)
+{
+    FRUAssociations fruAssociations;
+    for (const auto& [leftPath, leftElement] : objPathMap)
+    {
+        auto leftType = pldm_entity_extract(leftElement).entity_type;
+        const auto& left = leftPath.string();
+        for (const auto& [rightPath, rightElement] : objPathMap)
+        {
+            const auto& right = rightPath.string();
+            if (left == right)
+            {
+                continue;
+            }
+            const auto& [shorter, longer] = left.size() < right.size()
+                                                ? std::tie(left, right)
+                                                : std::tie(right, left);
+            if (longer.starts_with(shorter) && longer[shorter.size()] == '/')
+            {
+                auto rightType = pldm_entity_extract(rightElement).entity_type;
+                auto names = associationsInfoMap.find({leftType, rightType});
+                if (names != associationsInfoMap.end())
+                {
+                    fruAssociations[left].emplace_back(
+                        names->second.first, names->second.second, right);
+                }
+            }
+        }
+    }
+    return fruAssociations;
+}
+
+TEST(FRUAssociations, matchesAllPairs)
+{
+    ObjectPathMaps objPathMap;
+    auto tree = buildEntityTree(64, 8, objPathMap);
+
+    EXPECT_EQ(getFRUAssociations(objPathMap, associationsInfoMap),
+              allPairsAssociations(objPathMap));
+
+    pldm_entity_association_tree_destroy(tree);
+}
@@ -6,6 +6,8 @@
 #include "utils.hpp"
 
 #include <iostream>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace fs = std::filesystem;
 namespace pldm
@@ -15,135 +17,119 @@ namespace hostbmc
 namespace utils
 {
 
+constexpr auto inventoryPath = "/xyz/openbmc_project/inventory";
+
+/** @brief Index of the entity association list, maps the key of an entity to
+ *         the positions of the associations it is the parent of
+ */
+using AssociationIndex =
+    std::unordered_map<uint64_t, std::vector<EntityAssociations::size_type>>;
+
+/** @brief Key identifying an entity of the host entity association tree
+ *
+ *  @param[in] node - entity node
+ *
+ *  @return entity type, entity instance number and host container ID of the
+ *          entity
+ */
+static uint64_t entityKey(pldm_entity_node* node)
+{
+    pldm_entity entity = pldm_entity_extract(node);
+    return (static_cast<uint64_t>(entity.entity_type) << 32) |
+           (static_cast<uint64_t>(entity.entity_instance_num) << 16) |
+           pldm_extract_host_container_id(node);
+}
+
 Entities getParentEntites(const EntityAssociations& entityAssoc)
 {
-    Entities parents{};
-    for (const auto& et : entityAssoc)
+    std::unordered_set<uint64_t> children;
+    for (const auto& evs : entityAssoc)
     {
-        parents.push_back(et[0]);
+        for (size_t i = 1; i < evs.size(); i++)
+        {
+            children.emplace(entityKey(evs[i]));
+        }
     }
 
-    for (auto it = parents.begin(); it != parents.end();)
+    Entities parents{};
+    for (const auto& et : entityAssoc)
     {
-        uint16_t parent_host_contanied_id = pldm_extract_host_container_id(*it);
-        bool find = false;
-        for (const auto& evs : entityAssoc)
+        if (!children.contains(entityKey(et[0])))
         {
-            for (size_t i = 1; i < evs.size(); i++)
-            {
-                uint16_t node_host_contanied_id =
-                    pldm_extract_host_container_id(evs[i]);
+            parents.push_back(et[0]);
+        }
+    }
 
-                pldm_entity parent_entity = pldm_entity_extract(*it);
-                pldm_entity node_entity = pldm_entity_extract(evs[i]);
+    return parents;
+}
 
-                if (node_entity.entity_type == parent_entity.entity_type &&
-                    node_entity.entity_instance_num ==
-                        parent_entity.entity_instance_num &&
-                    node_host_contanied_id == parent_host_contanied_id)
-                {
-                    find = true;
-                    break;
-                }
-            }
-            if (find)
-            {
-                break;
-            }
-        }
-        if (find)
-        {
-            it = parents.erase(it);
-        }
-        else
+ObjectPathSet getInventoryObjectPaths()
+{
+    ObjectPathSet paths;
+    try
+    {
+        auto response =
+            pldm::utils::DBusHandler().getSubtree(inventoryPath, 0, {});
+        paths.reserve(response.size());
+        for (auto& [objectPath, serviceMap] : response)
         {
-            it++;
+            paths.emplace(std::move(objectPath));
         }
     }
-
-    return parents;
+    catch (const std::exception& e)
+    {
+        std::cerr << "Failed to get the inventory object paths, ERROR="
+                  << e.what() << "\n";
+    }
+    return paths;
 }
 
 void addObjectPathEntityAssociations(
-    const EntityAssociations& entityAssoc, pldm_entity_node* entity,
-    const ObjectPath& path, ObjectPathMaps& objPathMap,
-    pldm::responder::oem_platform::Handler* oemPlatformHandler)
+    const EntityAssociations& entityAssoc, const AssociationIndex& assocIndex,
+    pldm_entity_node* entity, const ObjectPath& path,
+    ObjectPathMaps& objPathMap,
+    pldm::responder::oem_platform::Handler* oemPlatformHandler,
+    const ObjectPathSet& existingPaths)
 {
     if (entity == nullptr)
     {
         return;
     }
 
-    bool find = false;
     pldm_entity node_entity = pldm_entity_extract(entity);
-    if (!entityMaps.contains(node_entity.entity_type))
+    auto entityName = entityMaps.find(node_entity.entity_type);
+    if (entityName == entityMaps.end())
     {
         return;
     }
 
-    std::string entityName = entityMaps.at(node_entity.entity_type);
-    for (auto& ev : entityAssoc)
+    ObjectPath p =
+        path / fs::path{entityName->second +
+                        std::to_string(node_entity.entity_instance_num)};
+    std::string entity_path = p.string();
+    if (oemPlatformHandler != nullptr)
     {
-        pldm_entity ev_entity = pldm_entity_extract(ev[0]);
-        if (ev_entity.entity_instance_num == node_entity.entity_instance_num &&
-            ev_entity.entity_type == node_entity.entity_type)
-        {
-
-            uint16_t node_host_contanied_id =
-                pldm_extract_host_container_id(ev[0]);
-            uint16_t entity_host_contanied_id =
-                pldm_extract_host_container_id(entity);
-
-            if (node_host_contanied_id != entity_host_contanied_id)
-            {
-                continue;
-            }
-
-            ObjectPath p =
-                path /
-                fs::path{entityName +
-                         std::to_string(node_entity.entity_instance_num)};
-            std::string entity_path = p.string();
-            if (oemPlatformHandler != nullptr)
-            {
-                oemPlatformHandler->upadteOemDbusPaths(entity_path);
-            }
-            try
-            {
-                pldm::utils::DBusHandler().getService(entity_path.c_str(),
-                                                      nullptr);
-            }
-            catch (const std::exception& e)
-            {
-                objPathMap[entity_path] = entity;
-            }
-
-            for (size_t i = 1; i < ev.size(); i++)
-            {
-                addObjectPathEntityAssociations(entityAssoc, ev[i], p,
-                                                objPathMap, oemPlatformHandler);
-            }
-            find = true;
-        }
+        oemPlatformHandler->upadteOemDbusPaths(entity_path);
     }
 
-    if (!find)
+    if (!existingPaths.contains(entity_path))
     {
-        std::string dbusPath =
-            path / fs::path{entityName +
-                            std::to_string(node_entity.entity_instance_num)};
+        objPathMap[entity_path] = entity;
+    }
 
-        if (oemPlatformHandler != nullptr)
-        {
-            oemPlatformHandler->upadteOemDbusPaths(dbusPath);
-        }
-        try
-        {
-            pldm::utils::DBusHandler().getService(dbusPath.c_str(), nullptr);
-        }
-        catch (const std::exception& e)
+    auto assocs = assocIndex.find(entityKey(entity));
+    if (assocs == assocIndex.end())
+    {
+        return;
+    }
+    for (auto pos : assocs->second)
+    {
+        const auto& ev = entityAssoc[pos];
+        for (size_t i = 1; i < ev.size(); i++)
         {
-            objPathMap[dbusPath] = entity;
+            addObjectPathEntityAssociations(entityAssoc, assocIndex, ev[i], p,
+                                            objPathMap, oemPlatformHandler,
+                                            existingPaths);
         }
     }
 }
@@ -153,11 +139,28 @@ void updateEntityAssociation(
     pldm_entity_association_tree* entityTree, ObjectPathMaps& objPathMap,
     pldm::responder::oem_platform::Handler* oemPlatformHandler)
 {
+    updateEntityAssociation(entityAssoc, entityTree, objPathMap,
+                            oemPlatformHandler, getInventoryObjectPaths());
+}
+
+void updateEntityAssociation(
+    const EntityAssociations& entityAssoc,
+    pldm_entity_association_tree* entityTree, ObjectPathMaps& objPathMap,
+    pldm::responder::oem_platform::Handler* oemPlatformHandler,
+    const ObjectPathSet& existingPaths)
+{
+    AssociationIndex assocIndex;
+    for (EntityAssociations::size_type pos = 0; pos < entityAssoc.size();
+         ++pos)
+    {
+        assocIndex[entityKey(entityAssoc[pos][0])].push_back(pos);
+    }
+
     std::vector<pldm_entity_node*> parentsEntity =
         getParentEntites(entityAssoc);
     for (auto& entity : parentsEntity)
     {
-        fs::path path{"/xyz/openbmc_project/inventory"};
+        fs::path path{inventoryPath};
         std::deque<std::string> paths{};
         pldm_entity node_entity = pldm_entity_extract(entity);
         auto node =
@@ -207,8 +210,9 @@ void updateEntityAssociation(
             paths.pop_back();
         }
 
-        addObjectPathEntityAssociations(entityAssoc, entity, path, objPathMap,
-                                        oemPlatformHandler);
+        addObjectPathEntityAssociations(entityAssoc, assocIndex, entity, path,
+                                        objPathMap, oemPlatformHandler,
+                                        existingPaths);
     }
 }
 void setCoreCount(const EntityAssociations& Associations)
@@ -268,6 +272,51 @@ void setCoreCount(const EntityAssociations& Associations)
         }
     }
 }
+
+FRUAssociations
+    getFRUAssociations(const ObjectPathMaps& objPathMap,
+                       const AssociationsInfoMap& associationsInfoMap)
+{
+    FRUAssociations fruAssociations;
+    std::vector<ObjectPathMaps::const_iterator> ancestors;
+    for (const auto& [path, node] : objPathMap)
+    {
+        // The ancestors of an object are the prefixes of its path that are
+        // objects of the map too
+        ancestors.clear();
+        for (auto parent = path.parent_path(); parent.has_relative_path();
+             parent = parent.parent_path())
+        {
+            auto ancestor = objPathMap.find(parent);
+            if (ancestor != objPathMap.end())
+            {
+                ancestors.push_back(ancestor);
+            }
+        }
+
+        auto entityType = pldm_entity_extract(node).entity_type;
+        for (auto it = ancestors.rbegin(); it != ancestors.rend(); ++it)
+        {
+            const auto& [ancestorPath, ancestorNode] = **it;
+            auto ancestorType = pldm_entity_extract(ancestorNode).entity_type;
+
+            auto names = associationsInfoMap.find({ancestorType, entityType});
+            if (names != associationsInfoMap.end())
+            {
+                fruAssociations[ancestorPath].emplace_back(
+                    names->second.first, names->second.second, path);
+            }
+            names = associationsInfoMap.find({entityType, ancestorType});
+            if (names != associationsInfoMap.end())
+            {
+                fruAssociations[path].emplace_back(
+                    names->second.first, names->second.second, ancestorPath);
+            }
+        }
+    }
+    return fruAssociations;
+}
+
 } // namespace utils
 } // namespace hostbmc
 } // namespace pldm
@@ -9,6 +9,9 @@
 #include <filesystem>
 #include <map>
 #include <string>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace fs = std::filesystem;
@@ -22,6 +25,13 @@ using EntityType = uint16_t;
 using Entities = std::vector<pldm_entity_node*>;
 using EntityAssociations = std::vector<Entities>;
 using ObjectPathMaps = std::map<ObjectPath, pldm_entity_node*>;
+using ObjectPathSet = std::unordered_set<std::string>;
+using AssociationsInfoMap =
+    std::map<std::pair<EntityType, EntityType>,
+             std::pair<std::string, std::string>>;
+using FRUAssociations = std::map<
+    std::string,
+    std::vector<std::tuple<std::string, std::string, std::string>>>;
 
 const std::map<EntityType, EntityName> entityMaps = {
     {PLDM_ENTITY_SYSTEM_CHASSIS, "chassis"},
@@ -56,8 +66,42 @@ void updateEntityAssociation(
     pldm_entity_association_tree* entityTree, ObjectPathMaps& objPathMap,
     pldm::responder::oem_platform::Handler* oemPlatformHandler);
 
+/** @brief Vector a entity name to pldm_entity from entity association tree,
+ *         skipping the object paths that are already on D-Bus
+ *  @param[in]  entityAssoc    - Vector of associated pldm entities
+ *  @param[in]  entityTree     - entity association tree
+ *  @param[out] objPathMap     - maps an object path to pldm_entity from the
+ *                               BMC's entity association tree
+ *  @param[in]  existingPaths  - inventory object paths already on D-Bus
+ *  @return
+ */
+void updateEntityAssociation(
+    const EntityAssociations& entityAssoc,
+    pldm_entity_association_tree* entityTree, ObjectPathMaps& objPathMap,
+    pldm::responder::oem_platform::Handler* oemPlatformHandler,
+    const ObjectPathSet& existingPaths);
+
+/** @brief Get the object paths in the inventory namespace with a single
+ *         mapper call
+ *  @return the object paths, empty if the mapper call failed
+ */
+ObjectPathSet getInventoryObjectPaths();
+
 void setCoreCount(const EntityAssociations& entityAssociation);
 
+/** @brief Build the associations between the host FRUs, from the ancestors of
+ *         each object path in the map rather than by comparing every pair
+ *  @param[in] objPathMap          - maps an object path to pldm_entity from
+ *                                   the BMC's entity association tree
+ *  @param[in] associationsInfoMap - forward and reverse association names,
+ *                                   keyed by the entity types of the object
+ *                                   and of the associated object
+ *  @return the whole list of associations of each object that has any
+ */
+FRUAssociations
+    getFRUAssociations(const ObjectPathMaps& objPathMap,
+                       const AssociationsInfoMap& associationsInfoMap);
+
 } // namespace utils
 } // namespace hostbmc
 } // namespace pldm
@@ -262,6 +262,58 @@ void get_fru_record_by_option(const uint8_t *table, size_t table_size,
 	*record_size = pos - record_table;
 }
 
+int get_fru_record_by_offsets(const uint8_t *table, size_t table_size,
+			      size_t record_offset,
+			      const uint32_t *tlv_offsets, size_t num_tlvs,
+			      uint8_t ft, uint8_t *record_table,
+			      size_t total_size, size_t *curr_size)
+{
+	size_t record_hdr_size = sizeof(struct pldm_fru_record_data_format) -
+				 sizeof(struct pldm_fru_record_tlv);
+	size_t tlv_hdr_size = sizeof(struct pldm_fru_record_tlv) - 1;
+
+	if (table == NULL || record_table == NULL || curr_size == NULL ||
+	    (tlv_offsets == NULL && num_tlvs)) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+	if (record_offset + record_hdr_size > table_size ||
+	    *curr_size + record_hdr_size > total_size) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	struct pldm_fru_record_data_format *record_data_dest =
+	    (struct pldm_fru_record_data_format *)(record_table + *curr_size);
+	size_t pos = *curr_size;
+	memcpy(record_table + pos, table + record_offset, record_hdr_size);
+	pos += record_hdr_size;
+
+	uint8_t count = 0;
+	for (size_t i = 0; i < num_tlvs; i++) {
+		if (tlv_offsets[i] + tlv_hdr_size > table_size) {
+			return PLDM_ERROR_INVALID_LENGTH;
+		}
+		const struct pldm_fru_record_tlv *tlv =
+		    (const struct pldm_fru_record_tlv *)(table +
+							   tlv_offsets[i]);
+		if (tlv->type != ft && ft != 0) {
+			continue;
+		}
+		size_t len = tlv_hdr_size + tlv->length;
+		if (tlv_offsets[i] + len > table_size ||
+		    pos + len > total_size) {
+			return PLDM_ERROR_INVALID_LENGTH;
+		}
+		memcpy(record_table + pos, tlv, len);
+		pos += len;
+		count++;
+	}
+
+	record_data_dest->num_fru_fields = count;
+	*curr_size = pos;
+
+	return PLDM_SUCCESS;
+}
+
 int encode_get_fru_record_by_option_req(
     uint8_t instance_id, uint32_t data_transfer_handle,
     uint16_t fru_table_handle, uint16_t record_set_identifier,
@@ -475,6 +527,37 @@ int decode_get_fru_record_table_resp_safe(
 	return PLDM_SUCCESS;
 }
 
+int decode_get_fru_record_table_resp_part(
+    const struct pldm_msg *msg, size_t payload_length, uint8_t *completion_code,
+    uint32_t *next_data_transfer_handle, uint8_t *transfer_flag,
+    struct variable_field *fru_record_table_data)
+{
+	if (msg == NULL || completion_code == NULL ||
+	    next_data_transfer_handle == NULL || transfer_flag == NULL ||
+	    fru_record_table_data == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	*completion_code = msg->payload[0];
+	if (PLDM_SUCCESS != *completion_code) {
+		return PLDM_SUCCESS;
+	}
+	if (payload_length < PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	struct pldm_get_fru_record_table_resp *resp =
+	    (struct pldm_get_fru_record_table_resp *)msg->payload;
+
+	*next_data_transfer_handle = le32toh(resp->next_data_transfer_handle);
+	*transfer_flag = resp->transfer_flag;
+	fru_record_table_data->ptr = resp->fru_record_table_data;
+	fru_record_table_data->length =
+	    payload_length - PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES;
+
+	return PLDM_SUCCESS;
+}
+
 int decode_get_fru_record_table_resp(
     const struct pldm_msg *msg, size_t payload_length, uint8_t *completion_code,
     uint32_t *next_data_transfer_handle, uint8_t *transfer_flag,
@@ -389,6 +389,25 @@ int decode_get_fru_record_table_resp_safe(
     uint8_t *fru_record_table_data, size_t *fru_record_table_length,
     size_t max_fru_record_table_length);
 
+/** @brief Decode GetFruRecordTable response data without copying the portion
+ *         of the FRU record table, it is pointed to in the message.
+ *
+ *  @param[in] msg - Response message
+ *  @param[in] payload_length - Length of response message payload
+ *  @param[out] completion_code - Pointer to response msg's PLDM completion code
+ *  @param[out] next_data_transfer_handle - A handle used to identify the next
+ *  portion of the transfer
+ *  @param[out] transfer_flag - The transfer flag that indicates what part of
+ * the transfer this response represents
+ *  @param[out] fru_record_table_data - This portion of the overall FRU Record
+ * Table, it may be empty
+ *  @return pldm_completion_codes
+ */
+int decode_get_fru_record_table_resp_part(
+    const struct pldm_msg *msg, size_t payload_length, uint8_t *completion_code,
+    uint32_t *next_data_transfer_handle, uint8_t *transfer_flag,
+    struct variable_field *fru_record_table_data);
+
 /** @brief Encode the FRU record in the FRU table
  *
  *  @param[in/out] fru_table - Pointer to the FRU table
@@ -464,6 +483,32 @@ int decode_get_fru_record_by_option_resp(
 void get_fru_record_by_option(const uint8_t *table, size_t table_size,
 			      uint8_t *record_table, size_t *record_size,
 			      uint16_t rsi, uint8_t rt, uint8_t ft);
+
+/** @brief Get a FRU record of the FRU table by its offsets
+ *
+ *  Unlike get_fru_record_by_option, the table is not walked: the record and
+ *  its fields are copied from the offsets of an index built along with the
+ *  table.
+ *
+ *  @param[in] table - The source fru record table
+ *  @param[in] table_size - Size of the source fru record table
+ *  @param[in] record_offset - Offset of the FRU record in the table
+ *  @param[in] tlv_offsets - Offsets of the FRU fields of the record in the
+ *                           table
+ *  @param[in] num_tlvs - Number of FRU fields of the record
+ *  @param[in] ft - FRU field type, 0 for all the fields
+ *  @param[out] record_table - Fru table fetched based on the input option,
+ *                             the record is appended to it
+ *  @param[in] total_size - Size of record_table
+ *  @param[in/out] curr_size - Size of the records in record_table, it is
+ *                             advanced by the size of the record appended
+ *  @return pldm_completion_codes
+ */
+int get_fru_record_by_offsets(const uint8_t *table, size_t table_size,
+			      size_t record_offset,
+			      const uint32_t *tlv_offsets, size_t num_tlvs,
+			      uint8_t ft, uint8_t *record_table,
+			      size_t total_size, size_t *curr_size);
 /* SetFruRecordTable */
 
 /** @brief Decode SetFruRecordTable request data
@@ -5,13 +5,46 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include <stdio.h>
+struct pldm_assoc_index_entry {
+	pldm_entity entity;
+	bool is_remote;
+	pldm_pdr_record *record;
+};
+
+/* Open addressing hash table of entity association PDRs */
+struct pldm_assoc_index {
+	struct pldm_assoc_index_entry *entries;
+	size_t capacity;
+	size_t count;
+	bool duplicates;
+};
+
+struct pldm_key_index_entry {
+	uint64_t key;
+	pldm_pdr_record *record;
+};
+
+/* Open addressing hash table of PDRs by a key made of their fields */
+struct pldm_key_index {
+	struct pldm_key_index_entry *entries;
+	size_t capacity;
+	size_t count;
+};
 
 typedef struct pldm_pdr {
 	uint32_t record_count;
 	uint32_t size;
+	uint32_t generation;
 	pldm_pdr_record *first;
 	pldm_pdr_record *last;
+	struct pldm_assoc_index containers;
+	struct pldm_assoc_index contained;
+	uint32_t assoc_index_generation;
+	bool assoc_index_valid;
+	struct pldm_key_index effecters;
+	struct pldm_key_index sensors;
+	uint32_t id_index_generation;
+	bool id_index_valid;
 } pldm_pdr;
 
 static inline uint32_t get_next_record_handle(const pldm_pdr *repo,
@@ -41,6 +74,7 @@ static void add_record(pldm_pdr *repo, pldm_pdr_record *record)
 	}
 	repo->size += record->size;
 	++repo->record_count;
+	++repo->generation;
 }
 
 static void add_hotplug_record(pldm_pdr *repo, pldm_pdr_record *record,
@@ -78,6 +112,7 @@ static void add_hotplug_record(pldm_pdr *repo, pldm_pdr_record *record,
 	}
 	repo->size += record->size;
 	++repo->record_count;
+	++repo->generation;
 }
 
 static void add_record_after_record_handle(pldm_pdr *repo,
@@ -106,6 +141,7 @@ static void add_record_after_record_handle(pldm_pdr *repo,
 	}
 	repo->size += record->size;
 	++repo->record_count;
+	++repo->generation;
 }
 
 static inline uint32_t get_new_record_handle(const pldm_pdr *repo)
@@ -131,6 +167,7 @@ static pldm_pdr_record *make_new_record(const pldm_pdr *repo,
 	record->record_handle =
 	    record_handle == 0 ? get_new_record_handle(repo) : record_handle;
 	record->size = size;
+	record->capacity = size;
 	record->is_remote = is_remote;
 	record->terminus_handle = terminus_handle;
 	if (data != NULL) {
@@ -208,8 +245,17 @@ pldm_pdr *pldm_pdr_init()
 	assert(repo != NULL);
 	repo->record_count = 0;
 	repo->size = 0;
+	repo->generation = 0;
 	repo->first = NULL;
 	repo->last = NULL;
+	memset(&repo->containers, 0, sizeof(repo->containers));
+	memset(&repo->contained, 0, sizeof(repo->contained));
+	repo->assoc_index_generation = 0;
+	repo->assoc_index_valid = false;
+	memset(&repo->effecters, 0, sizeof(repo->effecters));
+	memset(&repo->sensors, 0, sizeof(repo->sensors));
+	repo->id_index_generation = 0;
+	repo->id_index_valid = false;
 
 	return repo;
 }
@@ -228,6 +274,10 @@ void pldm_pdr_destroy(pldm_pdr *repo)
 		free(record);
 		record = next;
 	}
+	free(repo->containers.entries);
+	free(repo->contained.entries);
+	free(repo->effecters.entries);
+	free(repo->sensors.entries);
 	free(repo);
 }
 
@@ -263,33 +313,17 @@ const pldm_pdr_record *pldm_pdr_find_record(const pldm_pdr *repo,
 
 pldm_pdr_record *pldm_pdr_find_last_local_record(const pldm_pdr *repo)
 {
-	printf("\nenter pldm_pdr_find_last_local_record record_count=%d \n",
-	       repo->record_count);
 	assert(repo != NULL);
 	pldm_pdr_record *curr = repo->first;
 	pldm_pdr_record *prev = repo->first;
-	uint32_t i = 0;
-	// printf("\n first record handle=%d\n",repo->first->record_handle);
-	// printf("\nlast record handle=%d,
-	// last->next=%d",repo->last->record_handle, (unsigned
-	// int)repo->last->next);
 	while (curr != NULL) {
-		i = curr->record_handle;
-		// printf("\ni=%d\n",i);
 		if (!(prev->is_remote) && (curr->is_remote)) {
-			printf("\nfound record at %d, prev->record_handle=%d\n",
-			       i, prev->record_handle);
 			return prev;
 		}
 		prev = curr;
 		curr = curr->next;
 	}
-	if (curr == NULL) {
-		printf("\nreached curr as NULL prev->record_handle=%d\n",
-		       prev->record_handle);
-		return prev;
-	}
-	return NULL;
+	return prev;
 }
 
 bool pldm_pdr_find_prev_record_handle(pldm_pdr *repo, uint32_t record_handle,
@@ -377,6 +411,13 @@ uint32_t pldm_pdr_get_repo_size(const pldm_pdr *repo)
 	return repo->size;
 }
 
+uint32_t pldm_pdr_get_generation(const pldm_pdr *repo)
+{
+	assert(repo != NULL);
+
+	return repo->generation;
+}
+
 uint32_t pldm_pdr_get_record_handle(const pldm_pdr *repo,
 				    const pldm_pdr_record *record)
 {
@@ -407,9 +448,6 @@ uint32_t pldm_pdr_add_fru_record_set(pldm_pdr *repo, uint16_t terminus_handle,
 
 	if (bmc_record_handle == 0xFFFF) // handle hot plug
 	{
-		printf("\nadding a hot plugged record, record count=%d before "
-		       "adding\n",
-		       repo->record_count);
 		hotplug = true;
 		pldm_pdr_record *curr = repo->first;
 		while (curr != NULL) {
@@ -420,7 +458,6 @@ uint32_t pldm_pdr_add_fru_record_set(pldm_pdr *repo, uint16_t terminus_handle,
 			curr = curr->next;
 		}
 		bmc_record_handle = prev->record_handle + 1;
-		printf("\ngenerated record handle=%d", bmc_record_handle);
 	}
 
 	struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)&data;
@@ -517,6 +554,7 @@ uint32_t pldm_pdr_remove_fru_record_set_by_rsi(pldm_pdr *repo, uint16_t fru_rsi,
 				}
 				--repo->record_count;
 				repo->size -= record->size;
+				++repo->generation;
 				if (record->data) {
 					free(record->data);
 				}
@@ -584,6 +622,7 @@ void pldm_delete_by_record_handle(pldm_pdr *repo, uint32_t record_handle,
 			}
 			--repo->record_count;
 			repo->size -= record->size;
+			++repo->generation;
 			free(record);
 			break;
 		} else {
@@ -709,9 +748,293 @@ void pldm_change_container_id_of_effecter(const pldm_pdr *repo,
 	}
 }
 
+static inline struct pldm_pdr_entity_association *
+get_entity_association(const pldm_pdr_record *record)
+{
+	return (struct pldm_pdr_entity_association *)(record->data +
+						      sizeof(struct pldm_pdr_hdr));
+}
+
+static size_t key_index_hash(uint64_t key)
+{
+	/* Spread the key to the low bits, the table size is a power of two */
+	return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+static struct pldm_key_index_entry *
+key_index_lookup(const struct pldm_key_index *index, uint64_t key)
+{
+	if (index->capacity == 0) {
+		return NULL;
+	}
+
+	size_t mask = index->capacity - 1;
+	size_t pos = key_index_hash(key) & mask;
+	while (index->entries[pos].record != NULL) {
+		if (index->entries[pos].key == key) {
+			return &index->entries[pos];
+		}
+		pos = (pos + 1) & mask;
+	}
+	return NULL;
+}
+
+static void key_index_insert(struct pldm_key_index *index, uint64_t key,
+			     pldm_pdr_record *record);
+
+static void key_index_grow(struct pldm_key_index *index)
+{
+	struct pldm_key_index old = *index;
+
+	index->capacity = old.capacity ? old.capacity * 2 : 64;
+	index->count = 0;
+	index->entries =
+	    calloc(index->capacity, sizeof(struct pldm_key_index_entry));
+	assert(index->entries != NULL);
+	for (size_t i = 0; i < old.capacity; ++i) {
+		if (old.entries[i].record != NULL) {
+			key_index_insert(index, old.entries[i].key,
+					 old.entries[i].record);
+		}
+	}
+	free(old.entries);
+}
+
+/* Keep the first record a key was found in, as a walk of the repo would */
+static void key_index_insert(struct pldm_key_index *index, uint64_t key,
+			     pldm_pdr_record *record)
+{
+	if ((index->count + 1) * 2 > index->capacity) {
+		key_index_grow(index);
+	}
+
+	size_t mask = index->capacity - 1;
+	size_t pos = key_index_hash(key) & mask;
+	while (index->entries[pos].record != NULL) {
+		if (index->entries[pos].key == key) {
+			return;
+		}
+		pos = (pos + 1) & mask;
+	}
+	index->entries[pos].key = key;
+	index->entries[pos].record = record;
+	++index->count;
+}
+
+static void key_index_clear(struct pldm_key_index *index)
+{
+	free(index->entries);
+	index->entries = NULL;
+	index->capacity = 0;
+	index->count = 0;
+}
+
+static inline uint64_t effecter_key(uint8_t pdr_type, uint16_t effecter_id,
+				    bool is_remote)
+{
+	return (uint64_t)pdr_type << 24 | (uint64_t)is_remote << 16 |
+	       effecter_id;
+}
+
+static inline uint64_t sensor_key(const pldm_entity *entity,
+				  uint16_t state_set_id)
+{
+	return (uint64_t)entity->entity_type << 48 |
+	       (uint64_t)entity->entity_instance_num << 32 |
+	       (uint64_t)entity->entity_container_id << 16 | state_set_id;
+}
+
+/* Index the effecter PDRs by effecter ID, and the state sensor PDRs by entity
+ * and state set. The indexes are rebuilt after records are added to or removed
+ * from the repo. */
+static void id_index_refresh(pldm_pdr *repo)
+{
+	if (repo->id_index_valid &&
+	    repo->id_index_generation == repo->generation) {
+		return;
+	}
+
+	key_index_clear(&repo->effecters);
+	key_index_clear(&repo->sensors);
+	pldm_pdr_record *record = repo->first;
+	while (record != NULL) {
+		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
+		if (hdr->type == PLDM_STATE_EFFECTER_PDR ||
+		    hdr->type == PLDM_NUMERIC_EFFECTER_PDR) {
+			/* The effecter ID is at the same offset in both */
+			struct pldm_state_effecter_pdr *pdr =
+			    (struct pldm_state_effecter_pdr *)record->data;
+			key_index_insert(&repo->effecters,
+					 effecter_key(hdr->type,
+						      pdr->effecter_id,
+						      record->is_remote),
+					 record);
+		} else if (hdr->type == PLDM_STATE_SENSOR_PDR &&
+			   record->size >=
+			       sizeof(struct pldm_state_sensor_pdr) - 1) {
+			struct pldm_state_sensor_pdr *pdr =
+			    (struct pldm_state_sensor_pdr *)record->data;
+			pldm_entity entity = {pdr->entity_type,
+					      pdr->entity_instance,
+					      pdr->container_id};
+			const uint8_t *end = record->data + record->size;
+			const uint8_t *states = pdr->possible_states;
+			for (int i = 0; i < pdr->composite_sensor_count &&
+					states + 3 <= end;
+			     ++i) {
+				const struct state_sensor_possible_states
+				    *possible_states =
+					(const struct
+					 state_sensor_possible_states *)states;
+				key_index_insert(
+				    &repo->sensors,
+				    sensor_key(&entity,
+					       possible_states->state_set_id),
+				    record);
+				states +=
+				    3 + possible_states->possible_states_size;
+			}
+		}
+		record = record->next;
+	}
+	repo->id_index_generation = repo->generation;
+	repo->id_index_valid = true;
+}
+
+const pldm_pdr_record *
+pldm_pdr_find_effecter_by_id(const pldm_pdr *repo, uint8_t pdr_type,
+			     uint16_t effecter_id, bool is_remote,
+			     uint8_t **data, uint32_t *size)
+{
+	assert(repo != NULL);
+
+	/* The indexes are a cache, refreshing them leaves the records as they
+	 * are */
+	pldm_pdr *indexed = (pldm_pdr *)repo;
+	id_index_refresh(indexed);
+	uint64_t key = effecter_key(pdr_type, effecter_id, is_remote);
+	struct pldm_key_index_entry *entry =
+	    key_index_lookup(&indexed->effecters, key);
+	if (entry == NULL) {
+		return NULL;
+	}
+	if (data != NULL) {
+		*data = entry->record->data;
+	}
+	if (size != NULL) {
+		*size = entry->record->size;
+	}
+	return entry->record;
+}
+
+bool pldm_pdr_find_state_sensor_id(const pldm_pdr *repo, pldm_entity entity,
+				   uint16_t state_set_id, uint16_t *sensor_id)
+{
+	assert(repo != NULL);
+	assert(sensor_id != NULL);
+
+	pldm_pdr *indexed = (pldm_pdr *)repo;
+	id_index_refresh(indexed);
+	struct pldm_key_index_entry *entry = key_index_lookup(
+	    &indexed->sensors, sensor_key(&entity, state_set_id));
+	if (entry == NULL) {
+		return false;
+	}
+	*sensor_id =
+	    ((struct pldm_state_sensor_pdr *)entry->record->data)->sensor_id;
+	return true;
+}
+
+static int compare_container_ids(const void *lhs, const void *rhs)
+{
+	const struct pldm_effecter_container_id *l = lhs;
+	const struct pldm_effecter_container_id *r = rhs;
+	return (int)l->entity_instance - (int)r->entity_instance;
+}
+
+void pldm_change_container_id_of_effecters(
+    const pldm_pdr *repo, uint16_t container_entity_type,
+    struct pldm_effecter_container_id *updates, size_t count)
+{
+	assert(repo != NULL);
+	assert(updates != NULL || count == 0);
+
+	if (count == 0) {
+		return;
+	}
+
+	/* Look up the entity instances in one walk of the repo, the updates
+	 * are sorted by entity instance for it */
+	qsort(updates, count, sizeof(*updates), compare_container_ids);
+	bool *resolved = calloc(count, sizeof(bool));
+	assert(resolved != NULL);
+	for (size_t i = 0; i < count; ++i) {
+		updates[i].container_id = 0;
+	}
+	size_t unresolved = count;
+	pldm_pdr_record *record = repo->first;
+	while (record != NULL && unresolved) {
+		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
+		if (hdr->type != PLDM_PDR_ENTITY_ASSOCIATION) {
+			record = record->next;
+			continue;
+		}
+		struct pldm_pdr_entity_association *pdr =
+		    get_entity_association(record);
+		struct pldm_effecter_container_id key = {
+		    0, pdr->container.entity_instance_num, 0};
+		struct pldm_effecter_container_id *update = NULL;
+		if (pdr->num_children &&
+		    pdr->container.entity_type == container_entity_type) {
+			update = bsearch(&key, updates, count, sizeof(*updates),
+					 compare_container_ids);
+		}
+		if (update != NULL && !resolved[update - updates]) {
+			/* Effecters of the same instance are next to it */
+			while (update > updates &&
+			       update[-1].entity_instance ==
+				   key.entity_instance) {
+				--update;
+			}
+			for (; update < updates + count &&
+			       update->entity_instance == key.entity_instance;
+			     ++update) {
+				update->container_id =
+				    pdr->children[0].entity_container_id;
+				resolved[update - updates] = true;
+				--unresolved;
+			}
+		}
+		record = record->next;
+	}
+	free(resolved);
+
+	for (size_t i = 0; i < count; ++i) {
+		uint8_t *data = NULL;
+		if (pldm_pdr_find_effecter_by_id(
+			repo, PLDM_NUMERIC_EFFECTER_PDR, updates[i].effecter_id,
+			false, &data, NULL) == NULL &&
+		    pldm_pdr_find_effecter_by_id(
+			repo, PLDM_NUMERIC_EFFECTER_PDR, updates[i].effecter_id,
+			true, &data, NULL) == NULL) {
+			continue;
+		}
+		((struct pldm_numeric_effecter_value_pdr *)data)
+		    ->container_id = updates[i].container_id;
+	}
+}
+
+/* The nodes added for a remote terminus make an overlay on the local ones.
+ * The local nodes the overlay is attached to are kept, so that the overlay can
+ * be removed without walking the whole tree. */
 typedef struct pldm_entity_association_tree {
 	pldm_entity_node *root;
 	uint16_t last_used_container_id;
+	uint16_t last_local_container_id;
+	bool overlay_in_root; /* remote nodes in the sibling list of the root */
+	pldm_entity_node **overlay_parents;
+	size_t num_overlay_parents;
+	size_t overlay_parents_capacity;
 } pldm_entity_association_tree;
 
 typedef struct pldm_entity_node {
@@ -721,8 +1044,105 @@ typedef struct pldm_entity_node {
 	pldm_entity_node *first_child;
 	pldm_entity_node *next_sibling;
 	uint8_t association_type;
+	bool is_remote;
+	bool is_overlay_parent; /* has remote children, and is not remote */
 } pldm_entity_node;
 
+/* Number of entries of a node stack kept on the stack of its user, a walk only
+ * allocates for trees with more sibling lists pending than that */
+#define NODE_STACK_INLINE_SIZE 32
+
+struct node_stack_entry {
+	pldm_entity_node *node;
+	pldm_entity_node **copy;
+};
+
+/* Sibling lists still to walk, for the traversals of the tree to not recurse */
+struct node_stack {
+	struct node_stack_entry *entries;
+	size_t size;
+	size_t capacity;
+	struct node_stack_entry inline_entries[NODE_STACK_INLINE_SIZE];
+};
+
+static void node_stack_init(struct node_stack *stack)
+{
+	stack->entries = stack->inline_entries;
+	stack->size = 0;
+	stack->capacity = NODE_STACK_INLINE_SIZE;
+}
+
+static void node_stack_push(struct node_stack *stack, pldm_entity_node *node,
+			    pldm_entity_node **copy)
+{
+	if (stack->size == stack->capacity) {
+		size_t capacity = stack->capacity * 2;
+		struct node_stack_entry *entries = NULL;
+		if (stack->entries == stack->inline_entries) {
+			entries = malloc(capacity * sizeof(*entries));
+			assert(entries != NULL);
+			memcpy(entries, stack->inline_entries,
+			       sizeof(stack->inline_entries));
+		} else {
+			entries = realloc(stack->entries,
+					  capacity * sizeof(*entries));
+			assert(entries != NULL);
+		}
+		stack->entries = entries;
+		stack->capacity = capacity;
+	}
+	stack->entries[stack->size].node = node;
+	stack->entries[stack->size].copy = copy;
+	++stack->size;
+}
+
+static bool node_stack_pop(struct node_stack *stack,
+			   struct node_stack_entry *entry)
+{
+	if (stack->size == 0) {
+		return false;
+	}
+	*entry = stack->entries[--stack->size];
+	return true;
+}
+
+static void node_stack_release(struct node_stack *stack)
+{
+	if (stack->entries != stack->inline_entries) {
+		free(stack->entries);
+	}
+	node_stack_init(stack);
+}
+
+typedef bool (*node_visitor)(pldm_entity_node *node, void *ctx);
+
+/* Visit a node, the nodes after it in its sibling list with their descendants,
+ * and then its own descendants, until the visitor returns false. This is the
+ * order of a recursion on the next sibling and then on the first child. Only
+ * the child lists still to walk are stacked, so a wide sibling list costs no
+ * stack depth. */
+static void entity_association_tree_walk(pldm_entity_node *node,
+					 node_visitor visitor, void *ctx)
+{
+	struct node_stack stack;
+	node_stack_init(&stack);
+	struct node_stack_entry entry;
+	do {
+		for (; node != NULL; node = node->next_sibling) {
+			if (!visitor(node, ctx)) {
+				node_stack_release(&stack);
+				return;
+			}
+			if (node->first_child != NULL) {
+				node_stack_push(&stack, node->first_child,
+						NULL);
+			}
+		}
+		node = node_stack_pop(&stack, &entry) ? entry.node : NULL;
+	} while (node != NULL);
+	node_stack_release(&stack);
+}
+
 static inline uint16_t next_container_id(pldm_entity_association_tree *tree)
 {
 	assert(tree != NULL);
@@ -752,10 +1172,52 @@ pldm_entity_association_tree *pldm_entity_association_tree_init()
 	assert(tree != NULL);
 	tree->root = NULL;
 	tree->last_used_container_id = 0;
+	tree->last_local_container_id = 0;
+	tree->overlay_in_root = false;
+	tree->overlay_parents = NULL;
+	tree->num_overlay_parents = 0;
+	tree->overlay_parents_capacity = 0;
 
 	return tree;
 }
 
+static void overlay_add(pldm_entity_association_tree *tree,
+			pldm_entity_node *parent)
+{
+	if (parent == NULL) {
+		tree->overlay_in_root = true;
+		return;
+	}
+	if (parent->is_remote || parent->is_overlay_parent) {
+		return;
+	}
+	if (tree->num_overlay_parents == tree->overlay_parents_capacity) {
+		size_t capacity = tree->overlay_parents_capacity
+				      ? tree->overlay_parents_capacity * 2
+				      : 16;
+		pldm_entity_node **parents = realloc(
+		    tree->overlay_parents, capacity * sizeof(*parents));
+		assert(parents != NULL);
+		tree->overlay_parents = parents;
+		tree->overlay_parents_capacity = capacity;
+	}
+	tree->overlay_parents[tree->num_overlay_parents++] = parent;
+	parent->is_overlay_parent = true;
+}
+
+static void overlay_remove(pldm_entity_association_tree *tree,
+			   pldm_entity_node *parent)
+{
+	for (size_t i = 0; i < tree->num_overlay_parents; ++i) {
+		if (tree->overlay_parents[i] == parent) {
+			tree->overlay_parents[i] =
+			    tree->overlay_parents[--tree->num_overlay_parents];
+			break;
+		}
+	}
+	parent->is_overlay_parent = false;
+}
+
 static pldm_entity_node *
 find_insertion_at(pldm_entity_node *start,
 		  uint16_t entity_type) //,uint16_t *instance) //sm00
@@ -806,6 +1268,7 @@ pldm_entity_node *pldm_entity_association_tree_add(
 	assert(tree != NULL);
 	assert(entity != NULL);
 	// uint16_t instance = 0; //sm00
+	uint16_t last_used_container_id = tree->last_used_container_id;
 
 	if (entity_instance_number != 0xFFFF && parent != NULL) {
 		pldm_entity node;
@@ -830,6 +1293,8 @@ pldm_entity_node *pldm_entity_association_tree_add(
 	    entity_instance_number != 0xFFFF ? entity_instance_number : 1;
 	node->association_type = association_type;
 	node->host_container_id = 0;
+	node->is_remote = is_remote;
+	node->is_overlay_parent = false;
 
 	if (tree->root == NULL) {
 		assert(parent == NULL);
@@ -889,58 +1354,47 @@ pldm_entity_node *pldm_entity_association_tree_add(
 	if (is_update_contanier_id) {
 		entity->entity_container_id = node->entity.entity_container_id;
 	}
+	if (is_remote) {
+		overlay_add(tree, parent);
+	} else if (tree->last_used_container_id != last_used_container_id) {
+		tree->last_local_container_id = tree->last_used_container_id;
+	}
 
 	/*printf("\nexit pldm_entity_association_tree_add"); */
 	return node;
 }
 
-static void get_num_nodes(pldm_entity_node *node, size_t *num)
+static bool count_node(pldm_entity_node *node, void *ctx)
 {
-	if (node == NULL) {
-		return;
-	}
-
-	++(*num);
-	get_num_nodes(node->next_sibling, num);
-	get_num_nodes(node->first_child, num);
+	(void)node;
+	++(*(size_t *)ctx);
+	return true;
 }
 
-static void entity_association_tree_visit(pldm_entity_node *node,
-					  pldm_entity *entities, size_t *index)
+static void get_num_nodes(pldm_entity_node *node, size_t *num)
 {
-	if (node == NULL) {
-		return;
-	}
+	entity_association_tree_walk(node, count_node, num);
+}
 
-	pldm_entity *entity = &entities[*index];
-	++(*index);
+struct entity_list {
+	pldm_entity *entities;
+	size_t index;
+};
+
+static bool list_entity(pldm_entity_node *node, void *ctx)
+{
+	struct entity_list *list = ctx;
+	pldm_entity *entity = &list->entities[list->index];
+	++list->index;
 	entity->entity_type = node->entity.entity_type;
 	entity->entity_instance_num = node->entity.entity_instance_num;
 	entity->entity_container_id = node->entity.entity_container_id;
-	printf("\n\n\nentity_type=%d, instance_num=%d,container_id=%d",
-	       entity->entity_type, entity->entity_instance_num,
-	       entity->entity_container_id);
-	if (node->next_sibling) {
-		printf("\nsibling type=%d, instance=%d, container=%d",
-		       node->next_sibling->entity.entity_type,
-		       node->next_sibling->entity.entity_instance_num,
-		       node->next_sibling->entity.entity_container_id);
-	}
-	if (node->first_child) {
-		printf("\nfirst child type=%d, instance=%d, container=%d",
-		       node->first_child->entity.entity_type,
-		       node->first_child->entity.entity_instance_num,
-		       node->first_child->entity.entity_container_id);
-	}
-	entity_association_tree_visit(node->next_sibling, entities, index);
-	entity_association_tree_visit(node->first_child, entities, index);
+	return true;
 }
 
 void pldm_entity_association_tree_visit(pldm_entity_association_tree *tree,
 					pldm_entity **entities, size_t *size)
 {
-	/*  printf("\nenter pldm_entity_association_tree_visit with
-	 * tree=%p\n",(void*)tree); */
 	assert(tree != NULL);
 
 	*size = 0;
@@ -950,26 +1404,64 @@ void pldm_entity_association_tree_visit(pldm_entity_association_tree *tree,
 
 	get_num_nodes(tree->root, size);
 	*entities = malloc(*size * sizeof(pldm_entity));
-	size_t index = 0;
-	entity_association_tree_visit(tree->root, *entities, &index);
+	assert(*entities != NULL);
+	struct entity_list list = {*entities, 0};
+	entity_association_tree_walk(tree->root, list_entity, &list);
+}
+
+struct entity_visit {
+	pldm_entity_visitor visitor;
+	void *ctx;
+};
+
+static bool visit_entity(pldm_entity_node *node, void *ctx)
+{
+	struct entity_visit *visit = ctx;
+	return visit->visitor(&node->entity, visit->ctx);
 }
 
-static void entity_association_tree_destroy(pldm_entity_node *node)
+void pldm_entity_association_tree_for_each(pldm_entity_association_tree *tree,
+					   pldm_entity_visitor visitor,
+					   void *ctx)
 {
-	if (node == NULL) {
-		return;
-	}
+	assert(tree != NULL);
+	assert(visitor != NULL);
 
-	entity_association_tree_destroy(node->next_sibling);
-	entity_association_tree_destroy(node->first_child);
-	free(node);
+	struct entity_visit visit = {visitor, ctx};
+	entity_association_tree_walk(tree->root, visit_entity, &visit);
+}
+
+static void entity_association_tree_destroy(pldm_entity_association_tree *tree,
+					    pldm_entity_node *node)
+{
+	struct node_stack stack;
+	node_stack_init(&stack);
+	struct node_stack_entry entry;
+	do {
+		while (node != NULL) {
+			pldm_entity_node *next = node->next_sibling;
+			if (node->first_child != NULL) {
+				node_stack_push(&stack, node->first_child,
+						NULL);
+			}
+			if (node->is_overlay_parent) {
+				overlay_remove(tree, node);
+			}
+			free(node);
+			node = next;
+		}
+		node = node_stack_pop(&stack, &entry) ? entry.node : NULL;
+	} while (node != NULL);
+	node_stack_release(&stack);
 }
 
 void pldm_entity_association_tree_destroy(pldm_entity_association_tree *tree)
 {
 	assert(tree != NULL);
 
-	entity_association_tree_destroy(tree->root);
+	tree->num_overlay_parents = 0;
+	entity_association_tree_destroy(tree, tree->root);
+	free(tree->overlay_parents);
 	free(tree);
 }
 
@@ -1013,7 +1505,7 @@ void pldm_entity_association_tree_delete_node(
 		prev->next_sibling = start->next_sibling;
 	}
 	start->next_sibling = NULL;
-	entity_association_tree_destroy(node);
+	entity_association_tree_destroy(tree, node);
 }
 
 inline bool pldm_entity_is_node_parent(pldm_entity_node *node)
@@ -1178,24 +1670,33 @@ bool is_present(pldm_entity entity, pldm_entity **entities, size_t num_entities)
 	return false;
 }
 
+struct entity_association_pdr_add_ctx {
+	pldm_pdr *repo;
+	pldm_entity **entities;
+	size_t num_entities;
+	bool is_remote;
+	uint16_t terminus_handle;
+};
+
+static bool add_entity_association_pdrs(pldm_entity_node *node, void *ctx)
+{
+	struct entity_association_pdr_add_ctx *add = ctx;
+	if (is_present(node->entity, add->entities, add->num_entities)) {
+		entity_association_pdr_add_entry(node, add->repo,
+						 add->is_remote,
+						 add->terminus_handle);
+	}
+	return true;
+}
+
 static void entity_association_pdr_add(pldm_entity_node *curr, pldm_pdr *repo,
 				       pldm_entity **entities,
 				       size_t num_entities, bool is_remote,
 				       uint16_t terminus_handle)
 {
-	if (curr == NULL) {
-		return;
-	}
-	bool to_add = true;
-	to_add = is_present(curr->entity, entities, num_entities);
-	if (to_add) {
-		entity_association_pdr_add_entry(curr, repo, is_remote,
-						 terminus_handle);
-	}
-	entity_association_pdr_add(curr->next_sibling, repo, entities,
-				   num_entities, is_remote, terminus_handle);
-	entity_association_pdr_add(curr->first_child, repo, entities,
-				   num_entities, is_remote, terminus_handle);
+	struct entity_association_pdr_add_ctx add = {
+	    repo, entities, num_entities, is_remote, terminus_handle};
+	entity_association_tree_walk(curr, add_entity_association_pdrs, &add);
 }
 
 void pldm_entity_association_pdr_add(pldm_entity_association_tree *tree,
@@ -1219,218 +1720,233 @@ void pldm_entity_association_pdr_add_from_node(
 				   is_remote, terminus_handle);
 }
 
-uint32_t find_record_handle_by_contained_entity(pldm_pdr *repo,
-						pldm_entity entity,
-						bool is_remote)
+static inline bool entity_equal(const pldm_entity *lhs,
+				const pldm_entity *rhs)
 {
-	/*printf("\nenter find_record_handle_by_contained_entity with "
-		"entity_type=%d, entity_instance_num=%d, "
-		"entity_container_id=%d,is_remote=%d",
-		entity.entity_type, entity.entity_instance_num,
-		entity.entity_container_id, is_remote);*/
-	uint32_t record_handle = 0;
-	bool found = false;
-	assert(repo != NULL);
+	return lhs->entity_type == rhs->entity_type &&
+	       lhs->entity_instance_num == rhs->entity_instance_num &&
+	       lhs->entity_container_id == rhs->entity_container_id;
+}
+
+static size_t assoc_index_hash(const pldm_entity *entity, bool is_remote)
+{
+	size_t hash = entity->entity_type;
+	hash = hash * 31 + entity->entity_instance_num;
+	hash = hash * 31 + entity->entity_container_id;
+	hash = hash * 2 + is_remote;
+	/* Spread the low bits, the table size is a power of two */
+	return hash * 0x9E3779B1u;
+}
+
+static struct pldm_assoc_index_entry *
+assoc_index_lookup(const struct pldm_assoc_index *index,
+		   const pldm_entity *entity, bool is_remote)
+{
+	if (index->capacity == 0) {
+		return NULL;
+	}
+
+	size_t mask = index->capacity - 1;
+	size_t pos = assoc_index_hash(entity, is_remote) & mask;
+	while (index->entries[pos].record != NULL) {
+		struct pldm_assoc_index_entry *entry = &index->entries[pos];
+		if (entry->is_remote == is_remote &&
+		    entity_equal(&entry->entity, entity)) {
+			return entry;
+		}
+		pos = (pos + 1) & mask;
+	}
+	return NULL;
+}
+
+static void assoc_index_insert(struct pldm_assoc_index *index,
+			       const pldm_entity *entity, bool is_remote,
+			       pldm_pdr_record *record);
+
+static void assoc_index_grow(struct pldm_assoc_index *index)
+{
+	struct pldm_assoc_index old = *index;
+
+	index->capacity = old.capacity ? old.capacity * 2 : 64;
+	index->count = 0;
+	index->entries =
+	    calloc(index->capacity, sizeof(struct pldm_assoc_index_entry));
+	assert(index->entries != NULL);
+	for (size_t i = 0; i < old.capacity; ++i) {
+		if (old.entries[i].record != NULL) {
+			assoc_index_insert(index, &old.entries[i].entity,
+					   old.entries[i].is_remote,
+					   old.entries[i].record);
+		}
+	}
+	free(old.entries);
+}
+
+/* Keep the first record an entity was found in, as a walk of the repo would */
+static void assoc_index_insert(struct pldm_assoc_index *index,
+			       const pldm_entity *entity, bool is_remote,
+			       pldm_pdr_record *record)
+{
+	if ((index->count + 1) * 2 > index->capacity) {
+		assoc_index_grow(index);
+	}
+
+	size_t mask = index->capacity - 1;
+	size_t pos = assoc_index_hash(entity, is_remote) & mask;
+	while (index->entries[pos].record != NULL) {
+		struct pldm_assoc_index_entry *entry = &index->entries[pos];
+		if (entry->is_remote == is_remote &&
+		    entity_equal(&entry->entity, entity)) {
+			index->duplicates = true;
+			return;
+		}
+		pos = (pos + 1) & mask;
+	}
+	index->entries[pos].entity = *entity;
+	index->entries[pos].is_remote = is_remote;
+	index->entries[pos].record = record;
+	++index->count;
+}
+
+static void assoc_index_remove(struct pldm_assoc_index *index,
+			       struct pldm_assoc_index_entry *entry)
+{
+	/* Linear probing: shift back the entries of the cluster that follow
+	 * the removed one, so that lookups don't stop at the hole */
+	size_t mask = index->capacity - 1;
+	size_t hole = entry - index->entries;
+	size_t pos = (hole + 1) & mask;
+	while (index->entries[pos].record != NULL) {
+		struct pldm_assoc_index_entry *curr = &index->entries[pos];
+		size_t home =
+		    assoc_index_hash(&curr->entity, curr->is_remote) & mask;
+		if (((pos - home) & mask) >= ((pos - hole) & mask)) {
+			index->entries[hole] = *curr;
+			hole = pos;
+		}
+		pos = (pos + 1) & mask;
+	}
+	index->entries[hole].record = NULL;
+	--index->count;
+}
+
+static void assoc_index_clear(struct pldm_assoc_index *index)
+{
+	free(index->entries);
+	index->entries = NULL;
+	index->capacity = 0;
+	index->count = 0;
+	index->duplicates = false;
+}
+
+/* Index the entity association PDRs by container and by contained entity.
+ * The index is rebuilt after records are added to or removed from the repo,
+ * changes to the children of a PDR keep it up to date themselves. */
+static void assoc_index_refresh(pldm_pdr *repo)
+{
+	if (repo->assoc_index_valid &&
+	    repo->assoc_index_generation == repo->generation) {
+		return;
+	}
+
+	assoc_index_clear(&repo->containers);
+	assoc_index_clear(&repo->contained);
 	pldm_pdr_record *record = repo->first;
-	while (record != NULL && !found) {
-		pldm_pdr_record *next = record->next;
+	while (record != NULL) {
 		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
-		if ((record->is_remote == is_remote) &&
-		    hdr->type == PLDM_PDR_ENTITY_ASSOCIATION) {
-			/*	printf("\ngot one PLDM_PDR_ENTITY_ASSOCIATION "
-				       "record_handle=%d",
-				       record->record_handle);*/
+		if (hdr->type == PLDM_PDR_ENTITY_ASSOCIATION) {
 			struct pldm_pdr_entity_association *pdr =
-			    (struct pldm_pdr_entity_association
-				 *)((uint8_t *)record->data +
-				    sizeof(struct pldm_pdr_hdr));
-			/*	printf("\npdr->container_id=%d,pdr->num_children=%d",
-				       pdr->container_id, pdr->num_children);*/
-			struct pldm_entity *child =
-			    (struct pldm_entity *)(&pdr->children[0]);
+			    get_entity_association(record);
+			assoc_index_insert(&repo->containers, &pdr->container,
+					   record->is_remote, record);
 			for (int i = 0; i < pdr->num_children; ++i) {
-				if (child->entity_type == entity.entity_type &&
-				    child->entity_instance_num ==
-					entity.entity_instance_num &&
-				    child->entity_container_id ==
-					entity.entity_container_id) {
-					/*	printf("\nFOUND
-					   record_handle=%d",
-						       record->record_handle);*/
-					found = true;
-					record_handle = record->record_handle;
-					break;
-				}
-				child++;
+				assoc_index_insert(&repo->contained,
+						   &pdr->children[i],
+						   record->is_remote, record);
 			}
-		} // end if PLDM_PDR_ENTITY_ASSOCIATION
-		//   record = record->next;
-		record = next;
-	} // end while
-	return record_handle;
+		}
+		record = record->next;
+	}
+	repo->assoc_index_generation = repo->generation;
+	repo->assoc_index_valid = true;
+}
+
+uint32_t find_record_handle_by_contained_entity(pldm_pdr *repo,
+						pldm_entity entity,
+						bool is_remote)
+{
+	assert(repo != NULL);
+
+	assoc_index_refresh(repo);
+	struct pldm_assoc_index_entry *entry =
+	    assoc_index_lookup(&repo->contained, &entity, is_remote);
+	return entry != NULL ? entry->record->record_handle : 0;
 }
 
 uint32_t pldm_entity_association_pdr_remove_contained_entity(
     pldm_pdr *repo, pldm_entity entity, uint8_t *event_data_op, bool is_remote)
 {
 	assert(repo != NULL);
-	uint32_t updated_hdl = 0;
-	bool removed = false;
-	*event_data_op = PLDM_RECORDS_MODIFIED;
-	updated_hdl =
-	    find_record_handle_by_contained_entity(repo, entity, is_remote);
-	if (!updated_hdl) {
+	assert(event_data_op != NULL);
+
+	assoc_index_refresh(repo);
+	struct pldm_assoc_index_entry *entry =
+	    assoc_index_lookup(&repo->contained, &entity, is_remote);
+	if (entry == NULL) {
 		*event_data_op = PLDM_INVALID_OP;
-		return updated_hdl;
+		return 0;
 	}
-	/*	printf("\npldm_entity_association_pdr_remove_contained_entity
-	   found " "the record handle to delete %d", updated_hdl);*/
-
-	pldm_pdr_record *record = repo->first;
-	pldm_pdr_record *prev = repo->first;
-	pldm_pdr_record *new_record = malloc(sizeof(pldm_pdr_record));
-	new_record->data = NULL; // sm00
-	// new_record->data = malloc(record->size - sizeof(pldm_entity)); //sm00
-	// new_record->next = NULL; //sm00
-	// uint8_t *new_data = new_record->data; //sm00
-	while (record != NULL) {
-		pldm_pdr_record *next = record->next;
-		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
-		if (record->record_handle ==
-		    updated_hdl) /*(record->is_remote == is_remote) &&*/
-		/*hdr->type == PLDM_PDR_ENTITY_ASSOCIATION)*/ {
-			new_record->data =
-			    malloc(record->size - sizeof(pldm_entity)); // sm00
-			new_record->next = NULL;			// sm00
-			new_record->record_handle =
-			    htole32(record->record_handle);
-			new_record->size =
-			    htole32(record->size - sizeof(pldm_entity)); // sm00
-			new_record->is_remote = record->is_remote;
-			uint8_t *new_start = new_record->data; // sm00 new_data;
-			struct pldm_pdr_hdr *new_hdr =
-			    (struct pldm_pdr_hdr *)
-				new_record->data; // sm00 new_data;
-			new_hdr->version = hdr->version;
-			new_hdr->record_handle = htole32(hdr->record_handle);
-			new_hdr->type = PLDM_PDR_ENTITY_ASSOCIATION;
-			new_hdr->record_change_num =
-			    htole16(hdr->record_change_num);
-			/*new_hdr->length =
-			    htole16(record->size - sizeof(struct pldm_pdr_hdr) -
-				    sizeof(pldm_entity));*/
-			new_hdr->length =
-			    htole16(hdr->length - sizeof(pldm_entity)); // sm00
-			new_start += sizeof(struct pldm_pdr_hdr);
-			struct pldm_pdr_entity_association *new_pdr =
-			    (struct pldm_pdr_entity_association *)new_start;
-
-			struct pldm_pdr_entity_association *pdr =
-			    (struct pldm_pdr_entity_association
-				 *)((uint8_t *)record->data +
-				    sizeof(struct pldm_pdr_hdr));
-			struct pldm_entity *child =
-			    (struct pldm_entity *)(&pdr->children[0]);
 
-			new_pdr->container_id = pdr->container_id;
-			new_pdr->association_type = pdr->association_type;
-			new_pdr->container.entity_type =
-			    pdr->container.entity_type;
-			new_pdr->container.entity_instance_num =
-			    pdr->container.entity_instance_num;
-			new_pdr->container.entity_container_id =
-			    pdr->container.entity_container_id;
-			new_pdr->num_children =
-			    pdr->num_children -
-			    1; // if this becomes 0 then just delete. no new
-			       // entity assoc pdr is needed PENDING. can test
-			       // once pcie cards are placed under slots
-			struct pldm_entity *new_child =
-			    (struct pldm_entity *)(&new_pdr->children[0]);
-
-			for (int i = 0; i < pdr->num_children; ++i) {
-				if (child->entity_type == entity.entity_type &&
-				    child->entity_instance_num ==
-					entity.entity_instance_num &&
-				    child->entity_container_id ==
-					entity.entity_container_id) {
-					removed = true;
-					//	updated_hdl =
-					// hdr->record_handle; sm00 not needed
-					// as we are getting earlier
-					// skip this child.do not add in the
-					// new pdr
-				} else {
-					new_child->entity_type =
-					    child->entity_type;
-					new_child->entity_instance_num =
-					    child->entity_instance_num;
-					new_child->entity_container_id =
-					    child->entity_container_id;
-					new_child++;
-				}
-
-				++child;
-			}
-			if (!new_pdr
-				 ->num_children) // record will be deleted and
-						 // new_record will not be added
-			{
-				removed = false;
-				*event_data_op = PLDM_RECORDS_DELETED;
-				if (repo->first == record) {
-					repo->first = record->next;
-					record->next = NULL;
-				} else if (repo->last == record) {
-					repo->last = prev;
-					prev->next = NULL;
-				} else {
-					prev->next = record->next;
-					record->next = NULL;
-				}
-				repo->size -= record->size;
-				repo->record_count--;
-				if (record->data) {
-					free(record->data);
-				}
-				free(record);
-				break;
-			} else if (removed) {
-				if (repo->first == record) {
-					repo->first = new_record;
-					new_record->next = record->next;
-				} else {
-					prev->next = new_record;
-					new_record->next = record->next;
-					record->next = NULL; // sm00
-				}
-				if (repo->last == record) {
-					repo->last = new_record;
-					new_record->next = NULL; // sm00
-				}
-				repo->size -= record->size;
-				repo->size += new_record->size;
+	pldm_pdr_record *record = entry->record;
+	uint32_t updated_hdl = record->record_handle;
+	struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
+	struct pldm_pdr_entity_association *pdr =
+	    get_entity_association(record);
 
-				if (record->data) {
-					free(record->data);
-				}
-				free(record);
-				break;
-			}
+	if (pdr->num_children == 1) {
+		/* No child left, the record goes away */
+		*event_data_op = PLDM_RECORDS_DELETED;
+		pldm_pdr_record *prev = NULL;
+		pldm_pdr_record *curr = repo->first;
+		while (curr != record) {
+			prev = curr;
+			curr = curr->next;
 		}
-		prev = record;
-		record = next;
-	}
-	if (!removed) {
-		if (new_record->data) // sm00
-		{
-			free(new_record->data); // sm00
+		if (prev == NULL) {
+			repo->first = record->next;
+		} else {
+			prev->next = record->next;
 		}
-		if (new_record) {
-			free(new_record);
+		if (repo->last == record) {
+			repo->last = prev;
 		}
-		//	free(new_data); sm00
+		repo->size -= record->size;
+		--repo->record_count;
+		++repo->generation;
+		free(record->data);
+		free(record);
+		return updated_hdl;
+	}
+
+	*event_data_op = PLDM_RECORDS_MODIFIED;
+	int i = 0;
+	while (!entity_equal(&pdr->children[i], &entity)) {
+		++i;
 	}
+	memmove(&pdr->children[i], &pdr->children[i + 1],
+		(pdr->num_children - i - 1) * sizeof(pldm_entity));
+	--pdr->num_children;
+	hdr->length = htole16(le16toh(hdr->length) - sizeof(pldm_entity));
+	record->size -= sizeof(pldm_entity);
+	repo->size -= sizeof(pldm_entity);
+
+	if (repo->contained.duplicates) {
+		/* The entity may be contained in a later PDR as well */
+		repo->assoc_index_valid = false;
+	} else {
+		assoc_index_remove(&repo->contained, entry);
+	}
+
 	return updated_hdl;
 }
 
@@ -1438,225 +1954,134 @@ uint32_t pldm_entity_association_pdr_add_contained_entity(
     pldm_pdr *repo, pldm_entity entity, pldm_entity parent,
     uint8_t *event_data_op, bool is_remote)
 {
-	/*	printf("\nenter pldm_entity_association_pdr_add_contained_entity
-	   " "entity type=%d entity ins=%d container id=%d", entity.entity_type,
-	   entity.entity_instance_num, entity.entity_container_id); printf("\n
-	   and parent entity type=%d entity ins=%d container id=%d",
-		       parent.entity_type, parent.entity_instance_num,
-		       parent.entity_container_id);*/
-	// testing pending with pcie slot-card. can test once cards are placed
-	// under slots in DBus. usecase: will not find the PDR and need to
-	// create a new entity assoc PDR since the number of child is always 1
-	// if the PDR is not found then search for the PDR having parent as a
-	// child if found then parent is valid and create a new enitity assoc
-	// PDR with parent-entity
-	uint32_t updated_hdl = 0;
-	bool added = false;
-	*event_data_op = PLDM_RECORDS_MODIFIED;
-	pldm_pdr_record *record = repo->first;
-	pldm_pdr_record *prev = repo->first;
-	pldm_pdr_record *new_record = malloc(sizeof(pldm_pdr_record));
-	new_record->data = NULL; // sm00
-	// new_record->data = malloc(record->size + sizeof(pldm_entity)); //sm00
-	// new_record->next = NULL; //sm00
-	uint8_t *new_data = NULL; // new_record->data; //sm00
-	bool found = false;
-	while (record != NULL) {
-		pldm_pdr_record *next = record->next;
-		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
-		if ((record->is_remote == is_remote) &&
-		    hdr->type == PLDM_PDR_ENTITY_ASSOCIATION) {
-			struct pldm_pdr_entity_association *pdr =
-			    (struct pldm_pdr_entity_association
-				 *)((uint8_t *)record->data +
-				    sizeof(struct pldm_pdr_hdr));
-			if (pdr->container.entity_type == parent.entity_type &&
-			    pdr->container.entity_instance_num ==
-				parent.entity_instance_num &&
-			    pdr->container.entity_container_id ==
-				parent.entity_container_id) {
-				found = true;
-				new_record->data = malloc(
-				    record->size + sizeof(pldm_entity)); // sm00
-				new_record->next = NULL;		 // sm00
-				new_data = new_record->data;		 // sm00
-				updated_hdl = record->record_handle;
-				new_record->record_handle =
-				    htole32(record->record_handle);
-				new_record->size =
-				    htole32(record->size + sizeof(pldm_entity));
-				new_record->is_remote = record->is_remote;
-				uint8_t *new_start = new_data;
-				struct pldm_pdr_hdr *new_hdr =
-				    (struct pldm_pdr_hdr *)new_data;
-				new_hdr->version = hdr->version;
-				new_hdr->record_handle =
-				    htole32(hdr->record_handle);
-				new_hdr->type = PLDM_PDR_ENTITY_ASSOCIATION;
-				new_hdr->record_change_num =
-				    htole16(hdr->record_change_num);
-				/*	new_hdr->length = htole16(
-					    record->size - sizeof(struct
-				   pldm_pdr_hdr) + sizeof(pldm_entity)); */
-				new_hdr->length = htole16(
-				    hdr->length + sizeof(pldm_entity)); // sm00
-				new_start += sizeof(struct pldm_pdr_hdr);
-				struct pldm_pdr_entity_association *new_pdr =
-				    (struct pldm_pdr_entity_association *)
-					new_start;
-
-				struct pldm_entity *child =
-				    (struct pldm_entity *)(&pdr->children[0]);
-
-				new_pdr->container_id = pdr->container_id;
-				new_pdr->association_type =
-				    pdr->association_type;
-				new_pdr->container.entity_type =
-				    pdr->container.entity_type;
-				new_pdr->container.entity_instance_num =
-				    pdr->container.entity_instance_num;
-				new_pdr->container.entity_container_id =
-				    pdr->container.entity_container_id;
-				new_pdr->num_children = pdr->num_children + 1;
-				struct pldm_entity *new_child =
-				    (struct pldm_entity *)(&new_pdr
-								->children[0]);
-				for (int i = 0; i < pdr->num_children; ++i) {
-					new_child->entity_type =
-					    child->entity_type;
-					new_child->entity_instance_num =
-					    child->entity_instance_num;
-					new_child->entity_container_id =
-					    child->entity_container_id;
-					new_child++;
-					child++;
-				}
-				new_child->entity_type = entity.entity_type;
-				new_child->entity_instance_num =
-				    entity.entity_instance_num;
-				new_child->entity_container_id =
-				    entity.entity_container_id;
-
-				added = true;
-				if (repo->first == record) {
-					repo->first = new_record;
-					new_record->next = record->next;
-				} else {
-					prev->next = new_record;
-					new_record->next = record->next;
-				}
-				if (repo->last == record) {
-					repo->last = new_record;
-				}
-				repo->size -= record->size;
-				repo->size += new_record->size;
+	assert(repo != NULL);
+	assert(event_data_op != NULL);
+
+	assoc_index_refresh(repo);
+	struct pldm_assoc_index_entry *entry =
+	    assoc_index_lookup(&repo->containers, &parent, is_remote);
+	if (entry != NULL) {
+		pldm_pdr_record *record = entry->record;
+		struct pldm_pdr_entity_association *pdr =
+		    get_entity_association(record);
+		if (pdr->num_children == UINT8_MAX) {
+			*event_data_op = PLDM_INVALID_OP;
+			return 0;
+		}
 
-				if (record->data) {
-					free(record->data);
-				}
-				free(record);
-				break;
+		/* Grow the record in place, with room for more children */
+		uint32_t new_size = record->size + sizeof(pldm_entity);
+		if (new_size > record->capacity) {
+			uint32_t capacity = record->capacity * 2;
+			if (capacity < new_size) {
+				capacity = new_size;
 			}
+			uint8_t *data = realloc(record->data, capacity);
+			assert(data != NULL);
+			record->data = data;
+			record->capacity = capacity;
+			pdr = get_entity_association(record);
 		}
 
-		prev = record;
-		record = next;
+		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
+		pldm_entity *child = &pdr->children[pdr->num_children];
+		child->entity_type = entity.entity_type;
+		child->entity_instance_num = entity.entity_instance_num;
+		child->entity_container_id = entity.entity_container_id;
+		++pdr->num_children;
+		hdr->length =
+		    htole16(le16toh(hdr->length) + sizeof(pldm_entity));
+		record->size = new_size;
+		repo->size += sizeof(pldm_entity);
+		assoc_index_insert(&repo->contained, &entity, is_remote,
+				   record);
+
+		*event_data_op = PLDM_RECORDS_MODIFIED;
+		return record->record_handle;
 	}
-	if (!found && !is_remote) // need to create a new entity assoc pdr
-	{
-		//	printf("\ncreating a new entity assoc pdr for slot \n");
-		uint8_t num_children = 1;
-		added = true;
-		*event_data_op = PLDM_RECORDS_ADDED;
-		prev = repo->first;
-		pldm_pdr_record *curr = repo->first;
-		while (curr != NULL) {
-			if (!prev->is_remote && curr->is_remote) {
-				// printf("\nfound the place \n");
-				break;
-			}
-			prev = curr;
-			curr = curr->next;
+
+	if (is_remote) {
+		*event_data_op = PLDM_RECORDS_MODIFIED;
+		return 0;
+	}
+
+	/* Need to create a new entity association PDR, placed after the last
+	 * local record */
+	*event_data_op = PLDM_RECORDS_ADDED;
+	pldm_pdr_record *prev = repo->first;
+	pldm_pdr_record *curr = repo->first;
+	while (curr != NULL) {
+		if (!prev->is_remote && curr->is_remote) {
+			break;
 		}
+		prev = curr;
+		curr = curr->next;
+	}
 
-		uint16_t new_pdr_size = sizeof(struct pldm_pdr_hdr) +
-					sizeof(uint16_t) + sizeof(uint8_t) +
-					sizeof(pldm_entity) + sizeof(uint8_t) +
-					num_children * sizeof(pldm_entity);
-		new_record->data = malloc(new_pdr_size);
-		new_record->record_handle = prev->record_handle + 1;
-		new_record->size = new_pdr_size;
-		new_record->is_remote = false;
-		new_record->next = prev->next;
-		prev->next = new_record;
+	uint8_t new_pdr[sizeof(struct pldm_pdr_hdr) +
+			sizeof(struct pldm_pdr_entity_association)];
+	uint16_t new_pdr_size = sizeof(new_pdr);
+	uint32_t record_handle = prev != NULL ? prev->record_handle + 1 : 1;
+
+	struct pldm_pdr_hdr *new_hdr = (struct pldm_pdr_hdr *)new_pdr;
+	new_hdr->version = 1;
+	new_hdr->record_handle = htole32(record_handle);
+	new_hdr->type = PLDM_PDR_ENTITY_ASSOCIATION;
+	new_hdr->record_change_num = 0;
+	new_hdr->length = htole16(new_pdr_size - sizeof(struct pldm_pdr_hdr));
+
+	struct pldm_pdr_entity_association *pdr =
+	    (struct pldm_pdr_entity_association *)(new_pdr +
+						   sizeof(struct pldm_pdr_hdr));
+	pdr->container.entity_type = parent.entity_type;
+	pdr->container.entity_instance_num = parent.entity_instance_num;
+	pdr->container.entity_container_id = parent.entity_container_id;
+	pdr->container_id = entity.entity_container_id;
+	pdr->association_type = PLDM_ENTITY_ASSOCIAION_PHYSICAL;
+	pdr->num_children = 1;
+	pdr->children[0].entity_type = entity.entity_type;
+	pdr->children[0].entity_instance_num = entity.entity_instance_num;
+	pdr->children[0].entity_container_id = entity.entity_container_id;
+
+	pldm_pdr_record *record =
+	    make_new_record(repo, new_pdr, new_pdr_size, record_handle, false,
+			    prev != NULL ? prev->terminus_handle : 0);
+	if (prev == NULL) {
+		add_record(repo, record);
+	} else {
+		record->next = prev->next;
+		prev->next = record;
 		if (repo->last == prev) {
-			repo->last = new_record;
+			repo->last = record;
 		}
-		repo->size += new_record->size;
+		repo->size += record->size;
 		++repo->record_count;
+		++repo->generation;
+	}
 
-		updated_hdl = new_record->record_handle;
-
-		struct pldm_pdr_hdr *new_hdr =
-		    (struct pldm_pdr_hdr *)new_record->data;
-		new_hdr->version = 1;
-		new_hdr->record_handle = new_record->record_handle;
-		new_hdr->type = PLDM_PDR_ENTITY_ASSOCIATION;
-		new_hdr->record_change_num = 0;
-		new_hdr->length =
-		    htole16(new_pdr_size - sizeof(struct pldm_pdr_hdr));
-
-		struct pldm_pdr_entity_association *new_pdr =
-		    (struct pldm_pdr_entity_association
-			 *)((uint8_t *)new_record->data +
-			    sizeof(struct pldm_pdr_hdr));
-		new_pdr->container.entity_type = parent.entity_type;
-		new_pdr->container.entity_instance_num =
-		    parent.entity_instance_num;
-		new_pdr->container.entity_container_id =
-		    parent.entity_container_id;
-		new_pdr->container_id = entity.entity_container_id;
-		new_pdr->association_type = PLDM_ENTITY_ASSOCIAION_PHYSICAL;
-		new_pdr->num_children = 1;
-		struct pldm_entity *new_child =
-		    (struct pldm_entity *)(&new_pdr->children[0]);
-		new_child->entity_type = entity.entity_type;
-		new_child->entity_instance_num = entity.entity_instance_num;
-		new_child->entity_container_id = entity.entity_container_id;
-	}
-	if (!added) {
-		if (new_record->data) // sm00
-		{
-			free(new_record->data); // sm00
-		}
-		if (new_record) // sm00
-		{
-			free(new_record); // sm00
-		}
+	return record->record_handle;
+}
+
+struct entity_ref {
+	pldm_entity entity;
+	pldm_entity_node **node;
+};
+
+static bool match_entity_ref(pldm_entity_node *node, void *ctx)
+{
+	struct entity_ref *ref = ctx;
+	if (entity_equal(&node->entity, &ref->entity)) {
+		*ref->node = node;
+		return false;
 	}
-	//	printf("\nreturning updated_hdl=%d", updated_hdl);
-	return updated_hdl;
+	return true;
 }
 
 void find_entity_ref_in_tree(pldm_entity_node *tree_node, pldm_entity entity,
 			     pldm_entity_node **node)
 {
-	if (tree_node == NULL) {
-		return;
-	}
-
-	if (tree_node->entity.entity_type == entity.entity_type &&
-	    tree_node->entity.entity_instance_num ==
-		entity.entity_instance_num &&
-	    tree_node->entity.entity_container_id ==
-		entity.entity_container_id) {
-
-		*node = tree_node;
-		return;
-	}
-
-	find_entity_ref_in_tree(tree_node->first_child, entity, node);
-	find_entity_ref_in_tree(tree_node->next_sibling, entity, node);
+	struct entity_ref ref = {entity, node};
+	entity_association_tree_walk(tree_node, match_entity_ref, &ref);
 }
 
 void pldm_find_entity_ref_in_tree(pldm_entity_association_tree *tree,
@@ -1690,6 +2115,7 @@ void pldm_pdr_remove_pdrs_by_terminus_handle(uint32_t terminus_handle,
 			}
 			--repo->record_count;
 			repo->size -= record->size;
+			++repo->generation;
 			free(record);
 			removed = true;
 		} else {
@@ -1736,6 +2162,7 @@ void pldm_pdr_remove_remote_pdrs(pldm_pdr *repo)
 			}
 			--repo->record_count;
 			repo->size -= record->size;
+			++repo->generation;
 			free(record);
 			removed = true;
 		} else {
@@ -1760,38 +2187,48 @@ void pldm_pdr_remove_remote_pdrs(pldm_pdr *repo)
 	}
 }
 
+struct entity_find {
+	pldm_entity *entity;
+	pldm_entity_node **out;
+	bool is_remote;
+};
+
+static bool entity_matches(const pldm_entity_node *node,
+			   const pldm_entity *entity, bool is_remote)
+{
+	return node->entity.entity_type == entity->entity_type &&
+	       node->entity.entity_instance_num == entity->entity_instance_num &&
+	       (!is_remote ||
+		node->host_container_id == entity->entity_container_id);
+}
+
+/* The nodes are walked in the order of entity_association_tree_walk, but a
+ * match ends the walk of its sibling list and its descendants are not walked,
+ * as with the recursion this replaces. The matches in the other lists are
+ * kept, the last one wins, and the container ID of the entity is updated on
+ * each, which the remote matches that follow are made against. */
 void entity_association_tree_find(pldm_entity_node *node, pldm_entity *entity,
 				  pldm_entity_node **out, bool is_remote)
 {
-	if (node == NULL) {
-		return;
-	}
-	if (is_remote) {
-
-		if (node->entity.entity_type == entity->entity_type &&
-		    node->entity.entity_instance_num ==
-			entity->entity_instance_num &&
-		    node->host_container_id == entity->entity_container_id) {
-			entity->entity_container_id =
-			    node->entity.entity_container_id;
-
-			*out = node;
-			return;
-		}
-	} else {
-		if (node->entity.entity_type == entity->entity_type &&
-		    node->entity.entity_instance_num ==
-			entity->entity_instance_num) {
-			entity->entity_container_id =
-			    node->entity.entity_container_id;
-			*out = node;
-			return;
+	struct node_stack stack;
+	node_stack_init(&stack);
+	struct node_stack_entry entry;
+	do {
+		for (; node != NULL; node = node->next_sibling) {
+			if (entity_matches(node, entity, is_remote)) {
+				entity->entity_container_id =
+				    node->entity.entity_container_id;
+				*out = node;
+				break;
+			}
+			if (node->first_child != NULL) {
+				node_stack_push(&stack, node->first_child,
+						NULL);
+			}
 		}
-	}
-
-	entity_association_tree_find(node->next_sibling, entity, out,
-				     is_remote);
-	entity_association_tree_find(node->first_child, entity, out, is_remote);
+		node = node_stack_pop(&stack, &entry) ? entry.node : NULL;
+	} while (node != NULL);
+	node_stack_release(&stack);
 }
 
 pldm_entity_node *
@@ -1806,22 +2243,43 @@ pldm_entity_association_tree_find(pldm_entity_association_tree *tree,
 }
 
 static void entity_association_tree_copy(pldm_entity_node *org_node,
-					 pldm_entity_node **new_node)
+					 pldm_entity_association_tree *new_tree)
 {
-	if (org_node == NULL) {
-		return;
-	}
-	*new_node = malloc(sizeof(pldm_entity_node));
-	(*new_node)->parent = org_node->parent;
-	(*new_node)->entity = org_node->entity;
-	(*new_node)->association_type = org_node->association_type;
-	(*new_node)->host_container_id = org_node->host_container_id;
-	(*new_node)->first_child = NULL;
-	(*new_node)->next_sibling = NULL;
-	entity_association_tree_copy(org_node->first_child,
-				     &((*new_node)->first_child));
-	entity_association_tree_copy(org_node->next_sibling,
-				     &((*new_node)->next_sibling));
+	struct node_stack stack;
+	node_stack_init(&stack);
+	/* Each list is copied along with the copy of its parent, NULL for the
+	 * root list */
+	struct node_stack_entry entry = {org_node, NULL};
+	do {
+		pldm_entity_node *parent =
+		    entry.copy != NULL ? *entry.copy : NULL;
+		pldm_entity_node **new_node =
+		    parent != NULL ? &parent->first_child : &new_tree->root;
+		for (org_node = entry.node; org_node != NULL;
+		     org_node = org_node->next_sibling) {
+			pldm_entity_node *node =
+			    malloc(sizeof(pldm_entity_node));
+			assert(node != NULL);
+			node->parent = org_node->parent;
+			node->entity = org_node->entity;
+			node->association_type = org_node->association_type;
+			node->host_container_id = org_node->host_container_id;
+			node->first_child = NULL;
+			node->next_sibling = NULL;
+			node->is_remote = org_node->is_remote;
+			node->is_overlay_parent = false;
+			if (node->is_remote) {
+				overlay_add(new_tree, parent);
+			}
+			*new_node = node;
+			if (org_node->first_child != NULL) {
+				node_stack_push(&stack, org_node->first_child,
+						new_node);
+			}
+			new_node = &node->next_sibling;
+		}
+	} while (node_stack_pop(&stack, &entry));
+	node_stack_release(&stack);
 }
 
 void pldm_entity_association_tree_copy_root(
@@ -1829,18 +2287,109 @@ void pldm_entity_association_tree_copy_root(
     pldm_entity_association_tree *new_tree)
 {
 	new_tree->last_used_container_id = org_tree->last_used_container_id;
-	entity_association_tree_copy(org_tree->root, &(new_tree->root));
+	new_tree->last_local_container_id = org_tree->last_local_container_id;
+	entity_association_tree_copy(org_tree->root, new_tree);
 }
 
 void pldm_entity_association_tree_destroy_root(
     pldm_entity_association_tree *tree)
 {
 	assert(tree != NULL);
-	entity_association_tree_destroy(tree->root);
+	tree->num_overlay_parents = 0;
+	tree->overlay_in_root = false;
+	entity_association_tree_destroy(tree, tree->root);
 	tree->last_used_container_id = 0;
+	tree->last_local_container_id = 0;
 	tree->root = NULL;
 }
 
+/* Unlink the remote nodes of a sibling list and destroy them, along with their
+ * descendants */
+static void remove_remote_siblings(pldm_entity_association_tree *tree,
+				   pldm_entity_node **link)
+{
+	while (*link != NULL) {
+		pldm_entity_node *node = *link;
+		if (node->is_remote) {
+			*link = node->next_sibling;
+			node->next_sibling = NULL;
+			entity_association_tree_destroy(tree, node);
+		} else {
+			link = &node->next_sibling;
+		}
+	}
+}
+
+void pldm_entity_association_tree_remove_remote_nodes(
+    pldm_entity_association_tree *tree)
+{
+	assert(tree != NULL);
+
+	if (tree->overlay_in_root) {
+		tree->overlay_in_root = false;
+		remove_remote_siblings(tree, &tree->root);
+	}
+	/* Removing the overlay from a parent may remove other parents, found
+	 * in the local nodes of the overlay */
+	while (tree->num_overlay_parents) {
+		pldm_entity_node *parent =
+		    tree->overlay_parents[--tree->num_overlay_parents];
+		parent->is_overlay_parent = false;
+		remove_remote_siblings(tree, &parent->first_child);
+	}
+	tree->last_used_container_id = tree->last_local_container_id;
+}
+
+/* Find the local node of an entity, the remote nodes may have the same type
+ * and instance number */
+static bool match_local_entity(pldm_entity_node *node, void *ctx)
+{
+	struct entity_find *find = ctx;
+	pldm_entity *entity = find->entity;
+	if (!node->is_remote &&
+	    node->entity.entity_type == entity->entity_type &&
+	    node->entity.entity_instance_num == entity->entity_instance_num &&
+	    node->entity.entity_container_id == entity->entity_container_id) {
+		*find->out = node;
+		return false;
+	}
+	return true;
+}
+
+pldm_entity_node *pldm_entity_association_tree_add_local(
+    pldm_entity_association_tree *bmc_tree, pldm_entity_association_tree *tree,
+    pldm_entity *entity, uint16_t entity_instance_number,
+    pldm_entity_node *parent, uint8_t association_type)
+{
+	assert(bmc_tree != NULL);
+	assert(tree != NULL);
+	assert(entity != NULL);
+	assert(parent != NULL);
+
+	pldm_entity_node *node = pldm_entity_association_tree_add(
+	    bmc_tree, entity, entity_instance_number, parent, association_type,
+	    false, false);
+	if (node == NULL) {
+		return NULL;
+	}
+
+	pldm_entity_node *tree_parent = NULL;
+	struct entity_find find = {&parent->entity, &tree_parent, false};
+	entity_association_tree_walk(tree->root, match_local_entity, &find);
+	if (tree_parent != NULL) {
+		/* The entity is the one in the BMC's tree. A remote sibling may
+		 * have its instance number as well, the remote nodes go away
+		 * with the host. */
+		pldm_entity copy = node->entity;
+		pldm_entity_node *tree_node = pldm_entity_association_tree_add(
+		    tree, &copy, 0xFFFF, tree_parent, association_type, false,
+		    false);
+		tree_node->entity = node->entity;
+		tree_node->host_container_id = node->host_container_id;
+	}
+	return node;
+}
+
 bool pldm_is_empty_entity_assoc_tree(pldm_entity_association_tree *tree)
 {
 	return ((tree->root == NULL) ? true : false);
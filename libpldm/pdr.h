@@ -12,6 +12,7 @@ extern "C" {
 typedef struct pldm_pdr_record {
 	uint32_t record_handle;
 	uint32_t size;
+	uint32_t capacity;
 	uint8_t *data;
 	struct pldm_pdr_record *next;
 	bool is_remote;
@@ -65,6 +66,18 @@ uint32_t pldm_pdr_get_record_count(const pldm_pdr *repo);
  */
 uint32_t pldm_pdr_get_repo_size(const pldm_pdr *repo);
 
+/** @brief Get the generation of a PDR repository
+ *
+ *  The generation changes every time records are added to or removed from the
+ *  repository, so that users can tell whether data they derived from the
+ *  records is still current without walking the repository.
+ *
+ *  @param[in] repo - opaque pointer acting as a PDR repo handle
+ *
+ *  @return uint32_t - generation of the repository
+ */
+uint32_t pldm_pdr_get_generation(const pldm_pdr *repo);
+
 /** @brief Add a PDR record to a PDR repository
  *
  *  @param[in/out] repo - opaque pointer acting as a PDR repo handle
@@ -238,6 +251,52 @@ void pldm_change_container_id_of_effecter(const pldm_pdr *repo,
 					  uint16_t effecterId,
 					  uint16_t containerId);
 
+/** @struct pldm_effecter_container_id
+ *
+ *  An effecter to be moved into the container of the entities contained in an
+ *  entity
+ */
+struct pldm_effecter_container_id {
+	uint16_t effecter_id;	  //!< numeric effecter ID
+	uint16_t entity_instance; //!< instance of the containing entity
+	uint16_t container_id;	  //!< container ID the effecter was given
+};
+
+/** @brief update the container id of numeric effecters in bulk
+ *
+ *  Each effecter gets the container ID pldm_find_container_id() finds for
+ *  the entity instance, but the entity association PDRs are walked once for
+ *  all the effecters.
+ *
+ *  @param[in] repo - opaque pointer acting as a PDR repo handle
+ *  @param[in] container_entity_type - entity type of the containing entities
+ *  @param[in/out] updates - the effecters to update, sorted by entity
+ *                 instance on return, with the container IDs they were given
+ *  @param[in] count - number of effecters to update
+ */
+void pldm_change_container_id_of_effecters(
+    const pldm_pdr *repo, uint16_t container_entity_type,
+    struct pldm_effecter_container_id *updates, size_t count);
+
+/** @brief Find an effecter PDR by its effecter ID
+ *
+ *  The effecter PDRs are indexed by effecter ID, the index is rebuilt when
+ *  records are added to or removed from the repo.
+ *
+ *  @param[in] repo - opaque pointer acting as a PDR repo handle
+ *  @param[in] pdr_type - PLDM_STATE_EFFECTER_PDR or PLDM_NUMERIC_EFFECTER_PDR
+ *  @param[in] effecter_id - effecter ID
+ *  @param[in] is_remote - if true, then the PDR is not from this terminus
+ *  @param[out] data - if non-NULL, set to the PDR data
+ *  @param[out] size - if non-NULL, set to the size of the PDR data
+ *
+ *  @return opaque pointer to the PDR record, NULL if not found
+ */
+const pldm_pdr_record *
+pldm_pdr_find_effecter_by_id(const pldm_pdr *repo, uint8_t pdr_type,
+			     uint16_t effecter_id, bool is_remote,
+			     uint8_t **data, uint32_t *size);
+
 /* ======================= */
 /* FRU Record Set PDR APIs */
 /* ======================= */
@@ -370,6 +429,28 @@ void pldm_entity_association_tree_delete_node(
 void pldm_entity_association_tree_visit(pldm_entity_association_tree *tree,
 					pldm_entity **entities, size_t *size);
 
+/** @brief Function called on each entity of a walk of the entity association
+ *         tree
+ *
+ *  @param[in] entity - the entity
+ *  @param[in] ctx - context given to the walk
+ *
+ *  @return false to stop the walk, true to go on
+ */
+typedef bool (*pldm_entity_visitor)(const pldm_entity *entity, void *ctx);
+
+/** @brief Call a function on each entity in the entity association tree, in
+ *         the order pldm_entity_association_tree_visit lists them, without
+ *         making the list
+ *
+ *  @param[in] tree - opaque pointer acting as a handle to the tree
+ *  @param[in] visitor - function called on each entity
+ *  @param[in] ctx - context passed to the visitor
+ */
+void pldm_entity_association_tree_for_each(pldm_entity_association_tree *tree,
+					   pldm_entity_visitor visitor,
+					   void *ctx);
+
 /** @brief Extract pldm entity by the pldm_entity_node
  *
  *  @param[in] node     - opaque pointer to added entity
@@ -519,6 +600,44 @@ void pldm_entity_association_tree_copy_root(
 void pldm_entity_association_tree_destroy_root(
     pldm_entity_association_tree *tree);
 
+/** @brief Remove the nodes added for a remote terminus, with their
+ *         descendants, from the entity association tree. The local nodes are
+ *         kept as they are and the container IDs are assigned again from the
+ *         last one a local node got.
+ *
+ *  Only the sibling lists the remote nodes were added to are walked, the cost
+ *  does not grow with the number of local nodes.
+ *
+ *  @param[in] tree - pointer to entity association tree
+ */
+void pldm_entity_association_tree_remove_remote_nodes(
+    pldm_entity_association_tree *tree);
+
+/** @brief Add a local entity to the BMC's entity association tree, and to the
+ *         tree of the BMC and remote entities, whose local nodes are those of
+ *         the BMC's tree
+ *
+ *  The entity is added to both trees with the instance number it gets in the
+ *  BMC's tree, and keeps its container ID. It is a local node of the other
+ *  tree, so it stays when the remote nodes are removed.
+ *
+ *  @param[in] bmc_tree - pointer to the BMC's entity association tree
+ *  @param[in] tree - pointer to the tree of the BMC and remote entities
+ *  @param[in/out] entity - the entity to add, the instance number is set on
+ *                          output
+ *  @param[in] entity_instance_number - instance number of the entity, 0xFFFF
+ *                                      to assign the next one
+ *  @param[in] parent - the parent node in the BMC's tree
+ *  @param[in] association_type - relation with the parent
+ *
+ *  @return pldm_entity_node* - the node added to the BMC's tree, NULL if the
+ *          entity is there already
+ */
+pldm_entity_node *pldm_entity_association_tree_add_local(
+    pldm_entity_association_tree *bmc_tree, pldm_entity_association_tree *tree,
+    pldm_entity *entity, uint16_t entity_instance_number,
+    pldm_entity_node *parent, uint8_t association_type);
+
 /** @brief Check whether the entity association tree is empty
  *
  *  @param[in] tree - pointer to entity association tree
@@ -537,6 +656,23 @@ bool pldm_is_empty_entity_assoc_tree(pldm_entity_association_tree *tree);
 void pldm_entity_association_pdr_extract(const uint8_t *pdr, uint16_t pdr_len,
 					 size_t *num_entities,
 					 pldm_entity **entities);
+
+/** @brief Find the ID of the state sensor of an entity for a state set
+ *
+ *  The state sensor PDRs are indexed by entity and by the state sets of their
+ *  composite sensors, the index is rebuilt when records are added to or
+ *  removed from the repo.
+ *
+ *  @param[in] repo - opaque pointer acting as a PDR repo handle
+ *  @param[in] entity - entity of the sensor
+ *  @param[in] state_set_id - state set of one of the composite sensors
+ *  @param[out] sensor_id - ID of the first such sensor in the repo
+ *
+ *  @return true if a sensor is found
+ */
+bool pldm_pdr_find_state_sensor_id(const pldm_pdr *repo, pldm_entity entity,
+				   uint16_t state_set_id, uint16_t *sensor_id);
+
 pldm_entity pldm_get_entity_from_record_handle(const pldm_pdr *repo,
 					       uint32_t record_handle);
 
@@ -2,7 +2,9 @@
 #include "base.h"
 
 #include <errno.h>
+#include <linux/mctp.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/un.h>
@@ -37,6 +39,95 @@ pldm_requester_rc_t pldm_open()
 	return fd;
 }
 
+pldm_requester_rc_t pldm_open_af_mctp()
+{
+	int fd = socket(AF_MCTP, SOCK_DGRAM, 0);
+	if (-1 == fd) {
+		return PLDM_REQUESTER_OPEN_FAIL;
+	}
+
+	return fd;
+}
+
+/**
+ * @brief Check if the socket is a kernel AF_MCTP socket, else it is connected
+ *        to the mctp-demux daemon.
+ *
+ * @param[in] mctp_fd - MCTP socket fd
+ *
+ * @return 1 if the socket is an AF_MCTP socket, 0 otherwise
+ */
+static int is_af_mctp(int mctp_fd)
+{
+	int domain = AF_UNSPEC;
+	socklen_t len = sizeof(domain);
+	if (-1 == getsockopt(mctp_fd, SOL_SOCKET, SO_DOMAIN, &domain, &len)) {
+		return 0;
+	}
+
+	return domain == AF_MCTP;
+}
+
+/**
+ * @brief Read AF_MCTP socket. If there's data available, return success only
+ *        if data is a PLDM message from eid. The kernel strips the MCTP
+ *        header, the message starts with the MCTP message type.
+ *
+ * @param[in] eid - destination MCTP eid
+ * @param[in] mctp_fd - AF_MCTP socket fd
+ * @param[out] pldm_resp_msg - *pldm_resp_msg will point to PLDM msg,
+ *             this function allocates memory, caller to free(*pldm_resp_msg) on
+ *             success.
+ * @param[out] resp_msg_len - caller owned pointer that will be made point to
+ *             the size of the PLDM msg.
+ *
+ * @return pldm_requester_rc_t (errno may be set). failure is returned even
+ *         when data was read, but wasn't a PLDM message
+ */
+static pldm_requester_rc_t af_mctp_recv(mctp_eid_t eid, int mctp_fd,
+					uint8_t **pldm_resp_msg,
+					size_t *resp_msg_len)
+{
+	ssize_t min_len =
+	    sizeof(MCTP_MSG_TYPE_PLDM) + sizeof(struct pldm_msg_hdr);
+	ssize_t length = recv(mctp_fd, NULL, 0, MSG_PEEK | MSG_TRUNC);
+	if (length <= 0) {
+		return PLDM_REQUESTER_RECV_FAIL;
+	} else if (length < min_len) {
+		/* read and discard */
+		uint8_t buf[length];
+		recv(mctp_fd, buf, length, 0);
+		return PLDM_REQUESTER_INVALID_RECV_LEN;
+	} else {
+		struct iovec iov[2];
+		uint8_t msg_type = 0;
+		size_t pldm_len = length - sizeof(msg_type);
+		iov[0].iov_len = sizeof(msg_type);
+		iov[0].iov_base = &msg_type;
+		*pldm_resp_msg = malloc(pldm_len);
+		iov[1].iov_len = pldm_len;
+		iov[1].iov_base = *pldm_resp_msg;
+		struct sockaddr_mctp addr = {0};
+		struct msghdr msg = {0};
+		msg.msg_name = &addr;
+		msg.msg_namelen = sizeof(addr);
+		msg.msg_iov = iov;
+		msg.msg_iovlen = sizeof(iov) / sizeof(iov[0]);
+		ssize_t bytes = recvmsg(mctp_fd, &msg, 0);
+		if (length != bytes) {
+			free(*pldm_resp_msg);
+			return PLDM_REQUESTER_INVALID_RECV_LEN;
+		}
+		if ((addr.smctp_addr.s_addr != eid) ||
+		    (msg_type != MCTP_MSG_TYPE_PLDM)) {
+			free(*pldm_resp_msg);
+			return PLDM_REQUESTER_NOT_PLDM_MSG;
+		}
+		*resp_msg_len = pldm_len;
+		return PLDM_REQUESTER_SUCCESS;
+	}
+}
+
 /**
  * @brief Read MCTP socket. If there's data available, return success only if
  *        data is a PLDM message.
@@ -56,6 +147,10 @@ static pldm_requester_rc_t mctp_recv(mctp_eid_t eid, int mctp_fd,
 				     uint8_t **pldm_resp_msg,
 				     size_t *resp_msg_len)
 {
+	if (is_af_mctp(mctp_fd)) {
+		return af_mctp_recv(eid, mctp_fd, pldm_resp_msg, resp_msg_len);
+	}
+
 	ssize_t min_len = sizeof(eid) + sizeof(MCTP_MSG_TYPE_PLDM) +
 			  sizeof(struct pldm_msg_hdr);
 	ssize_t length = recv(mctp_fd, NULL, 0, MSG_PEEK | MSG_TRUNC);
@@ -165,9 +260,56 @@ pldm_requester_rc_t pldm_send_recv(mctp_eid_t eid, int mctp_fd,
 	return rc;
 }
 
+/**
+ * @brief Send a PLDM message on an AF_MCTP socket. The kernel allocates the
+ *        message tag and routes the response back to this socket.
+ *
+ * @param[in] eid - destination MCTP eid
+ * @param[in] mctp_fd - AF_MCTP socket fd
+ * @param[in] pldm_req_msg - caller owned pointer to PLDM request msg
+ * @param[in] req_msg_len - size of PLDM request msg
+ *
+ * @return pldm_requester_rc_t (errno may be set)
+ */
+static pldm_requester_rc_t af_mctp_send(mctp_eid_t eid, int mctp_fd,
+					const uint8_t *pldm_req_msg,
+					size_t req_msg_len)
+{
+	uint8_t msg_type = MCTP_MSG_TYPE_PLDM;
+
+	struct iovec iov[2];
+	iov[0].iov_base = &msg_type;
+	iov[0].iov_len = sizeof(msg_type);
+	iov[1].iov_base = (uint8_t *)pldm_req_msg;
+	iov[1].iov_len = req_msg_len;
+
+	struct sockaddr_mctp addr = {0};
+	addr.smctp_family = AF_MCTP;
+	addr.smctp_network = MCTP_NET_ANY;
+	addr.smctp_addr.s_addr = eid;
+	addr.smctp_type = MCTP_MSG_TYPE_PLDM;
+	addr.smctp_tag = MCTP_TAG_OWNER;
+
+	struct msghdr msg = {0};
+	msg.msg_name = &addr;
+	msg.msg_namelen = sizeof(addr);
+	msg.msg_iov = iov;
+	msg.msg_iovlen = sizeof(iov) / sizeof(iov[0]);
+
+	ssize_t rc = sendmsg(mctp_fd, &msg, 0);
+	if (rc == -1) {
+		return PLDM_REQUESTER_SEND_FAIL;
+	}
+	return PLDM_REQUESTER_SUCCESS;
+}
+
 pldm_requester_rc_t pldm_send(mctp_eid_t eid, int mctp_fd,
 			      const uint8_t *pldm_req_msg, size_t req_msg_len)
 {
+	if (is_af_mctp(mctp_fd)) {
+		return af_mctp_send(eid, mctp_fd, pldm_req_msg, req_msg_len);
+	}
+
 	uint8_t hdr[2] = {eid, MCTP_MSG_TYPE_PLDM};
 
 	struct iovec iov[2];
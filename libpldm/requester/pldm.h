@@ -31,6 +31,20 @@ typedef enum pldm_requester_error_codes {
  */
 pldm_requester_rc_t pldm_open();
 
+/**
+ * @brief Open a kernel AF_MCTP socket and provide an fd to it. The messages
+ *        are exchanged with the endpoints directly, without the hop through
+ *        the mctp-demux daemon. The fd can be passed to the APIs below, which
+ *        address the endpoint with a sockaddr_mctp and let the kernel own the
+ *        message tag of the requests.
+ *
+ *        The socket isn't bound, so it only receives the responses to the
+ *        requests sent on it.
+ *
+ * @return fd on success, pldm_requester_rc_t on error (errno may be set)
+ */
+pldm_requester_rc_t pldm_open_af_mctp();
+
 /**
  * @brief Send a PLDM request message. Wait for corresponding response message,
  *        which once received, is returned to the caller.
@@ -2,6 +2,7 @@
 
 #include <array>
 #include <cstring>
+#include <vector>
 
 #include "libpldm/base.h"
 #include "libpldm/fru.h"
@@ -516,6 +517,76 @@ TEST(GetFruRecordTable, testBadDecodeResponse)
     ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
 }
 
+TEST(GetFruRecordTable, testGoodDecodeResponsePart)
+{
+    uint32_t next_data_transfer_handle = 0x400;
+    uint8_t transfer_flag = PLDM_MIDDLE;
+    std::vector<uint8_t> fru_record_table_data = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    std::vector<uint8_t> responseMsg(sizeof(pldm_msg_hdr) +
+                                     PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES +
+                                     fru_record_table_data.size());
+
+    auto responsePtr = reinterpret_cast<pldm_msg*>(responseMsg.data());
+    size_t payload_length = responseMsg.size() - sizeof(pldm_msg_hdr);
+    auto response =
+        reinterpret_cast<pldm_get_fru_record_table_resp*>(responsePtr->payload);
+
+    response->completion_code = PLDM_SUCCESS;
+    response->next_data_transfer_handle = htole32(next_data_transfer_handle);
+    response->transfer_flag = transfer_flag;
+    memcpy(response->fru_record_table_data, fru_record_table_data.data(),
+           fru_record_table_data.size());
+
+    uint8_t ret_completion_code = 0;
+    uint32_t ret_next_data_transfer_handle = 0;
+    uint8_t ret_transfer_flag = 0;
+    variable_field ret_part{};
+
+    auto rc = decode_get_fru_record_table_resp_part(
+        responsePtr, payload_length, &ret_completion_code,
+        &ret_next_data_transfer_handle, &ret_transfer_flag, &ret_part);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(PLDM_SUCCESS, ret_completion_code);
+    ASSERT_EQ(next_data_transfer_handle, ret_next_data_transfer_handle);
+    ASSERT_EQ(transfer_flag, ret_transfer_flag);
+    // The part points into the response
+    ASSERT_EQ(ret_part.ptr, response->fru_record_table_data);
+    ASSERT_EQ(fru_record_table_data.size(), ret_part.length);
+
+    // An empty part
+    rc = decode_get_fru_record_table_resp_part(
+        responsePtr, PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES,
+        &ret_completion_code, &ret_next_data_transfer_handle,
+        &ret_transfer_flag, &ret_part);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(0, ret_part.length);
+}
+
+TEST(GetFruRecordTable, testBadDecodeResponsePart)
+{
+    uint8_t completion_code = 0;
+    uint32_t next_data_transfer_handle = 0;
+    uint8_t transfer_flag = 0;
+    variable_field part{};
+
+    std::vector<uint8_t> responseMsg(sizeof(pldm_msg_hdr) +
+                                     PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(responseMsg.data());
+
+    // Payload message is missing
+    auto rc = decode_get_fru_record_table_resp_part(
+        NULL, 0, &completion_code, &next_data_transfer_handle, &transfer_flag,
+        &part);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+
+    // Payload length is invalid
+    rc = decode_get_fru_record_table_resp_part(
+        responsePtr, PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES - 1,
+        &completion_code, &next_data_transfer_handle, &transfer_flag, &part);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+}
+
 TEST(GetFRURecordByOption, testGoodEncodeRequest)
 {
     uint8_t instanceId = 2;
@@ -885,3 +956,166 @@ TEST(SetFRURecordTable, testBadDecodeRequest)
         &retTransferHandle, &retTransferFlag, &table);
     EXPECT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
 }
+
+/** @struct IndexedFruTable
+ *
+ *  FRU table with the offsets of its records and fields, as a responder
+ *  indexes it while building the table
+ */
+struct IndexedFruTable
+{
+    struct Record
+    {
+        uint16_t rsi;
+        uint8_t recordType;
+        size_t offset;
+        size_t firstTlv;
+        size_t numTlvs;
+    };
+
+    std::vector<uint8_t> table;
+    std::vector<Record> records;
+    std::vector<uint32_t> tlvOffsets;
+};
+
+/** @brief Build a FRU table with a general and an OEM record per record set,
+ *         each with fields of types 1 to 4
+ */
+static IndexedFruTable buildFruTable(uint16_t numRecordSets)
+{
+    constexpr size_t recordHdrSize = sizeof(pldm_fru_record_data_format) -
+                                     sizeof(pldm_fru_record_tlv);
+    IndexedFruTable fru;
+    for (uint16_t rsi = 1; rsi <= numRecordSets; ++rsi)
+    {
+        for (uint8_t recordType :
+             {PLDM_FRU_RECORD_TYPE_GENERAL, PLDM_FRU_RECORD_TYPE_OEM})
+        {
+            std::vector<uint8_t> tlvs;
+            std::vector<size_t> tlvPos;
+            for (uint8_t type = 1; type <= 4; ++type)
+            {
+                tlvPos.push_back(tlvs.size());
+                uint8_t length = type * 3;
+                tlvs.push_back(type);
+                tlvs.push_back(length);
+                for (uint8_t i = 0; i < length; ++i)
+                {
+                    tlvs.push_back(static_cast<uint8_t>(rsi + i));
+                }
+            }
+
+            size_t offset = fru.table.size();
+            fru.records.push_back(
+                {rsi, recordType, offset, fru.tlvOffsets.size(), 4});
+            for (auto pos : tlvPos)
+            {
+                fru.tlvOffsets.push_back(offset + recordHdrSize + pos);
+            }
+
+            size_t currSize = offset;
+            fru.table.resize(offset + recordHdrSize + tlvs.size());
+            EXPECT_EQ(encode_fru_record(fru.table.data(), fru.table.size(),
+                                        &currSize, rsi, recordType, 4, 1,
+                                        tlvs.data(), tlvs.size()),
+                      PLDM_SUCCESS);
+        }
+    }
+    return fru;
+}
+
+/** @brief Get the records of the table by option, from the index */
+static std::vector<uint8_t> getByOffsets(const IndexedFruTable& fru,
+                                         uint16_t rsi, uint8_t rt, uint8_t ft)
+{
+    std::vector<uint8_t> recordTable(fru.table.size());
+    size_t currSize = 0;
+    for (const auto& record : fru.records)
+    {
+        if ((rsi && record.rsi != rsi) || (rt && record.recordType != rt))
+        {
+            continue;
+        }
+        EXPECT_EQ(get_fru_record_by_offsets(
+                      fru.table.data(), fru.table.size(), record.offset,
+                      &fru.tlvOffsets[record.firstTlv], record.numTlvs, ft,
+                      recordTable.data(), recordTable.size(), &currSize),
+                  PLDM_SUCCESS);
+    }
+    recordTable.resize(currSize);
+    return recordTable;
+}
+
+/** @brief Get the records of the table by option, walking the table */
+static std::vector<uint8_t> getByOption(const IndexedFruTable& fru,
+                                        uint16_t rsi, uint8_t rt, uint8_t ft)
+{
+    std::vector<uint8_t> recordTable(fru.table.size() + 7);
+    size_t recordSize = recordTable.size();
+    get_fru_record_by_option(fru.table.data(), fru.table.size(),
+                             recordTable.data(), &recordSize, rsi, rt, ft);
+    recordTable.resize(recordSize);
+    return recordTable;
+}
+
+TEST(GetFruRecordByOffsets, testGoodRecords)
+{
+    auto fru = buildFruTable(5);
+    const std::array<uint8_t, 3> recordTypes{0, PLDM_FRU_RECORD_TYPE_GENERAL,
+                                             PLDM_FRU_RECORD_TYPE_OEM};
+
+    for (uint16_t rsi : {0, 1, 3, 5, 6})
+    {
+        for (uint8_t rt : recordTypes)
+        {
+            for (uint8_t ft : {0, 2, 4, 5})
+            {
+                EXPECT_EQ(getByOffsets(fru, rsi, rt, ft),
+                          getByOption(fru, rsi, rt, ft));
+            }
+        }
+    }
+
+    auto recordTable = getByOffsets(fru, 3, PLDM_FRU_RECORD_TYPE_OEM, 2);
+    auto record =
+        reinterpret_cast<pldm_fru_record_data_format*>(recordTable.data());
+    EXPECT_EQ(le16toh(record->record_set_id), 3);
+    EXPECT_EQ(record->record_type, PLDM_FRU_RECORD_TYPE_OEM);
+    EXPECT_EQ(record->num_fru_fields, 1);
+    EXPECT_EQ(record->tlvs[0].type, 2);
+    EXPECT_EQ(record->tlvs[0].length, 6);
+}
+
+TEST(GetFruRecordByOffsets, testBadRecords)
+{
+    auto fru = buildFruTable(1);
+    const auto& record = fru.records[0];
+    std::vector<uint8_t> recordTable(fru.table.size());
+    size_t currSize = 0;
+
+    auto rc = get_fru_record_by_offsets(
+        nullptr, fru.table.size(), record.offset, fru.tlvOffsets.data(),
+        record.numTlvs, 0, recordTable.data(), recordTable.size(), &currSize);
+    EXPECT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+
+    rc = get_fru_record_by_offsets(fru.table.data(), fru.table.size(),
+                                   record.offset, nullptr, record.numTlvs, 0,
+                                   recordTable.data(), recordTable.size(),
+                                   &currSize);
+    EXPECT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+
+    // The record does not fit in the record table
+    rc = get_fru_record_by_offsets(fru.table.data(), fru.table.size(),
+                                   record.offset, fru.tlvOffsets.data(),
+                                   record.numTlvs, 0, recordTable.data(), 10,
+                                   &currSize);
+    EXPECT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+
+    // A field is past the end of the table
+    const auto& last = fru.records.back();
+    rc = get_fru_record_by_offsets(
+        fru.table.data(), fru.table.size() - 1, last.offset,
+        &fru.tlvOffsets[last.firstTlv], last.numTlvs, 0, recordTable.data(),
+        recordTable.size(), &currSize);
+    EXPECT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+}
@@ -1,5 +1,7 @@
 #include <array>
+#include <vector>
 
+#include "libpldm/entity.h"
 #include "libpldm/pdr.h"
 #include "libpldm/platform.h"
 
@@ -36,6 +38,47 @@ TEST(PDRUpdate, testAdd)
     pldm_pdr_destroy(repo);
 }
 
+TEST(PDRUpdate, testGeneration)
+{
+    std::array<uint8_t, sizeof(pldm_pdr_hdr)> data{};
+
+    auto repo = pldm_pdr_init();
+    auto generation = pldm_pdr_get_generation(repo);
+
+    auto handle = pldm_pdr_add(repo, data.data(), data.size(), 0, false, 1);
+    EXPECT_NE(pldm_pdr_get_generation(repo), generation);
+    generation = pldm_pdr_get_generation(repo);
+
+    pldm_pdr_add_hotplug_record(repo, data.data(), data.size(), 0, false,
+                                handle, 1);
+    EXPECT_NE(pldm_pdr_get_generation(repo), generation);
+    generation = pldm_pdr_get_generation(repo);
+
+    // Lookups leave the generation alone
+    uint8_t* outData = nullptr;
+    uint32_t size{};
+    uint32_t nextRecHdl{};
+    pldm_pdr_find_record(repo, handle, &outData, &size, &nextRecHdl);
+    EXPECT_EQ(pldm_pdr_get_generation(repo), generation);
+
+    pldm_delete_by_record_handle(repo, handle, false);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 1u);
+    EXPECT_NE(pldm_pdr_get_generation(repo), generation);
+    generation = pldm_pdr_get_generation(repo);
+
+    pldm_pdr_add(repo, data.data(), data.size(), 0, true, 2);
+    pldm_pdr_remove_remote_pdrs(repo);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 1u);
+    EXPECT_NE(pldm_pdr_get_generation(repo), generation);
+    generation = pldm_pdr_get_generation(repo);
+
+    pldm_pdr_remove_pdrs_by_terminus_handle(1, repo);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 0u);
+    EXPECT_NE(pldm_pdr_get_generation(repo), generation);
+
+    pldm_pdr_destroy(repo);
+}
+
 TEST(PDRRemoveByTerminus, testRemoveByTerminus)
 {
     std::array<uint8_t, 10> data{};
@@ -1347,6 +1390,60 @@ TEST(EntityAssociationPDR, testFind)
     pldm_entity_association_tree_destroy(tree);
 }
 
+TEST(EntityAssociationPDR, testFindNested)
+{
+    //        1
+    //        |
+    //       (2)--3
+    //        |   |
+    //       (2)  2
+    //
+    // (2) added for the host, the inner one with the host container ID of
+    // the outer one's container
+    pldm_entity entities[5]{};
+    entities[0].entity_type = 1;
+    entities[1].entity_type = 2;
+    entities[2].entity_type = 2;
+    entities[3].entity_type = 3;
+    entities[4].entity_type = 2;
+
+    auto tree = pldm_entity_association_tree_init();
+    auto l1 = pldm_entity_association_tree_add(
+        tree, &entities[0], 1, nullptr, PLDM_ENTITY_ASSOCIAION_PHYSICAL, false,
+        true);
+    entities[1].entity_container_id = 0x100;
+    auto outer = pldm_entity_association_tree_add(
+        tree, &entities[1], 1, l1, PLDM_ENTITY_ASSOCIAION_PHYSICAL, true, true);
+    ASSERT_NE(outer, nullptr);
+    auto l2b = pldm_entity_association_tree_add(
+        tree, &entities[3], 1, l1, PLDM_ENTITY_ASSOCIAION_PHYSICAL, false,
+        true);
+    entities[2].entity_container_id =
+        pldm_entity_extract(outer).entity_container_id;
+    auto inner = pldm_entity_association_tree_add(
+        tree, &entities[2], 1, outer, PLDM_ENTITY_ASSOCIAION_PHYSICAL, true,
+        true);
+    ASSERT_NE(inner, nullptr);
+    pldm_entity_association_tree_add(tree, &entities[4], 1, l2b,
+                                     PLDM_ENTITY_ASSOCIAION_PHYSICAL, false,
+                                     true);
+
+    // A match ends the search of its sibling list and of its descendants
+    pldm_entity entity{2, 1, 0};
+    EXPECT_EQ(pldm_entity_association_tree_find(tree, &entity, false), outer);
+    EXPECT_EQ(entity.entity_container_id,
+              pldm_entity_extract(outer).entity_container_id);
+
+    // The inner node is not compared with the container ID the outer match
+    // sets
+    entity = {2, 1, 0x100};
+    EXPECT_EQ(pldm_entity_association_tree_find(tree, &entity, true), outer);
+    EXPECT_EQ(entity.entity_container_id,
+              pldm_entity_extract(outer).entity_container_id);
+
+    pldm_entity_association_tree_destroy(tree);
+}
+
 TEST(EntityAssociationPDR, testCopyTree)
 {
     pldm_entity entities[4]{};
@@ -1392,6 +1489,294 @@ TEST(EntityAssociationPDR, testCopyTree)
     pldm_entity_association_tree_destroy(newTree);
 }
 
+TEST(EntityAssociationPDR, testDeepAndWideTrees)
+{
+    // A chain of containers as deep as the tree is wide, a sibling list at
+    // its end, and a last container in the list with a child
+    constexpr uint16_t depth = 50000;
+    constexpr uint16_t width = 10000;
+    auto tree = pldm_entity_association_tree_init();
+    pldm_entity entity{PLDM_ENTITY_SYSTEM_CHASSIS, 0, 0};
+    auto parent = pldm_entity_association_tree_add(
+        tree, &entity, 0xFFFF, nullptr, PLDM_ENTITY_ASSOCIAION_PHYSICAL, false,
+        true);
+    for (uint16_t i = 1; i < depth; ++i)
+    {
+        entity = {PLDM_ENTITY_BOARD, 0, 1};
+        parent = pldm_entity_association_tree_add(
+            tree, &entity, 0xFFFF, parent, PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+            false, false);
+        ASSERT_NE(parent, nullptr);
+    }
+    pldm_entity_node* last = nullptr;
+    for (uint16_t i = 0; i < width; ++i)
+    {
+        entity = {PLDM_ENTITY_MEMORY_MODULE, 0, 2};
+        last = pldm_entity_association_tree_add(
+            tree, &entity, 0xFFFF, parent, PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+            false, false);
+        ASSERT_NE(last, nullptr);
+    }
+    entity = {PLDM_ENTITY_PROC, 1, 3};
+    auto leaf = pldm_entity_association_tree_add(
+        tree, &entity, 0xFFFF, last, PLDM_ENTITY_ASSOCIAION_PHYSICAL, false,
+        false);
+    ASSERT_NE(leaf, nullptr);
+
+    size_t num{};
+    pldm_entity* out = nullptr;
+    pldm_entity_association_tree_visit(tree, &out, &num);
+    ASSERT_EQ(num, depth + width + 1u);
+    // The sibling list is listed before the child of its last module
+    EXPECT_EQ(out[depth].entity_instance_num, 1u);
+    EXPECT_EQ(out[depth + width - 1].entity_instance_num, width);
+    EXPECT_EQ(out[num - 1].entity_type, PLDM_ENTITY_PROC);
+
+    std::vector<pldm_entity> visited;
+    pldm_entity_association_tree_for_each(
+        tree,
+        [](const pldm_entity* entity, void* ctx) {
+            static_cast<std::vector<pldm_entity>*>(ctx)->push_back(*entity);
+            return true;
+        },
+        &visited);
+    ASSERT_EQ(visited.size(), num);
+    EXPECT_EQ(memcmp(visited.data(), out, num * sizeof(pldm_entity)), 0);
+
+    // The walk stops when the visitor says so
+    size_t count = 0;
+    pldm_entity_association_tree_for_each(
+        tree,
+        [](const pldm_entity*, void* ctx) {
+            return ++*static_cast<size_t*>(ctx) < 10;
+        },
+        &count);
+    EXPECT_EQ(count, 10u);
+
+    entity = {PLDM_ENTITY_PROC, 1, 0};
+    EXPECT_EQ(pldm_entity_association_tree_find(tree, &entity, false), leaf);
+    EXPECT_EQ(entity.entity_container_id, 3u);
+    pldm_entity_node* node = nullptr;
+    pldm_find_entity_ref_in_tree(tree, entity, &node);
+    EXPECT_EQ(node, leaf);
+
+    auto copy = pldm_entity_association_tree_init();
+    pldm_entity_association_tree_copy_root(tree, copy);
+    size_t copyNum{};
+    pldm_entity* copyOut = nullptr;
+    pldm_entity_association_tree_visit(copy, &copyOut, &copyNum);
+    ASSERT_EQ(copyNum, num);
+    EXPECT_EQ(memcmp(copyOut, out, num * sizeof(pldm_entity)), 0);
+
+    free(out);
+    free(copyOut);
+    pldm_entity_association_tree_destroy(tree);
+    pldm_entity_association_tree_destroy(copy);
+}
+
+TEST(EntityAssociationPDR, testRemoveRemoteNodes)
+{
+    //        1
+    //        |
+    //        2--3--(4)
+    //        |     |
+    //       (5)   (6)--7
+    //
+    // (n) added for the host, 7 added locally under a host entity
+
+    pldm_entity entities[7]{};
+    for (size_t i = 0; i < 7; ++i)
+    {
+        entities[i].entity_type = static_cast<uint16_t>(i + 1);
+    }
+
+    auto tree = pldm_entity_association_tree_init();
+    auto l1 = pldm_entity_association_tree_add(
+        tree, &entities[0], 0xFFFF, nullptr, PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+        false, true);
+    auto l2 = pldm_entity_association_tree_add(tree, &entities[1], 0xFFFF, l1,
+                                               PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                                               false, true);
+    auto l3 = pldm_entity_association_tree_add(tree, &entities[2], 0xFFFF, l1,
+                                               PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                                               false, true);
+    size_t localNum{};
+    pldm_entity* localOut = nullptr;
+    pldm_entity_association_tree_visit(tree, &localOut, &localNum);
+    EXPECT_EQ(localNum, 3u);
+
+    auto l4 = pldm_entity_association_tree_add(tree, &entities[3], 0xFFFF, l1,
+                                               PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                                               true, true);
+    EXPECT_NE(l4, nullptr);
+    EXPECT_NE(pldm_entity_association_tree_add(
+                  tree, &entities[4], 0xFFFF, l2,
+                  PLDM_ENTITY_ASSOCIAION_PHYSICAL, true, true),
+              nullptr);
+    auto l6 = pldm_entity_association_tree_add(tree, &entities[5], 0xFFFF, l4,
+                                               PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+                                               true, true);
+    EXPECT_NE(l6, nullptr);
+    EXPECT_NE(pldm_entity_association_tree_add(
+                  tree, &entities[6], 0xFFFF, l4,
+                  PLDM_ENTITY_ASSOCIAION_PHYSICAL, false, true),
+              nullptr);
+
+    // A copy of the tree has the same overlay
+    auto copy = pldm_entity_association_tree_init();
+    pldm_entity_association_tree_copy_root(tree, copy);
+
+    for (auto t : {tree, copy})
+    {
+        size_t num{};
+        pldm_entity* out = nullptr;
+        pldm_entity_association_tree_visit(t, &out, &num);
+        EXPECT_EQ(num, 7u);
+        free(out);
+
+        pldm_entity_association_tree_remove_remote_nodes(t);
+        pldm_entity_association_tree_visit(t, &out, &num);
+        ASSERT_EQ(num, localNum);
+        EXPECT_EQ(memcmp(out, localOut, num * sizeof(pldm_entity)), 0);
+        free(out);
+
+        // Nothing left to remove
+        pldm_entity_association_tree_remove_remote_nodes(t);
+        pldm_entity_association_tree_visit(t, &out, &num);
+        EXPECT_EQ(num, localNum);
+        free(out);
+    }
+
+    // The local nodes are kept, and are not overlay parents anymore
+    EXPECT_EQ(pldm_entity_association_tree_find(tree, &entities[1], false),
+              l2);
+    EXPECT_TRUE(pldm_entity_is_node_parent(l1));
+    EXPECT_FALSE(pldm_entity_is_node_parent(l2));
+    EXPECT_FALSE(pldm_entity_is_node_parent(l3));
+
+    // The container IDs the host entities got are assigned again
+    auto again = pldm_entity_association_tree_add(
+        tree, &entities[3], 0xFFFF, l2, PLDM_ENTITY_ASSOCIAION_PHYSICAL, true,
+        true);
+    EXPECT_EQ(pldm_entity_extract(again).entity_container_id, 2u);
+
+    // The overlay goes away with a local node it is attached to
+    pldm_entity_association_tree_delete_node(tree, pldm_entity_extract(l2));
+    pldm_entity_association_tree_remove_remote_nodes(tree);
+    size_t num{};
+    pldm_entity* out = nullptr;
+    pldm_entity_association_tree_visit(tree, &out, &num);
+    EXPECT_EQ(num, 2u);
+    free(out);
+
+    free(localOut);
+    pldm_entity_association_tree_destroy(tree);
+    pldm_entity_association_tree_destroy(copy);
+}
+
+TEST(EntityAssociationPDR, testAddLocalAcrossPowerCycles)
+{
+    //        1
+    //        |
+    //        2--3
+    //           |
+    //          (2)
+    //
+    // (2) added for the host, with the type and instance of a BMC entity
+    pldm_entity entities[3]{};
+    for (size_t i = 0; i < 3; ++i)
+    {
+        entities[i].entity_type = static_cast<uint16_t>(i + 1);
+    }
+
+    auto entityTree = pldm_entity_association_tree_init();
+    auto l1 = pldm_entity_association_tree_add(
+        entityTree, &entities[0], 1, nullptr, PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+        false, true);
+    pldm_entity_association_tree_add(entityTree, &entities[1], 1, l1,
+                                     PLDM_ENTITY_ASSOCIAION_PHYSICAL, false,
+                                     true);
+    auto l3 = pldm_entity_association_tree_add(
+        entityTree, &entities[2], 1, l1, PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+        false, true);
+    auto bmcTree = pldm_entity_association_tree_init();
+    pldm_entity_association_tree_copy_root(entityTree, bmcTree);
+
+    pldm_entity host = entities[1];
+    host.entity_container_id = 0x8000;
+    auto remote = pldm_entity_association_tree_add(
+        entityTree, &host, 1, l3, PLDM_ENTITY_ASSOCIAION_PHYSICAL, true, true);
+    ASSERT_NE(remote, nullptr);
+
+    auto sameLocal = [&]() {
+        size_t bmcNum{};
+        pldm_entity* bmcOut = nullptr;
+        pldm_entity_association_tree_visit(bmcTree, &bmcOut, &bmcNum);
+        size_t num{};
+        pldm_entity* out = nullptr;
+        pldm_entity_association_tree_visit(entityTree, &out, &num);
+        bool same = num == bmcNum &&
+                    !memcmp(out, bmcOut, num * sizeof(pldm_entity));
+        free(bmcOut);
+        free(out);
+        return same;
+    };
+
+    // A sensor entity added to the BMC's tree after the copy, below the BMC
+    // entity the host entity looks like
+    pldm_entity sensor{PLDM_ENTITY_PROC, 0, 5};
+    pldm_entity parent = entities[1];
+    auto bmcParent = pldm_entity_association_tree_find(bmcTree, &parent, false);
+    ASSERT_NE(bmcParent, nullptr);
+    auto node = pldm_entity_association_tree_add_local(
+        bmcTree, entityTree, &sensor, 3, bmcParent,
+        PLDM_ENTITY_ASSOCIAION_PHYSICAL);
+    ASSERT_NE(node, nullptr);
+    EXPECT_EQ(pldm_entity_extract(node).entity_container_id, 5u);
+    EXPECT_EQ(pldm_entity_get_num_children(remote,
+                                           PLDM_ENTITY_ASSOCIAION_PHYSICAL),
+              0u);
+
+    // Already there
+    EXPECT_EQ(pldm_entity_association_tree_add_local(
+                  bmcTree, entityTree, &sensor, 3, bmcParent,
+                  PLDM_ENTITY_ASSOCIAION_PHYSICAL),
+              nullptr);
+
+    for (size_t cycle = 0; cycle < 2; ++cycle)
+    {
+        // Power off
+        pldm_entity_association_tree_remove_remote_nodes(entityTree);
+        EXPECT_TRUE(sameLocal());
+        sensor = {PLDM_ENTITY_PROC, 3, 5};
+        EXPECT_NE(pldm_entity_association_tree_find(entityTree, &sensor, false),
+                  nullptr);
+
+        // Power on, the host entity has the instance number the OEM entity
+        // is to get
+        host = entities[2];
+        host.entity_container_id = 0x8000;
+        auto hostNode = pldm_entity_association_tree_add(
+            entityTree, &host, cycle + 2, l1, PLDM_ENTITY_ASSOCIAION_PHYSICAL,
+            true, true);
+        ASSERT_NE(hostNode, nullptr);
+        pldm_entity oem{entities[2].entity_type, 0, 1};
+        auto bmcRoot = pldm_entity_association_tree_find(
+            bmcTree, &entities[0], false);
+        node = pldm_entity_association_tree_add_local(
+            bmcTree, entityTree, &oem, 0xFFFF, bmcRoot,
+            PLDM_ENTITY_ASSOCIAION_PHYSICAL);
+        ASSERT_NE(node, nullptr);
+        EXPECT_EQ(oem.entity_instance_num, cycle + 2);
+    }
+
+    pldm_entity_association_tree_remove_remote_nodes(entityTree);
+    EXPECT_TRUE(sameLocal());
+
+    pldm_entity_association_tree_destroy(entityTree);
+    pldm_entity_association_tree_destroy(bmcTree);
+}
+
 TEST(EntityAssociationPDR, testExtract)
 {
     std::vector<uint8_t> pdr{};
@@ -1741,3 +2126,317 @@ TEST(EntityAssociationPDR, findAndAddHostPDR)
 
     pldm_entity_association_tree_destroy(tree);
 }
+
+TEST(EntityAssociationPDR, testAddRemoveContainedEntity)
+{
+    std::array<uint8_t, sizeof(pldm_pdr_hdr)> data{};
+    auto repo = pldm_pdr_init();
+    pldm_pdr_add(repo, data.data(), data.size(), 0, false, 1);
+
+    pldm_entity slot{PLDM_ENTITY_SLOT, 1, 1};
+    std::vector<pldm_entity> cards;
+    for (uint16_t i = 0; i < 4; ++i)
+    {
+        cards.push_back({PLDM_ENTITY_BOARD, i, 2});
+    }
+
+    uint8_t eventDataOp{};
+    auto handle = pldm_entity_association_pdr_add_contained_entity(
+        repo, cards[0], slot, &eventDataOp, false);
+    EXPECT_EQ(eventDataOp, PLDM_RECORDS_ADDED);
+    EXPECT_NE(handle, 0u);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 2u);
+
+    for (size_t i = 1; i < cards.size(); ++i)
+    {
+        EXPECT_EQ(pldm_entity_association_pdr_add_contained_entity(
+                      repo, cards[i], slot, &eventDataOp, false),
+                  handle);
+        EXPECT_EQ(eventDataOp, PLDM_RECORDS_MODIFIED);
+    }
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 2u);
+
+    auto checkChildren = [&](const std::vector<pldm_entity>& expected) {
+        uint8_t* outData = nullptr;
+        uint32_t size{};
+        uint32_t nextRecHdl{};
+        ASSERT_NE(pldm_pdr_find_record(repo, handle, &outData, &size,
+                                       &nextRecHdl),
+                  nullptr);
+        auto hdr = reinterpret_cast<pldm_pdr_hdr*>(outData);
+        EXPECT_EQ(le16toh(hdr->length), size - sizeof(pldm_pdr_hdr));
+        EXPECT_EQ(pldm_pdr_get_repo_size(repo), data.size() + size);
+
+        size_t numEntities{};
+        pldm_entity* entities = nullptr;
+        pldm_entity_association_pdr_extract(outData, size, &numEntities,
+                                            &entities);
+        ASSERT_EQ(numEntities, expected.size() + 1);
+        EXPECT_EQ(entities[0].entity_type, slot.entity_type);
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            EXPECT_EQ(entities[i + 1].entity_type, expected[i].entity_type);
+            EXPECT_EQ(entities[i + 1].entity_instance_num,
+                      expected[i].entity_instance_num);
+            EXPECT_EQ(entities[i + 1].entity_container_id,
+                      expected[i].entity_container_id);
+        }
+        free(entities);
+    };
+    checkChildren(cards);
+
+    EXPECT_EQ(pldm_entity_association_pdr_remove_contained_entity(
+                  repo, cards[1], &eventDataOp, false),
+              handle);
+    EXPECT_EQ(eventDataOp, PLDM_RECORDS_MODIFIED);
+    checkChildren({cards[0], cards[2], cards[3]});
+
+    // The removed entity can't be found anymore
+    EXPECT_EQ(pldm_entity_association_pdr_remove_contained_entity(
+                  repo, cards[1], &eventDataOp, false),
+              0u);
+    EXPECT_EQ(eventDataOp, PLDM_INVALID_OP);
+
+    EXPECT_EQ(pldm_entity_association_pdr_add_contained_entity(
+                  repo, cards[1], slot, &eventDataOp, false),
+              handle);
+    checkChildren({cards[0], cards[2], cards[3], cards[1]});
+
+    for (const auto& card : cards)
+    {
+        pldm_entity_association_pdr_remove_contained_entity(
+            repo, card, &eventDataOp, false);
+    }
+    EXPECT_EQ(eventDataOp, PLDM_RECORDS_DELETED);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), 1u);
+    EXPECT_EQ(pldm_pdr_get_repo_size(repo), data.size());
+
+    pldm_pdr_destroy(repo);
+}
+
+TEST(EntityAssociationPDR, testHotplugContainedEntities)
+{
+    constexpr size_t otherRecords = 1000;
+    std::array<uint8_t, sizeof(pldm_pdr_hdr)> data{};
+    pldm_entity slot{PLDM_ENTITY_SLOT, 1, 1};
+    uint8_t eventDataOp{};
+
+    for (size_t children : {1, 2, 8, 32, 128, 255})
+    {
+        auto repo = pldm_pdr_init();
+        for (size_t i = 0; i < otherRecords; ++i)
+        {
+            pldm_pdr_add(repo, data.data(), data.size(), 0, false, 1);
+        }
+
+        uint32_t handle{};
+        for (size_t i = 0; i < children; ++i)
+        {
+            pldm_entity card{PLDM_ENTITY_BOARD, static_cast<uint16_t>(i), 2};
+            handle = pldm_entity_association_pdr_add_contained_entity(
+                repo, card, slot, &eventDataOp, false);
+        }
+        for (size_t i = 0; i < children; ++i)
+        {
+            pldm_entity card{PLDM_ENTITY_BOARD, static_cast<uint16_t>(i), 2};
+            pldm_entity_association_pdr_remove_contained_entity(
+                repo, card, &eventDataOp, false);
+        }
+
+        EXPECT_NE(handle, 0u);
+        EXPECT_EQ(eventDataOp, PLDM_RECORDS_DELETED);
+        EXPECT_EQ(pldm_pdr_get_record_count(repo), otherRecords);
+
+        pldm_pdr_destroy(repo);
+    }
+}
+
+namespace
+{
+
+void addStateSensor(pldm_pdr* repo, uint16_t sensorId, pldm_entity entity,
+                    const std::vector<uint16_t>& stateSets, bool isRemote)
+{
+    // One byte of possible states per composite sensor
+    std::vector<uint8_t> pdr(sizeof(pldm_state_sensor_pdr) - 1 +
+                             stateSets.size() * 4);
+    auto sensor = reinterpret_cast<pldm_state_sensor_pdr*>(pdr.data());
+    sensor->hdr.type = PLDM_STATE_SENSOR_PDR;
+    sensor->sensor_id = sensorId;
+    sensor->entity_type = entity.entity_type;
+    sensor->entity_instance = entity.entity_instance_num;
+    sensor->container_id = entity.entity_container_id;
+    sensor->composite_sensor_count = stateSets.size();
+    auto states = reinterpret_cast<state_sensor_possible_states*>(
+        sensor->possible_states);
+    for (auto stateSet : stateSets)
+    {
+        states->state_set_id = stateSet;
+        states->possible_states_size = 1;
+        states = reinterpret_cast<state_sensor_possible_states*>(
+            reinterpret_cast<uint8_t*>(states) + 4);
+    }
+    pldm_pdr_add(repo, pdr.data(), pdr.size(), 0, isRemote, 1);
+}
+
+void addEffecter(pldm_pdr* repo, uint8_t type, uint16_t effecterId,
+                 pldm_entity entity, uint16_t stateSet, bool isRemote)
+{
+    std::vector<uint8_t> pdr(std::max(sizeof(pldm_state_effecter_pdr) + 3,
+                                      sizeof(pldm_numeric_effecter_value_pdr)));
+    auto effecter = reinterpret_cast<pldm_state_effecter_pdr*>(pdr.data());
+    effecter->hdr.type = type;
+    effecter->effecter_id = effecterId;
+    effecter->entity_type = entity.entity_type;
+    effecter->entity_instance = entity.entity_instance_num;
+    effecter->container_id = entity.entity_container_id;
+    if (type == PLDM_STATE_EFFECTER_PDR)
+    {
+        effecter->composite_effecter_count = 1;
+        auto states = reinterpret_cast<state_effecter_possible_states*>(
+            effecter->possible_states);
+        states->state_set_id = stateSet;
+        states->possible_states_size = 1;
+    }
+    pldm_pdr_add(repo, pdr.data(), pdr.size(), 0, isRemote, 1);
+}
+
+void addContainer(pldm_pdr* repo, pldm_entity container, uint16_t containerId)
+{
+    std::vector<uint8_t> pdr(sizeof(pldm_pdr_hdr) +
+                             sizeof(pldm_pdr_entity_association));
+    auto hdr = reinterpret_cast<pldm_pdr_hdr*>(pdr.data());
+    hdr->type = PLDM_PDR_ENTITY_ASSOCIATION;
+    auto assoc = reinterpret_cast<pldm_pdr_entity_association*>(
+        pdr.data() + sizeof(pldm_pdr_hdr));
+    assoc->container_id = containerId;
+    assoc->container = container;
+    assoc->num_children = 1;
+    assoc->children[0] = {PLDM_ENTITY_PROC, 0, containerId};
+    pldm_pdr_add(repo, pdr.data(), pdr.size(), 0, false, 1);
+}
+
+uint16_t numericEffecterContainerId(const pldm_pdr* repo, uint16_t effecterId)
+{
+    uint8_t* data = nullptr;
+    if (!pldm_pdr_find_effecter_by_id(repo, PLDM_NUMERIC_EFFECTER_PDR,
+                                      effecterId, false, &data, nullptr))
+    {
+        return 0xFFFF;
+    }
+    return reinterpret_cast<pldm_numeric_effecter_value_pdr*>(data)
+        ->container_id;
+}
+
+} // namespace
+
+TEST(PDRIndex, testFindEffecterById)
+{
+    auto repo = pldm_pdr_init();
+    pldm_entity slot{PLDM_ENTITY_SLOT, 1, 2};
+    addEffecter(repo, PLDM_STATE_EFFECTER_PDR, 10, slot, 3, false);
+    addEffecter(repo, PLDM_NUMERIC_EFFECTER_PDR, 10, {PLDM_ENTITY_PROC, 1, 3},
+                0, false);
+    addEffecter(repo, PLDM_STATE_EFFECTER_PDR, 10, {PLDM_ENTITY_SLOT, 9, 9}, 3,
+                true);
+
+    uint8_t* data = nullptr;
+    uint32_t size = 0;
+    auto record = pldm_pdr_find_effecter_by_id(
+        repo, PLDM_STATE_EFFECTER_PDR, 10, false, &data, &size);
+    ASSERT_NE(record, nullptr);
+    EXPECT_FALSE(pldm_pdr_record_is_remote(record));
+    auto pdr = reinterpret_cast<pldm_state_effecter_pdr*>(data);
+    EXPECT_EQ(pdr->entity_instance, 1);
+    EXPECT_EQ(pdr->container_id, 2);
+    EXPECT_EQ(size, sizeof(pldm_numeric_effecter_value_pdr));
+
+    record = pldm_pdr_find_effecter_by_id(repo, PLDM_STATE_EFFECTER_PDR, 10,
+                                          true, &data, nullptr);
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(reinterpret_cast<pldm_state_effecter_pdr*>(data)->entity_instance,
+              9);
+    EXPECT_EQ(numericEffecterContainerId(repo, 10), 3);
+    EXPECT_EQ(pldm_pdr_find_effecter_by_id(repo, PLDM_STATE_EFFECTER_PDR, 11,
+                                           false, nullptr, nullptr),
+              nullptr);
+
+    // The index follows the records added and removed
+    addEffecter(repo, PLDM_STATE_EFFECTER_PDR, 11, slot, 3, false);
+    EXPECT_NE(pldm_pdr_find_effecter_by_id(repo, PLDM_STATE_EFFECTER_PDR, 11,
+                                           false, nullptr, nullptr),
+              nullptr);
+    pldm_pdr_remove_remote_pdrs(repo);
+    EXPECT_EQ(pldm_pdr_find_effecter_by_id(repo, PLDM_STATE_EFFECTER_PDR, 10,
+                                           true, nullptr, nullptr),
+              nullptr);
+
+    pldm_pdr_destroy(repo);
+}
+
+TEST(PDRIndex, testFindStateSensorId)
+{
+    auto repo = pldm_pdr_init();
+    pldm_entity fan{PLDM_ENTITY_FAN, 1, 2};
+    addStateSensor(repo, 1, fan, {10, 11}, false);
+    addStateSensor(repo, 2, fan, {11}, true);
+    addStateSensor(repo, 3, {PLDM_ENTITY_FAN, 2, 2}, {10}, true);
+
+    uint16_t sensorId = 0;
+    ASSERT_TRUE(pldm_pdr_find_state_sensor_id(repo, fan, 10, &sensorId));
+    EXPECT_EQ(sensorId, 1);
+    // The first sensor in the repo with the state set
+    ASSERT_TRUE(pldm_pdr_find_state_sensor_id(repo, fan, 11, &sensorId));
+    EXPECT_EQ(sensorId, 1);
+    ASSERT_TRUE(pldm_pdr_find_state_sensor_id(repo, {PLDM_ENTITY_FAN, 2, 2},
+                                              10, &sensorId));
+    EXPECT_EQ(sensorId, 3);
+    EXPECT_FALSE(pldm_pdr_find_state_sensor_id(repo, {PLDM_ENTITY_FAN, 1, 3},
+                                               10, &sensorId));
+    EXPECT_FALSE(pldm_pdr_find_state_sensor_id(repo, fan, 12, &sensorId));
+
+    addStateSensor(repo, 4, fan, {12}, false);
+    ASSERT_TRUE(pldm_pdr_find_state_sensor_id(repo, fan, 12, &sensorId));
+    EXPECT_EQ(sensorId, 4);
+    pldm_pdr_remove_remote_pdrs(repo);
+    EXPECT_FALSE(pldm_pdr_find_state_sensor_id(repo, {PLDM_ENTITY_FAN, 2, 2},
+                                               10, &sensorId));
+
+    pldm_pdr_destroy(repo);
+}
+
+TEST(PDRIndex, testChangeContainerIdOfEffecters)
+{
+    auto repo = pldm_pdr_init();
+    addContainer(repo, {PLDM_ENTITY_PROC_MODULE, 0, 1}, 5);
+    addContainer(repo, {PLDM_ENTITY_PROC_MODULE, 1, 1}, 6);
+    // Not the first PDR of the instance
+    addContainer(repo, {PLDM_ENTITY_PROC_MODULE, 1, 1}, 7);
+    for (uint16_t id = 1; id <= 4; ++id)
+    {
+        addEffecter(repo, PLDM_NUMERIC_EFFECTER_PDR, id,
+                    {PLDM_ENTITY_PROC, id, 0}, 0, false);
+    }
+
+    std::vector<pldm_effecter_container_id> updates{
+        {1, 1, 0}, {2, 0, 0}, {3, 1, 0}, {4, 2, 0}};
+    pldm_change_container_id_of_effecters(repo, PLDM_ENTITY_PROC_MODULE,
+                                          updates.data(), updates.size());
+
+    EXPECT_EQ(numericEffecterContainerId(repo, 1), 6);
+    EXPECT_EQ(numericEffecterContainerId(repo, 2), 5);
+    EXPECT_EQ(numericEffecterContainerId(repo, 3), 6);
+    // No containing entity
+    EXPECT_EQ(numericEffecterContainerId(repo, 4), 0);
+
+    // As the effecters are updated one by one
+    for (uint16_t id = 1; id <= 4; ++id)
+    {
+        uint16_t instance = id == 2 ? 0 : id == 4 ? 2 : 1;
+        EXPECT_EQ(numericEffecterContainerId(repo, id),
+                  pldm_find_container_id(repo, PLDM_ENTITY_PROC_MODULE,
+                                         instance));
+    }
+
+    pldm_pdr_destroy(repo);
+}
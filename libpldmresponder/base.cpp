@@ -180,26 +180,28 @@ void Handler::processSetEventReceiver(
     sdeventplus::source::EventBase& /*source */)
 {
     survEvent.reset();
-    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
-                                    PLDM_SET_EVENT_RECEIVER_REQ_BYTES);
-    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
-    auto instanceId = requester.getInstanceId(eid);
-    uint8_t eventMessageGlobalEnable =
-        PLDM_EVENT_MESSAGE_GLOBAL_ENABLE_ASYNC_KEEP_ALIVE;
-    uint8_t transportProtocolType = PLDM_TRANSPORT_PROTOCOL_TYPE_MCTP;
-    uint8_t eventReceiverAddressInfo = pldm::responder::pdr::BmcMctpEid;
-    uint16_t heartbeatTimer = HEARTBEAT_TIMEOUT;
-
-    auto rc = encode_set_event_receiver_req(
-        instanceId, eventMessageGlobalEnable, transportProtocolType,
-        eventReceiverAddressInfo, heartbeatTimer, request);
-    if (rc != PLDM_SUCCESS)
+    if (!setEventReceiverRequest)
     {
-        requester.markFree(eid, instanceId);
-        std::cerr << "Failed to encode_set_event_receiver_req, rc = "
-                  << std::hex << std::showbase << rc << std::endl;
-        return;
+        setEventReceiverRequest.emplace(PLDM_PLATFORM, PLDM_SET_EVENT_RECEIVER,
+                                        PLDM_SET_EVENT_RECEIVER_REQ_BYTES);
+        auto rc = setEventReceiverRequest->encode(
+            [](uint8_t instanceId, pldm_msg* request) {
+                return encode_set_event_receiver_req(
+                    instanceId,
+                    PLDM_EVENT_MESSAGE_GLOBAL_ENABLE_ASYNC_KEEP_ALIVE,
+                    PLDM_TRANSPORT_PROTOCOL_TYPE_MCTP,
+                    pldm::responder::pdr::BmcMctpEid, HEARTBEAT_TIMEOUT,
+                    request);
+            });
+        if (rc != PLDM_SUCCESS)
+        {
+            setEventReceiverRequest.reset();
+            std::cerr << "Failed to encode_set_event_receiver_req, rc = "
+                      << std::hex << std::showbase << rc << std::endl;
+            return;
+        }
     }
+    auto instanceId = requester.getInstanceId(eid);
 
     auto processSetEventReceiverResponse = [](mctp_eid_t /*eid*/,
                                               const pldm_msg* response,
@@ -221,9 +223,9 @@ void Handler::processSetEventReceiver(
                       << "\n";
         }
     };
-    rc = handler->registerRequest(
-        eid, instanceId, PLDM_PLATFORM, PLDM_SET_EVENT_RECEIVER,
-        std::move(requestMsg), std::move(processSetEventReceiverResponse));
+    auto rc = handler->registerRequest(
+        eid, instanceId, *setEventReceiverRequest,
+        std::move(processSetEventReceiverResponse));
 
     if (rc != PLDM_SUCCESS)
     {
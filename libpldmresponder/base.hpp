@@ -5,11 +5,13 @@
 #include "libpldmresponder/platform.hpp"
 #include "pldmd/handler.hpp"
 #include "requester/handler.hpp"
+#include "requester/prepared_request.hpp"
 
 #include <stdint.h>
 
 #include <sdeventplus/source/event.hpp>
 
+#include <optional>
 #include <vector>
 
 using namespace pldm::dbus_api;
@@ -48,6 +50,13 @@ class Handler : public CmdHandler
                          [this](const pldm_msg* request, size_t payloadLength) {
                              return this->getTID(request, payloadLength);
                          });
+
+        // The types, commands and versions supported never change. GetTID
+        // is not memoized, it sets up the event receiver of the host.
+        auto constant = [] { return uint64_t(0); };
+        memoized.emplace(PLDM_GET_PLDM_TYPES, constant);
+        memoized.emplace(PLDM_GET_PLDM_COMMANDS, constant);
+        memoized.emplace(PLDM_GET_PLDM_VERSION, constant);
     }
 
     /** @brief Handler for getPLDMTypes
@@ -112,6 +121,12 @@ class Handler : public CmdHandler
 
     /** @brief sdeventplus event source */
     std::unique_ptr<sdeventplus::source::Defer> survEvent;
+
+    /** @brief SetEventReceiver request, encoded the first time it is sent.
+     *  The fields never change, it is resent each time the host asks for
+     *  the TID.
+     */
+    std::optional<pldm::requester::PreparedRequest> setEventReceiverRequest;
 };
 
 } // namespace base
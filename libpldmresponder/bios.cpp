@@ -65,8 +65,6 @@ std::time_t timeToEpoch(uint8_t seconds, uint8_t minutes, uint8_t hours,
 namespace bios
 {
 
-using EpochTimeUS = uint64_t;
-
 DBusHandler dbusHandler;
 
 Handler::Handler(int fd, uint8_t eid, dbus_api::Requester* requester,
@@ -103,6 +101,10 @@ Handler::Handler(int fd, uint8_t eid, dbus_api::Requester* requester,
                          return this->setBIOSAttributeCurrentValue(
                              request, payloadLength);
                      });
+
+    // The tables are read from their files otherwise
+    memoized.emplace(PLDM_GET_BIOS_TABLE,
+                     [this] { return biosConfig.getGeneration(); });
 }
 
 Response Handler::getDateTime(const pldm_msg* request, size_t /*payloadLength*/)
@@ -114,27 +116,13 @@ Response Handler::getDateTime(const pldm_msg* request, size_t /*payloadLength*/)
     uint8_t month = 0;
     uint16_t year = 0;
 
-    constexpr auto timeInterface = "xyz.openbmc_project.Time.EpochTime";
-    constexpr auto bmcTimePath = "/xyz/openbmc_project/time/bmc";
     Response response(sizeof(pldm_msg_hdr) + PLDM_GET_DATE_TIME_RESP_BYTES, 0);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
-    EpochTimeUS timeUsec;
-
-    try
-    {
-        timeUsec = pldm::utils::DBusHandler().getDbusProperty<EpochTimeUS>(
-            bmcTimePath, "Elapsed", timeInterface);
-    }
-    catch (const sdbusplus::exception::exception& e)
-    {
-        std::cerr << "Error getting time, PATH=" << bmcTimePath
-                  << " TIME INTERACE=" << timeInterface << "\n";
-
-        return CmdHandler::ccOnlyResponse(request, PLDM_ERROR);
-    }
 
+    // The Elapsed property of the BMC time object is the realtime clock, it
+    // is read here rather than over D-Bus
     uint64_t timeSec = std::chrono::duration_cast<std::chrono::seconds>(
-                           std::chrono::microseconds(timeUsec))
+                           std::chrono::system_clock::now().time_since_epoch())
                            .count();
 
     pldm::responder::utils::epochToBCDTime(timeSec, seconds, minutes, hours,
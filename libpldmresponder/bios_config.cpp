@@ -575,6 +575,7 @@ void BIOSConfig::storeTable(const fs::path& path, const Table& table)
 {
     BIOSTable biosTable(path.c_str());
     biosTable.store(table);
+    ++generation;
 }
 
 std::optional<Table> BIOSConfig::loadTable(const fs::path& path)
@@ -762,6 +763,7 @@ int BIOSConfig::setAttrValue(const void* entry, size_t size, bool updateDBus,
 
 void BIOSConfig::removeTables()
 {
+    ++generation;
     try
     {
         fs::remove(tableDir / stringTableFile);
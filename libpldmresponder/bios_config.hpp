@@ -117,6 +117,15 @@ class BIOSConfig
     int setBIOSTable(uint8_t tableType, const Table& table,
                      bool updateBaseBIOSTable = true);
 
+    /** @brief Get the generation of the BIOS tables, it changes every time
+     *         a table is stored or the tables are removed
+     *  @return the generation
+     */
+    uint64_t getGeneration() const
+    {
+        return generation;
+    }
+
   private:
     /** @enum Index into the fields in the BaseBIOSTable
      */
@@ -137,6 +146,9 @@ class BIOSConfig
     pldm::utils::DBusHandler* const dbusHandler;
     BaseBIOSTable baseBIOSTableMaps;
 
+    /** @brief generation of the BIOS tables */
+    uint64_t generation = 0;
+
     /** @brief socket descriptor to communicate to host */
     int fd;
 
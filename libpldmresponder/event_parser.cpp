@@ -5,7 +5,9 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <set>
+#include <system_error>
 
 namespace pldm::responder::events
 {
@@ -22,6 +24,28 @@ const std::set<std::string_view> supportedDbusPropertyTypes = {
     "bool",     "uint8_t", "int16_t",  "uint16_t", "int32_t",
     "uint32_t", "int64_t", "uint64_t", "double",   "string"};
 
+/** @brief Container ID of the entries that apply to any container */
+constexpr pdr::ContainerID anyContainer = 0xFFFF;
+
+/** @brief Key of a state sensor in the event map
+ *
+ *  @param[in] entityType - entity type of the sensor
+ *  @param[in] entityInstance - entity instance of the sensor
+ *  @param[in] containerId - container ID of the sensor, or anyContainer
+ *  @param[in] sensorOffset - sensor offset in the composite sensor
+ *
+ *  @return the key
+ */
+static uint64_t eventKey(pdr::EntityType entityType,
+                         pdr::EntityInstance entityInstance,
+                         pdr::ContainerID containerId,
+                         pdr::SensorOffset sensorOffset)
+{
+    return (static_cast<uint64_t>(entityType) << 40) |
+           (static_cast<uint64_t>(entityInstance) << 24) |
+           (static_cast<uint64_t>(containerId) << 8) | sensorOffset;
+}
+
 StateSensorHandler::StateSensorHandler(const std::string& dirPath)
 {
     fs::path dir(dirPath);
@@ -49,7 +73,7 @@ StateSensorHandler::StateSensorHandler(const std::string& dirPath)
         {
             StateSensorEntry stateSensorEntry{};
             stateSensorEntry.containerId =
-                static_cast<uint16_t>(entry.value("containerID", 0xFFFF));
+                static_cast<uint16_t>(entry.value("containerID", anyContainer));
             stateSensorEntry.entityType =
                 static_cast<uint16_t>(entry.value("entityType", 0));
             stateSensorEntry.entityInstance =
@@ -59,7 +83,7 @@ StateSensorHandler::StateSensorHandler(const std::string& dirPath)
 
             // container id is not found in the json
             stateSensorEntry.skipContainerCheck =
-                (stateSensorEntry.containerId == 0xFFFF) ? true : false;
+                (stateSensorEntry.containerId == anyContainer) ? true : false;
 
             pldm::utils::DBusMapping dbusInfo{};
 
@@ -96,7 +120,10 @@ StateSensorHandler::StateSensorHandler(const std::string& dirPath)
             auto eventStateMap = mapStateToDBusVal(eventStates, propertyValues,
                                                    dbusInfo.propertyType);
             eventMap.emplace(
-                stateSensorEntry,
+                eventKey(stateSensorEntry.entityType,
+                         stateSensorEntry.entityInstance,
+                         stateSensorEntry.containerId,
+                         stateSensorEntry.sensorOffset),
                 std::make_tuple(std::move(dbusInfo), std::move(eventStateMap)));
         }
     }
@@ -118,53 +145,115 @@ StateToDBusValue StateSensorHandler::mapStateToDBusVal(
     return eventStateMap;
 }
 
-int StateSensorHandler::eventAction(StateSensorEntry entry,
-                                    pdr::EventState state)
+const EventDBusInfo*
+    StateSensorHandler::findEventInfo(const StateSensorEntry& entry) const
 {
-    for (const auto& kv : eventMap)
+    auto eventInfo = eventMap.end();
+    if (!entry.skipContainerCheck)
     {
-        if (kv.first.skipContainerCheck &&
-            kv.first.entityType == entry.entityType &&
-            kv.first.entityInstance == entry.entityInstance)
-        {
-            entry.skipContainerCheck = true;
-            break;
-        }
+        eventInfo =
+            eventMap.find(eventKey(entry.entityType, entry.entityInstance,
+                                   entry.containerId, entry.sensorOffset));
     }
-    try
+    if (eventInfo == eventMap.end())
     {
-        const auto& [dbusMapping, eventStateMap] = eventMap.at(entry);
-        utils::PropertyValue propValue{};
-        try
-        {
-            propValue = eventStateMap.at(state);
-        }
-        catch (const std::out_of_range& e)
-        {
-            std::cerr << "Invalid event state" << static_cast<unsigned>(state)
-                      << '\n';
-            return PLDM_ERROR_INVALID_DATA;
-        }
-
-        try
-        {
-            pldm::utils::DBusHandler().setDbusProperty(dbusMapping, propValue);
-        }
-        catch (const std::exception& e)
-        {
-            std::cerr << "Error setting property, ERROR=" << e.what()
-                      << " PROPERTY=" << dbusMapping.propertyName
-                      << " INTERFACE=" << dbusMapping.interface << " PATH="
-                      << dbusMapping.objectPath << "\n";
-            return PLDM_ERROR;
-        }
+        eventInfo =
+            eventMap.find(eventKey(entry.entityType, entry.entityInstance,
+                                   anyContainer, entry.sensorOffset));
     }
-    catch (const std::out_of_range& e)
+    return eventInfo == eventMap.end() ? nullptr : &eventInfo->second;
+}
+
+int StateSensorHandler::eventAction(const StateSensorEntry& entry,
+                                    pdr::EventState state)
+{
+    auto eventInfo = findEventInfo(entry);
+    if (!eventInfo)
     {
         // There is no BMC action for this PLDM event
         return PLDM_SUCCESS;
     }
+
+    const auto& [dbusMapping, eventStateMap] = *eventInfo;
+    auto propValue = eventStateMap.find(state);
+    if (propValue == eventStateMap.end())
+    {
+        std::cerr << "Invalid event state" << static_cast<unsigned>(state)
+                  << '\n';
+        return PLDM_ERROR_INVALID_DATA;
+    }
+
+    try
+    {
+        setPropertyAsync(dbusMapping, propValue->second);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error setting property, ERROR=" << e.what()
+                  << " PROPERTY=" << dbusMapping.propertyName
+                  << " INTERFACE=" << dbusMapping.interface << " PATH="
+                  << dbusMapping.objectPath << "\n";
+        return PLDM_ERROR;
+    }
     return PLDM_SUCCESS;
 }
 
+void StateSensorHandler::setPropertyAsync(
+    const pldm::utils::DBusMapping& dbusMapping,
+    const pldm::utils::PropertyValue& value)
+{
+    auto serviceKey = dbusMapping.objectPath + ':' + dbusMapping.interface;
+    auto service = services.find(serviceKey);
+    if (service == services.end())
+    {
+        service = services
+                      .emplace(serviceKey,
+                               pldm::utils::DBusHandler().getService(
+                                   dbusMapping.objectPath.c_str(),
+                                   dbusMapping.interface.c_str()))
+                      .first;
+    }
+
+    auto& bus = pldm::utils::DBusHandler::getBus();
+    auto method = bus.new_method_call(service->second.c_str(),
+                                      dbusMapping.objectPath.c_str(),
+                                      pldm::utils::dbusProperties, "Set");
+    std::visit(
+        [&method, &dbusMapping](const auto& v) {
+            method.append(dbusMapping.interface.c_str(),
+                          dbusMapping.propertyName.c_str(),
+                          std::variant<std::decay_t<decltype(v)>>(v));
+        },
+        value);
+
+    // The reply is handled in the event loop, the callback frees the mapping
+    // kept to log a failure
+    auto userData = std::make_unique<pldm::utils::DBusMapping>(dbusMapping);
+    auto rc = sd_bus_call_async(bus.get(), nullptr, method.get(),
+                                propertySetCallback, userData.get(), 0);
+    if (rc < 0)
+    {
+        throw std::system_error(-rc, std::generic_category());
+    }
+    userData.release();
+}
+
+int StateSensorHandler::propertySetCallback(sd_bus_message* msg,
+                                            void* userData,
+                                            sd_bus_error* /*error*/)
+{
+    std::unique_ptr<pldm::utils::DBusMapping> dbusMapping(
+        static_cast<pldm::utils::DBusMapping*>(userData));
+    if (sd_bus_message_is_method_error(msg, nullptr))
+    {
+        auto error = sd_bus_message_get_error(msg);
+        std::cerr << "Error setting property, ERROR="
+                  << (error && error->message ? error->message : "")
+                  << " PROPERTY=" << dbusMapping->propertyName
+                  << " INTERFACE=" << dbusMapping->interface
+                  << " PATH=" << dbusMapping->objectPath << "\n";
+    }
+    return 0;
+}
+
 } // namespace pldm::responder::events
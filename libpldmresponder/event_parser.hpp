@@ -7,8 +7,10 @@
 
 #include <filesystem>
 #include <map>
+#include <stdexcept>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace pldm::responder::events
@@ -75,7 +77,7 @@ struct StateSensorEntry
 
 using StateToDBusValue = std::map<pdr::EventState, pldm::utils::PropertyValue>;
 using EventDBusInfo = std::tuple<pldm::utils::DBusMapping, StateToDBusValue>;
-using EventMap = std::map<StateSensorEntry, EventDBusInfo>;
+using EventMap = std::unordered_map<uint64_t, EventDBusInfo>;
 using Json = nlohmann::json;
 
 /** @class StateSensorHandler
@@ -106,26 +108,69 @@ class StateSensorHandler
      *         property corresponding to the StateSensorEntry is set based on
      *         the EventState
      *
+     *  The property is set asynchronously, a failure to set it is logged
+     *  when the reply arrives.
+     *
      *  @param[in] entry - state sensor entry
      *  @param[in] state - event state
      *
      *  @return PLDM completion code
      */
-    int eventAction(StateSensorEntry entry, pdr::EventState state);
+    int eventAction(const StateSensorEntry& entry, pdr::EventState state);
 
     /** @brief Helper API to get D-Bus information for a StateSensorEntry
      *
      *  @param[in] entry - state sensor entry
      *
      *  @return D-Bus information corresponding to the SensorEntry
+     *
+     *  @throw std::out_of_range if there is no D-Bus information
      */
     const EventDBusInfo& getEventInfo(const StateSensorEntry& entry) const
     {
-        return eventMap.at(entry);
+        auto eventInfo = findEventInfo(entry);
+        if (!eventInfo)
+        {
+            throw std::out_of_range("No D-Bus information for the sensor");
+        }
+        return *eventInfo;
     }
 
   private:
-    EventMap eventMap; //!< a map of StateSensorEntry to D-Bus information
+    /** @brief Find the D-Bus information for a StateSensorEntry, an entry
+     *         configured for the container of the sensor takes precedence
+     *         over one configured for any container
+     *
+     *  @param[in] entry - state sensor entry
+     *
+     *  @return D-Bus information, nullptr if there is none
+     */
+    const EventDBusInfo* findEventInfo(const StateSensorEntry& entry) const;
+
+    /** @brief Set a D-Bus property without waiting for the reply
+     *
+     *  @param[in] dbusMapping - the D-Bus property
+     *  @param[in] value - the value to be set
+     *
+     *  @throw std::exception when the call can't be made
+     */
+    void setPropertyAsync(const pldm::utils::DBusMapping& dbusMapping,
+                          const pldm::utils::PropertyValue& value);
+
+    /** @brief Reply handler of setPropertyAsync */
+    static int propertySetCallback(sd_bus_message* msg, void* userData,
+                                   sd_bus_error* error);
+
+    /** @brief Map of the sensors to D-Bus information, keyed by entity type,
+     *         entity instance, container ID and sensor offset. The entries
+     *         for any container are keyed with the container ID 0xFFFF.
+     */
+    EventMap eventMap;
+
+    /** @brief D-Bus services of the object paths and interfaces set, looked
+     *         up on the first event
+     */
+    std::unordered_map<std::string, std::string> services;
 
     /** @brief Create a map of EventState to D-Bus property values from
      *         the information provided in the event state configuration
@@ -3,6 +3,7 @@
 #include "libpldm/entity.h"
 #include "libpldm/utils.h"
 
+#include "common/logger.hpp"
 #include "common/utils.hpp"
 #include "pdr.hpp"
 #ifdef OEM_IBM
@@ -222,6 +223,7 @@ void FruImpl::buildFRUTable()
         // Calculate the checksum
         checksum = crc32(table.data(), table.size());
     }
+    ++generation;
     isBuilt = true;
 }
 std::string FruImpl::populatefwVersion()
@@ -337,6 +339,7 @@ uint32_t FruImpl::populateRecords(
             encode_fru_record(table.data(), table.size(), &curSize,
                               recordSetIdentifier, recType, numFRUFields,
                               encType, tlvs.data(), tlvs.size());
+            indexRecord(curSize - recHeaderSize - tlvs.size());
             numRecs++;
         }
     }
@@ -345,9 +348,8 @@ uint32_t FruImpl::populateRecords(
 
 void FruImpl::removeIndividualFRU(const std::string& fruObjPath)
 {
-    std::cout << "\nenter removeIndividualFRU with " << fruObjPath << std::endl;
     uint16_t rsi = objectPathToRSIMap[fruObjPath];
-    std::cout << "rsi to delete " << rsi << std::endl;
+    logging::debug("Removing the FRU ", fruObjPath, " RSI = ", rsi);
     pldm_entity removeEntity;
     uint16_t terminusHdl{};
     uint16_t entityType{};
@@ -359,33 +361,25 @@ void FruImpl::removeIndividualFRU(const std::string& fruObjPath)
     removeEntity.entity_instance_num = entityInsNum;
     removeEntity.entity_container_id = containerId;
 
-    std::cout << "removeEntity.entity_type "
-              << (uint32_t)removeEntity.entity_type
-              << "\nremoveEntity.entity_instance_num "
-              << (uint32_t)removeEntity.entity_instance_num
-              << "\nremoveEntity.entity_container_id "
-              << (uint32_t)removeEntity.entity_container_id << std::endl;
+    logging::debug("Removing the entity, TYPE = ", removeEntity.entity_type,
+                   " INSTANCE = ", removeEntity.entity_instance_num,
+                   " CONTAINER_ID = ", removeEntity.entity_container_id);
 
     uint8_t bmcEventDataOps = PLDM_INVALID_OP;
     uint8_t hostEventDataOps = PLDM_INVALID_OP;
     auto updateRecordHdlBmc =
         pldm_entity_association_pdr_remove_contained_entity(
             pdrRepo, removeEntity, &bmcEventDataOps, false);
-    std::cout << "\n pldm_entity_association_pdr_remove_contained_entity"
-                 "updateRecordHdlBmc "
-              << updateRecordHdlBmc << std::endl;
 
     auto updateRecordHdlHost =
         pldm_entity_association_pdr_remove_contained_entity(
             pdrRepo, removeEntity, &hostEventDataOps, true);
-    std::cout << "\n pldm_entity_association_pdr_remove_contained_entity"
-                 "updateRecordHdlHost "
-              << updateRecordHdlHost << std::endl;
 
     auto deleteRecordHdl =
         pldm_pdr_remove_fru_record_set_by_rsi(pdrRepo, rsi, false);
-    std::cout << "\npldm_pdr_remove_fru_record_set_by_rsi deleteRecordHdl "
-              << deleteRecordHdl << std::endl;
+    logging::debug("Removed the FRU record set, RECORD_HANDLE = ",
+                   deleteRecordHdl, " BMC_ASSOCIATION = ", updateRecordHdlBmc,
+                   " HOST_ASSOCIATION = ", updateRecordHdlHost);
 
     // sm00
     /* std::cout << "\nprinting the entityTree before deleting node\n";
@@ -395,12 +389,8 @@ void FruImpl::removeIndividualFRU(const std::string& fruObjPath)
      free(out);*/
     // sm00
 
-    std::cout << "\nbefore pldm_entity_association_tree_delete_node "
-              << std::endl;
     pldm_entity_association_tree_delete_node(entityTree, removeEntity);
 
-    std::cout
-        << "\nafter pldm_entity_association_tree_delete_node for entityTree \n";
     // sm00
     /*std::cout << "\nprinting the entityTree after deleting node\n";
     num = 0;
@@ -409,9 +399,6 @@ void FruImpl::removeIndividualFRU(const std::string& fruObjPath)
     free(out);*/
     // sm00
     pldm_entity_association_tree_delete_node(bmcEntityTree, removeEntity);
-    std::cout
-        << "\nafter pldm_entity_association_tree_delete_node for bmcEntityTree"
-        << std::endl;
     objectPathToRSIMap.erase(fruObjPath);
     objToEntityNode.erase(fruObjPath);     // sm00
     associatedEntityMap.erase(fruObjPath); // sm00
@@ -432,6 +419,7 @@ void FruImpl::removeIndividualFRU(const std::string& fruObjPath)
         // Calculate the checksum
         checksum = crc32(table.data(), table.size());
     }
+    ++generation;
     sendPDRRepositoryChgEventbyPDRHandles(
         std::move(std::vector<ChangeEntry>(1, deleteRecordHdl)),
         std::move(std::vector<uint8_t>(1, PLDM_RECORDS_DELETED))); // need to
@@ -448,14 +436,13 @@ void FruImpl::removeIndividualFRU(const std::string& fruObjPath)
             std::move(std::vector<ChangeEntry>(1, updateRecordHdlHost)),
             std::move(std::vector<uint8_t>(1, hostEventDataOps)));
     } // sm00 this can be RECORDS_DELETED also for adapter pdrs
-    std::cout << "\nexit removeIndividualFRU " << std::endl;
 }
 
 void FruImpl::buildIndividualFRU(const std::string& fruInterface,
                                  const std::string& fruObjectPath)
 {
-    std::cout << "\nenter buildIndividualFRU with " << fruObjectPath << " and "
-              << fruInterface << std::endl;
+    logging::debug("Adding the FRU ", fruObjectPath, " INTERFACE = ",
+                   fruInterface);
     // An exception will be thrown by getRecordInfo, if the item
     // D-Bus interface name specified in FRU_Master.json does
     // not have corresponding config jsons
@@ -467,7 +454,6 @@ void FruImpl::buildIndividualFRU(const std::string& fruInterface,
     {
         entity.entity_type = parser.getEntityType(fruInterface);
         auto parentObj = pldm::utils::findParent(fruObjectPath);
-        std::cout << "\nfound parent as " << parentObj << std::endl;
         do
         {
             auto iter = objToEntityNode.find(parentObj);
@@ -516,9 +502,6 @@ void FruImpl::buildIndividualFRU(const std::string& fruInterface,
                 const auto& interfaces = object.second;
                 newRecordHdl = populateRecords(interfaces, recordInfos, entity,
                                                fruObjectPath, true);
-                std::cout << "\npopulateRecords returned"
-                             " newRecordHdl "
-                          << newRecordHdl << std::endl;
                 associatedEntityMap.emplace(fruObjectPath, entity);
                 break;
             }
@@ -526,37 +509,28 @@ void FruImpl::buildIndividualFRU(const std::string& fruInterface,
     }
     catch (const std::exception& e)
     {
-        std::cout << "Config JSONs missing for the item "
-                  << " in concurrent add path "
-                  << "interface type, interface = " << fruInterface << "\n";
+        logging::error("Config JSONs missing for the item in concurrent add "
+                       "path interface type, interface = ",
+                       fruInterface);
     }
 
     uint8_t bmcEventDataOps = PLDM_INVALID_OP;
     auto updatedRecordHdlBmc = pldm_entity_association_pdr_add_contained_entity(
         pdrRepo, entity, parentEntity, &bmcEventDataOps, false);
-    std::cout << "\npldm_entity_association_pdr_add_contained_entity"
-                 "updatedRecordHdlBmc "
-              << updatedRecordHdlBmc << std::endl;
 
     uint8_t hostEventDataOps = PLDM_INVALID_OP;
 
     auto updatedRecordHdlHost =
         pldm_entity_association_pdr_add_contained_entity(
             pdrRepo, entity, parentEntity, &hostEventDataOps, true);
-    std::cout << "\npldm_entity_association_pdr_add_contained_entity"
-                 "updatedRecordHdlHost "
-              << updatedRecordHdlHost << std::endl;
 
     // create the relevant state effecter and sensor PDRs for the new fru record
     std::vector<uint32_t> recordHdlList;
     reGenerateStatePDR(fruObjectPath, recordHdlList);
-    std::cout << "\ncreated " << recordHdlList.size() << " new pdrs"
-              << std::endl;
-
-    for (auto& newLedRecord : recordHdlList)
-    {
-        std::cout << "\ncreated record handle " << newLedRecord << std::endl;
-    }
+    logging::debug("Added the FRU record set, RECORD_HANDLE = ", newRecordHdl,
+                   " BMC_ASSOCIATION = ", updatedRecordHdlBmc,
+                   " HOST_ASSOCIATION = ", updatedRecordHdlHost,
+                   " STATE_PDRS = ", recordHdlList.size());
 
     if (table.size())
     {
@@ -565,6 +539,7 @@ void FruImpl::buildIndividualFRU(const std::string& fruInterface,
         // Calculate the checksum
         checksum = crc32(table.data(), table.size());
     }
+    ++generation;
     sendPDRRepositoryChgEventbyPDRHandles(
         std::move(std::vector<ChangeEntry>(1, newRecordHdl)),
         std::move(std::vector<uint8_t>(1, PLDM_RECORDS_ADDED)));
@@ -580,7 +555,6 @@ void FruImpl::buildIndividualFRU(const std::string& fruInterface,
     sendPDRRepositoryChgEventbyPDRHandles(
         std::move(std::vector<ChangeEntry>(1, updatedRecordHdlHost)),
         std::move(std::vector<uint8_t>(1, hostEventDataOps)));
-    std::cout << "\nexit buildIndividualFRU" << std::endl;
 }
 
 void FruImpl::reGenerateStatePDR(const std::string& fruObjectPath,
@@ -666,6 +640,30 @@ void FruImpl::getFRUTable(Response& response)
                 iter);
 }
 
+void FruImpl::indexRecord(size_t offset)
+{
+    auto record =
+        reinterpret_cast<const pldm_fru_record_data_format*>(&table[offset]);
+
+    RecordLocation location{};
+    location.offset = offset;
+    location.firstTlv = tlvOffsets.size();
+    location.numTlvs = record->num_fru_fields;
+    location.recordType = record->record_type;
+
+    size_t tlvOffset = offset + recHeaderSize;
+    for (uint8_t i = 0; i < record->num_fru_fields; ++i)
+    {
+        tlvOffsets.push_back(tlvOffset);
+        auto tlv =
+            reinterpret_cast<const pldm_fru_record_tlv*>(&table[tlvOffset]);
+        tlvOffset += sizeof(pldm_fru_record_tlv) - 1 + tlv->length;
+    }
+    location.size = tlvOffset - offset;
+
+    recordIndex[le16toh(record->record_set_id)].push_back(location);
+}
+
 int FruImpl::getFRURecordByOption(std::vector<uint8_t>& fruData,
                                   uint16_t /* fruTableHandle */,
                                   uint16_t recordSetIdentifer,
@@ -676,17 +674,41 @@ int FruImpl::getFRURecordByOption(std::vector<uint8_t>& fruData,
     // FRU table is built lazily, build if not done.
     buildFRUTable();
 
-    /* 7 is sizeof(checksum,4) + padBytesMax(3)
-     * We can not know size of the record table got by options in advance, but
-     * it must be less than the source table. So it's safe to use sizeof the
-     * source table + 7 as the buffer length
-     */
-    size_t recordTableSize = table.size() - padBytes + 7;
-    fruData.resize(recordTableSize, 0);
+    // Only the records asked for are visited, the buffer grows by the size of
+    // each record, the fields filtered out are not copied
+    size_t recordTableSize = 0;
+    auto getRecords = [&](const std::vector<RecordLocation>& locations) {
+        for (const auto& location : locations)
+        {
+            if (recordType != 0 && location.recordType != recordType)
+            {
+                continue;
+            }
+            fruData.resize(recordTableSize + location.size);
+            get_fru_record_by_offsets(table.data(), table.size(),
+                                      location.offset,
+                                      tlvOffsets.data() + location.firstTlv,
+                                      location.numTlvs, fieldType,
+                                      fruData.data(), fruData.size(),
+                                      &recordTableSize);
+        }
+    };
 
-    get_fru_record_by_option(table.data(), table.size() - padBytes,
-                             fruData.data(), &recordTableSize,
-                             recordSetIdentifer, recordType, fieldType);
+    if (recordSetIdentifer != 0)
+    {
+        auto it = recordIndex.find(recordSetIdentifer);
+        if (it != recordIndex.end())
+        {
+            getRecords(it->second);
+        }
+    }
+    else
+    {
+        for (const auto& [rsi, locations] : recordIndex)
+        {
+            getRecords(locations);
+        }
+    }
 
     if (recordTableSize == 0)
     {
@@ -694,12 +716,13 @@ int FruImpl::getFRURecordByOption(std::vector<uint8_t>& fruData,
     }
 
     auto pads = pldm::utils::getNumPadBytes(recordTableSize);
-    crc32(fruData.data(), recordTableSize + pads);
+    fruData.resize(recordTableSize);
+    fruData.resize(recordTableSize + pads, 0);
+    sum recordTableChecksum = crc32(fruData.data(), fruData.size());
 
-    auto iter = fruData.begin() + recordTableSize + pads;
-    std::copy_n(reinterpret_cast<const uint8_t*>(&checksum), sizeof(checksum),
-                iter);
     fruData.resize(recordTableSize + pads + sizeof(sum));
+    std::copy_n(reinterpret_cast<const uint8_t*>(&recordTableChecksum),
+                sizeof(sum), fruData.begin() + recordTableSize + pads);
 
     return PLDM_SUCCESS;
 }
@@ -939,8 +962,6 @@ std::vector<uint32_t> FruImpl::setStatePDRParams(
         return idList;
     }
 
-    std::cout << "startStateEffecterId " << startStateEffecterId
-              << " startStateSensorId " << startStateSensorId << std::endl;
     if (pdrType == PLDM_STATE_EFFECTER_PDR)
     {
         static const std::vector<Json> emptyList{};
@@ -1000,8 +1021,6 @@ std::vector<uint32_t> FruImpl::setStatePDRParams(
                 }
                 pdr->effecter_id =
                     startStateEffecterId++; // handler.getNextEffecterId();
-                std::cout << "assigned effecter id " << pdr->effecter_id
-                          << std::endl;
                 // auto& associatedEntityMap = handler.getAssociateEntityMap();
                 if (entity_path != "" &&
                     associatedEntityMap.find(entity_path) !=
@@ -1104,7 +1123,6 @@ std::vector<uint32_t> FruImpl::setStatePDRParams(
             pdrEntry.size = pdrSize;
             if (singleEffecter)
             {
-                std::cout << "calling addHotPlugRecord" << std::endl;
                 auto newRecordHdl = addHotPlugRecord(pdrEntry);
                 // nowa dd to the vector
                 idList.push_back(newRecordHdl);
@@ -1289,7 +1307,6 @@ std::vector<uint32_t> FruImpl::setStatePDRParams(
             }
         }
     }
-    std::cout << "\nexit FruImpl::setStatePDRParams" << std::endl;
     return idList;
 }
 
@@ -1298,9 +1315,6 @@ uint32_t
 {
     auto lastLocalRecord = pldm_pdr_find_last_local_record(pdrRepo);
     auto lastHandle = lastLocalRecord->record_handle;
-    std::cout << "lastLocalRecord->record_handle "
-              << lastLocalRecord->record_handle << " lastHandle " << lastHandle
-              << std::endl;
     pdrEntry.handle.recordHandle = lastHandle + 1;
     return pldm_pdr_add_hotplug_record(pdrRepo, pdrEntry.data, pdrEntry.size,
                                        pdrEntry.handle.recordHandle, false,
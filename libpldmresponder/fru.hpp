@@ -133,6 +133,16 @@ class FruImpl
         return checksum;
     }
 
+    /** @brief The generation of the FRU table, it changes every time the
+     *         table is built or updated
+     *
+     *  @return generation
+     */
+    uint64_t getGeneration() const
+    {
+        return generation;
+    }
+
     /** @brief Number of record set identifiers in the FRU tables
      *
      *  @return number of record set identifiers
@@ -187,6 +197,27 @@ class FruImpl
         return associatedEntityMap;
     }
 
+    /** @brief Add an entity of the BMC found after the FRU table is built,
+     *         to the BMC's entity association tree and to the one with the
+     *         host entities, so it stays there across host power cycles
+     *
+     *  @param[in] parent - the parent node in the BMC's entity association
+     *                      tree
+     *  @param[in/out] entity - the entity, its instance number is set
+     *  @param[in] instance - instance number of the entity, 0xFFFF for the
+     *                        next one
+     *
+     *  @return the node in the BMC's tree, nullptr if the entity is there
+     *          already
+     */
+    pldm_entity_node* addBmcEntity(pldm_entity_node* parent,
+                                   pldm_entity& entity, uint16_t instance)
+    {
+        return pldm_entity_association_tree_add_local(
+            bmcEntityTree, entityTree, &entity, instance, parent,
+            PLDM_ENTITY_ASSOCIAION_PHYSICAL);
+    }
+
     /** @brief Get pldm entity by the object path
      *
      *  @param[in] objects - std::map The object value tree
@@ -254,8 +285,39 @@ class FruImpl
     uint8_t padBytes = 0;
     std::vector<uint8_t> table;
     uint32_t checksum = 0;
+    uint64_t generation = 0;
     bool isBuilt = false;
 
+    /** @struct RecordLocation
+     *
+     *  Location of a FRU record in the FRU table
+     */
+    struct RecordLocation
+    {
+        uint32_t offset;    //!< offset of the record in the table
+        uint32_t size;      //!< size of the record
+        uint32_t firstTlv;  //!< index of the offset of its first field
+        uint8_t numTlvs;    //!< number of fields of the record
+        uint8_t recordType; //!< FRU record type
+    };
+
+    /** @brief The locations of the FRU records by record set identifier, in
+     *         the order of the table
+     */
+    std::map<uint16_t, std::vector<RecordLocation>> recordIndex;
+
+    /** @brief The offsets of the FRU fields in the table, the fields of a
+     *         record are contiguous
+     */
+    std::vector<uint32_t> tlvOffsets;
+
+    /** @brief Index a FRU record added to the FRU table, so that
+     *         getFRURecordByOption gets it without walking the table
+     *
+     *  @param[in] offset - offset of the record in the table
+     */
+    void indexRecord(size_t offset);
+
     fru_parser::FruParser parser;
     pldm_pdr* pdrRepo;
     pldm_entity_association_tree* entityTree;
@@ -391,6 +453,9 @@ class Handler : public CmdHandler
                              return this->setFRURecordTable(request,
                                                             payloadLength);
                          });
+
+        memoized.emplace(PLDM_GET_FRU_RECORD_TABLE_METADATA,
+                         [this] { return impl.getGeneration(); });
     }
 
     /** @brief Handler for Get FRURecordTableMetadata
@@ -432,6 +497,23 @@ class Handler : public CmdHandler
         return impl.getAssociateEntityMap();
     }
 
+    /** @brief Add an entity of the BMC found after the FRU table is built
+     *
+     *  @param[in] parent - the parent node in the BMC's entity association
+     *                      tree
+     *  @param[in/out] entity - the entity, its instance number is set
+     *  @param[in] instance - instance number of the entity, 0xFFFF for the
+     *                        next one
+     *
+     *  @return the node in the BMC's tree, nullptr if the entity is there
+     *          already
+     */
+    pldm_entity_node* addBmcEntity(pldm_entity_node* parent,
+                                   pldm_entity& entity, uint16_t instance)
+    {
+        return impl.addBmcEntity(parent, entity, instance);
+    }
+
     /** @brief Handler for GetFRURecordByOption
      *
      *  @param[in] request - Request message payload
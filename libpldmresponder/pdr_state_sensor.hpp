@@ -122,10 +122,8 @@ void generateStateSensorPDR(const DBusInterface& dBusIntf, const Json& json,
                             << " not found in the BMC Entity Association tree\n";
                         return;
                     }
-                    pldm_entity_association_tree_add(
-                        bmcEntityTree, &child_entity, pdr->entity_instance,
-                        parent_node, PLDM_ENTITY_ASSOCIAION_PHYSICAL, false,
-                        false);
+                    handler.addBmcEntity(parent_node, child_entity,
+                                         pdr->entity_instance);
                     pldm_entity_association_pdr_add_contained_entity(
                         repo.getPdr(), child_entity, parent_entity,
                         &bmcEventDataOps, false);
@@ -445,6 +445,28 @@ class Handler : public CmdHandler
         return fruHandler->getAssociateEntityMap();
     }
 
+    /** @brief Add an entity of the BMC found after the FRU table is built
+     *
+     *  @param[in] parent - the parent node in the BMC's entity association
+     *                      tree
+     *  @param[in/out] entity - the entity, its instance number is set
+     *  @param[in] instance - instance number of the entity, 0xFFFF for the
+     *                        next one
+     *
+     *  @return the node in the BMC's tree, nullptr if the entity is there
+     *          already
+     */
+    inline pldm_entity_node* addBmcEntity(pldm_entity_node* parent,
+                                          pldm_entity& entity,
+                                          uint16_t instance)
+    {
+        if (fruHandler == nullptr)
+        {
+            throw InternalFailure();
+        }
+        return fruHandler->addBmcEntity(parent, entity, instance);
+    }
+
     /** @brief process the actions that needs to be performed after a GetPDR
      *         call is received
      *  @param[in] source - sdeventplus event source
@@ -156,3 +156,27 @@ TEST_F(TestBaseCommands, testGetTIDGoodRequest)
     ASSERT_EQ(payload[0], 0);
     ASSERT_EQ(payload[1], 1);
 }
+
+TEST_F(TestBaseCommands, testMemoizedDiscovery)
+{
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_GET_COMMANDS_REQ_BYTES>
+        requestPayload{};
+    auto request = reinterpret_cast<pldm_msg*>(requestPayload.data());
+    size_t requestPayloadLength = requestPayload.size() - sizeof(pldm_msg_hdr);
+    ver32_t version{0xF1, 0xF0, 0xF0, 0x00};
+    auto rc = encode_get_commands_req(1, PLDM_PLATFORM, version, request);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+
+    base::Handler handler(mctpEid, requester, event, nullptr, nullptr);
+    auto response =
+        handler.handle(PLDM_GET_PLDM_COMMANDS, request, requestPayloadLength);
+    EXPECT_EQ(response, handler.getPLDMCommands(request, requestPayloadLength));
+
+    // The response is reused with the instance ID of the request
+    request->hdr.instance_id = 2;
+    response =
+        handler.handle(PLDM_GET_PLDM_COMMANDS, request, requestPayloadLength);
+    EXPECT_EQ(response, handler.getPLDMCommands(request, requestPayloadLength));
+    EXPECT_EQ(reinterpret_cast<pldm_msg*>(response.data())->hdr.instance_id,
+              2);
+}
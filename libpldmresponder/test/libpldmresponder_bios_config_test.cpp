@@ -3,6 +3,7 @@
 #include "libpldmresponder/bios_config.hpp"
 #include "libpldmresponder/bios_string_attribute.hpp"
 #include "mocked_bios.hpp"
+#include "pldmd/handler.hpp"
 
 #include <nlohmann/json.hpp>
 
@@ -293,9 +294,11 @@ TEST_F(TestBIOSConfig, setAttrValue)
     PropertyValue value = std::string("abcd");
     EXPECT_CALL(dbusHandler, setDbusProperty(dbusMapping, value)).Times(1);
 
+    auto generation = biosConfig.getGeneration();
     auto rc =
         biosConfig.setAttrValue(attrValueEntry.data(), attrValueEntry.size());
     EXPECT_EQ(rc, PLDM_SUCCESS);
+    EXPECT_NE(biosConfig.getGeneration(), generation);
 
     auto attrValueTable = biosConfig.getBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE);
     auto findEntry =
@@ -318,3 +321,103 @@ TEST_F(TestBIOSConfig, setAttrValue)
     EXPECT_THAT(std::vector<uint8_t>(p, p + attrValueEntry.size()),
                 ElementsAreArray(attrValueEntry));
 }
+
+/** @class BIOSTableHandler
+ *
+ *  Serves GetBIOSTable from a BIOSConfig as the BIOS handler does, with the
+ *  responses memoized or not
+ */
+class BIOSTableHandler : public pldm::responder::CmdHandler
+{
+  public:
+    BIOSTableHandler(BIOSConfig& biosConfig, bool memoize) :
+        biosConfig(biosConfig)
+    {
+        handlers.emplace(PLDM_GET_BIOS_TABLE,
+                         [this](const pldm_msg* request, size_t payloadLength) {
+                             return this->getBIOSTable(request, payloadLength);
+                         });
+        if (memoize)
+        {
+            memoized.emplace(PLDM_GET_BIOS_TABLE, [this] {
+                return this->biosConfig.getGeneration();
+            });
+        }
+    }
+
+    pldm::responder::Response getBIOSTable(const pldm_msg* request,
+                                           size_t payloadLength)
+    {
+        uint32_t transferHandle{};
+        uint8_t transferOpFlag{};
+        uint8_t tableType{};
+        auto rc = decode_get_bios_table_req(request, payloadLength,
+                                            &transferHandle, &transferOpFlag,
+                                            &tableType);
+        if (rc != PLDM_SUCCESS)
+        {
+            return ccOnlyResponse(request, rc);
+        }
+
+        auto table = biosConfig.getBIOSTable(
+            static_cast<pldm_bios_table_types>(tableType));
+        if (!table)
+        {
+            return ccOnlyResponse(request, PLDM_BIOS_TABLE_UNAVAILABLE);
+        }
+
+        pldm::responder::Response response(
+            sizeof(pldm_msg_hdr) + PLDM_GET_BIOS_TABLE_MIN_RESP_BYTES +
+            table->size());
+        encode_get_bios_table_resp(
+            request->hdr.instance_id, PLDM_SUCCESS, 0, PLDM_START_AND_END,
+            table->data(), response.size(),
+            reinterpret_cast<pldm_msg*>(response.data()));
+        return response;
+    }
+
+  private:
+    BIOSConfig& biosConfig;
+};
+
+/** @brief Build a GetBIOSTable request */
+static std::vector<uint8_t> getBIOSTableRequest(uint8_t instanceId,
+                                                uint8_t tableType)
+{
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
+                                    PLDM_GET_BIOS_TABLE_REQ_BYTES);
+    encode_get_bios_table_req(instanceId, 0, PLDM_GET_FIRSTPART, tableType,
+                              reinterpret_cast<pldm_msg*>(requestMsg.data()));
+    return requestMsg;
+}
+
+TEST_F(TestBIOSConfig, memoizedGetBIOSTable)
+{
+    MockdBusHandler dbusHandler;
+    ON_CALL(dbusHandler, getDbusPropertyVariant(_, _, _))
+        .WillByDefault(Throw(std::exception()));
+
+    BIOSConfig biosConfig("./bios_jsons", tableDir.c_str(), &dbusHandler, 0, 0,
+                          nullptr, nullptr);
+    biosConfig.removeTables();
+    biosConfig.buildTables();
+    BIOSTableHandler handler(biosConfig, true);
+
+    auto requestMsg = getBIOSTableRequest(1, PLDM_BIOS_ATTR_VAL_TABLE);
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    auto length = requestMsg.size() - sizeof(pldm_msg_hdr);
+    auto response = handler.handle(PLDM_GET_BIOS_TABLE, request, length);
+    EXPECT_EQ(response, handler.getBIOSTable(request, length));
+
+    request->hdr.instance_id = 2;
+    response = handler.handle(PLDM_GET_BIOS_TABLE, request, length);
+    EXPECT_EQ(response, handler.getBIOSTable(request, length));
+
+    // Not served from the memoized response once the tables change
+    biosConfig.removeTables();
+    response = handler.handle(PLDM_GET_BIOS_TABLE, request, length);
+    EXPECT_EQ(response[sizeof(pldm_msg_hdr)], PLDM_BIOS_TABLE_UNAVAILABLE);
+    biosConfig.buildTables();
+    response = handler.handle(PLDM_GET_BIOS_TABLE, request, length);
+    EXPECT_EQ(response, handler.getBIOSTable(request, length));
+}
@@ -533,6 +533,25 @@ TEST(StateSensorHandler, allScenarios)
         ASSERT_EQ(value1 == propValue1, true);
     }
 
+    // Event Entry 4, for any container
+    {
+        DBusMapping mapping{"/xyz/abc/jkl",
+                            "xyz.openbmc_project.example4.value", "value4",
+                            "bool"};
+        StateSensorEntry entry{3, 64, 1, 0, false};
+        const auto& [dbusMapping, eventStateMap] = handler.getEventInfo(entry);
+        ASSERT_EQ(mapping == dbusMapping, true);
+
+        StateSensorEntry anyContainerEntry{1, 64, 1, 0, true};
+        ASSERT_EQ(mapping ==
+                      std::get<0>(handler.getEventInfo(anyContainerEntry)),
+                  true);
+
+        // The sensor offset still has to match
+        StateSensorEntry otherOffset{3, 64, 1, 1, false};
+        ASSERT_THROW(handler.getEventInfo(otherOffset), std::out_of_range);
+    }
+
     // Invalid Entry
     {
         StateSensorEntry entry{0, 0, 0, 0, false};
@@ -3,29 +3,64 @@
 #include "oem_ibm_handler.hpp"
 #include "xyz/openbmc_project/Common/error.hpp"
 
+#include <algorithm>
+#include <system_error>
+
 namespace pldm
 {
 
 namespace responder
 {
 using namespace oem_ibm_platform;
-void SlotHandler::timeOutHandler()
+
+static constexpr auto inventoryObjPath = "/xyz/openbmc_project/inventory";
+
+SlotHandler::SlotHandler(const sdeventplus::Event& event, pldm_pdr* repo,
+                         std::chrono::milliseconds timeout) :
+    oemPlatformHandler(nullptr),
+    event(event), pdrRepo(repo), timeout(timeout)
+{
+    retireOperations = std::make_unique<sdeventplus::source::Defer>(
+        event, [this](sdeventplus::source::EventBase& source) {
+            source.set_enabled(sdeventplus::source::Enabled::Off);
+            retiredOperations.clear();
+        });
+    retireOperations->set_enabled(sdeventplus::source::Enabled::Off);
+}
+
+void SlotHandler::timeOutHandler(const std::string& adapterObjectPath)
 {
-    std::cerr << "Timer expired waiting for Event from Inventory" << std::endl;
+    std::cerr << "Timer expired waiting for Event from Inventory, ADAPTER="
+              << adapterObjectPath << std::endl;
+
+    // send the sensor event to host with error state
+    finishSlotOperation(adapterObjectPath, uint8_t(SLOT_STATE_ERROR));
+}
+
+void SlotHandler::finishSlotOperation(const std::string& adapterObjectPath,
+                                      uint8_t sensorOpState)
+{
+    auto it = slotOperations.find(adapterObjectPath);
+    if (it == slotOperations.end())
+    {
+        return;
+    }
 
-    // Disable the timer
-    timer.setEnabled(false);
+    // The operation may be ended from the callback of its own timer or
+    // presence match, release it once back in the event loop
+    auto entity = it->second.entity;
+    it->second.timer->setEnabled(false);
+    retiredOperations.emplace_back(std::move(it->second));
+    slotOperations.erase(it);
+    retireOperations->set_enabled(sdeventplus::source::Enabled::On);
 
-    // obtain the sensor Id
+    // obtain the sensor id attached with this slot
     auto sensorId = pldm::utils::findStateSensorId(
-        pdrRepo, 0, PLDM_ENTITY_SLOT,
-        current_on_going_slot_entity.entity_instance_num,
-        current_on_going_slot_entity.entity_container_id,
-        PLDM_OEM_IBM_SLOT_ENABLE_SENSOR_STATE);
+        pdrRepo, 0, PLDM_ENTITY_SLOT, entity.entity_instance_num,
+        entity.entity_container_id, PLDM_OEM_IBM_SLOT_ENABLE_SENSOR_STATE);
 
-    // send the sensor event to host with error state
-    sendStateSensorEvent(sensorId, PLDM_STATE_SENSOR_STATE, 0,
-                         uint8_t(SLOT_STATE_ERROR), uint8_t(SLOT_STATE_UNKOWN));
+    sendStateSensorEvent(sensorId, PLDM_STATE_SENSOR_STATE, 0, sensorOpState,
+                         uint8_t(SLOT_STATE_UNKOWN));
 }
 
 void SlotHandler::enableSlot(uint16_t effecterId,
@@ -41,11 +76,6 @@ void SlotHandler::enableSlot(uint16_t effecterId,
             entity.entity_type == value.entity_type &&
             entity.entity_container_id == value.entity_container_id)
         {
-            this->current_on_going_slot_entity.entity_type = value.entity_type;
-            this->current_on_going_slot_entity.entity_instance_num =
-                value.entity_instance_num;
-            this->current_on_going_slot_entity.entity_container_id =
-                value.entity_container_id;
             processSlotOperations(key, value, stateFileValue);
         }
     }
@@ -55,128 +85,277 @@ void SlotHandler::processSlotOperations(const std::string& slotObjectPath,
                                         const pldm_entity& entity,
                                         uint8_t stateFiledValue)
 {
-
-    std::string adapterObjPath;
-    try
+    // get the adapter dbus object path from the slot dbus object path
+    auto adapterObjPath = getAdapterObjPath(slotObjectPath);
+    if (!adapterObjPath)
     {
-        // get the adapter dbus object path from the slot dbus object path
-        adapterObjPath = getAdapterObjPath(slotObjectPath).value();
+        std::cerr << "No adapter found under the slot, SLOT="
+                  << slotObjectPath << "\n";
+        return;
     }
-    catch (const std::bad_optional_access& e)
+
+    if (slotOperations.contains(*adapterObjPath))
     {
-        std::cerr << e.what() << '\n';
-        return;
+        std::cerr << "Replacing the slot operation in progress, ADAPTER="
+                  << *adapterObjPath << "\n";
+        slotOperations.erase(*adapterObjPath);
     }
 
+    auto& operation = slotOperations[*adapterObjPath];
+    operation.entity = entity;
+    operation.stateFieldValue = stateFiledValue;
+
     // create a presence match for the adpter present property
-    createPresenceMatch(adapterObjPath, entity, stateFiledValue);
+    operation.presenceMatch = createPresenceMatch(*adapterObjPath);
+
+    // start the timer of this slot operation
+    operation.timer = std::make_unique<
+        sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>>(
+        event, [this, adapterObjPath = *adapterObjPath](auto&) {
+            timeOutHandler(adapterObjPath);
+        });
+    operation.timer->restartOnce(timeout);
 
     // call the VPD Manager to collect/remove VPD objects
-    callVPDManager(adapterObjPath, stateFiledValue);
+    callVPDManager(*adapterObjPath, stateFiledValue);
+}
 
-    // start the 1 min timer
-    timer.restart(std::chrono::seconds(60));
+int SlotHandler::vpdCallCallback(sd_bus_message* msg, void* userData,
+                                 sd_bus_error* /*error*/)
+{
+    auto [handler, adapterObjPath] =
+        *static_cast<std::pair<SlotHandler*, std::string>*>(userData);
+    bool success = !sd_bus_message_is_method_error(msg, nullptr);
+    if (!success)
+    {
+        auto error = sd_bus_message_get_error(msg);
+        std::cerr << "VPD Manager failed the slot operation, ADAPTER="
+                  << adapterObjPath << ", ERROR="
+                  << (error && error->message ? error->message : "") << "\n";
+    }
+    handler->completeVPDCall(adapterObjPath, success);
+    return 0;
 }
 
 void SlotHandler::callVPDManager(const std::string& adapterObjPath,
                                  uint8_t stateFiledValue)
 {
+    static constexpr auto VPDService = "com.ibm.VPD.Manager";
     static constexpr auto VPDObjPath = "/com/ibm/VPD/Manager";
     static constexpr auto VPDInterface = "com.ibm.VPD.Manager";
+
+    const char* vpdMethod = nullptr;
+    if (stateFiledValue == uint8_t(ADD))
+    {
+        vpdMethod = "CollectFRUVPD";
+    }
+    else if (stateFiledValue == uint8_t(REMOVE) ||
+             stateFiledValue == uint8_t(REPLACE))
+    {
+        vpdMethod = "deleteFRUVPD";
+    }
+    else
+    {
+        return;
+    }
+
     auto& bus = pldm::utils::DBusHandler::getBus();
     try
     {
-        auto service =
-            pldm::utils::DBusHandler().getService(VPDObjPath, VPDInterface);
-        if (stateFiledValue == uint8_t(ADD))
+        auto method = bus.new_method_call(VPDService, VPDObjPath,
+                                          VPDInterface, vpdMethod);
+        method.append(
+            static_cast<sdbusplus::message::object_path>(adapterObjPath));
+
+        // The reply is handled in the event loop, the callback data lives
+        // as long as the call slot
+        auto userData =
+            std::make_unique<std::pair<SlotHandler*, std::string>>(
+                this, adapterObjPath);
+        sd_bus_slot* slot = nullptr;
+        auto rc = sd_bus_call_async(bus.get(), &slot, method.get(),
+                                    vpdCallCallback, userData.get(), 0);
+        if (rc < 0)
         {
-            auto method = bus.new_method_call(service.c_str(), VPDObjPath,
-                                              VPDInterface, "CollectFRUVPD");
-            method.append(
-                static_cast<sdbusplus::message::object_path>(adapterObjPath));
-            bus.call_noreply(method);
-        }
-        else if (stateFiledValue == uint8_t(REMOVE) ||
-                 stateFiledValue == uint8_t(REPLACE))
-        {
-            auto method = bus.new_method_call(service.c_str(), VPDObjPath,
-                                              VPDInterface, "deleteFRUVPD");
-            method.append(
-                static_cast<sdbusplus::message::object_path>(adapterObjPath));
-            bus.call_noreply(method);
+            throw std::system_error(-rc, std::generic_category());
         }
+        sd_bus_slot_set_destroy_callback(slot, [](void* data) {
+            delete static_cast<std::pair<SlotHandler*, std::string>*>(data);
+        });
+        userData.release();
+        slotOperations.at(adapterObjPath).vpdCall.reset(slot);
     }
     catch (const std::exception& e)
     {
         std::cerr << "failed to make a d-bus call to VPD Manager , Operation ="
                   << (unsigned)stateFiledValue << ", ERROR=" << e.what()
                   << "\n";
+        completeVPDCall(adapterObjPath, false);
     }
 }
 
-std::optional<std::string>
-    SlotHandler::getAdapterObjPath(const std::string& slotObjPath)
+void SlotHandler::completeVPDCall(const std::string& adapterObjectPath,
+                                  bool success)
+{
+    if (!success)
+    {
+        // Nothing is going to change on the adapter
+        finishSlotOperation(adapterObjectPath, uint8_t(SLOT_STATE_ERROR));
+    }
+}
+
+std::vector<std::string> SlotHandler::getAdapterObjPaths()
 {
-    static constexpr auto searchpath = "/xyz/openbmc_project/inventory";
     int depth = 0;
-    std::vector<std::string> pcieAdapterInterface = {
-        "xyz.openbmc_project.Inventory.Item.PCIeDevice"};
+    std::vector<std::string> pcieAdapterInterface = {PCIeDeviceInterface};
     pldm::utils::MapperGetSubTreeResponse response =
-        pldm::utils::DBusHandler().getSubtree(searchpath, depth,
+        pldm::utils::DBusHandler().getSubtree(inventoryObjPath, depth,
                                               pcieAdapterInterface);
-    for (const auto& [objPath, serviceMap] : response)
+
+    std::vector<std::string> adapterObjPaths;
+    adapterObjPaths.reserve(response.size());
+    for (auto& [objPath, serviceMap] : response)
+    {
+        adapterObjPaths.emplace_back(std::move(objPath));
+    }
+    return adapterObjPaths;
+}
+
+void SlotHandler::addAdapter(const std::string& adapterObjectPath)
+{
+    // An adapter is a child of a PCIe Slot Object
+    auto pos = adapterObjectPath.rfind('/');
+    if (pos == std::string::npos || pos == 0)
+    {
+        return;
+    }
+    slotAdapterMap[adapterObjectPath.substr(0, pos)] = adapterObjectPath;
+}
+
+void SlotHandler::removeAdapter(const std::string& adapterObjectPath)
+{
+    auto pos = adapterObjectPath.rfind('/');
+    if (pos == std::string::npos || pos == 0)
+    {
+        return;
+    }
+    auto it = slotAdapterMap.find(adapterObjectPath.substr(0, pos));
+    if (it != slotAdapterMap.end() && it->second == adapterObjectPath)
     {
-        // An adapter is a child of a PCIe Slot Object
-        if (objPath.find(slotObjPath) != std::string::npos)
+        slotAdapterMap.erase(it);
+    }
+}
+
+std::optional<std::string>
+    SlotHandler::getAdapterObjPath(const std::string& slotObjPath)
+{
+    if (!adapterMapLoaded)
+    {
+        auto& bus = pldm::utils::DBusHandler::getBus();
+        adapterAddedMatch = std::make_unique<sdbusplus::bus::match::match>(
+            bus, interfacesAdded() +
+                     argNpath(0, std::string(inventoryObjPath) + "/"),
+            [this](sdbusplus::message::message& msg) {
+                sdbusplus::message::object_path path;
+                std::map<std::string,
+                         std::map<std::string, pldm::utils::PropertyValue>>
+                    interfaces;
+                try
+                {
+                    msg.read(path, interfaces);
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << "Failed to read the added inventory "
+                                 "interfaces, ERROR="
+                              << e.what() << "\n";
+                    // Look the adapters up again on the next slot operation
+                    adapterMapLoaded = false;
+                    return;
+                }
+                if (interfaces.contains(PCIeDeviceInterface))
+                {
+                    addAdapter(path);
+                }
+            });
+        adapterRemovedMatch = std::make_unique<sdbusplus::bus::match::match>(
+            bus, interfacesRemoved() +
+                     argNpath(0, std::string(inventoryObjPath) + "/"),
+            [this](sdbusplus::message::message& msg) {
+                sdbusplus::message::object_path path;
+                std::vector<std::string> interfaces;
+                try
+                {
+                    msg.read(path, interfaces);
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << "Failed to read the removed inventory "
+                                 "interfaces, ERROR="
+                              << e.what() << "\n";
+                    // Look the adapters up again on the next slot operation
+                    adapterMapLoaded = false;
+                    return;
+                }
+                if (std::find(interfaces.begin(), interfaces.end(),
+                              PCIeDeviceInterface) != interfaces.end())
+                {
+                    removeAdapter(path);
+                }
+            });
+
+        try
+        {
+            slotAdapterMap.clear();
+            for (const auto& adapterObjPath : getAdapterObjPaths())
+            {
+                addAdapter(adapterObjPath);
+            }
+            adapterMapLoaded = true;
+        }
+        catch (const std::exception& e)
         {
-            // Found the Adapter under the slot
-            return objPath;
+            std::cerr << "Failed to look up the PCIe adapters, ERROR="
+                      << e.what() << "\n";
         }
     }
-    return std::nullopt;
+
+    auto it = slotAdapterMap.find(slotObjPath);
+    if (it == slotAdapterMap.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
 }
 
-void SlotHandler::createPresenceMatch(const std::string& adapterObjectPath,
-                                      const pldm_entity& entity,
-                                      uint8_t stateFieldValue)
+std::unique_ptr<sdbusplus::bus::match::match>
+    SlotHandler::createPresenceMatch(const std::string& adapterObjectPath)
 {
-
-    fruPresenceMatch = std::make_unique<sdbusplus::bus::match::match>(
+    return std::make_unique<sdbusplus::bus::match::match>(
         pldm::utils::DBusHandler::getBus(),
-        propertiesChanged(adapterObjectPath,
-                          "xyz.openbmc_project.Inventory.Item"),
-        [this, adapterObjectPath, stateFieldValue,
-         entity](sdbusplus::message::message& msg) {
+        propertiesChanged(adapterObjectPath, ItemInterface),
+        [this, adapterObjectPath](sdbusplus::message::message& msg) {
             pldm::utils::DbusChangedProps props{};
             std::string intf;
             msg.read(intf, props);
-            const auto itr = props.find("Present");
+            const auto itr = props.find(PresentProperty);
             if (itr != props.end())
             {
                 bool value = std::get<bool>(itr->second);
                 // Present Property is found
-                this->processPropertyChangeFromVPD(value, adapterObjectPath,
-                                                   stateFieldValue, entity);
+                this->processPropertyChangeFromVPD(value, adapterObjectPath);
             }
         });
 }
 
 void SlotHandler::processPropertyChangeFromVPD(
-    bool presentValue, const std::string& /*adapterObjectPath*/,
-    uint8_t stateFiledvalue, const pldm_entity& entity)
+    bool presentValue, const std::string& adapterObjectPath)
 {
-    // irrespective of true->false or false->true change, we should stop the
-    // timer
-    timer.setEnabled(false);
-
-    // remove the prence match so that it does not monitor the change
-    // even after we captured the property changed signal
-    fruPresenceMatch = nullptr;
-
-    // obtain the sensor id attached with this slot
-    auto sensorId = pldm::utils::findStateSensorId(
-        pdrRepo, 0, PLDM_ENTITY_SLOT, entity.entity_instance_num,
-        entity.entity_container_id, PLDM_OEM_IBM_SLOT_ENABLE_SENSOR_STATE);
+    auto it = slotOperations.find(adapterObjectPath);
+    if (it == slotOperations.end())
+    {
+        return;
+    }
 
     uint8_t sensorOpState = uint8_t(SLOT_STATE_UNKOWN);
     if (presentValue)
@@ -185,7 +364,7 @@ void SlotHandler::processPropertyChangeFromVPD(
     }
     else
     {
-        if (stateFiledvalue == uint8_t(REPLACE))
+        if (it->second.stateFieldValue == uint8_t(REPLACE))
         {
             sensorOpState = uint8_t(SLOT_STATE_UNKOWN);
         }
@@ -194,69 +373,48 @@ void SlotHandler::processPropertyChangeFromVPD(
             sensorOpState = uint8_t(SLOT_STATE_DISABLED);
         }
     }
-    // set the sensor state based on the stateFieldValue
-    this->sendStateSensorEvent(sensorId, PLDM_STATE_SENSOR_STATE, 0,
-                               sensorOpState, uint8_t(SLOT_STATE_UNKOWN));
+
+    // irrespective of true->false or false->true change, the operation is
+    // over: stop its timer and presence match, and set the sensor state
+    // based on the stateFieldValue
+    finishSlotOperation(adapterObjectPath, sensorOpState);
 }
 
 pldm_entity SlotHandler::getEntityIDfromEffecterID(uint16_t effecterId)
 {
     pldm_entity parentfruentity{};
     uint8_t* pdrData = nullptr;
-    uint32_t pdrSize{};
-    const pldm_pdr_record* record{};
-    do
+    if (!pldm_pdr_find_effecter_by_id(pdrRepo, PLDM_STATE_EFFECTER_PDR,
+                                      effecterId, false, &pdrData, nullptr))
     {
-        record = pldm_pdr_find_record_by_type(pdrRepo, PLDM_STATE_EFFECTER_PDR,
-                                              record, &pdrData, &pdrSize);
-        if (record && (true ^ pldm_pdr_record_is_remote(record)))
-        {
-            auto pdr = reinterpret_cast<pldm_state_effecter_pdr*>(pdrData);
-            auto compositeEffecterCount = pdr->composite_effecter_count;
-            auto possible_states_start = pdr->possible_states;
-
-            for (auto effecters = 0x00; effecters < compositeEffecterCount;
-                 effecters++)
-            {
-
-                auto possibleStates =
-                    reinterpret_cast<state_effecter_possible_states*>(
-                        possible_states_start);
-
-                if (possibleStates->state_set_id ==
-                        PLDM_OEM_IBM_SLOT_ENABLE_EFFECTER_STATE &&
-                    effecterId == pdr->effecter_id)
-                {
-                    parentfruentity.entity_type = pdr->entity_type;
-                    parentfruentity.entity_instance_num = pdr->entity_instance;
-                    parentfruentity.entity_container_id = pdr->container_id;
-
-                    return parentfruentity;
-                }
-            }
-        }
-    } while (record);
+        return parentfruentity;
+    }
 
+    auto pdr = reinterpret_cast<pldm_state_effecter_pdr*>(pdrData);
+    auto possibleStates =
+        reinterpret_cast<state_effecter_possible_states*>(pdr->possible_states);
+    if (pdr->composite_effecter_count &&
+        possibleStates->state_set_id == PLDM_OEM_IBM_SLOT_ENABLE_EFFECTER_STATE)
+    {
+        parentfruentity.entity_type = pdr->entity_type;
+        parentfruentity.entity_instance_num = pdr->entity_instance;
+        parentfruentity.entity_container_id = pdr->container_id;
+    }
     return parentfruentity;
 }
 
 uint8_t SlotHandler::fetchSlotSensorState(const std::string& slotObjectPath)
 {
-    std::string adapterObjPath;
     uint8_t sensorOpState = uint8_t(SLOT_STATE_UNKOWN);
 
-    try
-    {
-        // get the adapter dbus object path from the slot dbus object path
-        adapterObjPath = getAdapterObjPath(slotObjectPath).value();
-    }
-    catch (const std::bad_optional_access& e)
+    // get the adapter dbus object path from the slot dbus object path
+    auto adapterObjPath = getAdapterObjPath(slotObjectPath);
+    if (!adapterObjPath)
     {
-        std::cerr << e.what() << '\n';
         return uint8_t(SLOT_STATE_UNKOWN);
     }
 
-    if (fetchSensorStateFromDbus(adapterObjPath))
+    if (fetchSensorStateFromDbus(*adapterObjPath))
     {
         sensorOpState = uint8_t(SLOT_STATE_ENABLED);
     }
@@ -5,11 +5,19 @@
 #include <libpldm/pdr.h>
 #include <libpldm/platform.h>
 
+#include <systemd/sd-bus.h>
+
 #include <sdbusplus/bus/match.hpp>
 #include <sdeventplus/event.hpp>
+#include <sdeventplus/source/event.hpp>
 #include <sdeventplus/utility/timer.hpp>
 
+#include <chrono>
+#include <map>
 #include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace pldm
 {
@@ -26,6 +34,8 @@ static constexpr auto FreedesktopInterface = "org.freedesktop.DBus.Properties";
 static constexpr auto PresentProperty = "Present";
 static constexpr auto GetMethod = "Get";
 static constexpr auto ItemInterface = "xyz.openbmc_project.Inventory.Item";
+static constexpr auto PCIeDeviceInterface =
+    "xyz.openbmc_project.Inventory.Item.PCIeDevice";
 
 /** @class SlotHandler
  *
@@ -33,33 +43,34 @@ static constexpr auto ItemInterface = "xyz.openbmc_project.Inventory.Item";
  *         Slot Enable operation. That includes taking actions on the
  *         setStateEffecterStates calls from Host and also sending
  *         notification to inventory manager application
+ *
+ *         Any number of slots can be under operation at the same time, each
+ *         with its own presence match and timeout. The PCIe adapters in the
+ *         inventory are looked up once and then tracked through the
+ *         InterfacesAdded/InterfacesRemoved signals, and the VPD manager is
+ *         called asynchronously, so that a slot operation does not block
+ *         the event loop.
  */
 class SlotHandler
 {
   public:
     SlotHandler() = delete;
-    ~SlotHandler() = default;
+    virtual ~SlotHandler() = default;
     SlotHandler(const SlotHandler&) = delete;
     SlotHandler& operator=(const SlotHandler&) = delete;
-    SlotHandler(SlotHandler&&) = default;
-    SlotHandler& operator=(SlotHandler&&) = default;
+    SlotHandler(SlotHandler&&) = delete;
+    SlotHandler& operator=(SlotHandler&&) = delete;
 
     /** @brief Constructors the slot enable object
      *
      * @param[in] event - reference for the main event loop
      * @param[in] repo - pointer to the BMC's Primary PDR repo
+     * @param[in] timeout - time given to the VPD manager to complete a slot
+     *                      operation
      *
      */
-    SlotHandler(const sdeventplus::Event& event, pldm_pdr* repo) :
-        timer(event,
-              std::bind(std::mem_fn(&SlotHandler::timeOutHandler), this)),
-        pdrRepo(repo)
-    {
-        fruPresenceMatch = nullptr;
-        current_on_going_slot_entity.entity_type = 0;
-        current_on_going_slot_entity.entity_instance_num = 0;
-        current_on_going_slot_entity.entity_container_id = 0;
-    }
+    SlotHandler(const sdeventplus::Event& event, pldm_pdr* repo,
+                std::chrono::milliseconds timeout = std::chrono::seconds(60));
 
     /** @brief Method to be called when enabling a Slot for ADD/REMOVE/REPLACE
      *  @param[in] effecterID - The effecter ID of the effecter that is set from
@@ -81,10 +92,87 @@ class SlotHandler
     /** @brief Method to set the oem platform handler in CodeUpdate class */
     void setOemPlatformHandler(pldm::responder::oem_platform::Handler* handler);
 
+    /** @brief Get the number of slot operations in progress */
+    size_t getOperationsInProgress() const
+    {
+        return slotOperations.size();
+    }
+
+  protected:
+    /** @brief Method to call VPD collection & VPD removal API's
+     *
+     *  The call is asynchronous, completeVPDCall() is called with its
+     *  result.
+     *
+     *  @param[in] adapterObjectPath - The adapter dbus object path
+     *  @param[in] stateFieldvalue - The current stateField value from set
+     * Effecter call
+     */
+    virtual void callVPDManager(const std::string& adapterObjPath,
+                                uint8_t stateFiledValue);
+
+    /** @brief Method to get the object paths of the PCIe adapters in the
+     *         inventory
+     */
+    virtual std::vector<std::string> getAdapterObjPaths();
+
+    /* @brief Method to send a state sensor event to Host from SlotHandler class
+     * @param[in] sensorId - sensor id for the event
+     * @param[in] sensorEventClass - sensor event class wrt DSP0248
+     * @param[in] sensorOffset - sensor offset
+     * @param[in] eventState - new event state
+     * @param[in] prevEventState - previous state
+     */
+    virtual void
+        sendStateSensorEvent(uint16_t sensorId,
+                             enum sensor_event_class_states sensorEventClass,
+                             uint8_t sensorOffset, uint8_t eventState,
+                             uint8_t prevEventState);
+
+    /** @brief Method to record the result of a VPD manager call
+     *  @param[in] adapterObjectPath - The adapter dbus object path
+     *  @param[in] success - false if the VPD manager failed the call
+     */
+    void completeVPDCall(const std::string& adapterObjectPath, bool success);
+
+    /** @brief Method to process the Property change signal from Preset Property
+     *  @param[in] presentValue - The current value of present Value
+     *  @param[in] adapterObjectPath - The adapter dbus object path
+     */
+    void processPropertyChangeFromVPD(bool presentValue,
+                                      const std::string& adapterObjectPath);
+
+    /** @brief Method to add a PCIe adapter to the slot to adapter map
+     *  @param[in] adapterObjectPath - The adapter dbus object path
+     */
+    void addAdapter(const std::string& adapterObjectPath);
+
+    /** @brief Method to remove a PCIe adapter from the slot to adapter map
+     *  @param[in] adapterObjectPath - The adapter dbus object path
+     */
+    void removeAdapter(const std::string& adapterObjectPath);
+
   private:
+    /** @struct SlotOperation
+     *
+     *  A slot operation waiting for the VPD manager
+     */
+    struct SlotOperation
+    {
+        pldm_entity entity;
+        uint8_t stateFieldValue;
+        std::unique_ptr<sdbusplus::bus::match::match> presenceMatch;
+        std::unique_ptr<
+            sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic>>
+            timer;
+        std::unique_ptr<sd_bus_slot, decltype(&sd_bus_slot_unref)> vpdCall{
+            nullptr, sd_bus_slot_unref};
+    };
+
     /** @brief call back method called when the timer is expired
+     *  @param[in] adapterObjectPath - The adapter dbus object path
      */
-    void timeOutHandler();
+    void timeOutHandler(const std::string& adapterObjectPath);
 
     /** @brief Abstracted method for obtaining the entityID from effecterID
      *  @param[in]  effecterID - The effecterID of the BMC effeter
@@ -109,35 +197,23 @@ class SlotHandler
     std::optional<std::string>
         getAdapterObjPath(const std::string& slotObjPath);
 
-    /** @brief Method to call VPD collection & VPD removal API's
-     *  @param[in] adapterObjectPath - The adapter dbus object path
-     *  @param[in] stateFieldvalue - The current stateField value from set
-     * Effecter call
-     */
-    void callVPDManager(const std::string& adapterObjPath,
-                        uint8_t stateFiledValue);
-
     /** @brief Method to create a matcher to catch the property change signal
      *  @param[in] adapterObjectPath - The adapter dbus object path
-     *  @param[in] stateFieldvalue - The current stateField value from set
-     * Effecter call
-     *  @param[in] entity - the current slot pldm entity under operation
+     *  @return the matcher
      */
-    void createPresenceMatch(const std::string& adapterObjectPath,
-                             const pldm_entity& entity,
-                             uint8_t stateFieldValue);
+    std::unique_ptr<sdbusplus::bus::match::match>
+        createPresenceMatch(const std::string& adapterObjectPath);
 
-    /** @brief Method to process the Property change signal from Preset Property
-     *  @param[in] presentValue - The current value of present Value
+    /** @brief Method to end a slot operation and report its state to host
      *  @param[in] adapterObjectPath - The adapter dbus object path
-     *  @param[in] stateFieldvalue - The current stateField value from set
-     * Effecter call
-     *  @param[in] entity - the current slot pldm entity under operation
+     *  @param[in] sensorOpState - the slot state to report
      */
-    void processPropertyChangeFromVPD(bool presentValue,
-                                      const std::string& adapterObjectPath,
-                                      uint8_t stateFieldvalue,
-                                      const pldm_entity& entity);
+    void finishSlotOperation(const std::string& adapterObjectPath,
+                             uint8_t sensorOpState);
+
+    /** @brief Callback for the asynchronous VPD manager calls */
+    static int vpdCallCallback(sd_bus_message* msg, void* userData,
+                               sd_bus_error* error);
 
     /** @brief Method to find the Present State from DBUS
      *  @param[in] adapterObjectPath - reference of the Adapter dbus object path
@@ -145,32 +221,36 @@ class SlotHandler
 
     bool fetchSensorStateFromDbus(const std::string& adapterObjectPath);
 
-    /* @brief Method to send a state sensor event to Host from SlotHandler class
-     * @param[in] sensorId - sensor id for the event
-     * @param[in] sensorEventClass - sensor event class wrt DSP0248
-     * @param[in] sensorOffset - sensor offset
-     * @param[in] eventState - new event state
-     * @param[in] prevEventState - previous state
-     */
-    void sendStateSensorEvent(uint16_t sensorId,
-                              enum sensor_event_class_states sensorEventClass,
-                              uint8_t sensorOffset, uint8_t eventState,
-                              uint8_t prevEventState);
-
     pldm::responder::oem_platform::Handler*
         oemPlatformHandler; //!< oem platform handler
 
-    /** @brief pointer to tha matcher for Present State for adapter object*/
-    std::unique_ptr<sdbusplus::bus::match::match> fruPresenceMatch;
-
-    /** @brief Timer used for Slot VPD Collection Operetation */
-    sdeventplus::utility::Timer<sdeventplus::ClockId::Monotonic> timer;
+    /** @brief the main event loop */
+    sdeventplus::Event event;
 
     /** @brief pointer to BMC's primary PDR repo */
     const pldm_pdr* pdrRepo;
 
-    /** @brief variable to store the current slot entity under operation */
-    pldm_entity current_on_going_slot_entity;
+    /** @brief time given to the VPD manager to complete a slot operation */
+    std::chrono::milliseconds timeout;
+
+    /** @brief slot operations in progress, keyed by adapter object path */
+    std::map<std::string, SlotOperation> slotOperations;
+
+    /** @brief ended slot operations, released by retireOperations out of
+     *         the callbacks of their own matches and timers
+     */
+    std::vector<SlotOperation> retiredOperations;
+    std::unique_ptr<sdeventplus::source::Defer> retireOperations;
+
+    /** @brief PCIe adapter object paths, keyed by their slot object path */
+    std::map<std::string, std::string> slotAdapterMap;
+
+    /** @brief true once the adapters were looked up in the inventory */
+    bool adapterMapLoaded = false;
+
+    /** @brief matchers keeping the slot to adapter map up to date */
+    std::unique_ptr<sdbusplus::bus::match::match> adapterAddedMatch;
+    std::unique_ptr<sdbusplus::bus::match::match> adapterRemovedMatch;
 };
 
 } // namespace responder
@@ -0,0 +1,207 @@
+#include "dbus_state_cache.hpp"
+
+#include <iostream>
+
+namespace pldm
+{
+namespace responder
+{
+namespace oem_ibm_platform
+{
+
+DbusStateCache::DbusStateCache(const pldm::utils::DBusHandler* dBusIntf) :
+    dBusIntf(dBusIntf)
+{
+    using namespace sdbusplus::bus::match::rules;
+    auto& bus = pldm::utils::DBusHandler::getBus();
+
+    bmcStateMatch = std::make_unique<sdbusplus::bus::match::match>(
+        bus, propertiesChanged(bmcStateObjectPath, bmcStateInterface),
+        std::bind(&DbusStateCache::bmcStateChanged, this,
+                  std::placeholders::_1));
+    watchDogMatch = std::make_unique<sdbusplus::bus::match::match>(
+        bus, propertiesChanged(watchDogObjectPath, watchDogInterface),
+        std::bind(&DbusStateCache::watchDogChanged, this,
+                  std::placeholders::_1));
+    compatibleSystemMatch = std::make_unique<sdbusplus::bus::match::match>(
+        bus, interfacesAdded() + sender("xyz.openbmc_project.EntityManager"),
+        std::bind(&DbusStateCache::compatibleSystemAdded, this,
+                  std::placeholders::_1));
+}
+
+std::optional<std::string> DbusStateCache::getBMCState()
+{
+    if (!bmcState)
+    {
+        try
+        {
+            auto value = dBusIntf->getDbusPropertyVariant(
+                bmcStateObjectPath, bmcStateProperty, bmcStateInterface);
+            bmcState = std::get<std::string>(value);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Error getting the current BMC state, ERROR="
+                      << e.what() << "\n";
+        }
+    }
+    return bmcState;
+}
+
+std::filesystem::path DbusStateCache::getSystemType()
+{
+    if (systemType.empty() && !systemTypeLookedUp)
+    {
+        readSystemType();
+    }
+    return std::filesystem::path{systemType};
+}
+
+bool DbusStateCache::isWatchDogEnabled()
+{
+    if (!watchDogEnabled)
+    {
+        try
+        {
+            auto value = dBusIntf->getDbusPropertyVariant(
+                watchDogObjectPath, watchDogEnabledProperty,
+                watchDogInterface);
+            watchDogEnabled = std::get<bool>(value);
+        }
+        catch (const std::exception& e)
+        {
+            return false;
+        }
+    }
+    return *watchDogEnabled;
+}
+
+void DbusStateCache::setBMCState(const std::string& state)
+{
+    bmcState = state;
+}
+
+void DbusStateCache::setSystemType(const std::string& type)
+{
+    systemType = type;
+    // The system type does not change once it is published, so there is no
+    // need to keep listening for it.
+    compatibleSystemMatch.reset();
+}
+
+void DbusStateCache::setWatchDogEnabled(bool enabled)
+{
+    watchDogEnabled = enabled;
+}
+
+void DbusStateCache::bmcStateChanged(sdbusplus::message::message& msg)
+{
+    pldm::utils::DbusChangedProps props{};
+    std::string intf;
+    msg.read(intf, props);
+
+    const auto itr = props.find(bmcStateProperty);
+    if (itr != props.end())
+    {
+        setBMCState(std::get<std::string>(itr->second));
+    }
+}
+
+void DbusStateCache::watchDogChanged(sdbusplus::message::message& msg)
+{
+    pldm::utils::DbusChangedProps props{};
+    std::string intf;
+    msg.read(intf, props);
+
+    const auto itr = props.find(watchDogEnabledProperty);
+    if (itr != props.end())
+    {
+        setWatchDogEnabled(std::get<bool>(itr->second));
+    }
+}
+
+void DbusStateCache::compatibleSystemAdded(sdbusplus::message::message& msg)
+{
+    sdbusplus::message::object_path path;
+    std::map<std::string,
+             std::map<std::string, std::variant<std::vector<std::string>>>>
+        interfaces;
+
+    msg.read(path, interfaces);
+
+    if (!interfaces.contains(compatibleSystemInterface))
+    {
+        return;
+    }
+
+    const auto& properties = interfaces.at(compatibleSystemInterface);
+    if (!properties.contains(compatibleNamesProperty))
+    {
+        return;
+    }
+
+    auto names = std::get<std::vector<std::string>>(
+        properties.at(compatibleNamesProperty));
+    if (!names.empty())
+    {
+        // get only the first system type
+        setSystemType(names[0]);
+    }
+}
+
+void DbusStateCache::readSystemType()
+{
+    static constexpr auto searchpath = "/xyz/openbmc_project/";
+    int depth = 0;
+    std::vector<std::string> ibmCompatible = {compatibleSystemInterface};
+
+    pldm::utils::MapperGetSubTreeResponse response;
+    try
+    {
+        response = dBusIntf->getSubtree(searchpath, depth, ibmCompatible);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error looking up IBMCompatibleSystem, ERROR="
+                  << e.what() << "\n";
+        return;
+    }
+
+    auto& bus = pldm::utils::DBusHandler::getBus();
+    for (const auto& [objectPath, serviceMap] : response)
+    {
+        try
+        {
+            auto method = bus.new_method_call(
+                serviceMap[0].first.c_str(), objectPath.c_str(),
+                pldm::utils::dbusProperties, "Get");
+            method.append(compatibleSystemInterface, compatibleNamesProperty);
+            auto reply = bus.call(method);
+            std::variant<std::vector<std::string>> value;
+            reply.read(value);
+            auto names = std::get<std::vector<std::string>>(value);
+            if (!names.empty())
+            {
+                setSystemType(names[0]);
+                return;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Error getting Names property , PATH=" << objectPath
+                      << " Compatible interface =" << ibmCompatible[0] << "\n";
+        }
+    }
+
+    if (response.empty())
+    {
+        // Entity Manager has not published the system type yet, the
+        // InterfacesAdded match delivers it once it does, so there is no
+        // need to query the mapper on every lookup.
+        systemTypeLookedUp = true;
+    }
+}
+
+} // namespace oem_ibm_platform
+} // namespace responder
+} // namespace pldm
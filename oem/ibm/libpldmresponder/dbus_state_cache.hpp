@@ -0,0 +1,122 @@
+#pragma once
+
+#include "common/utils.hpp"
+
+#include <sdbusplus/bus/match.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace pldm
+{
+namespace responder
+{
+namespace oem_ibm_platform
+{
+
+static constexpr auto bmcStateObjectPath = "/xyz/openbmc_project/state/bmc0";
+static constexpr auto bmcStateInterface = "xyz.openbmc_project.State.BMC";
+static constexpr auto bmcStateProperty = "CurrentBMCState";
+static constexpr auto bmcStateNotReady =
+    "xyz.openbmc_project.State.BMC.BMCState.NotReady";
+static constexpr auto watchDogObjectPath =
+    "/xyz/openbmc_project/watchdog/host0";
+static constexpr auto watchDogInterface = "xyz.openbmc_project.State.Watchdog";
+static constexpr auto watchDogEnabledProperty = "Enabled";
+static constexpr auto compatibleSystemInterface =
+    "xyz.openbmc_project.Configuration.IBMCompatibleSystem";
+static constexpr auto compatibleNamesProperty = "Names";
+
+/** @class DbusStateCache
+ *
+ *  @brief Keeps the BMC state, the system type (IBMCompatibleSystem) and the
+ *         host watchdog Enabled property in memory so that the GetPDR and
+ *         heartbeat paths do not need a D-Bus round trip per PLDM message.
+ *
+ *         Each value is read over D-Bus at most once, when it is first
+ *         needed, and from then on is kept up to date by the D-Bus signals
+ *         the cache subscribes to. A value whose initial read failed is
+ *         retried on the next lookup.
+ */
+class DbusStateCache
+{
+  public:
+    DbusStateCache() = delete;
+    DbusStateCache(const DbusStateCache&) = delete;
+    DbusStateCache& operator=(const DbusStateCache&) = delete;
+    DbusStateCache(DbusStateCache&&) = delete;
+    DbusStateCache& operator=(DbusStateCache&&) = delete;
+    ~DbusStateCache() = default;
+
+    /** @brief Constructor
+     *
+     *  @param[in] dBusIntf - interface used for the one time D-Bus reads
+     */
+    explicit DbusStateCache(const pldm::utils::DBusHandler* dBusIntf);
+
+    /** @brief Get the current BMC state
+     *
+     *  @return the CurrentBMCState value, std::nullopt if it is not known
+     */
+    std::optional<std::string> getBMCState();
+
+    /** @brief Get the system type/model
+     *
+     *  @return the first IBMCompatibleSystem name, empty path if not known
+     */
+    std::filesystem::path getSystemType();
+
+    /** @brief Check if the host watchdog is enabled
+     *
+     *  @return true if the watchdog is enabled, false otherwise
+     */
+    bool isWatchDogEnabled();
+
+    /** @brief Update the cached BMC state
+     *
+     *  @param[in] state - new CurrentBMCState value
+     */
+    void setBMCState(const std::string& state);
+
+    /** @brief Update the cached system type
+     *
+     *  @param[in] type - new system type/model
+     */
+    void setSystemType(const std::string& type);
+
+    /** @brief Update the cached watchdog Enabled property
+     *
+     *  @param[in] enabled - new value of the Enabled property
+     */
+    void setWatchDogEnabled(bool enabled);
+
+  private:
+    /** @brief Callback for the BMC state PropertiesChanged signal */
+    void bmcStateChanged(sdbusplus::message::message& msg);
+
+    /** @brief Callback for the watchdog PropertiesChanged signal */
+    void watchDogChanged(sdbusplus::message::message& msg);
+
+    /** @brief Callback for the Entity Manager InterfacesAdded signal */
+    void compatibleSystemAdded(sdbusplus::message::message& msg);
+
+    /** @brief Read the system type from the IBMCompatibleSystem object */
+    void readSystemType();
+
+    const pldm::utils::DBusHandler* dBusIntf;
+
+    std::optional<std::string> bmcState;
+    std::optional<bool> watchDogEnabled;
+    std::string systemType;
+    bool systemTypeLookedUp = false;
+
+    std::unique_ptr<sdbusplus::bus::match::match> bmcStateMatch;
+    std::unique_ptr<sdbusplus::bus::match::match> watchDogMatch;
+    std::unique_ptr<sdbusplus::bus::match::match> compatibleSystemMatch;
+};
+
+} // namespace oem_ibm_platform
+} // namespace responder
+} // namespace pldm
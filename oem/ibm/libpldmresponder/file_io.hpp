@@ -243,6 +243,11 @@ class Handler : public CmdHandler
                                  request, payloadLength);
                          });
 
+        // These only move data between the files of the file table and the
+        // host, they don't use the D-Bus connection.
+        offloadable = {PLDM_READ_FILE_INTO_MEMORY, PLDM_WRITE_FILE_FROM_MEMORY,
+                       PLDM_READ_FILE, PLDM_WRITE_FILE};
+
         resDumpMatcher = std::make_unique<sdbusplus::bus::match::match>(
             pldm::utils::DBusHandler::getBus(),
             sdbusplus::bus::match::rules::interfacesAdded() +
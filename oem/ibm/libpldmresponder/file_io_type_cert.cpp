@@ -3,11 +3,13 @@
 #include "libpldm/base.h"
 #include "oem/ibm/libpldm/file_io.h"
 
+#include "common/logger.hpp"
 #include "common/utils.hpp"
 
 #include <stdint.h>
+#include <sys/stat.h>
 
-#include <iostream>
+#include <algorithm>
 
 namespace pldm
 {
@@ -16,47 +18,38 @@ using namespace utils;
 namespace responder
 {
 
-static constexpr auto certFilePath = "/var/lib/ibm/bmcweb/";
-
 CertMap CertHandler::certMap;
 
 int CertHandler::writeFromMemory(uint32_t offset, uint32_t length,
                                  uint64_t address,
                                  oem_platform::Handler* /*oemPlatformHandler*/)
 {
-    auto it = certMap.find(certType);
+    auto it = certMap.find({certType, fileHandle});
     if (it == certMap.end())
     {
-        std::cerr << "file for type " << certType << " doesn't exist\n";
+        logging::error("file for type ", certType, " doesn't exist");
         return PLDM_ERROR;
     }
 
     auto fd = std::get<0>(it->second);
-    auto& remSize = std::get<1>(it->second);
     auto rc = transferFileData(fd, false, offset, length, address);
-    if (rc == PLDM_SUCCESS)
+    if (rc != PLDM_SUCCESS)
     {
-        remSize -= length;
-        if (!remSize)
-        {
-            close(fd);
-            certMap.erase(it);
-        }
+        return rc;
     }
-    return rc;
+    return transferred(it, length);
 }
 
 int CertHandler::readIntoMemory(uint32_t offset, uint32_t& length,
                                 uint64_t address,
                                 oem_platform::Handler* /*oemPlatformHandler*/)
 {
-    std::string filePath = certFilePath;
-    filePath += "CSR_" + std::to_string(fileHandle);
+    auto filePath = certDir / ("CSR_" + std::to_string(fileHandle));
     if (certType != PLDM_FILE_TYPE_CERT_SIGNING_REQUEST)
     {
         return PLDM_ERROR_INVALID_DATA;
     }
-    auto rc = transferFileData(filePath.c_str(), true, offset, length, address);
+    auto rc = transferFileData(filePath, true, offset, length, address);
     fs::remove(filePath);
     if (rc)
     {
@@ -68,10 +61,9 @@ int CertHandler::readIntoMemory(uint32_t offset, uint32_t& length,
 int CertHandler::read(uint32_t offset, uint32_t& length, Response& response,
                       oem_platform::Handler* /*oemPlatformHandler*/)
 {
-    std::cout << "Read file response for Sign CSR, file handle: " << fileHandle
-              << std::endl;
-    std::string filePath = certFilePath;
-    filePath += "CSR_" + std::to_string(fileHandle);
+    logging::info("Read file response for Sign CSR, file handle: ",
+                  fileHandle);
+    auto filePath = certDir / ("CSR_" + std::to_string(fileHandle));
     if (certType != PLDM_FILE_TYPE_CERT_SIGNING_REQUEST)
     {
         return PLDM_ERROR_INVALID_DATA;
@@ -88,127 +80,111 @@ int CertHandler::read(uint32_t offset, uint32_t& length, Response& response,
 int CertHandler::write(const char* buffer, uint32_t offset, uint32_t& length,
                        oem_platform::Handler* /*oemPlatformHandler*/)
 {
-    std::cout << "Client certificate write, file handle: " << fileHandle
-              << std::endl;
-    auto it = certMap.find(certType);
+    logging::debug("Client certificate write, file handle: ", fileHandle);
+    auto it = certMap.find({certType, fileHandle});
     if (it == certMap.end())
     {
-        std::cerr << "file for type " << certType << " doesn't exist\n";
+        logging::error("file for type ", certType, " doesn't exist");
         return PLDM_ERROR;
     }
 
     auto fd = std::get<0>(it->second);
-    int rc = lseek(fd, offset, SEEK_SET);
-    if (rc == -1)
-    {
-        std::cerr << "lseek failed, ERROR=" << errno << ", OFFSET=" << offset
-                  << "\n";
-        return PLDM_ERROR;
-    }
-    rc = ::write(fd, buffer, length);
+    auto rc = pwrite(fd, buffer, length, offset);
     if (rc == -1)
     {
-        std::cerr << "file write failed, ERROR=" << errno
-                  << ", LENGTH=" << length << ", OFFSET=" << offset << "\n";
+        logging::error("file write failed, ERROR=", errno, ", LENGTH=", length,
+                       ", OFFSET=", offset);
         return PLDM_ERROR;
     }
     length = rc;
-    auto& remSize = std::get<1>(it->second);
-    remSize -= length;
-    if (!remSize)
+    return transferred(it, length);
+}
+
+int CertHandler::transferred(CertMap::iterator it, uint32_t length)
+{
+    auto& [fd, remSize] = it->second;
+    remSize -= std::min<RemainingSize>(remSize, length);
+    if (remSize)
     {
-        close(fd);
-        certMap.erase(it);
+        return PLDM_SUCCESS;
     }
 
+    auto certFd = fd;
+    certMap.erase(it);
+    int rc = PLDM_SUCCESS;
     if (certType == PLDM_FILE_TYPE_SIGNED_CERT)
     {
-        constexpr auto certObjPath = "/xyz/openbmc_project/certs/ca/entry/";
-        constexpr auto certEntryIntf = "xyz.openbmc_project.Certs.Entry";
+        rc = publishSignedCert(certFd);
+    }
+    close(certFd);
+    return rc;
+}
 
-        std::string filePath = certFilePath;
-        filePath += "ClientCert_" + std::to_string(fileHandle);
+int CertHandler::publishSignedCert(Fd fd)
+{
+    constexpr auto certObjPath = "/xyz/openbmc_project/certs/ca/entry/";
+    constexpr auto certEntryIntf = "xyz.openbmc_project.Certs.Entry";
 
-        std::ifstream inFile;
-        inFile.open(filePath);
-        std::stringstream strStream;
-        strStream << inFile.rdbuf();
-        std::string str = strStream.str();
-        inFile.close();
+    // The certificate is read back once, from the fd it was written with
+    std::string cert;
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+        cert.resize(fileStat.st_size);
+        auto rc = pread(fd, cert.data(), cert.size(), 0);
+        cert.resize(rc > 0 ? rc : 0);
+    }
 
-        if (!str.empty())
+    DBusHandler defaultDBusIntf;
+    auto dBus = dBusIntf ? dBusIntf : &defaultDBusIntf;
+    auto setProperty = [this, dBus](const char* propertyName,
+                                    const std::string& value) {
+        DBusMapping dbusMapping{certObjPath + std::to_string(fileHandle),
+                                certEntryIntf, propertyName, "string"};
+        try
         {
-            PropertyValue value{str};
-
-            DBusMapping dbusMapping{certObjPath + std::to_string(fileHandle),
-                                    certEntryIntf, "ClientCertificate",
-                                    "string"};
-            try
-            {
-                pldm::utils::DBusHandler().setDbusProperty(dbusMapping, value);
-            }
-            catch (const std::exception& e)
-            {
-                std::cerr << "failed to set Client certificate, "
-                             "ERROR="
-                          << e.what() << "\n";
-                return PLDM_ERROR;
-            }
-            PropertyValue valueStatus{
-                "xyz.openbmc_project.Certs.Entry.State.Complete"};
-            DBusMapping dbusMappingStatus{certObjPath +
-                                              std::to_string(fileHandle),
-                                          certEntryIntf, "Status", "string"};
-            try
-            {
-                std::cout
-                    << "Client cert write, status: complete. File handle: "
-                    << fileHandle << std::endl;
-                pldm::utils::DBusHandler().setDbusProperty(dbusMappingStatus,
-                                                           valueStatus);
-            }
-            catch (const std::exception& e)
-            {
-                std::cerr
-                    << "failed to set status property of certicate entry, "
-                       "ERROR="
-                    << e.what() << "\n";
-                return PLDM_ERROR;
-            }
-            fs::remove(filePath);
+            dBus->setDbusProperty(dbusMapping, PropertyValue{value});
         }
-        else
+        catch (const std::exception& e)
         {
-            PropertyValue value{"xyz.openbmc_project.Certs.Entry.State.BadCSR"};
-            DBusMapping dbusMapping{certObjPath + std::to_string(fileHandle),
-                                    certEntryIntf, "Status", "string"};
-            try
-            {
-                std::cout << "Client cert write, status: Bad CSR. File handle: "
-                          << fileHandle << std::endl;
-                pldm::utils::DBusHandler().setDbusProperty(dbusMapping, value);
-            }
-            catch (const std::exception& e)
-            {
-                std::cerr
-                    << "failed to set status property of certicate entry, "
-                       "ERROR="
-                    << e.what() << "\n";
-                return PLDM_ERROR;
-            }
+            logging::error("failed to set ", propertyName,
+                           " property of certicate entry, ERROR=", e.what());
+            return false;
         }
+        return true;
+    };
+
+    if (cert.empty())
+    {
+        logging::info("Client cert write, status: Bad CSR. File handle: ",
+                      fileHandle);
+        return setProperty("Status",
+                           "xyz.openbmc_project.Certs.Entry.State.BadCSR")
+                   ? PLDM_SUCCESS
+                   : PLDM_ERROR;
+    }
+
+    if (!setProperty("ClientCertificate", cert))
+    {
+        return PLDM_ERROR;
     }
+    logging::info("Client cert write, status: complete. File handle: ",
+                  fileHandle);
+    if (!setProperty("Status",
+                     "xyz.openbmc_project.Certs.Entry.State.Complete"))
+    {
+        return PLDM_ERROR;
+    }
+    fs::remove(certDir / ("ClientCert_" + std::to_string(fileHandle)));
     return PLDM_SUCCESS;
 }
 
 int CertHandler::newFileAvailable(uint64_t length)
 {
-    fs::create_directories(certFilePath);
-    fs::permissions(certFilePath,
-                    fs::perms::others_read | fs::perms::owner_write);
+    fs::create_directories(certDir);
+    fs::permissions(certDir, fs::perms::others_read | fs::perms::owner_write);
     int fileFd = -1;
-    int flags = O_WRONLY | O_CREAT | O_TRUNC;
-    std::string filePath = certFilePath;
+    int flags = O_RDWR | O_CREAT | O_TRUNC;
 
     if (certType == PLDM_FILE_TYPE_CERT_SIGNING_REQUEST)
     {
@@ -216,24 +192,47 @@ int CertHandler::newFileAvailable(uint64_t length)
     }
     if (certType == PLDM_FILE_TYPE_SIGNED_CERT)
     {
-        std::cout << "new file available client cert file, file handle: "
-                  << fileHandle << std::endl;
-        fileFd = open(
-            (filePath + "ClientCert_" + std::to_string(fileHandle)).c_str(),
-            flags, S_IRUSR | S_IWUSR);
+        logging::info("new file available client cert file, file handle: ",
+                      fileHandle);
+        fileFd =
+            open((certDir / ("ClientCert_" + std::to_string(fileHandle)))
+                     .c_str(),
+                 flags, S_IRUSR | S_IWUSR);
     }
     else if (certType == PLDM_FILE_TYPE_ROOT_CERT)
     {
-        fileFd =
-            open((filePath + "RootCert").c_str(), flags, S_IRUSR | S_IWUSR);
+        // There is one root certificate file, a new transfer of it abandons
+        // the one in progress rather than truncating its file under it
+        auto it = certMap.lower_bound({certType, 0});
+        while (it != certMap.end() && it->first.first == certType)
+        {
+            if (it->first.second == fileHandle)
+            {
+                ++it;
+                continue;
+            }
+            logging::info("root cert transfer abandoned, file handle: ",
+                          it->first.second);
+            close(std::get<0>(it->second));
+            it = certMap.erase(it);
+        }
+        fileFd = open((certDir / "RootCert").c_str(), flags, S_IRUSR | S_IWUSR);
     }
     if (fileFd == -1)
     {
-        std::cerr << "failed to open file for type " << certType
-                  << " ERROR=" << errno << "\n";
+        logging::error("failed to open file for type ", certType,
+                       " ERROR=", errno);
         return PLDM_ERROR;
     }
-    certMap.emplace(certType, std::tuple(fileFd, length));
+
+    // The host starting over with a file handle abandons its transfer
+    auto [it, added] = certMap.try_emplace({certType, fileHandle}, fileFd,
+                                           length);
+    if (!added)
+    {
+        close(std::get<0>(it->second));
+        it->second = std::tuple(fileFd, length);
+    }
     return PLDM_SUCCESS;
 }
 
@@ -2,31 +2,51 @@
 
 #include "file_io_by_type.hpp"
 
+#include "common/utils.hpp"
+
+#include <map>
 #include <tuple>
+#include <utility>
 
 namespace pldm
 {
 namespace responder
 {
 
+static constexpr auto certFilePath = "/var/lib/ibm/bmcweb/";
+
 using Fd = int;
 using RemainingSize = uint64_t;
 using CertDetails = std::tuple<Fd, RemainingSize>;
 using CertType = uint16_t;
-using CertMap = std::map<CertType, CertDetails>;
+using CertHandle = std::pair<CertType, uint32_t>;
+using CertMap = std::map<CertHandle, CertDetails>;
 
 /** @class CertHandler
  *
  *  @brief Inherits and implements FileHandler. This class is used
  *  to read/write certificates and certificate signing requests
+ *
+ *  A transfer is tracked per certificate type and file handle, so that the
+ *  host can exchange several certificates at the same time. There is one
+ *  root certificate file, so only its latest transfer goes on.
  */
 class CertHandler : public FileHandler
 {
   public:
     /** @brief CertHandler constructor
+     *
+     *  @param[in] fileHandle - file handle of the certificate
+     *  @param[in] fileType - type of the certificate
+     *  @param[in] dBusIntf - D-Bus handler to publish the signed certificates
+     *                        with, the default one if nullptr
+     *  @param[in] certDir - directory of the certificate files
      */
-    CertHandler(uint32_t fileHandle, uint16_t fileType) :
-        FileHandler(fileHandle), certType(fileType)
+    CertHandler(uint32_t fileHandle, uint16_t fileType,
+                const pldm::utils::DBusHandler* dBusIntf = nullptr,
+                const fs::path& certDir = certFilePath) :
+        FileHandler(fileHandle),
+        certType(fileType), dBusIntf(dBusIntf), certDir(certDir)
     {}
 
     virtual int writeFromMemory(uint32_t offset, uint32_t length,
@@ -68,9 +88,29 @@ class CertHandler : public FileHandler
     {}
 
   private:
-    uint16_t certType;      //!< type of the certificate
+    /** @brief Account for the data written to a certificate, the transfer is
+     *         finished when all of it is written
+     *
+     *  @param[in] it - the transfer
+     *  @param[in] length - length of the data written
+     *
+     *  @return PLDM status code
+     */
+    int transferred(CertMap::iterator it, uint32_t length);
+
+    /** @brief Publish a signed certificate to the certificate manager
+     *
+     *  @param[in] fd - fd of the certificate file
+     *
+     *  @return PLDM status code
+     */
+    int publishSignedCert(Fd fd);
+
+    uint16_t certType; //!< type of the certificate
+    const pldm::utils::DBusHandler* dBusIntf; //!< D-Bus handler
+    fs::path certDir; //!< directory of the certificate files
     static CertMap certMap; //!< holds the fd and remaining read/write size for
-                            //!< each certificate
+                            //!< each certificate transfer
 };
 } // namespace responder
 } // namespace pldm
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include <fstream>
 #include <iostream>
 
 namespace pldm
@@ -21,29 +22,101 @@ namespace responder
 {
 
 static constexpr auto codFilePath = "/var/lib/ibm/cod/";
-static constexpr auto licFilePath = "/var/lib/pldm/license/";
 constexpr auto newLicenseFile = "new_license.bin";
 constexpr auto newLicenseJsonFile = "new_license.json";
 
-int LicenseHandler::updateBinFileAndLicObjs(const fs::path& newLicJsonFilePath)
+void LicenseBuffer::start(uint64_t length)
 {
-    int rc = PLDM_SUCCESS;
-    fs::path newLicFilePath(fs::path(licFilePath) / newLicenseFile);
-    std::ifstream jsonFileNew(newLicJsonFilePath);
+    this->length = length;
+    data.clear();
+    depth = 0;
+    inString = false;
+    escaped = false;
+    closed = false;
+}
 
-    auto dataNew = Json::parse(jsonFileNew, nullptr, false);
-    if (dataNew.is_discarded())
+void LicenseBuffer::append(const char* buffer, uint32_t length)
+{
+    data.append(buffer, length);
+    if (this->length)
     {
-        std::cerr << "Parsing the new license json file failed, FILE="
-                  << newLicJsonFilePath << "\n";
-        throw InternalFailure();
+        return;
     }
+    // Each chunk is scanned once, the data is parsed when it is complete
+    for (uint32_t i = 0; i < length; ++i)
+    {
+        scan(buffer[i]);
+    }
+}
+
+void LicenseBuffer::scan(char c)
+{
+    if (inString)
+    {
+        if (escaped)
+        {
+            escaped = false;
+        }
+        else if (c == '\\')
+        {
+            escaped = true;
+        }
+        else if (c == '"')
+        {
+            inString = false;
+        }
+        return;
+    }
+
+    switch (c)
+    {
+        case '"':
+            inString = true;
+            break;
+        case '{':
+        case '[':
+            ++depth;
+            break;
+        case '}':
+        case ']':
+            if (depth)
+            {
+                --depth;
+                closed = !depth;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+bool LicenseBuffer::complete() const
+{
+    if (length)
+    {
+        return data.size() >= length;
+    }
+    // A chunk can end with the end of an object nested in the license
+    return closed && !depth;
+}
+
+Json LicenseBuffer::take()
+{
+    auto licJson = Json::parse(data, nullptr, false);
+    start(0);
+    data.shrink_to_fit();
+    return licJson;
+}
+
+int LicenseHandler::updateBinFileAndLicObjs(const Json& licJson)
+{
+    fs::path newLicFilePath(licDir / newLicenseFile);
 
     // Store the json data in a file with binary format
-    convertJsonToBinaryFile(dataNew, newLicFilePath);
+    convertJsonToBinaryFile(licJson, newLicFilePath);
 
     // Create or update the license objects
-    rc = createOrUpdateLicenseObjs();
+    auto rc = createOrUpdateLicenseObjs(licJson);
     if (rc != PLDM_SUCCESS)
     {
         std::cerr << "createOrUpdateLicenseObjs failed with rc= " << rc
@@ -58,20 +131,33 @@ int LicenseHandler::writeFromMemory(
     oem_platform::Handler* /*oemPlatformHandler*/)
 {
     namespace fs = std::filesystem;
-    if (!fs::exists(licFilePath))
+    if (offset + uint64_t(length) > maxLicenseLength)
     {
-        fs::create_directories(licFilePath);
-        fs::permissions(licFilePath,
+        std::cerr << "License data too long, OFFSET=" << offset
+                  << ", LENGTH=" << length << "\n";
+        licLength = 0;
+        return PLDM_ERROR_INVALID_LENGTH;
+    }
+    if (!fs::exists(licDir))
+    {
+        fs::create_directories(licDir);
+        fs::permissions(licDir,
                         fs::perms::others_read | fs::perms::owner_write);
     }
-    fs::path newLicJsonFilePath(fs::path(licFilePath) / newLicenseJsonFile);
-    std::ofstream licJsonFile(newLicJsonFilePath,
-                              std::ios::out | std::ios::binary);
-    if (!licJsonFile)
+    fs::path newLicJsonFilePath(licDir / newLicenseJsonFile);
+
+    // The file is recreated for a new license only, the chunks after the
+    // first are transferred into it at their offsets
+    if (offset == 0)
     {
-        std::cerr << "license json file create error: " << newLicJsonFilePath
-                  << std::endl;
-        return -1;
+        std::ofstream licJsonFile(newLicJsonFilePath,
+                                  std::ios::out | std::ios::binary);
+        if (!licJsonFile)
+        {
+            std::cerr << "license json file create error: "
+                      << newLicJsonFilePath << std::endl;
+            return -1;
+        }
     }
 
     auto rc =
@@ -82,15 +168,27 @@ int LicenseHandler::writeFromMemory(
         return rc;
     }
 
-    if (length == licLength)
+    // Without an announced length, the transfer is the whole license
+    if (licLength && offset + length < licLength)
     {
-        rc = updateBinFileAndLicObjs(newLicJsonFilePath);
-        if (rc != PLDM_SUCCESS)
-        {
-            std::cerr << "updateBinFileAndLicObjs failed with rc= " << rc
-                      << " \n";
-            return rc;
-        }
+        return PLDM_SUCCESS;
+    }
+    licLength = 0;
+
+    std::ifstream licJsonFile(newLicJsonFilePath);
+    auto licJson = Json::parse(licJsonFile, nullptr, false);
+    if (!licJson.is_object())
+    {
+        std::cerr << "Parsing the new license json file failed, FILE="
+                  << newLicJsonFilePath << "\n";
+        return PLDM_ERROR;
+    }
+
+    rc = updateBinFileAndLicObjs(licJson);
+    if (rc != PLDM_SUCCESS)
+    {
+        std::cerr << "updateBinFileAndLicObjs failed with rc= " << rc << " \n";
+        return rc;
     }
 
     return PLDM_SUCCESS;
@@ -100,37 +198,54 @@ int LicenseHandler::write(const char* buffer, uint32_t /*offset*/,
                           uint32_t& length,
                           oem_platform::Handler* /*oemPlatformHandler*/)
 {
-    int rc = PLDM_SUCCESS;
-
-    fs::path newLicJsonFilePath(fs::path(licFilePath) / newLicenseJsonFile);
-    std::ofstream licJsonFile(newLicJsonFilePath,
-                              std::ios::out | std::ios::binary | std::ios::app);
-    if (!licJsonFile)
+    if (licenseBuffer.size() + length > maxLicenseLength)
     {
-        std::cerr << "license json file create error: " << newLicJsonFilePath
-                  << std::endl;
-        return -1;
+        std::cerr << "License data too long, SIZE=" << licenseBuffer.size()
+                  << ", LENGTH=" << length << "\n";
+        licenseBuffer.start(0);
+        licLength = 0;
+        return PLDM_ERROR_INVALID_LENGTH;
     }
-
     if (buffer != nullptr)
     {
-        licJsonFile.write(buffer, length);
+        licenseBuffer.append(buffer, length);
+    }
+    if (!licenseBuffer.complete())
+    {
+        return PLDM_SUCCESS;
     }
-    licJsonFile.close();
 
-    updateBinFileAndLicObjs(newLicJsonFilePath);
+    auto size = licenseBuffer.size();
+    auto licJson = licenseBuffer.take();
+    licLength = 0;
+    if (!licJson.is_object())
+    {
+        std::cerr << "Parsing the new license data failed, SIZE=" << size
+                  << "\n";
+        return PLDM_ERROR;
+    }
+
+    auto rc = updateBinFileAndLicObjs(licJson);
     if (rc != PLDM_SUCCESS)
     {
         std::cerr << "updateBinFileAndLicObjs failed with rc= " << rc << " \n";
         return rc;
     }
 
-    return rc;
+    return PLDM_SUCCESS;
 }
 
 int LicenseHandler::newFileAvailable(uint64_t length)
 {
+    if (length > maxLicenseLength)
+    {
+        std::cerr << "License data too long, LENGTH=" << length << "\n";
+        licLength = 0;
+        licenseBuffer.start(0);
+        return PLDM_ERROR_INVALID_LENGTH;
+    }
     licLength = length;
+    licenseBuffer.start(length);
     return PLDM_SUCCESS;
 }
 
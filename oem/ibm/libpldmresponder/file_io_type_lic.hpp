@@ -2,13 +2,73 @@
 
 #include "file_io_by_type.hpp"
 
+#include <nlohmann/json.hpp>
+
+#include <string>
+
 namespace pldm
 {
 namespace responder
 {
 
+static constexpr auto licFilePath = "/var/lib/pldm/license/";
+
+/** @brief Largest license data accepted from the host */
+static constexpr uint64_t maxLicenseLength = 16 * 1024 * 1024;
+
 using LicType = uint16_t;
 
+/** @class LicenseBuffer
+ *
+ *  @brief Accumulates the license data the host writes in chunks, so that it
+ *  is parsed once, when all of it is received
+ */
+class LicenseBuffer
+{
+  public:
+    /** @brief Start receiving a license
+     *
+     *  @param[in] length - length of the license data, 0 if not announced
+     */
+    void start(uint64_t length);
+
+    /** @brief Append a chunk of the license data
+     *
+     *  @param[in] buffer - the chunk
+     *  @param[in] length - length of the chunk
+     */
+    void append(const char* buffer, uint32_t length);
+
+    /** @brief Check if all the license data is received. If the length was not
+     *         announced, the data is taken as complete when its top-level
+     *         object or array is closed.
+     */
+    bool complete() const;
+
+    /** @brief Parse the license data received, and start over
+     *
+     *  @return the license JSON, discarded if the data is not valid JSON
+     */
+    nlohmann::json take();
+
+    /** @brief Get the number of bytes received */
+    size_t size() const
+    {
+        return data.size();
+    }
+
+  private:
+    /** @brief Follow the nesting of the data without an announced length */
+    void scan(char c);
+
+    uint64_t length = 0;   //!< announced length of the license data
+    std::string data;      //!< license data received
+    size_t depth = 0;      //!< objects and arrays open in the data
+    bool inString = false; //!< the data ends within a string
+    bool escaped = false;  //!< the data ends with an escape in a string
+    bool closed = false;   //!< a top-level object or array was closed
+};
+
 /** @class LicenseHandler
  *
  *  @brief Inherits and implements FileHandler. This class is used
@@ -18,9 +78,15 @@ class LicenseHandler : public FileHandler
 {
   public:
     /** @brief Handler constructor
+     *
+     *  @param[in] fileHandle - file handle of the license
+     *  @param[in] fileType - type of the license
+     *  @param[in] licDir - directory of the license files
      */
-    LicenseHandler(uint32_t fileHandle, uint16_t fileType) :
-        FileHandler(fileHandle), licType(fileType)
+    LicenseHandler(uint32_t fileHandle, uint16_t fileType,
+                   const fs::path& licDir = licFilePath) :
+        FileHandler(fileHandle),
+        licType(fileType), licDir(licDir)
     {}
 
     virtual int writeFromMemory(uint32_t offset, uint32_t length,
@@ -57,7 +123,15 @@ class LicenseHandler : public FileHandler
         return PLDM_ERROR_UNSUPPORTED_PLDM_CMD;
     }
 
-    int updateBinFileAndLicObjs(const fs::path& newLicFilePath);
+    /** @brief Store the new license data and create or update the license
+     *         D-Bus objects. This method is made virtual to be overridden in
+     *         test case.
+     *
+     *  @param[in] licJson - the new license data
+     *
+     *  @return PLDM status code
+     */
+    virtual int updateBinFileAndLicObjs(const nlohmann::json& licJson);
 
     /** @brief LicenseHandler destructor
      */
@@ -65,8 +139,16 @@ class LicenseHandler : public FileHandler
     {}
 
   private:
-    uint16_t licType;   //!< type of the license
-    uint64_t licLength; //!< length of the full license data
+    uint16_t licType; //!< type of the license
+    fs::path licDir;  //!< directory of the license files
+
+    /** @brief Length of the license data the host announced, the handler of
+     *         each command is a new object
+     */
+    static inline uint64_t licLength = 0;
+
+    /** @brief License data received with WriteFileByType */
+    static inline LicenseBuffer licenseBuffer;
 
     enum Status
     {
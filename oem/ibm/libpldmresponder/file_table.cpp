@@ -4,6 +4,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <mutex>
 
 namespace pldm
 {
@@ -131,6 +132,9 @@ Table FileTable::operator()() const
 FileTable& buildFileTable(const std::string& fileTablePath)
 {
     static FileTable table;
+    // The file I/O commands can be handled on the worker threads
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
     if (table.isEmpty())
     {
         table = std::move(FileTable(fileTablePath));
@@ -560,9 +560,7 @@ void attachOemEntityToEntityAssociationPDR(
                       << " not found in the BMC Entity Association tree\n";
             return;
         }
-        pldm_entity_association_tree_add(
-            bmcEntityTree, &childEntity, 0xFFFF, parent_node,
-            PLDM_ENTITY_ASSOCIAION_PHYSICAL, false, false);
+        platformHandler->addBmcEntity(parent_node, childEntity, 0xFFFF);
         uint8_t bmcEventDataOps = PLDM_INVALID_OP;
         pldm_entity_association_pdr_add_contained_entity(
             repo.getPdr(), childEntity, parent_entity, &bmcEventDataOps, false);
@@ -571,46 +569,7 @@ void attachOemEntityToEntityAssociationPDR(
 
 std::filesystem::path pldm::responder::oem_ibm_platform::Handler::getConfigDir()
 {
-    if (!systemType.empty())
-    {
-        return fs::path{systemType};
-    }
-
-    namespace fs = std::filesystem;
-    static constexpr auto compatibleInterface =
-        "xyz.openbmc_project.Configuration.IBMCompatibleSystem";
-    static constexpr auto namesProperty = "Names";
-    static constexpr auto orgFreeDesktopInterface =
-        "org.freedesktop.DBus.Properties";
-    static constexpr auto getMethod = "Get";
-
-    static constexpr auto searchpath = "/xyz/openbmc_project/";
-    int depth = 0;
-    std::vector<std::string> ibmCompatible = {compatibleInterface};
-    pldm::utils::MapperGetSubTreeResponse response =
-        pldm::utils::DBusHandler().getSubtree(searchpath, depth, ibmCompatible);
-    auto& bus = pldm::utils::DBusHandler::getBus();
-    std::variant<std::vector<std::string>> value;
-
-    for (const auto& [objectPath, serviceMap] : response)
-    {
-        try
-        {
-            auto method = bus.new_method_call(
-                serviceMap[0].first.c_str(), objectPath.c_str(),
-                orgFreeDesktopInterface, getMethod);
-            method.append(ibmCompatible[0].c_str(), namesProperty);
-            auto reply = bus.call(method);
-            reply.read(value);
-            return fs::path{std::get<std::vector<std::string>>(value)[0]};
-        }
-        catch (const std::exception& e)
-        {
-            std::cerr << "Error getting Names property , PATH=" << objectPath
-                      << " Compatible interface =" << ibmCompatible[0] << "\n";
-        }
-    }
-    return fs::path();
+    return stateCache.getSystemType();
 }
 
 void pldm::responder::oem_ibm_platform::Handler::buildOEMPDR(
@@ -1065,31 +1024,12 @@ void pldm::responder::oem_ibm_platform::Handler::checkAndDisableWatchDog()
 
 bool pldm::responder::oem_ibm_platform::Handler::watchDogRunning()
 {
-    static constexpr auto watchDogObjectPath =
-        "/xyz/openbmc_project/watchdog/host0";
-    static constexpr auto watchDogEnablePropName = "Enabled";
-    static constexpr auto watchDogInterface =
-        "xyz.openbmc_project.State.Watchdog";
-    bool isWatchDogRunning = false;
-    try
-    {
-        isWatchDogRunning = pldm::utils::DBusHandler().getDbusProperty<bool>(
-            watchDogObjectPath, watchDogEnablePropName, watchDogInterface);
-    }
-    catch (const std::exception& e)
-    {
-        return false;
-    }
-    return isWatchDogRunning;
+    return stateCache.isWatchDogEnabled();
 }
 
 void pldm::responder::oem_ibm_platform::Handler::resetWatchDogTimer()
 {
     static constexpr auto watchDogService = "xyz.openbmc_project.Watchdog";
-    static constexpr auto watchDogObjectPath =
-        "/xyz/openbmc_project/watchdog/host0";
-    static constexpr auto watchDogInterface =
-        "xyz.openbmc_project.State.Watchdog";
     static constexpr auto watchDogResetPropName = "ResetTimeRemaining";
 
     bool wdStatus = watchDogRunning();
@@ -1129,6 +1069,7 @@ void pldm::responder::oem_ibm_platform::Handler::disableWatchDogTimer()
     try
     {
         pldm::utils::DBusHandler().setDbusProperty(dbusMapping, false);
+        stateCache.setWatchDogEnabled(false);
     }
     catch (const std::exception& e)
     {
@@ -1138,25 +1079,17 @@ void pldm::responder::oem_ibm_platform::Handler::disableWatchDogTimer()
 }
 int pldm::responder::oem_ibm_platform::Handler::checkBMCState()
 {
-    try
+    auto bmcState = stateCache.getBMCState();
+    if (!bmcState)
     {
-        pldm::utils::PropertyValue propertyValue =
-            pldm::utils::DBusHandler().getDbusPropertyVariant(
-                "/xyz/openbmc_project/state/bmc0", "CurrentBMCState",
-                "xyz.openbmc_project.State.BMC");
-
-        if (std::get<std::string>(propertyValue) ==
-            "xyz.openbmc_project.State.BMC.BMCState.NotReady")
-        {
-            std::cerr << "GetPDR : PLDM stack is not ready for PDR exchange"
-                      << std::endl;
-            return PLDM_ERROR_NOT_READY;
-        }
+        return PLDM_ERROR;
     }
-    catch (const std::exception& e)
+
+    if (*bmcState == bmcStateNotReady)
     {
-        std::cerr << "Error getting the current BMC state" << std::endl;
-        return PLDM_ERROR;
+        std::cerr << "GetPDR : PLDM stack is not ready for PDR exchange"
+                  << std::endl;
+        return PLDM_ERROR_NOT_READY;
     }
     return PLDM_SUCCESS;
 }
@@ -1203,12 +1136,14 @@ void pldm::responder::oem_ibm_platform::Handler::modifyPDROemActions(
 
 void pldm::responder::oem_ibm_platform::Handler::updateContainerID()
 {
-    for (auto& [key, value] : instanceMap)
+    std::vector<pldm_effecter_container_id> updates;
+    updates.reserve(instanceMap.size());
+    for (const auto& [key, value] : instanceMap)
     {
-        uint16_t newContainerID = pldm_find_container_id(
-            pdrRepo, PLDM_ENTITY_PROC_MODULE, value.dcmId);
-        pldm_change_container_id_of_effecter(pdrRepo, key, newContainerID);
+        updates.push_back({key, value.dcmId, 0});
     }
+    pldm_change_container_id_of_effecters(pdrRepo, PLDM_ENTITY_PROC_MODULE,
+                                          updates.data(), updates.size());
 }
 
 void pldm::responder::oem_ibm_platform::Handler::handleBootTypesAtPowerOn()
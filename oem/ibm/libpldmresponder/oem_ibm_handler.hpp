@@ -6,6 +6,7 @@
 #include "collect_slot_vpd.hpp"
 #include "common/types.hpp"
 #include "common/utils.hpp"
+#include "dbus_state_cache.hpp"
 #include "inband_code_update.hpp"
 #include "libpldmresponder/oem_handler.hpp"
 #include "libpldmresponder/pdr_utils.hpp"
@@ -71,8 +72,8 @@ class Handler : public oem_platform::Handler
         oem_platform::Handler(dBusIntf),
         codeUpdate(codeUpdate), slotHandler(slotHandler),
         platformHandler(nullptr), mctp_fd(mctp_fd), mctp_eid(mctp_eid),
-        requester(requester), event(event), pdrRepo(repo), handler(handler),
-        bmcEntityTree(bmcEntityTree)
+        requester(requester), event(event), stateCache(dBusIntf),
+        pdrRepo(repo), handler(handler), bmcEntityTree(bmcEntityTree)
     {
         codeUpdate->setVersions();
         pldm::responder::utils::clearLicenseStatus();
@@ -139,45 +140,6 @@ class Handler : public oem_platform::Handler
                     }
                 }
             });
-        ibmCompatibleMatch = std::make_unique<sdbusplus::bus::match::match>(
-            pldm::utils::DBusHandler::getBus(),
-            sdbusplus::bus::match::rules::interfacesAdded() +
-                sdbusplus::bus::match::rules::sender(
-                    "xyz.openbmc_project.EntityManager"),
-            std::bind(&Handler::ibmCompatibleAddedCallback, this,
-                      std::placeholders::_1));
-    }
-
-    void ibmCompatibleAddedCallback(sdbusplus::message::message& msg)
-    {
-        sdbusplus::message::object_path path;
-        std::map<std::string,
-                 std::map<std::string, std::variant<std::vector<std::string>>>>
-            interfaces;
-
-        msg.read(path, interfaces);
-
-        if (!interfaces.contains(
-                "xyz.openbmc_project.Configuration.IBMCompatibleSystem"))
-        {
-            return;
-        }
-
-        // Get the "Name" property value of the
-        // "xyz.openbmc_project.Configuration.IBMCompatibleSystem" interface
-        const auto& properties = interfaces.at(
-            "xyz.openbmc_project.Configuration.IBMCompatibleSystem");
-
-        if (!properties.contains("Names"))
-        {
-            return;
-        }
-        auto names = std::get<std::vector<std::string>>(properties.at("Names"));
-
-        // get only the first system type
-        systemType = names[0];
-
-        ibmCompatibleMatch.reset();
     }
 
     int oemSetNumericEffecterValueHandler(
@@ -229,6 +191,27 @@ class Handler : public oem_platform::Handler
         return platformHandler->getAssociateEntityMap();
     }
 
+    /** @brief Method to add an OEM entity of the BMC, the slots and
+     *         adapters, to the entity association trees. The OEM PDRs are
+     *         built after the FRU table, so the entity goes to the BMC's
+     *         tree and to the one with the host entities as well.
+     *
+     * @param[in] parent - the parent node in the BMC's entity association
+     *                     tree
+     * @param[in/out] entity - the entity, its instance number is set
+     * @param[in] instance - instance number of the entity, 0xFFFF for the
+     *                       next one
+     *
+     * @return platformHandler->addBmcEntity() - returns the node in the
+     *             BMC's tree, nullptr if the entity is there already
+     */
+    virtual pldm_entity_node* addBmcEntity(pldm_entity_node* parent,
+                                           pldm_entity& entity,
+                                           uint16_t instance)
+    {
+        return platformHandler->addBmcEntity(parent, entity, instance);
+    }
+
     /** @brief Method to Generate the OEM PDRs
      *
      * @param[in] repo - instance of concrete implementation of Repo
@@ -388,8 +371,8 @@ class Handler : public oem_platform::Handler
     sdeventplus::Event& event;
 
   private:
-    /**@ brief system type/model */
-    std::string systemType;
+    /** @brief Cache of the BMC state, system type and watchdog state */
+    DbusStateCache stateCache;
 
     /** @brief D-Bus property changed signal match for CurrentPowerState*/
     std::unique_ptr<sdbusplus::bus::match::match> chassisOffMatch;
@@ -405,8 +388,6 @@ class Handler : public oem_platform::Handler
     /** @brief D-Bus property changed signal match */
     std::unique_ptr<sdbusplus::bus::match::match> hostOffMatch;
     std::unique_ptr<sdbusplus::bus::match::match> updateBIOSMatch;
-    /** @brief D-Bus Interfaced added signal match for Entity Manager */
-    std::unique_ptr<sdbusplus::bus::match::match> ibmCompatibleMatch;
 
     /** @brief D-Bus property Changed Signal match for bootProgress*/
     std::unique_ptr<sdbusplus::bus::match::match> bootProgressMatch;
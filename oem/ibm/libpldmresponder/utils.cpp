@@ -36,7 +36,6 @@ static constexpr uint8_t clearLicStatus = 2;
 using InternalFailure =
     sdbusplus::xyz::openbmc_project::Common::Error::InternalFailure;
 
-using LicJsonObjMap = std::map<fs::path, nlohmann::json>;
 LicJsonObjMap licJsonMap;
 
 int setupUnixSocket(const std::string& socketInterface)
@@ -215,9 +214,24 @@ void clearLicenseStatus()
     }
 
     createOrUpdateLicenseDbusPaths(clearLicStatus);
+
+    // The licenses follow their cleared objects, so that they are published
+    // again when the host sends them
+    for (auto& [key, licJson] : licJsonMap)
+    {
+        licJson["Status"] = "Unknown";
+    }
 }
 
-int createOrUpdateLicenseDbusPaths(const uint8_t& flag)
+/** @brief Create or update the d-bus objects of a license
+ *
+ *  @param[in] key - object path of the license
+ *  @param[in] licJson - the license data
+ *  @param[in] flag - input flag, 1 : create and 2 : clear
+ */
+static void createOrUpdateLicenseDbusPath(const fs::path& key,
+                                          const Json& licJson,
+                                          const uint8_t& flag)
 {
     const Json empty{};
     std::string authTypeAsNoOfDev = "NumberOfDevice";
@@ -230,101 +244,124 @@ int createOrUpdateLicenseDbusPaths(const uint8_t& flag)
     sdbusplus::com::ibm::License::Entry::server::LicenseEntry::AuthorizationType
         licAuthType = sdbusplus::com::ibm::License::Entry::server::
             LicenseEntry::AuthorizationType::Device;
-    for (auto const& [key, licJson] : licJsonMap)
+    auto licName = licJson.value("Name", empty);
+
+    auto type = licJson.value("Type", empty);
+    if (type == "Trial")
     {
-        auto licName = licJson.value("Name", empty);
+        licType = sdbusplus::com::ibm::License::Entry::server::
+            LicenseEntry::Type::Trial;
+    }
+    else if (type == "Commercial")
+    {
+        licType = sdbusplus::com::ibm::License::Entry::server::
+            LicenseEntry::Type::Purchased;
+    }
+    else
+    {
+        licType = sdbusplus::com::ibm::License::Entry::server::
+            LicenseEntry::Type::Prototype;
+    }
 
-        auto type = licJson.value("Type", empty);
-        if (type == "Trial")
-        {
-            licType = sdbusplus::com::ibm::License::Entry::server::
-                LicenseEntry::Type::Trial;
-        }
-        else if (type == "Commercial")
-        {
-            licType = sdbusplus::com::ibm::License::Entry::server::
-                LicenseEntry::Type::Purchased;
-        }
-        else
-        {
-            licType = sdbusplus::com::ibm::License::Entry::server::
-                LicenseEntry::Type::Prototype;
-        }
+    auto authType = licJson.value("AuthType", empty);
+    if (authType == "NumberOfDevice")
+    {
+        licAuthType = sdbusplus::com::ibm::License::Entry::server::
+            LicenseEntry::AuthorizationType::Capacity;
+    }
+    else if (authType == "Unlimited")
+    {
+        licAuthType = sdbusplus::com::ibm::License::Entry::server::
+            LicenseEntry::AuthorizationType::Unlimited;
+    }
+    else
+    {
+        licAuthType = sdbusplus::com::ibm::License::Entry::server::
+            LicenseEntry::AuthorizationType::Device;
+    }
 
-        auto authType = licJson.value("AuthType", empty);
-        if (authType == "NumberOfDevice")
-        {
-            licAuthType = sdbusplus::com::ibm::License::Entry::server::
-                LicenseEntry::AuthorizationType::Capacity;
-        }
-        else if (authType == "Unlimited")
-        {
-            licAuthType = sdbusplus::com::ibm::License::Entry::server::
-                LicenseEntry::AuthorizationType::Unlimited;
-        }
-        else
-        {
-            licAuthType = sdbusplus::com::ibm::License::Entry::server::
-                LicenseEntry::AuthorizationType::Device;
-        }
+    uint32_t licAuthDevNo = 0;
+    if (authType == authTypeAsNoOfDev)
+    {
+        licAuthDevNo = licJson.value("AuthDeviceNumber", 0);
+    }
 
-        uint32_t licAuthDevNo = 0;
-        if (authType == authTypeAsNoOfDev)
-        {
-            licAuthDevNo = licJson.value("AuthDeviceNumber", 0);
-        }
+    auto licSerialNo = licJson.value("SerialNum", "");
 
-        auto licSerialNo = licJson.value("SerialNum", "");
+    auto expTime = licJson.value("ExpirationTime", "");
+    if (!expTime.empty())
+    {
+        memset(&tm, 0, sizeof(tm));
+        strptime(expTime.c_str(), "%Y-%m-%dT%H:%M:%SZ", &tm);
+        licTimeSinceEpoch = mktime(&tm);
+    }
 
-        auto expTime = licJson.value("ExpirationTime", "");
-        if (!expTime.empty())
-        {
-            memset(&tm, 0, sizeof(tm));
-            strptime(expTime.c_str(), "%Y-%m-%dT%H:%M:%SZ", &tm);
-            licTimeSinceEpoch = mktime(&tm);
-        }
+    CustomDBus::getCustomDBus().implementLicInterfaces(
+        key, licAuthDevNo, licName, licSerialNo, licTimeSinceEpoch, licType,
+        licAuthType);
 
-        CustomDBus::getCustomDBus().implementLicInterfaces(
-            key, licAuthDevNo, licName, licSerialNo, licTimeSinceEpoch, licType,
-            licAuthType);
+    auto status = licJson.value("Status", empty);
 
-        auto status = licJson.value("Status", empty);
+    // License status is a single entry which needs to be mapped to
+    // OperationalStatus and Availability dbus interfaces
+    auto licOpStatus = false;
+    auto licAvailState = false;
+    if ((flag == clearLicStatus) || (status == "Unknown"))
+    {
+        licOpStatus = false;
+        licAvailState = false;
+    }
+    else if (status == "Enabled")
+    {
+        licOpStatus = true;
+        licAvailState = true;
+    }
+    else if (status == "Disabled")
+    {
+        licOpStatus = false;
+        licAvailState = true;
+    }
 
-        // License status is a single entry which needs to be mapped to
-        // OperationalStatus and Availability dbus interfaces
-        auto licOpStatus = false;
-        auto licAvailState = false;
-        if ((flag == clearLicStatus) || (status == "Unknown"))
-        {
-            licOpStatus = false;
-            licAvailState = false;
-        }
-        else if (status == "Enabled")
-        {
-            licOpStatus = true;
-            licAvailState = true;
-        }
-        else if (status == "Disabled")
-        {
-            licOpStatus = false;
-            licAvailState = true;
-        }
+    CustomDBus::getCustomDBus().setOperationalStatus(key, licOpStatus, "");
+    CustomDBus::getCustomDBus().setAvailabilityState(key, licAvailState);
+}
 
-        CustomDBus::getCustomDBus().setOperationalStatus(key, licOpStatus, "");
-        CustomDBus::getCustomDBus().setAvailabilityState(key, licAvailState);
+int createOrUpdateLicenseDbusPaths(const uint8_t& flag)
+{
+    for (auto const& [key, licJson] : licJsonMap)
+    {
+        createOrUpdateLicenseDbusPath(key, licJson, flag);
     }
 
     return PLDM_SUCCESS;
 }
 
-int createOrUpdateLicenseObjs()
+std::vector<fs::path> mergeLicenses(const Json& data, LicJsonObjMap& licenses)
 {
-    bool l_curFilePresent = true;
     const Json empty{};
     const std::vector<Json> emptyList{};
-    std::ifstream jsonFileCurrent;
+    fs::path path{licEntryPath};
+    std::vector<fs::path> changed;
+
+    for (const auto& entry : data.value("Licenses", emptyList))
+    {
+        auto licId = entry.value("Id", empty);
+        fs::path l_path = path / licId;
+        auto [it, added] = licenses.try_emplace(l_path, entry);
+        if (!added && it->second == entry)
+        {
+            continue;
+        }
+        it->second = entry;
+        changed.emplace_back(l_path);
+    }
+    return changed;
+}
+
+int createOrUpdateLicenseObjs(const Json& dataNew)
+{
+    bool l_curFilePresent = true;
     Json dataCurrent;
-    Json entries;
 
     if (!fs::exists(curLicFilePath))
     {
@@ -334,49 +371,36 @@ int createOrUpdateLicenseObjs()
     if (l_curFilePresent == true)
     {
         dataCurrent = convertBinFileToJson(curLicFilePath);
-    }
-
-    auto dataNew = convertBinFileToJson(newLicFilePath);
-
-    if (l_curFilePresent == true)
-    {
         dataCurrent.merge_patch(dataNew);
         convertJsonToBinaryFile(dataCurrent, curLicFilePath);
-        entries = dataCurrent.value("Licenses", emptyList);
     }
     else
     {
         convertJsonToBinaryFile(dataNew, curLicFilePath);
-        entries = dataNew.value("Licenses", emptyList);
     }
 
-    fs::path path{licEntryPath};
-
-    for (const auto& entry : entries)
+    // Only the objects of the licenses added or changed are updated
+    for (const auto& l_path :
+         mergeLicenses(l_curFilePresent ? dataCurrent : dataNew, licJsonMap))
     {
-        auto licId = entry.value("Id", empty);
-        fs::path l_path = path / licId;
-        licJsonMap.emplace(l_path, entry);
+        createOrUpdateLicenseDbusPath(l_path, licJsonMap.at(l_path),
+                                      createLic);
     }
 
-    int rc = createOrUpdateLicenseDbusPaths(createLic);
-    if (rc == PLDM_SUCCESS)
-    {
-        fs::copy_file(newLicFilePath, curLicFilePath,
-                      fs::copy_options::overwrite_existing);
+    fs::copy_file(newLicFilePath, curLicFilePath,
+                  fs::copy_options::overwrite_existing);
 
-        if (fs::exists(newLicFilePath))
-        {
-            fs::remove_all(newLicFilePath);
-        }
+    if (fs::exists(newLicFilePath))
+    {
+        fs::remove_all(newLicFilePath);
+    }
 
-        if (fs::exists(newLicJsonFilePath))
-        {
-            fs::remove_all(newLicJsonFilePath);
-        }
+    if (fs::exists(newLicJsonFilePath))
+    {
+        fs::remove_all(newLicJsonFilePath);
     }
 
-    return rc;
+    return PLDM_SUCCESS;
 }
 
 bool checkIfIBMCableCard(const std::string& objPath)
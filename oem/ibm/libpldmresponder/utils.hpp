@@ -3,6 +3,7 @@
 #include <nlohmann/json.hpp>
 
 #include <filesystem>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -14,6 +15,7 @@ namespace utils
 {
 namespace fs = std::filesystem;
 using Json = nlohmann::json;
+using LicJsonObjMap = std::map<fs::path, Json>;
 
 /** @brief Setup UNIX socket
  *  This function creates listening socket in non-blocking mode and allows only
@@ -83,14 +85,27 @@ void clearLicenseStatus();
  */
 int createOrUpdateLicenseDbusPaths(const uint8_t& flag);
 
+/** @brief Merge the licenses of the license data into a license map
+ *  This function adds the licenses that are new to the map and replaces the
+ *  ones that changed, the other licenses are left as they are.
+ *
+ *  @param[in] data - the license data
+ *  @param[in/out] licenses - the licenses, keyed by D-Bus object path
+ *
+ *  @return   the object paths of the licenses added or changed
+ */
+std::vector<fs::path> mergeLicenses(const Json& data, LicJsonObjMap& licenses);
+
 /** @brief Create or update the license bjects
  *  This function creates or updates the license objects as per the data passed
  *  from host.
  *
+ *  @param[in] dataNew - the license data passed from host
+ *
  *  @return   on success returns PLDM_SUCCESS
  *            on failure returns -1
  */
-int createOrUpdateLicenseObjs();
+int createOrUpdateLicenseObjs(const Json& dataNew);
 
 /** @brief checks if a pcie adapter is IBM specific
  *         cable card
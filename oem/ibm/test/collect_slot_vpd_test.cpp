@@ -0,0 +1,252 @@
+#include "libpldm/entity.h"
+#include "libpldm/pdr.h"
+#include "libpldm/platform.h"
+#include "oem/ibm/libpldm/state_set_oem_ibm.h"
+
+#include "oem/ibm/libpldmresponder/collect_slot_vpd.hpp"
+
+#include <sdeventplus/event.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::responder;
+using namespace std::chrono;
+
+static constexpr uint16_t slotContainerId = 1;
+static constexpr uint16_t effecterIdBase = 0x100;
+static constexpr uint16_t sensorIdBase = 0x200;
+
+/** @brief SlotHandler talking to a fake VPD manager */
+class FakeVPDSlotHandler : public SlotHandler
+{
+  public:
+    FakeVPDSlotHandler(const sdeventplus::Event& event, pldm_pdr* repo,
+                       milliseconds timeout, size_t slots) :
+        SlotHandler(event, repo, timeout),
+        slots(slots)
+    {}
+
+    using SlotHandler::addAdapter;
+    using SlotHandler::completeVPDCall;
+    using SlotHandler::processPropertyChangeFromVPD;
+    using SlotHandler::removeAdapter;
+
+    static std::string slotPath(size_t slot)
+    {
+        return "/xyz/openbmc_project/inventory/system/chassis/motherboard/"
+               "pcieslot" +
+               std::to_string(slot);
+    }
+
+    static std::string adapterPath(size_t slot)
+    {
+        return slotPath(slot) + "/pcie_card" + std::to_string(slot);
+    }
+
+    std::vector<std::pair<std::string, uint8_t>> vpdCalls;
+    std::vector<std::pair<uint16_t, uint8_t>> sensorEvents;
+    size_t adapterLookups = 0;
+
+  protected:
+    void callVPDManager(const std::string& adapterObjPath,
+                        uint8_t stateFieldValue) override
+    {
+        vpdCalls.emplace_back(adapterObjPath, stateFieldValue);
+    }
+
+    std::vector<std::string> getAdapterObjPaths() override
+    {
+        ++adapterLookups;
+        std::vector<std::string> paths;
+        for (size_t slot = 0; slot < slots; ++slot)
+        {
+            paths.emplace_back(adapterPath(slot));
+        }
+        return paths;
+    }
+
+    void sendStateSensorEvent(uint16_t sensorId,
+                              enum sensor_event_class_states /*eventClass*/,
+                              uint8_t /*sensorOffset*/, uint8_t eventState,
+                              uint8_t /*prevEventState*/) override
+    {
+        sensorEvents.emplace_back(sensorId, eventState);
+    }
+
+  private:
+    size_t slots;
+};
+
+class SlotHandlerTest : public testing::Test
+{
+  protected:
+    static constexpr size_t slots = 48;
+
+    SlotHandlerTest() :
+        event(sdeventplus::Event::get_default()), repo(pldm_pdr_init())
+    {
+        for (uint16_t slot = 0; slot < slots; ++slot)
+        {
+            addSlotPDRs(slot);
+            fruAssociationMap.emplace(
+                FakeVPDSlotHandler::slotPath(slot),
+                pldm_entity{PLDM_ENTITY_SLOT, slot, slotContainerId});
+        }
+    }
+
+    ~SlotHandlerTest()
+    {
+        pldm_pdr_destroy(repo);
+    }
+
+    void addSlotPDRs(uint16_t slot)
+    {
+        std::vector<uint8_t> effecter(
+            sizeof(pldm_state_effecter_pdr) - sizeof(uint8_t) +
+            sizeof(state_effecter_possible_states));
+        auto effecterPdr =
+            reinterpret_cast<pldm_state_effecter_pdr*>(effecter.data());
+        effecterPdr->hdr.type = PLDM_STATE_EFFECTER_PDR;
+        effecterPdr->effecter_id = effecterIdBase + slot;
+        effecterPdr->entity_type = PLDM_ENTITY_SLOT;
+        effecterPdr->entity_instance = slot;
+        effecterPdr->container_id = slotContainerId;
+        effecterPdr->composite_effecter_count = 1;
+        auto effecterStates = reinterpret_cast<state_effecter_possible_states*>(
+            effecterPdr->possible_states);
+        effecterStates->state_set_id = PLDM_OEM_IBM_SLOT_ENABLE_EFFECTER_STATE;
+        effecterStates->possible_states_size = 1;
+        pldm_pdr_add(repo, effecter.data(), effecter.size(), 0, false, 1);
+
+        std::vector<uint8_t> sensor(sizeof(pldm_state_sensor_pdr) -
+                                    sizeof(uint8_t) +
+                                    sizeof(state_sensor_possible_states));
+        auto sensorPdr =
+            reinterpret_cast<pldm_state_sensor_pdr*>(sensor.data());
+        sensorPdr->hdr.type = PLDM_STATE_SENSOR_PDR;
+        sensorPdr->sensor_id = sensorIdBase + slot;
+        sensorPdr->entity_type = PLDM_ENTITY_SLOT;
+        sensorPdr->entity_instance = slot;
+        sensorPdr->container_id = slotContainerId;
+        sensorPdr->composite_sensor_count = 1;
+        auto sensorStates = reinterpret_cast<state_sensor_possible_states*>(
+            sensorPdr->possible_states);
+        sensorStates->state_set_id = PLDM_OEM_IBM_SLOT_ENABLE_SENSOR_STATE;
+        sensorStates->possible_states_size = 1;
+        pldm_pdr_add(repo, sensor.data(), sensor.size(), 0, false, 1);
+    }
+
+    /** @brief Dispatch the events until there is none for the timeout */
+    void waitEventExpiry(milliseconds timeout)
+    {
+        auto sleepTime = duration_cast<microseconds>(timeout);
+        while (sd_event_run(event.get(), sleepTime.count()))
+        {}
+    }
+
+    sdeventplus::Event event;
+    pldm_pdr* repo;
+    AssociatedEntityMap fruAssociationMap;
+};
+
+TEST_F(SlotHandlerTest, ConcurrentSlotOperations)
+{
+    FakeVPDSlotHandler handler(event, repo, seconds(60), slots);
+
+    for (uint16_t slot = 0; slot < slots; ++slot)
+    {
+        handler.enableSlot(effecterIdBase + slot, fruAssociationMap,
+                           slot % 2 ? uint8_t(REMOVE) : uint8_t(ADD));
+    }
+    EXPECT_EQ(handler.getOperationsInProgress(), slots);
+    EXPECT_EQ(handler.adapterLookups, 1);
+    ASSERT_EQ(handler.vpdCalls.size(), slots);
+    for (uint16_t slot = 0; slot < slots; ++slot)
+    {
+        EXPECT_EQ(handler.vpdCalls[slot].first,
+                  FakeVPDSlotHandler::adapterPath(slot));
+    }
+
+    // The fake VPD manager completes the operations in reverse order
+    for (size_t slot = slots; slot-- > 0;)
+    {
+        handler.processPropertyChangeFromVPD(
+            !(slot % 2), FakeVPDSlotHandler::adapterPath(slot));
+    }
+    waitEventExpiry(milliseconds(10));
+
+    EXPECT_EQ(handler.getOperationsInProgress(), 0);
+    ASSERT_EQ(handler.sensorEvents.size(), slots);
+    for (size_t i = 0; i < slots; ++i)
+    {
+        auto slot = slots - 1 - i;
+        EXPECT_EQ(handler.sensorEvents[i].first, sensorIdBase + slot);
+        EXPECT_EQ(handler.sensorEvents[i].second,
+                  slot % 2 ? uint8_t(SLOT_STATE_DISABLED)
+                           : uint8_t(SLOT_STATE_ENABLED));
+    }
+
+    // Late property changes are not reported again
+    handler.processPropertyChangeFromVPD(true,
+                                         FakeVPDSlotHandler::adapterPath(0));
+    EXPECT_EQ(handler.sensorEvents.size(), slots);
+}
+
+TEST_F(SlotHandlerTest, PerOperationTimeout)
+{
+    FakeVPDSlotHandler handler(event, repo, milliseconds(50), slots);
+
+    for (uint16_t slot = 0; slot < slots; ++slot)
+    {
+        handler.enableSlot(effecterIdBase + slot, fruAssociationMap,
+                           uint8_t(ADD));
+    }
+    // The VPD manager answers the even slots only, one fails the call
+    for (size_t slot = 2; slot < slots; slot += 2)
+    {
+        handler.processPropertyChangeFromVPD(
+            true, FakeVPDSlotHandler::adapterPath(slot));
+    }
+    handler.completeVPDCall(FakeVPDSlotHandler::adapterPath(0), false);
+    EXPECT_EQ(handler.getOperationsInProgress(), slots / 2);
+
+    waitEventExpiry(milliseconds(200));
+
+    EXPECT_EQ(handler.getOperationsInProgress(), 0);
+    ASSERT_EQ(handler.sensorEvents.size(), slots);
+    std::map<uint16_t, uint8_t> states(handler.sensorEvents.begin(),
+                                       handler.sensorEvents.end());
+    ASSERT_EQ(states.size(), slots);
+    for (uint16_t slot = 0; slot < slots; ++slot)
+    {
+        EXPECT_EQ(states[sensorIdBase + slot],
+                  slot % 2 || slot == 0 ? uint8_t(SLOT_STATE_ERROR)
+                                        : uint8_t(SLOT_STATE_ENABLED));
+    }
+}
+
+TEST_F(SlotHandlerTest, AdapterMapUpdates)
+{
+    FakeVPDSlotHandler handler(event, repo, seconds(60), slots);
+    EXPECT_EQ(handler.fetchSlotSensorState(FakeVPDSlotHandler::slotPath(0)),
+              uint8_t(SLOT_STATE_DISABLED));
+
+    handler.removeAdapter(FakeVPDSlotHandler::adapterPath(3));
+    handler.enableSlot(effecterIdBase + 3, fruAssociationMap, uint8_t(ADD));
+    EXPECT_EQ(handler.getOperationsInProgress(), 0);
+    EXPECT_TRUE(handler.vpdCalls.empty());
+
+    auto newAdapter = FakeVPDSlotHandler::slotPath(3) + "/pcie_card_new";
+    handler.addAdapter(newAdapter);
+    handler.enableSlot(effecterIdBase + 3, fruAssociationMap, uint8_t(ADD));
+    EXPECT_EQ(handler.getOperationsInProgress(), 1);
+    ASSERT_EQ(handler.vpdCalls.size(), 1);
+    EXPECT_EQ(handler.vpdCalls[0].first, newAdapter);
+
+    // The inventory is only looked up once
+    EXPECT_EQ(handler.adapterLookups, 1);
+}
@@ -1,13 +1,16 @@
 #include "libpldm/base.h"
 #include "libpldm/file_io.h"
 
+#include "common/test/mocked_utils.hpp"
 #include "libpldmresponder/file_io.hpp"
 #include "libpldmresponder/file_io_by_type.hpp"
 #include "libpldmresponder/file_io_type_cert.hpp"
 #include "libpldmresponder/file_io_type_dump.hpp"
+#include "libpldmresponder/file_io_type_lic.hpp"
 #include "libpldmresponder/file_io_type_lid.hpp"
 #include "libpldmresponder/file_io_type_pel.hpp"
 #include "libpldmresponder/file_table.hpp"
+#include "libpldmresponder/utils.hpp"
 #include "xyz/openbmc_project/Common/error.hpp"
 
 #include <nlohmann/json.hpp>
@@ -987,3 +990,405 @@ TEST(readFileByType, testReadFile)
     ASSERT_EQ(response.size(), in.size());
     ASSERT_EQ(std::equal(in.begin(), in.end(), response.begin()), true);
 }
+
+/** @brief Build a license bundle of about the given size */
+static std::string licenseBundle(size_t size)
+{
+    auto licenses = Json::array();
+    size_t length = 0;
+    for (size_t i = 0; length < size; ++i)
+    {
+        Json license{{"Id", "lic" + std::to_string(i)},
+                     {"Name", "License " + std::to_string(i)},
+                     {"Type", "Commercial"},
+                     {"AuthType", "NumberOfDevice"},
+                     {"AuthDeviceNumber", i},
+                     {"SerialNum", std::string(32, 'a' + i % 26)},
+                     {"ExpirationTime", "2030-01-01T00:00:00Z"},
+                     {"Status", "Enabled"}};
+        length += license.dump().size() + 1;
+        licenses.push_back(std::move(license));
+    }
+    return Json{{"Licenses", licenses}}.dump();
+}
+
+TEST(LicenseBuffer, multiMegabyteBundleInChunks)
+{
+    auto bundle = licenseBundle(4 * 1024 * 1024);
+    auto numLicenses = Json::parse(bundle)["Licenses"].size();
+
+    LicenseBuffer buffer;
+    buffer.start(bundle.size());
+    constexpr size_t chunkSize = 1024;
+    for (size_t offset = 0; offset < bundle.size(); offset += chunkSize)
+    {
+        ASSERT_FALSE(buffer.complete());
+        buffer.append(bundle.data() + offset,
+                      std::min(chunkSize, bundle.size() - offset));
+    }
+    ASSERT_TRUE(buffer.complete());
+
+    auto licJson = buffer.take();
+    ASSERT_FALSE(licJson.is_discarded());
+    EXPECT_EQ(licJson["Licenses"].size(), numLicenses);
+    EXPECT_EQ(buffer.size(), 0);
+}
+
+TEST(LicenseBuffer, unannouncedLength)
+{
+    auto bundle = licenseBundle(64 * 1024);
+
+    // Chunks ending with the end of a nested object don't complete it
+    LicenseBuffer buffer;
+    size_t offset = 0;
+    size_t partialObjects = 0;
+    while (offset < bundle.size())
+    {
+        ASSERT_FALSE(buffer.complete());
+        auto end = bundle.find('}', offset);
+        auto length = std::min(bundle.size(), end + 1) - offset;
+        buffer.append(bundle.data() + offset, length);
+        offset += length;
+        partialObjects += offset < bundle.size();
+    }
+    EXPECT_GT(partialObjects, 0);
+    ASSERT_TRUE(buffer.complete());
+    EXPECT_FALSE(buffer.take().is_discarded());
+
+    // Braces in strings don't count, the first chunk ends with an escape
+    std::string braces = "{\"Licenses\": [{\"Name\": \"}]}\\\"}\"}]}";
+    buffer.append(braces.data(), braces.find(']') + 3);
+    EXPECT_FALSE(buffer.complete());
+    buffer.append(braces.data() + braces.find(']') + 3,
+                  braces.size() - braces.find(']') - 3);
+    ASSERT_TRUE(buffer.complete());
+    EXPECT_EQ(buffer.take()["Licenses"][0]["Name"], "}]}\"}");
+
+    // Invalid data is discarded
+    buffer.append("{\"Licenses\": [}", 15);
+    EXPECT_FALSE(buffer.complete());
+    buffer.start(15);
+    buffer.append("{\"Licenses\": [}", 15);
+    ASSERT_TRUE(buffer.complete());
+    EXPECT_TRUE(buffer.take().is_discarded());
+}
+
+/** @class TestLicenseHandler
+ *
+ *  A license handler that transfers the data from the test's memory rather
+ *  than the host's, and keeps the license objects in a map rather than on
+ *  D-Bus
+ */
+class TestLicenseHandler : public LicenseHandler
+{
+  public:
+    TestLicenseHandler(const fs::path& licDir,
+                       pldm::responder::utils::LicJsonObjMap& licenses,
+                       std::vector<fs::path>& updated, size_t& numParsed) :
+        LicenseHandler(0, PLDM_FILE_TYPE_COD_LICENSED_RESOURCES, licDir),
+        licenses(licenses), updated(updated), numParsed(numParsed)
+    {}
+
+    int transferFileData(const fs::path& path, bool /*upstream*/,
+                         uint32_t offset, uint32_t& length,
+                         uint64_t address) override
+    {
+        std::fstream file(path,
+                          std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char*>(address), length);
+        return file ? PLDM_SUCCESS : PLDM_ERROR;
+    }
+
+    int updateBinFileAndLicObjs(const Json& licJson) override
+    {
+        ++numParsed;
+        auto changed =
+            pldm::responder::utils::mergeLicenses(licJson, licenses);
+        updated.insert(updated.end(), changed.begin(), changed.end());
+        return PLDM_SUCCESS;
+    }
+
+  private:
+    pldm::responder::utils::LicJsonObjMap& licenses;
+    std::vector<fs::path>& updated;
+    size_t& numParsed;
+};
+
+/** @class LicenseTransferTest
+ *
+ *  License transfers, a new handler is created for each command like the
+ *  file I/O responder does
+ */
+class LicenseTransferTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        char tmplic[] = "/tmp/pldm_license.XXXXXX";
+        dir = fs::path(mkdtemp(tmplic));
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(dir);
+    }
+
+    TestLicenseHandler handler()
+    {
+        return TestLicenseHandler(dir, licenses, updated, numParsed);
+    }
+
+    /** @brief Send a license with WriteFileByType, in chunks */
+    void write(const std::string& bundle, size_t chunkSize)
+    {
+        ASSERT_EQ(handler().newFileAvailable(bundle.size()), PLDM_SUCCESS);
+        for (size_t offset = 0; offset < bundle.size(); offset += chunkSize)
+        {
+            uint32_t length = std::min(chunkSize, bundle.size() - offset);
+            ASSERT_EQ(handler().write(bundle.data() + offset, offset, length,
+                                      nullptr),
+                      PLDM_SUCCESS);
+        }
+    }
+
+    /** @brief Send a license with WriteFileByTypeFromMemory, in chunks */
+    void writeFromMemory(const std::string& bundle, size_t chunkSize)
+    {
+        ASSERT_EQ(handler().newFileAvailable(bundle.size()), PLDM_SUCCESS);
+        for (size_t offset = 0; offset < bundle.size(); offset += chunkSize)
+        {
+            uint32_t length = std::min(chunkSize, bundle.size() - offset);
+            ASSERT_EQ(handler().writeFromMemory(
+                          offset, length,
+                          reinterpret_cast<uint64_t>(bundle.data() + offset),
+                          nullptr),
+                      PLDM_SUCCESS);
+        }
+    }
+
+    fs::path dir;
+    pldm::responder::utils::LicJsonObjMap licenses;
+    std::vector<fs::path> updated; //!< objects updated, in order
+    size_t numParsed = 0;          //!< licenses parsed
+};
+
+TEST_F(LicenseTransferTest, writeInChunks)
+{
+    auto bundle = licenseBundle(1024 * 1024);
+    auto numLicenses = Json::parse(bundle)["Licenses"].size();
+
+    write(bundle, 4096);
+    EXPECT_EQ(numParsed, 1);
+    EXPECT_EQ(licenses.size(), numLicenses);
+    EXPECT_EQ(updated.size(), numLicenses);
+
+    // The same licenses again, nothing to update
+    updated.clear();
+    write(bundle, 4096);
+    EXPECT_EQ(numParsed, 2);
+    EXPECT_TRUE(updated.empty());
+}
+
+TEST_F(LicenseTransferTest, writeFromMemoryInChunks)
+{
+    auto bundle = licenseBundle(256 * 1024);
+    auto numLicenses = Json::parse(bundle)["Licenses"].size();
+
+    writeFromMemory(bundle, 4096);
+    EXPECT_EQ(numParsed, 1);
+    EXPECT_EQ(licenses.size(), numLicenses);
+
+    // One license changes, only its object is updated
+    auto licJson = Json::parse(bundle);
+    licJson["Licenses"][3]["Status"] = "Disabled";
+    updated.clear();
+    writeFromMemory(licJson.dump(), 4096);
+    EXPECT_EQ(numParsed, 2);
+    ASSERT_EQ(updated.size(), 1);
+    EXPECT_EQ(updated[0].filename(), "lic3");
+    EXPECT_EQ(licenses.at(updated[0])["Status"], "Disabled");
+}
+
+TEST_F(LicenseTransferTest, tooLong)
+{
+    EXPECT_EQ(handler().newFileAvailable(maxLicenseLength + 1),
+              PLDM_ERROR_INVALID_LENGTH);
+    EXPECT_EQ(handler().newFileAvailable(UINT64_MAX),
+              PLDM_ERROR_INVALID_LENGTH);
+
+    // Without an announced length, the data received is limited as well
+    std::string chunk(1024 * 1024, ' ');
+    chunk[0] = '{';
+    uint32_t length = chunk.size();
+    for (size_t size = 0; size < maxLicenseLength; size += chunk.size())
+    {
+        length = chunk.size();
+        ASSERT_EQ(handler().write(chunk.data(), 0, length, nullptr),
+                  PLDM_SUCCESS);
+        chunk[0] = ' ';
+    }
+    length = chunk.size();
+    EXPECT_EQ(handler().write(chunk.data(), 0, length, nullptr),
+              PLDM_ERROR_INVALID_LENGTH);
+
+    EXPECT_EQ(handler().writeFromMemory(maxLicenseLength - 10, 11,
+                                        reinterpret_cast<uint64_t>(
+                                            chunk.data()),
+                                        nullptr),
+              PLDM_ERROR_INVALID_LENGTH);
+    EXPECT_EQ(numParsed, 0);
+}
+
+/** @class CertTransferTest
+ *
+ *  Certificate transfers with a fake certificate manager, a new handler is
+ *  created for each command like the file I/O responder does
+ */
+class CertTransferTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        char tmpcerts[] = "/tmp/pldm_certs.XXXXXX";
+        dir = fs::path(mkdtemp(tmpcerts));
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(dir);
+    }
+
+    /** @brief Expect a signed certificate to be published once */
+    void expectPublished(uint32_t fileHandle, const std::string& cert)
+    {
+        auto objPath =
+            "/xyz/openbmc_project/certs/ca/entry/" + std::to_string(fileHandle);
+        DBusMapping certMapping{objPath, "xyz.openbmc_project.Certs.Entry",
+                                "ClientCertificate", "string"};
+        DBusMapping statusMapping{objPath, "xyz.openbmc_project.Certs.Entry",
+                                  "Status", "string"};
+        testing::InSequence seq;
+        EXPECT_CALL(certsManager,
+                    setDbusProperty(certMapping, PropertyValue{cert}))
+            .Times(1);
+        EXPECT_CALL(
+            certsManager,
+            setDbusProperty(statusMapping,
+                            PropertyValue{std::string{
+                                "xyz.openbmc_project.Certs.Entry.State."
+                                "Complete"}}))
+            .Times(1);
+    }
+
+    /** @brief Write a chunk of a signed certificate, the last chunk is cut
+     *         short
+     */
+    int writeChunk(uint32_t fileHandle, const std::string& cert,
+                   uint32_t offset, uint32_t chunkSize)
+    {
+        CertHandler handler(fileHandle, PLDM_FILE_TYPE_SIGNED_CERT,
+                            &certsManager, dir);
+        uint32_t length = std::min<size_t>(chunkSize, cert.size() - offset);
+        auto rc = handler.write(cert.data() + offset, offset, length, nullptr);
+        EXPECT_EQ(length, std::min<size_t>(chunkSize, cert.size() - offset));
+        return rc;
+    }
+
+    int newFileAvailable(uint32_t fileHandle, uint64_t length)
+    {
+        CertHandler handler(fileHandle, PLDM_FILE_TYPE_SIGNED_CERT,
+                            &certsManager, dir);
+        return handler.newFileAvailable(length);
+    }
+
+    fs::path dir;
+    MockdBusHandler certsManager;
+};
+
+TEST_F(CertTransferTest, publishedOnceWhenComplete)
+{
+    constexpr uint32_t fileHandle = 7;
+    std::string cert(8192, 'c');
+    for (size_t i = 0; i < cert.size(); ++i)
+    {
+        cert[i] = 'A' + i % 26;
+    }
+    expectPublished(fileHandle, cert);
+
+    ASSERT_EQ(newFileAvailable(fileHandle, cert.size()), PLDM_SUCCESS);
+    constexpr uint32_t chunkSize = 512;
+    for (uint32_t offset = 0; offset < cert.size(); offset += chunkSize)
+    {
+        ASSERT_EQ(writeChunk(fileHandle, cert, offset, chunkSize),
+                  PLDM_SUCCESS);
+    }
+    EXPECT_FALSE(
+        fs::exists(dir / ("ClientCert_" + std::to_string(fileHandle))));
+
+    // The transfer is over
+    EXPECT_EQ(writeChunk(fileHandle, cert, 0, chunkSize), PLDM_ERROR);
+}
+
+TEST_F(CertTransferTest, overlappingTransfers)
+{
+    constexpr size_t numCerts = 4;
+    constexpr uint32_t chunkSize = 100;
+    std::vector<std::string> certs;
+    for (size_t i = 0; i < numCerts; ++i)
+    {
+        certs.emplace_back(1000 + 250 * i, 'a' + i);
+        expectPublished(i, certs.back());
+        ASSERT_EQ(newFileAvailable(i, certs.back().size()), PLDM_SUCCESS);
+    }
+
+    // The chunks of the certificates are interleaved, the chunks of the odd
+    // ones are written from the end
+    bool written = true;
+    for (uint32_t chunk = 0; written; ++chunk)
+    {
+        written = false;
+        for (size_t i = 0; i < numCerts; ++i)
+        {
+            const auto& cert = certs[i];
+            auto numChunks = (cert.size() + chunkSize - 1) / chunkSize;
+            if (chunk >= numChunks)
+            {
+                continue;
+            }
+            auto offset = (i % 2 ? numChunks - 1 - chunk : chunk) * chunkSize;
+            ASSERT_EQ(writeChunk(i, cert, offset, chunkSize), PLDM_SUCCESS);
+            written = true;
+        }
+    }
+}
+
+TEST_F(CertTransferTest, oneRootCertTransfer)
+{
+    std::string first(1000, 'a');
+    std::string second(600, 'b');
+    auto rootCert = [this](uint32_t fileHandle) {
+        return CertHandler(fileHandle, PLDM_FILE_TYPE_ROOT_CERT,
+                           &certsManager, dir);
+    };
+
+    ASSERT_EQ(rootCert(1).newFileAvailable(first.size()), PLDM_SUCCESS);
+    uint32_t length = 500;
+    ASSERT_EQ(rootCert(1).write(first.data(), 0, length, nullptr),
+              PLDM_SUCCESS);
+
+    // The new transfer abandons the first one, which no longer writes to
+    // the file
+    ASSERT_EQ(rootCert(2).newFileAvailable(second.size()), PLDM_SUCCESS);
+    length = 500;
+    EXPECT_EQ(rootCert(1).write(first.data() + 500, 500, length, nullptr),
+              PLDM_ERROR);
+    length = second.size();
+    ASSERT_EQ(rootCert(2).write(second.data(), 0, length, nullptr),
+              PLDM_SUCCESS);
+
+    std::ifstream file(dir / "RootCert");
+    std::string written((std::istreambuf_iterator<char>(file)),
+                        std::istreambuf_iterator<char>());
+    EXPECT_EQ(written, second);
+}
@@ -404,3 +404,124 @@ TEST(generateStateSensorOEMPDR, testGoodRequest)
 
     pldm_pdr_destroy(inPDRRepo);
 }
+
+TEST(DbusStateCache, BMCStateReadOnce)
+{
+    using ::testing::Return;
+    using ::testing::StrEq;
+
+    MockdBusHandler mockDbusHandler;
+    EXPECT_CALL(mockDbusHandler,
+                getDbusPropertyVariant(StrEq(bmcStateObjectPath),
+                                       StrEq(bmcStateProperty),
+                                       StrEq(bmcStateInterface)))
+        .Times(1)
+        .WillOnce(Return(PropertyValue{std::string(
+            "xyz.openbmc_project.State.BMC.BMCState.Ready")}));
+
+    DbusStateCache stateCache(&mockDbusHandler);
+    // Every GetPDR checks the BMC state, only the first one goes to D-Bus
+    for (auto i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(stateCache.getBMCState(),
+                  "xyz.openbmc_project.State.BMC.BMCState.Ready");
+    }
+
+    // PropertiesChanged updates the cached value without a D-Bus call
+    stateCache.setBMCState(bmcStateNotReady);
+    ASSERT_EQ(stateCache.getBMCState(), bmcStateNotReady);
+}
+
+TEST(DbusStateCache, BMCStateRetriedOnFailure)
+{
+    using ::testing::_;
+    using ::testing::Return;
+    using ::testing::Throw;
+
+    MockdBusHandler mockDbusHandler;
+    EXPECT_CALL(mockDbusHandler, getDbusPropertyVariant(_, _, _))
+        .Times(2)
+        .WillOnce(Throw(std::runtime_error("service not up")))
+        .WillOnce(Return(PropertyValue{std::string(bmcStateNotReady)}));
+
+    DbusStateCache stateCache(&mockDbusHandler);
+    ASSERT_EQ(stateCache.getBMCState(), std::nullopt);
+    ASSERT_EQ(stateCache.getBMCState(), bmcStateNotReady);
+    ASSERT_EQ(stateCache.getBMCState(), bmcStateNotReady);
+}
+
+TEST(DbusStateCache, WatchDogEnabledReadOnce)
+{
+    using ::testing::Return;
+    using ::testing::StrEq;
+
+    MockdBusHandler mockDbusHandler;
+    EXPECT_CALL(mockDbusHandler,
+                getDbusPropertyVariant(StrEq(watchDogObjectPath),
+                                       StrEq(watchDogEnabledProperty),
+                                       StrEq(watchDogInterface)))
+        .Times(1)
+        .WillOnce(Return(PropertyValue{true}));
+
+    DbusStateCache stateCache(&mockDbusHandler);
+    // Every heartbeat checks the watchdog, only the first one goes to D-Bus
+    for (auto i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(stateCache.isWatchDogEnabled());
+    }
+
+    stateCache.setWatchDogEnabled(false);
+    ASSERT_FALSE(stateCache.isWatchDogEnabled());
+}
+
+TEST(DbusStateCache, SystemTypeLookedUpOnce)
+{
+    using ::testing::_;
+    using ::testing::Return;
+
+    MockdBusHandler mockDbusHandler;
+    // Entity Manager has not published IBMCompatibleSystem yet
+    EXPECT_CALL(mockDbusHandler, getSubtree(_, _, _))
+        .Times(1)
+        .WillOnce(Return(MapperGetSubTreeResponse{}));
+
+    DbusStateCache stateCache(&mockDbusHandler);
+    for (auto i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(stateCache.getSystemType().empty());
+    }
+
+    // InterfacesAdded from Entity Manager delivers the system type
+    stateCache.setSystemType("rainier");
+    ASSERT_EQ(stateCache.getSystemType(), std::filesystem::path("rainier"));
+}
+
+TEST(DbusStateCache, OemHandlerUsesCache)
+{
+    using ::testing::_;
+    using ::testing::Return;
+
+    sdbusplus::bus::bus bus(sdbusplus::bus::new_default());
+    Requester requester(bus, "/abc/def");
+    auto event = sdeventplus::Event::get_default();
+
+    auto mockDbusHandler = std::make_unique<MockdBusHandler>();
+    EXPECT_CALL(*mockDbusHandler, getDbusPropertyVariant(_, _, _))
+        .Times(1)
+        .WillOnce(Return(PropertyValue{std::string(bmcStateNotReady)}));
+    EXPECT_CALL(*mockDbusHandler, getSubtree(_, _, _))
+        .Times(1)
+        .WillOnce(Return(MapperGetSubTreeResponse{}));
+
+    std::unique_ptr<CodeUpdate> mockCodeUpdate =
+        std::make_unique<MockCodeUpdate>(mockDbusHandler.get());
+    auto oemPlatformHandler = std::make_unique<oem_ibm_platform::Handler>(
+        mockDbusHandler.get(), mockCodeUpdate.get(), nullptr, 0x1, 0x9,
+        requester, event, nullptr, nullptr, nullptr);
+
+    for (auto i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(oemPlatformHandler->checkBMCState(), PLDM_ERROR_NOT_READY);
+        ASSERT_TRUE(oemPlatformHandler->getConfigDir().empty());
+    }
+}
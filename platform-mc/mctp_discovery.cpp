@@ -0,0 +1,192 @@
+#include "mctp_discovery.hpp"
+
+#include "common/transport.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace pldm
+{
+
+namespace platform_mc
+{
+
+namespace
+{
+
+constexpr auto mctpPath = "/xyz/openbmc_project/mctp";
+constexpr auto endpointIntf = "xyz.openbmc_project.MCTP.Endpoint";
+
+/** @brief Check if an endpoint supports PLDM */
+bool supportsPldm(const std::vector<uint8_t>& types)
+{
+    return std::find(types.begin(), types.end(),
+                     pldm::transport::MCTP_MSG_TYPE_PLDM) != types.end();
+}
+
+} // namespace
+
+MctpEndpoints
+    getMctpEndpoints(const pldm::utils::DBusHandlerInterface& dBusIntf)
+{
+    MctpEndpoints endpoints;
+    pldm::utils::MapperGetSubTreeResponse subtree;
+    try
+    {
+        subtree = dBusIntf.getSubtree(mctpPath, 0, {endpointIntf});
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Failed to get the MCTP endpoints, ERROR=" << e.what()
+                  << "\n";
+        return endpoints;
+    }
+
+    for (const auto& [path, services] : subtree)
+    {
+        try
+        {
+            auto types = std::get<std::vector<uint8_t>>(
+                dBusIntf.getDbusPropertyVariant(
+                    path.c_str(), "SupportedMessageTypes", endpointIntf));
+            if (!supportsPldm(types))
+            {
+                continue;
+            }
+            endpoints.emplace(path,
+                              std::get<uint8_t>(dBusIntf.getDbusPropertyVariant(
+                                  path.c_str(), "EID", endpointIntf)));
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed to get the MCTP endpoint, PATH=" << path
+                      << " ERROR=" << e.what() << "\n";
+        }
+    }
+    return endpoints;
+}
+
+MctpDiscovery::MctpDiscovery(
+    const pldm::utils::DBusHandlerInterface& dBusIntf,
+    std::vector<mctp_eid_t> excluded, Callback added, Callback removed) :
+    excluded(std::move(excluded)),
+    added(std::move(added)), removed(std::move(removed))
+{
+    using namespace sdbusplus::bus::match::rules;
+
+    // Subscribed before the endpoints are looked up, so none are missed
+    auto& bus = pldm::utils::DBusHandler::getBus();
+    addedMatch = std::make_unique<sdbusplus::bus::match::match>(
+        bus, interfacesAdded() + argNpath(0, std::string(mctpPath) + "/"),
+        [this](sdbusplus::message::message& msg) {
+            sdbusplus::message::object_path path;
+            std::map<std::string, pldm::utils::DbusChangedProps> interfaces;
+            try
+            {
+                msg.read(path, interfaces);
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "Failed to read the MCTP endpoint added, ERROR="
+                          << e.what() << "\n";
+                return;
+            }
+            processInterfacesAdded(path, interfaces);
+        });
+    removedMatch = std::make_unique<sdbusplus::bus::match::match>(
+        bus, interfacesRemoved() + argNpath(0, std::string(mctpPath) + "/"),
+        [this](sdbusplus::message::message& msg) {
+            sdbusplus::message::object_path path;
+            std::vector<std::string> interfaces;
+            try
+            {
+                msg.read(path, interfaces);
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "Failed to read the MCTP endpoint removed, ERROR="
+                          << e.what() << "\n";
+                return;
+            }
+            processInterfacesRemoved(path, interfaces);
+        });
+
+    std::vector<mctp_eid_t> eids;
+    for (const auto& [path, eid] : getMctpEndpoints(dBusIntf))
+    {
+        if (isManaged(eid))
+        {
+            endpoints.emplace(path, eid);
+            eids.push_back(eid);
+        }
+    }
+    if (!eids.empty())
+    {
+        this->added(eids);
+    }
+}
+
+void MctpDiscovery::processInterfacesAdded(
+    const std::string& path,
+    const std::map<std::string, pldm::utils::DbusChangedProps>& interfaces)
+{
+    auto intf = interfaces.find(endpointIntf);
+    if (intf == interfaces.end())
+    {
+        return;
+    }
+
+    const auto& properties = intf->second;
+    auto types = properties.find("SupportedMessageTypes");
+    auto eid = properties.find("EID");
+    if (types == properties.end() || eid == properties.end() ||
+        !std::holds_alternative<std::vector<uint8_t>>(types->second) ||
+        !std::holds_alternative<uint8_t>(eid->second))
+    {
+        std::cerr << "Failed to get the MCTP endpoint, PATH=" << path << "\n";
+        return;
+    }
+    mctp_eid_t endpointEid = std::get<uint8_t>(eid->second);
+    if (!supportsPldm(std::get<std::vector<uint8_t>>(types->second)) ||
+        !isManaged(endpointEid))
+    {
+        return;
+    }
+
+    auto [it, inserted] = endpoints.emplace(path, endpointEid);
+    if (!inserted && it->second != endpointEid)
+    {
+        // The endpoint got a new EID
+        removed({it->second});
+        it->second = endpointEid;
+    }
+    added({endpointEid});
+}
+
+void MctpDiscovery::processInterfacesRemoved(
+    const std::string& path, const std::vector<std::string>& interfaces)
+{
+    if (std::find(interfaces.begin(), interfaces.end(), endpointIntf) ==
+        interfaces.end())
+    {
+        return;
+    }
+
+    auto it = endpoints.find(path);
+    if (it == endpoints.end())
+    {
+        return;
+    }
+    auto eid = it->second;
+    endpoints.erase(it);
+    removed({eid});
+}
+
+bool MctpDiscovery::isManaged(mctp_eid_t eid) const
+{
+    return std::find(excluded.begin(), excluded.end(), eid) == excluded.end();
+}
+
+} // namespace platform_mc
+
+} // namespace pldm
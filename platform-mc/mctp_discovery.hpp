@@ -0,0 +1,94 @@
+#pragma once
+
+#include "libpldm/requester/pldm.h"
+
+#include "common/utils.hpp"
+
+#include <sdbusplus/bus/match.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pldm
+{
+
+namespace platform_mc
+{
+
+/** @brief MCTP endpoints, their EIDs keyed by object path */
+using MctpEndpoints = std::map<std::string, mctp_eid_t>;
+
+/** @brief Get the MCTP endpoints that support PLDM
+ *
+ *  @param[in] dBusIntf - interface to the D-Bus
+ *
+ *  @return the endpoints
+ */
+MctpEndpoints
+    getMctpEndpoints(const pldm::utils::DBusHandlerInterface& dBusIntf);
+
+/** @class MctpDiscovery
+ *
+ *  Reports the MCTP endpoints that support PLDM, those on D-Bus at startup
+ *  and then those added and removed as the MCTP daemon finds and loses them.
+ */
+class MctpDiscovery
+{
+  public:
+    /** @brief Called with the EIDs of the endpoints added or removed */
+    using Callback = std::function<void(const std::vector<mctp_eid_t>&)>;
+
+    MctpDiscovery() = delete;
+    MctpDiscovery(const MctpDiscovery&) = delete;
+    MctpDiscovery& operator=(const MctpDiscovery&) = delete;
+    MctpDiscovery(MctpDiscovery&&) = delete;
+    MctpDiscovery& operator=(MctpDiscovery&&) = delete;
+    ~MctpDiscovery() = default;
+
+    /** @brief Constructor, the endpoints on D-Bus are reported as added
+     *
+     *  @param[in] dBusIntf - interface to the D-Bus
+     *  @param[in] excluded - EIDs of the endpoints not to report, those
+     *                        managed otherwise
+     *  @param[in] added - called with the endpoints added
+     *  @param[in] removed - called with the endpoints removed
+     */
+    MctpDiscovery(const pldm::utils::DBusHandlerInterface& dBusIntf,
+                  std::vector<mctp_eid_t> excluded, Callback added,
+                  Callback removed);
+
+    /** @brief Process the interfaces added to an object
+     *
+     *  @param[in] path - object path
+     *  @param[in] interfaces - the interfaces added and their properties
+     */
+    void processInterfacesAdded(
+        const std::string& path,
+        const std::map<std::string, pldm::utils::DbusChangedProps>& interfaces);
+
+    /** @brief Process the interfaces removed from an object
+     *
+     *  @param[in] path - object path
+     *  @param[in] interfaces - the interfaces removed
+     */
+    void processInterfacesRemoved(const std::string& path,
+                                  const std::vector<std::string>& interfaces);
+
+  private:
+    /** @brief Check if an endpoint is to be reported */
+    bool isManaged(mctp_eid_t eid) const;
+
+    std::vector<mctp_eid_t> excluded;
+    Callback added;
+    Callback removed;
+    MctpEndpoints endpoints; //!< the endpoints reported
+    std::unique_ptr<sdbusplus::bus::match::match> addedMatch;
+    std::unique_ptr<sdbusplus::bus::match::match> removedMatch;
+};
+
+} // namespace platform_mc
+
+} // namespace pldm
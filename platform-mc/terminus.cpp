@@ -0,0 +1,284 @@
+#include "terminus.hpp"
+
+#include <array>
+#include <iostream>
+
+namespace pldm
+{
+
+namespace platform_mc
+{
+
+Terminus::Terminus(mctp_eid_t eid, uint8_t eventReceiverEid) :
+    eid(eid), eventReceiverEid(eventReceiverEid),
+    pdrRepo(pldm_pdr_init(), pldm_pdr_destroy)
+{}
+
+std::optional<TerminusRequest> Terminus::nextRequest(uint8_t instanceId)
+{
+    TerminusRequest request{};
+    int rc = PLDM_SUCCESS;
+    switch (state)
+    {
+        case State::GetTID:
+            request = {PLDM_BASE, PLDM_GET_TID,
+                       pldm::Request(sizeof(pldm_msg_hdr))};
+            rc = encode_get_tid_req(
+                instanceId, reinterpret_cast<pldm_msg*>(request.msg.data()));
+            break;
+        case State::SetEventReceiver:
+            request = {PLDM_PLATFORM, PLDM_SET_EVENT_RECEIVER,
+                       pldm::Request(sizeof(pldm_msg_hdr) +
+                                     PLDM_SET_EVENT_RECEIVER_REQ_BYTES)};
+            rc = encode_set_event_receiver_req(
+                instanceId, PLDM_EVENT_MESSAGE_GLOBAL_DISABLE,
+                PLDM_TRANSPORT_PROTOCOL_TYPE_MCTP, eventReceiverEid, 0,
+                reinterpret_cast<pldm_msg*>(request.msg.data()));
+            break;
+        case State::SyncPDRs:
+            request = {PLDM_PLATFORM, PLDM_GET_PDR,
+                       pldm::Request(sizeof(pldm_msg_hdr) +
+                                     PLDM_GET_PDR_REQ_BYTES)};
+            rc = encode_get_pdr_req(
+                instanceId, recordHandle, dataTransferHandle, transferOpFlag,
+                UINT16_MAX, 0, reinterpret_cast<pldm_msg*>(request.msg.data()),
+                PLDM_GET_PDR_REQ_BYTES);
+            break;
+        case State::PollSensors:
+        {
+            request = {PLDM_PLATFORM, PLDM_GET_STATE_SENSOR_READINGS,
+                       pldm::Request(sizeof(pldm_msg_hdr) +
+                                     PLDM_GET_STATE_SENSOR_READINGS_REQ_BYTES)};
+            bitfield8_t rearm{};
+            rc = encode_get_state_sensor_readings_req(
+                instanceId, stateSensors[sensorIndex].sensorId, rearm, 0,
+                reinterpret_cast<pldm_msg*>(request.msg.data()));
+            break;
+        }
+        case State::Idle:
+            return std::nullopt;
+    }
+
+    if (rc != PLDM_SUCCESS)
+    {
+        std::cerr << "Failed to encode the request to the terminus, EID = "
+                  << (unsigned)eid << " RC = " << rc << "\n";
+        return std::nullopt;
+    }
+    return request;
+}
+
+void Terminus::processResponse(const pldm_msg* response, size_t respMsgLen)
+{
+    switch (state)
+    {
+        case State::GetTID:
+            processGetTID(response, respMsgLen);
+            break;
+        case State::SetEventReceiver:
+            processSetEventReceiver(response, respMsgLen);
+            break;
+        case State::SyncPDRs:
+            processGetPDR(response, respMsgLen);
+            break;
+        case State::PollSensors:
+            processSensorReading(response, respMsgLen);
+            break;
+        case State::Idle:
+            break;
+    }
+}
+
+void Terminus::sync()
+{
+    if (state == State::Idle)
+    {
+        startSync();
+    }
+    else if (state == State::PollSensors)
+    {
+        // The response to the sensor read in flight is to be processed first
+        syncPending = true;
+    }
+}
+
+void Terminus::startPolling()
+{
+    if (state != State::Idle)
+    {
+        return;
+    }
+    if (!pdrsSynced)
+    {
+        startSync();
+        return;
+    }
+    if (!stateSensors.empty())
+    {
+        sensorIndex = 0;
+        state = State::PollSensors;
+    }
+}
+
+void Terminus::processGetTID(const pldm_msg* response, size_t respMsgLen)
+{
+    uint8_t cc = 0;
+    if (response == nullptr || !respMsgLen ||
+        decode_get_tid_resp(response, respMsgLen, &cc, &tid) != PLDM_SUCCESS ||
+        cc != PLDM_SUCCESS)
+    {
+        // The terminus may still answer the platform commands
+        std::cerr << "Failed to get the TID of the terminus, EID = "
+                  << (unsigned)eid << "\n";
+    }
+    state = State::SetEventReceiver;
+}
+
+void Terminus::processSetEventReceiver(const pldm_msg* response,
+                                       size_t respMsgLen)
+{
+    uint8_t cc = 0;
+    if (response == nullptr || !respMsgLen ||
+        decode_set_event_receiver_resp(response, respMsgLen, &cc) !=
+            PLDM_SUCCESS ||
+        cc != PLDM_SUCCESS)
+    {
+        std::cerr << "Failed to set the event receiver of the terminus, EID = "
+                  << (unsigned)eid << "\n";
+    }
+    startSync();
+}
+
+void Terminus::startSync()
+{
+    pdrRepo.reset(pldm_pdr_init());
+    stateSensors.clear();
+    readings.clear();
+    syncPending = false;
+    recordHandle = 0;
+    dataTransferHandle = 0;
+    transferOpFlag = PLDM_GET_FIRSTPART;
+    record.clear();
+    pdrsSynced = false;
+    state = State::SyncPDRs;
+}
+
+void Terminus::processGetPDR(const pldm_msg* response, size_t respMsgLen)
+{
+    uint8_t cc = 0;
+    uint32_t nextRecordHandle = 0;
+    uint32_t nextDataTransferHandle = 0;
+    uint8_t transferFlag = 0;
+    uint16_t respCount = 0;
+    uint8_t transferCRC = 0;
+    int rc = PLDM_ERROR;
+    if (response != nullptr && respMsgLen)
+    {
+        rc = decode_get_pdr_resp(response, respMsgLen, &cc, &nextRecordHandle,
+                                 &nextDataTransferHandle, &transferFlag,
+                                 &respCount, nullptr, 0, &transferCRC);
+    }
+    if (rc != PLDM_SUCCESS || cc != PLDM_SUCCESS)
+    {
+        // Synced again at the next poll
+        std::cerr << "Failed to get the PDRs of the terminus, EID = "
+                  << (unsigned)eid << " RC = " << rc
+                  << " CC = " << (unsigned)cc << "\n";
+        state = State::Idle;
+        return;
+    }
+
+    auto offset = record.size();
+    record.resize(offset + respCount);
+    decode_get_pdr_resp(response, respMsgLen, &cc, &nextRecordHandle,
+                        &nextDataTransferHandle, &transferFlag, &respCount,
+                        record.data() + offset, respCount, &transferCRC);
+
+    if (transferFlag == PLDM_START || transferFlag == PLDM_MIDDLE)
+    {
+        // The rest of the record comes in the next parts
+        dataTransferHandle = nextDataTransferHandle;
+        transferOpFlag = PLDM_GET_NEXTPART;
+        return;
+    }
+
+    if (record.size() >= sizeof(pldm_pdr_hdr))
+    {
+        auto hdr = reinterpret_cast<const pldm_pdr_hdr*>(record.data());
+        pldm_pdr_add(pdrRepo.get(), record.data(), record.size(),
+                     hdr->record_handle, true, tid);
+    }
+    record.clear();
+    dataTransferHandle = 0;
+    transferOpFlag = PLDM_GET_FIRSTPART;
+    recordHandle = nextRecordHandle;
+    if (recordHandle)
+    {
+        return;
+    }
+
+    pdrsSynced = true;
+    parseStateSensors();
+    state = State::Idle;
+    startPolling();
+}
+
+void Terminus::parseStateSensors()
+{
+    uint8_t* data = nullptr;
+    uint32_t size = 0;
+    const pldm_pdr_record* pdrRecord = nullptr;
+    while ((pdrRecord = pldm_pdr_find_record_by_type(
+                pdrRepo.get(), PLDM_STATE_SENSOR_PDR, pdrRecord, &data,
+                &size)) != nullptr)
+    {
+        if (size < sizeof(pldm_state_sensor_pdr) - 1)
+        {
+            continue;
+        }
+        auto pdr = reinterpret_cast<const pldm_state_sensor_pdr*>(data);
+        stateSensors.push_back({pdr->sensor_id, pdr->composite_sensor_count});
+    }
+}
+
+void Terminus::processSensorReading(const pldm_msg* response,
+                                    size_t respMsgLen)
+{
+    const auto& sensor = stateSensors[sensorIndex];
+    uint8_t cc = 0;
+    uint8_t count = sensor.compositeCount;
+    std::array<get_sensor_state_field, 8> fields{};
+    if (response == nullptr || !respMsgLen || count > fields.size() ||
+        decode_get_state_sensor_readings_resp(response, respMsgLen, &cc,
+                                              &count, fields.data()) !=
+            PLDM_SUCCESS ||
+        cc != PLDM_SUCCESS)
+    {
+        std::cerr << "Failed to read the state sensor of the terminus, EID = "
+                  << (unsigned)eid << " SENSOR_ID = " << sensor.sensorId
+                  << "\n";
+        readings.erase(sensor.sensorId);
+    }
+    else
+    {
+        readings[sensor.sensorId].assign(fields.begin(),
+                                         fields.begin() + count);
+    }
+    nextSensor();
+}
+
+void Terminus::nextSensor()
+{
+    if (syncPending)
+    {
+        startSync();
+    }
+    else if (++sensorIndex >= stateSensors.size())
+    {
+        state = State::Idle;
+    }
+}
+
+} // namespace platform_mc
+
+} // namespace pldm
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "libpldm/base.h"
+#include "libpldm/pdr.h"
+#include "libpldm/platform.h"
+#include "libpldm/requester/pldm.h"
+
+#include "common/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace pldm
+{
+
+namespace platform_mc
+{
+
+/** @struct TerminusRequest
+ *
+ *  A PLDM request message to send to a terminus
+ */
+struct TerminusRequest
+{
+    uint8_t type;      //!< PLDM type
+    uint8_t command;   //!< PLDM command
+    pldm::Request msg; //!< PLDM request message
+};
+
+/** @struct StateSensor
+ *
+ *  A state sensor found in the PDRs of a terminus
+ */
+struct StateSensor
+{
+    uint16_t sensorId;      //!< sensor ID
+    uint8_t compositeCount; //!< number of composite sensors
+};
+
+/** @class Terminus
+ *
+ *  The state of a PLDM terminus the BMC manages: its TID, the PDRs it
+ *  reported, its state sensors and their readings. Once discovered a terminus
+ *  gets its TID, has its asynchronous events disabled, the BMC does not
+ *  handle them, has its PDRs synced and then has its state sensors read in
+ *  rounds.
+ *
+ *  The terminus only builds its requests and processes the responses, one
+ *  request at a time. Sending them is left to the TerminusManager, which
+ *  shares the requester between the termini.
+ */
+class Terminus
+{
+  public:
+    /** @brief The step a terminus is at */
+    enum class State
+    {
+        GetTID,
+        SetEventReceiver,
+        SyncPDRs,
+        PollSensors,
+        Idle,
+    };
+
+    Terminus() = delete;
+    Terminus(const Terminus&) = delete;
+    Terminus& operator=(const Terminus&) = delete;
+
+    /** @brief Constructor
+     *
+     *  @param[in] eid - MCTP endpoint ID of the terminus
+     *  @param[in] eventReceiverEid - MCTP endpoint ID of the event receiver
+     */
+    Terminus(mctp_eid_t eid, uint8_t eventReceiverEid);
+
+    /** @brief Build the next request of the terminus
+     *
+     *  @param[in] instanceId - instance ID of the request
+     *
+     *  @return the request, std::nullopt if the terminus has nothing to send
+     */
+    std::optional<TerminusRequest> nextRequest(uint8_t instanceId);
+
+    /** @brief Process the response to the last request and move on
+     *
+     *  @param[in] response - PLDM response message, nullptr if none was
+     *                        received
+     *  @param[in] respMsgLen - length of the response payload
+     */
+    void processResponse(const pldm_msg* response, size_t respMsgLen);
+
+    /** @brief Sync the PDRs again. A round of sensor reads in progress ends
+     *         after the read in flight, does nothing if the terminus is busy
+     *         otherwise.
+     */
+    void sync();
+
+    /** @brief Start a round of sensor reads, or sync the PDRs again if the
+     *         last sync failed. Does nothing if the terminus is busy.
+     */
+    void startPolling();
+
+    /** @brief Check if the terminus has requests to send */
+    bool hasWork() const
+    {
+        return state != State::Idle;
+    }
+
+    /** @brief Check if the PDRs of the terminus are synced */
+    bool synced() const
+    {
+        return pdrsSynced;
+    }
+
+    mctp_eid_t getEid() const
+    {
+        return eid;
+    }
+
+    uint8_t getTid() const
+    {
+        return tid;
+    }
+
+    State getState() const
+    {
+        return state;
+    }
+
+    /** @brief Get the PDRs reported by the terminus */
+    const pldm_pdr* getPdrRepo() const
+    {
+        return pdrRepo.get();
+    }
+
+    /** @brief Get the state sensors of the terminus */
+    const std::vector<StateSensor>& getStateSensors() const
+    {
+        return stateSensors;
+    }
+
+    /** @brief Get the last readings of the state sensors, keyed by sensor
+     *         ID. A sensor whose last read failed has no reading.
+     */
+    const std::map<uint16_t, std::vector<get_sensor_state_field>>&
+        getReadings() const
+    {
+        return readings;
+    }
+
+  private:
+    /** @brief Process the responses of each step */
+    void processGetTID(const pldm_msg* response, size_t respMsgLen);
+    void processSetEventReceiver(const pldm_msg* response, size_t respMsgLen);
+    void processGetPDR(const pldm_msg* response, size_t respMsgLen);
+    void processSensorReading(const pldm_msg* response, size_t respMsgLen);
+
+    /** @brief Start the sync of the PDRs, from the first record */
+    void startSync();
+
+    /** @brief Find the state sensors once the PDRs are synced */
+    void parseStateSensors();
+
+    /** @brief Move on to the next sensor to read, or end the round after the
+     *         last or when a sync is pending
+     */
+    void nextSensor();
+
+    mctp_eid_t eid;
+    uint8_t eventReceiverEid;
+    uint8_t tid = 0;
+    State state = State::GetTID;
+
+    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> pdrRepo;
+    uint32_t recordHandle = 0;       //!< record handle of the PDR being read
+    uint32_t dataTransferHandle = 0; //!< handle of the next part of the PDR
+    uint8_t transferOpFlag = PLDM_GET_FIRSTPART;
+    std::vector<uint8_t> record;     //!< the parts of the PDR received so far
+    bool pdrsSynced = false;
+
+    std::vector<StateSensor> stateSensors;
+    size_t sensorIndex = 0;   //!< index of the sensor being read
+    bool syncPending = false; //!< sync the PDRs after the read in flight
+    std::map<uint16_t, std::vector<get_sensor_state_field>> readings;
+};
+
+} // namespace platform_mc
+
+} // namespace pldm
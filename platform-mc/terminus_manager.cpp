@@ -0,0 +1,187 @@
+#include "terminus_manager.hpp"
+
+#include <iostream>
+
+namespace pldm
+{
+
+namespace platform_mc
+{
+
+TerminusManager::TerminusManager(
+    sdeventplus::Event& event, pldm::dbus_api::Requester& requester,
+    pldm::requester::Handler<pldm::requester::Request>& handler,
+    uint8_t eventReceiverEid, size_t maxInFlight,
+    std::chrono::seconds pollInterval) :
+    requester(requester),
+    handler(handler), eventReceiverEid(eventReceiverEid),
+    maxInFlight(maxInFlight),
+    pollTimer(event.get(), std::bind(&TerminusManager::pollSensors, this))
+{
+    try
+    {
+        pollTimer.start(
+            std::chrono::duration_cast<std::chrono::microseconds>(pollInterval),
+            true);
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cerr << "Failed to start the sensor polling timer, ERROR="
+                  << e.what() << "\n";
+    }
+}
+
+void TerminusManager::discover(const std::vector<mctp_eid_t>& eids)
+{
+    for (auto eid : eids)
+    {
+        auto it = termini.find(eid);
+        if (it != termini.end())
+        {
+            // A busy terminus is in flight or waiting for its turn already
+            auto& terminus = *it->second.terminus;
+            bool busy = terminus.hasWork();
+            terminus.sync();
+            if (!busy)
+            {
+                ready.push_back(eid);
+            }
+            continue;
+        }
+        termini.emplace(eid,
+                        Entry{std::make_unique<Terminus>(eid, eventReceiverEid),
+                              nextSerial++});
+        handler.reserveSlots(eid);
+        ready.push_back(eid);
+    }
+
+    schedule();
+}
+
+void TerminusManager::remove(const std::vector<mctp_eid_t>& eids)
+{
+    for (auto eid : eids)
+    {
+        // The responses to its requests in flight are dropped
+        if (termini.erase(eid))
+        {
+            std::erase(ready, eid);
+            handler.releaseSlots(eid);
+        }
+    }
+}
+
+void TerminusManager::pollSensors()
+{
+    for (auto& [eid, entry] : termini)
+    {
+        // A busy terminus is in flight or waiting for its turn already
+        if (entry.terminus->hasWork())
+        {
+            continue;
+        }
+        entry.terminus->startPolling();
+        if (entry.terminus->hasWork())
+        {
+            ready.push_back(eid);
+        }
+    }
+    schedule();
+}
+
+const Terminus* TerminusManager::getTerminus(mctp_eid_t eid) const
+{
+    auto it = termini.find(eid);
+    if (it == termini.end())
+    {
+        return nullptr;
+    }
+    return it->second.terminus.get();
+}
+
+void TerminusManager::schedule()
+{
+    while (inFlight < maxInFlight && !ready.empty())
+    {
+        auto eid = ready.front();
+        ready.pop_front();
+        auto it = termini.find(eid);
+        if (it == termini.end() || !it->second.terminus->hasWork())
+        {
+            continue;
+        }
+        if (sendRequest(eid, it->second))
+        {
+            ++inFlight;
+        }
+        else if (it->second.terminus->hasWork())
+        {
+            ready.push_back(eid);
+        }
+    }
+}
+
+bool TerminusManager::sendRequest(mctp_eid_t eid, Entry& entry)
+{
+    auto& terminus = *entry.terminus;
+    uint8_t instanceId = 0;
+    try
+    {
+        instanceId = requester.getInstanceId(eid);
+    }
+    catch (const std::exception& e)
+    {
+        // Taken as a request that got no response, the terminus moves on
+        std::cerr << "No instance ID for the request to the terminus, EID = "
+                  << (unsigned)eid << "\n";
+        terminus.processResponse(nullptr, 0);
+        return false;
+    }
+
+    auto request = terminus.nextRequest(instanceId);
+    if (!request)
+    {
+        requester.markFree(eid, instanceId);
+        terminus.processResponse(nullptr, 0);
+        return false;
+    }
+
+    auto rc = handler.registerRequest(
+        eid, instanceId, request->type, request->command,
+        std::move(request->msg),
+        [this, serial = entry.serial](mctp_eid_t eid, const pldm_msg* response,
+                                      size_t respMsgLen) {
+            processResponse(eid, serial, response, respMsgLen);
+        });
+    if (rc != PLDM_SUCCESS)
+    {
+        std::cerr << "Failed to send the request to the terminus, EID = "
+                  << (unsigned)eid
+                  << " COMMAND = " << (unsigned)request->command << "\n";
+        terminus.processResponse(nullptr, 0);
+        return false;
+    }
+    return true;
+}
+
+void TerminusManager::processResponse(mctp_eid_t eid, size_t serial,
+                                      const pldm_msg* response,
+                                      size_t respMsgLen)
+{
+    --inFlight;
+    auto it = termini.find(eid);
+    if (it != termini.end() && it->second.serial == serial)
+    {
+        auto& terminus = *it->second.terminus;
+        terminus.processResponse(response, respMsgLen);
+        if (terminus.hasWork())
+        {
+            ready.push_back(eid);
+        }
+    }
+    schedule();
+}
+
+} // namespace platform_mc
+
+} // namespace pldm
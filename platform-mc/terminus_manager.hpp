@@ -0,0 +1,145 @@
+#pragma once
+
+#include "config.h"
+
+#include "libpldm/base.h"
+
+#include "pldmd/dbus_impl_requester.hpp"
+#include "requester/handler.hpp"
+#include "terminus.hpp"
+
+#include <sdbusplus/timer.hpp>
+#include <sdeventplus/event.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace pldm
+{
+
+namespace platform_mc
+{
+
+/** @class TerminusManager
+ *
+ *  Manages the PLDM termini discovered on MCTP. Each terminus has its own
+ *  state and they all share the requester: their PDR syncs and sensor reads
+ *  run at the same time, taking turns at sending. A terminus has one request
+ *  in flight at most and goes to the back of the queue once it has its
+ *  response, so a terminus with many PDRs does not hold up the others.
+ */
+class TerminusManager
+{
+  public:
+    TerminusManager() = delete;
+    TerminusManager(const TerminusManager&) = delete;
+    TerminusManager& operator=(const TerminusManager&) = delete;
+
+    /** @brief Constructor
+     *
+     *  @param[in] event - reference to PLDM daemon's main event loop
+     *  @param[in] requester - reference to Requester object
+     *  @param[in] handler - PLDM request handler
+     *  @param[in] eventReceiverEid - MCTP endpoint ID the termini are to send
+     *                                their events to
+     *  @param[in] maxInFlight - number of requests in flight at most, across
+     *                           the termini
+     *  @param[in] pollInterval - interval between the rounds of sensor reads
+     */
+    TerminusManager(
+        sdeventplus::Event& event, pldm::dbus_api::Requester& requester,
+        pldm::requester::Handler<pldm::requester::Request>& handler,
+        uint8_t eventReceiverEid,
+        size_t maxInFlight = TERMINUS_MAX_REQUESTS_IN_FLIGHT,
+        std::chrono::seconds pollInterval =
+            std::chrono::seconds(SENSOR_POLLING_INTERVAL));
+
+    /** @brief Add termini to manage and sync them, the termini managed
+     *         already have their PDRs synced again
+     *
+     *  @param[in] eids - MCTP endpoint IDs of the termini
+     */
+    void discover(const std::vector<mctp_eid_t>& eids);
+
+    /** @brief Drop termini, their requests in flight are dropped and the
+     *         request slots reserved for them released
+     *
+     *  @param[in] eids - MCTP endpoint IDs of the termini
+     */
+    void remove(const std::vector<mctp_eid_t>& eids);
+
+    /** @brief Start a round of sensor reads on the idle termini, called on
+     *         the polling timer
+     */
+    void pollSensors();
+
+    /** @brief Get a terminus
+     *
+     *  @param[in] eid - MCTP endpoint ID of the terminus
+     *
+     *  @return the terminus, nullptr if it is not managed
+     */
+    const Terminus* getTerminus(mctp_eid_t eid) const;
+
+    /** @brief Get the number of termini managed */
+    size_t size() const
+    {
+        return termini.size();
+    }
+
+    /** @brief Check if requests are in flight or waiting to be sent */
+    bool busy() const
+    {
+        return inFlight || !ready.empty();
+    }
+
+  private:
+    /** @struct Entry
+     *
+     *  A terminus managed, and the serial number the responses to its
+     *  requests are matched with
+     */
+    struct Entry
+    {
+        std::unique_ptr<Terminus> terminus;
+        size_t serial;
+    };
+
+    /** @brief Send requests of the termini in turn, until the window is full
+     *         or no terminus has requests to send
+     */
+    void schedule();
+
+    /** @brief Send the next request of a terminus
+     *
+     *  @param[in] eid - MCTP endpoint ID of the terminus
+     *  @param[in] entry - the terminus
+     *
+     *  @return true if the request is in flight
+     */
+    bool sendRequest(mctp_eid_t eid, Entry& entry);
+
+    /** @brief Process the response to a request of a terminus, and send the
+     *         next requests
+     */
+    void processResponse(mctp_eid_t eid, size_t serial,
+                         const pldm_msg* response, size_t respMsgLen);
+
+    pldm::dbus_api::Requester& requester;
+    pldm::requester::Handler<pldm::requester::Request>& handler;
+    uint8_t eventReceiverEid;
+    size_t maxInFlight;
+    phosphor::Timer pollTimer; //!< starts the rounds of sensor reads
+    std::map<mctp_eid_t, Entry> termini;
+    std::deque<mctp_eid_t> ready; //!< the termini waiting to send, in turn
+    size_t inFlight = 0;          //!< number of requests awaiting response
+    size_t nextSerial = 0;        //!< serial number of the next terminus
+};
+
+} // namespace platform_mc
+
+} // namespace pldm
@@ -0,0 +1,113 @@
+#include "common/test/mocked_utils.hpp"
+#include "common/utils.hpp"
+#include "platform-mc/mctp_discovery.hpp"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace pldm::platform_mc;
+using ::testing::_;
+using ::testing::Return;
+using ::testing::StrEq;
+
+namespace
+{
+
+constexpr auto endpointIntf = "xyz.openbmc_project.MCTP.Endpoint";
+
+/** @brief The interfaces of an MCTP endpoint added to D-Bus */
+std::map<std::string, pldm::utils::DbusChangedProps>
+    endpoint(uint8_t eid, std::vector<uint8_t> types = {0, 1})
+{
+    return {{endpointIntf, {{"EID", eid}, {"SupportedMessageTypes", types}}}};
+}
+
+} // namespace
+
+TEST(GetMctpEndpoints, pldmEndpoints)
+{
+    MockdBusHandler dBusIntf;
+    pldm::utils::MapperGetSubTreeResponse endpoints{
+        {"/xyz/openbmc_project/mctp/1/9", {}},
+        {"/xyz/openbmc_project/mctp/1/10", {}}};
+    EXPECT_CALL(dBusIntf, getSubtree(StrEq("/xyz/openbmc_project/mctp"), 0, _))
+        .WillOnce(Return(endpoints));
+    EXPECT_CALL(dBusIntf,
+                getDbusPropertyVariant(StrEq("/xyz/openbmc_project/mctp/1/9"),
+                                       StrEq("SupportedMessageTypes"), _))
+        .WillOnce(Return(std::vector<uint8_t>{0, 1}));
+    EXPECT_CALL(dBusIntf,
+                getDbusPropertyVariant(StrEq("/xyz/openbmc_project/mctp/1/9"),
+                                       StrEq("EID"), _))
+        .WillOnce(Return(uint8_t(9)));
+    // Not a PLDM endpoint
+    EXPECT_CALL(dBusIntf,
+                getDbusPropertyVariant(StrEq("/xyz/openbmc_project/mctp/1/10"),
+                                       StrEq("SupportedMessageTypes"), _))
+        .WillOnce(Return(std::vector<uint8_t>{0, 5}));
+
+    MctpEndpoints expected{{"/xyz/openbmc_project/mctp/1/9", 9}};
+    EXPECT_EQ(getMctpEndpoints(dBusIntf), expected);
+}
+
+TEST(MctpDiscovery, addedAndRemoved)
+{
+    MockdBusHandler dBusIntf;
+    pldm::utils::MapperGetSubTreeResponse subtree{
+        {"/xyz/openbmc_project/mctp/1/8", {}},
+        {"/xyz/openbmc_project/mctp/1/9", {}}};
+    EXPECT_CALL(dBusIntf, getSubtree(StrEq("/xyz/openbmc_project/mctp"), 0, _))
+        .WillOnce(Return(subtree));
+    EXPECT_CALL(dBusIntf,
+                getDbusPropertyVariant(_, StrEq("SupportedMessageTypes"), _))
+        .WillRepeatedly(Return(std::vector<uint8_t>{0, 1}));
+    EXPECT_CALL(dBusIntf,
+                getDbusPropertyVariant(StrEq("/xyz/openbmc_project/mctp/1/8"),
+                                       StrEq("EID"), _))
+        .WillOnce(Return(uint8_t(8)));
+    EXPECT_CALL(dBusIntf,
+                getDbusPropertyVariant(StrEq("/xyz/openbmc_project/mctp/1/9"),
+                                       StrEq("EID"), _))
+        .WillOnce(Return(uint8_t(9)));
+
+    std::vector<mctp_eid_t> added;
+    std::vector<mctp_eid_t> removed;
+    // The BMC is left out
+    MctpDiscovery discovery(
+        dBusIntf, {8},
+        [&added](const std::vector<mctp_eid_t>& eids) {
+            added.insert(added.end(), eids.begin(), eids.end());
+        },
+        [&removed](const std::vector<mctp_eid_t>& eids) {
+            removed.insert(removed.end(), eids.begin(), eids.end());
+        });
+    EXPECT_EQ(added, std::vector<mctp_eid_t>{9});
+
+    discovery.processInterfacesAdded("/xyz/openbmc_project/mctp/1/10",
+                                     endpoint(10));
+    // Not a PLDM endpoint
+    discovery.processInterfacesAdded("/xyz/openbmc_project/mctp/1/11",
+                                     endpoint(11, {0, 5}));
+    // Not an endpoint
+    discovery.processInterfacesAdded("/xyz/openbmc_project/mctp/1/12",
+                                     {{"xyz.openbmc_project.Common.UUID", {}}});
+    EXPECT_EQ(added, (std::vector<mctp_eid_t>{9, 10}));
+
+    discovery.processInterfacesRemoved("/xyz/openbmc_project/mctp/1/9",
+                                       {endpointIntf});
+    // Never reported
+    discovery.processInterfacesRemoved("/xyz/openbmc_project/mctp/1/11",
+                                       {endpointIntf});
+    discovery.processInterfacesRemoved("/xyz/openbmc_project/mctp/1/10",
+                                       {"xyz.openbmc_project.Common.UUID"});
+    EXPECT_EQ(removed, std::vector<mctp_eid_t>{9});
+
+    // The endpoint comes back with a new EID
+    discovery.processInterfacesAdded("/xyz/openbmc_project/mctp/1/10",
+                                     endpoint(13));
+    EXPECT_EQ(added, (std::vector<mctp_eid_t>{9, 10, 13}));
+    EXPECT_EQ(removed, (std::vector<mctp_eid_t>{9, 10}));
+}
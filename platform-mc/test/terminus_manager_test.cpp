@@ -0,0 +1,439 @@
+#include "libpldm/base.h"
+#include "libpldm/entity.h"
+#include "libpldm/platform.h"
+
+#include "common/transport.hpp"
+#include "common/types.hpp"
+#include "common/utils.hpp"
+#include "platform-mc/terminus_manager.hpp"
+#include "pldmd/dbus_impl_requester.hpp"
+#include "requester/handler.hpp"
+#include "requester/request.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <queue>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::platform_mc;
+using namespace std::chrono;
+
+namespace
+{
+
+/** @class FakeTerminus
+ *
+ *  Answers the requests of the terminus manager like a PLDM terminus with
+ *  state sensors, the PDRs are sent in parts of a few bytes. A sensor reads
+ *  the low byte of its ID plus an offset.
+ */
+class FakeTerminus
+{
+  public:
+    static constexpr uint16_t partSize = 16;
+
+    FakeTerminus(mctp_eid_t eid, uint16_t numSensors) : eid(eid)
+    {
+        for (uint16_t i = 0; i < numSensors; ++i)
+        {
+            std::vector<uint8_t> pdr(sizeof(pldm_state_sensor_pdr) - 1 +
+                                     sizeof(state_sensor_possible_states));
+            auto sensor = reinterpret_cast<pldm_state_sensor_pdr*>(pdr.data());
+            sensor->hdr.record_handle = i + 1;
+            sensor->hdr.version = 1;
+            sensor->hdr.type = PLDM_STATE_SENSOR_PDR;
+            sensor->hdr.length = pdr.size() - sizeof(pldm_pdr_hdr);
+            sensor->terminus_handle = eid;
+            sensor->sensor_id = 100 + i;
+            sensor->entity_type = PLDM_ENTITY_PROC;
+            sensor->entity_instance = i;
+            sensor->composite_sensor_count = 1;
+            pdrs.push_back(std::move(pdr));
+        }
+    }
+
+    /** @brief Build the response to a request */
+    pldm::Response respond(const pldm::Request& request)
+    {
+        auto msg = reinterpret_cast<const pldm_msg*>(request.data());
+        auto len = request.size() - sizeof(pldm_msg_hdr);
+        auto instanceId = msg->hdr.instance_id;
+        pldm::Response response;
+        switch (msg->hdr.command)
+        {
+            case PLDM_GET_TID:
+                response.resize(sizeof(pldm_msg_hdr) + PLDM_GET_TID_RESP_BYTES);
+                encode_get_tid_resp(instanceId, PLDM_SUCCESS, eid,
+                                    out(response));
+                break;
+            case PLDM_SET_EVENT_RECEIVER:
+            {
+                uint8_t enable = 0;
+                uint8_t protocol = 0;
+                uint8_t receiver = 0;
+                uint16_t heartbeat = 0;
+                decode_set_event_receiver_req(msg, len, &enable, &protocol,
+                                              &receiver, &heartbeat);
+                eventMessageGlobalEnable = enable;
+                response.resize(sizeof(pldm_msg_hdr) + 1);
+                encode_set_event_receiver_resp(instanceId, PLDM_SUCCESS,
+                                               out(response));
+                break;
+            }
+            case PLDM_GET_PDR:
+                response = getPDR(instanceId, msg, len);
+                break;
+            case PLDM_GET_STATE_SENSOR_READINGS:
+            {
+                uint16_t sensorId = 0;
+                bitfield8_t rearm{};
+                uint8_t reserved = 0;
+                decode_get_state_sensor_readings_req(msg, len, &sensorId,
+                                                     &rearm, &reserved);
+                sensorReads++;
+                if (failedSensors.contains(sensorId))
+                {
+                    response.resize(sizeof(pldm_msg_hdr) + 1);
+                    encode_cc_only_resp(instanceId, PLDM_PLATFORM,
+                                        PLDM_GET_STATE_SENSOR_READINGS,
+                                        PLDM_PLATFORM_INVALID_SENSOR_ID,
+                                        out(response));
+                    break;
+                }
+                get_sensor_state_field field{
+                    PLDM_SENSOR_ENABLED,
+                    static_cast<uint8_t>(sensorId + stateOffset), 0, 0};
+                response.resize(sizeof(pldm_msg_hdr) +
+                                PLDM_GET_STATE_SENSOR_READINGS_MIN_RESP_BYTES +
+                                sizeof(field));
+                encode_get_state_sensor_readings_resp(
+                    instanceId, PLDM_SUCCESS, 1, &field, out(response));
+                break;
+            }
+        }
+        return response;
+    }
+
+    mctp_eid_t eid;
+    uint8_t eventMessageGlobalEnable = PLDM_EVENT_MESSAGE_GLOBAL_ENABLE_ASYNC;
+    std::vector<std::vector<uint8_t>> pdrs;
+    uint8_t stateOffset = 0;          //!< added to the sensor readings
+    std::set<uint16_t> failedSensors; //!< sensors failing to read
+    size_t sensorReads = 0;           //!< GetStateSensorReadings received
+
+  private:
+    static pldm_msg* out(pldm::Response& response)
+    {
+        return reinterpret_cast<pldm_msg*>(response.data());
+    }
+
+    pldm::Response getPDR(uint8_t instanceId, const pldm_msg* msg, size_t len)
+    {
+        uint32_t recordHandle = 0;
+        uint32_t dataTransferHandle = 0;
+        uint8_t opFlag = 0;
+        uint16_t requestCount = 0;
+        uint16_t changeNumber = 0;
+        decode_get_pdr_req(msg, len, &recordHandle, &dataTransferHandle,
+                           &opFlag, &requestCount, &changeNumber);
+
+        // Record handles are 1 based, 0 is the first record
+        auto index = recordHandle ? recordHandle - 1 : 0;
+        const auto& pdr = pdrs[index];
+        uint32_t offset = opFlag == PLDM_GET_FIRSTPART ? 0 : dataTransferHandle;
+        uint16_t count = std::min<size_t>(
+            {pdr.size() - offset, partSize, requestCount});
+        bool first = offset == 0;
+        bool last = offset + count == pdr.size();
+        uint8_t flag = first ? (last ? PLDM_START_AND_END : PLDM_START)
+                             : (last ? PLDM_END : PLDM_MIDDLE);
+        uint32_t nextRecord =
+            last ? (index + 1 < pdrs.size() ? index + 2 : 0) : recordHandle;
+
+        pldm::Response response(sizeof(pldm_msg_hdr) +
+                                PLDM_GET_PDR_MIN_RESP_BYTES + count +
+                                (last ? 1 : 0));
+        encode_get_pdr_resp(instanceId, PLDM_SUCCESS, nextRecord,
+                            last ? 0 : offset + count, flag, count,
+                            pdr.data() + offset, 0, out(response));
+        return response;
+    }
+};
+
+/** @class FleetTransport
+ *
+ *  Delivers the requests to a fleet of fake termini, each response arrives
+ *  a fixed latency after its request on a simulated clock
+ */
+class FleetTransport : public pldm::transport::Transport
+{
+  public:
+    int getFd() const override
+    {
+        return -1;
+    }
+
+    int sendRequest(mctp_eid_t eid, const uint8_t* msg, size_t len) override
+    {
+        inFlight.emplace(now + latency, sequence++, eid,
+                         pldm::Request(msg, msg + len));
+        maxInFlight = std::max(maxInFlight, inFlight.size());
+        return 0;
+    }
+
+    int sendResponse(mctp_eid_t, uint8_t, std::vector<uint8_t>&&) override
+    {
+        return 0;
+    }
+
+    int recv(pldm::transport::Message&) override
+    {
+        return -EAGAIN;
+    }
+
+    /** @brief Deliver the responses until no request is in flight
+     *
+     *  @param[in] handler - the request handler to hand the responses to
+     */
+    void run(pldm::requester::Handler<pldm::requester::Request>& handler)
+    {
+        while (!inFlight.empty())
+        {
+            auto [time, seq, eid, request] = inFlight.top();
+            inFlight.pop();
+            now = time;
+            auto& terminus = termini.at(eid);
+            auto response = terminus.respond(request);
+            auto hdr = reinterpret_cast<const pldm_msg_hdr*>(request.data());
+            handler.handleResponse(
+                eid, hdr->instance_id, hdr->type, hdr->command,
+                reinterpret_cast<const pldm_msg*>(response.data()),
+                response.size() - sizeof(pldm_msg_hdr));
+            lastResponse[eid] = now;
+        }
+    }
+
+    using InFlight =
+        std::tuple<microseconds, size_t, mctp_eid_t, pldm::Request>;
+
+    std::map<mctp_eid_t, FakeTerminus> termini;
+    std::map<mctp_eid_t, microseconds> lastResponse;
+    std::priority_queue<InFlight, std::vector<InFlight>, std::greater<>>
+        inFlight;
+    microseconds latency{1000};
+    microseconds now{0};
+    size_t sequence = 0;
+    size_t maxInFlight = 0;
+};
+
+} // namespace
+
+class TerminusManagerTest : public testing::Test
+{
+  protected:
+    TerminusManagerTest() :
+        event(sdeventplus::Event::get_default()),
+        dbusImplReq(pldm::utils::DBusHandler::getBus(),
+                    "/xyz/openbmc_project/pldm"),
+        handler(transport, event, dbusImplReq, false, seconds(5), 0,
+                seconds(1))
+    {}
+
+    /** @brief Add fake termini to the fleet
+     *
+     *  @return the EIDs of the termini
+     */
+    std::vector<mctp_eid_t> addTermini(size_t count, uint16_t numSensors,
+                                       mctp_eid_t firstEid = 10)
+    {
+        std::vector<mctp_eid_t> eids;
+        for (size_t i = 0; i < count; ++i)
+        {
+            mctp_eid_t eid = firstEid + i;
+            transport.termini.emplace(eid, FakeTerminus(eid, numSensors));
+            eids.push_back(eid);
+        }
+        return eids;
+    }
+
+    sdeventplus::Event event;
+    FleetTransport transport;
+    pldm::dbus_api::Requester dbusImplReq;
+    pldm::requester::Handler<pldm::requester::Request> handler;
+};
+
+TEST_F(TerminusManagerTest, syncAndPoll)
+{
+    auto eids = addTermini(4, 10);
+    TerminusManager manager(event, dbusImplReq, handler, 8, 8, seconds(3600));
+    manager.discover(eids);
+    transport.run(handler);
+
+    EXPECT_FALSE(manager.busy());
+    ASSERT_EQ(manager.size(), eids.size());
+    for (auto eid : eids)
+    {
+        auto terminus = manager.getTerminus(eid);
+        ASSERT_NE(terminus, nullptr);
+        EXPECT_TRUE(terminus->synced());
+        EXPECT_EQ(terminus->getTid(), eid);
+        EXPECT_EQ(terminus->getState(), Terminus::State::Idle);
+        // The BMC does not handle the events of the termini
+        EXPECT_EQ(transport.termini.at(eid).eventMessageGlobalEnable,
+                  PLDM_EVENT_MESSAGE_GLOBAL_DISABLE);
+
+        // The PDRs are put together from their parts
+        EXPECT_EQ(pldm_pdr_get_record_count(terminus->getPdrRepo()), 10);
+        uint8_t* data = nullptr;
+        uint32_t size = 0;
+        uint32_t next = 0;
+        pldm_pdr_find_record(terminus->getPdrRepo(), 5, &data, &size, &next);
+        ASSERT_NE(data, nullptr);
+        const auto& expected = transport.termini.at(eid).pdrs[4];
+        EXPECT_EQ(std::vector<uint8_t>(data, data + size), expected);
+
+        ASSERT_EQ(terminus->getStateSensors().size(), 10);
+        EXPECT_EQ(terminus->getStateSensors()[5].sensorId, 105);
+
+        // The state sensors are read once the PDRs are synced
+        const auto& readings = terminus->getReadings();
+        ASSERT_EQ(readings.size(), 10);
+        ASSERT_EQ(readings.at(105).size(), 1);
+        EXPECT_EQ(readings.at(105)[0].sensor_op_state, PLDM_SENSOR_ENABLED);
+        EXPECT_EQ(readings.at(105)[0].present_state, 105);
+    }
+}
+
+TEST_F(TerminusManagerTest, pollRounds)
+{
+    auto eids = addTermini(4, 10);
+    TerminusManager manager(event, dbusImplReq, handler, 8, 2, seconds(3600));
+    manager.discover(eids);
+    transport.run(handler);
+
+    for (auto eid : eids)
+    {
+        transport.termini.at(eid).stateOffset = 1;
+    }
+    transport.termini.at(eids[0]).failedSensors.insert(103);
+    transport.maxInFlight = 0;
+    manager.pollSensors();
+    EXPECT_TRUE(manager.busy());
+    transport.run(handler);
+
+    // The reads of the termini share the window
+    EXPECT_EQ(transport.maxInFlight, 2);
+    EXPECT_FALSE(manager.busy());
+    for (auto eid : eids)
+    {
+        auto terminus = manager.getTerminus(eid);
+        EXPECT_EQ(terminus->getState(), Terminus::State::Idle);
+        EXPECT_EQ(transport.termini.at(eid).sensorReads, 20);
+        const auto& readings = terminus->getReadings();
+        EXPECT_EQ(readings.at(105)[0].present_state, 106);
+        // A sensor failing to read has no reading
+        EXPECT_EQ(readings.contains(103), eid != eids[0]);
+    }
+}
+
+TEST_F(TerminusManagerTest, rediscoveredWhilePolling)
+{
+    auto eids = addTermini(1, 4);
+    TerminusManager manager(event, dbusImplReq, handler, 8, 8, seconds(3600));
+    manager.discover(eids);
+    transport.run(handler);
+
+    // The round ends after the read in flight, then the PDRs are synced
+    manager.pollSensors();
+    transport.termini.at(eids[0]) = FakeTerminus(eids[0], 6);
+    manager.discover(eids);
+    transport.run(handler);
+
+    auto terminus = manager.getTerminus(eids[0]);
+    EXPECT_EQ(transport.termini.at(eids[0]).sensorReads, 1 + 6);
+    EXPECT_EQ(terminus->getStateSensors().size(), 6);
+    EXPECT_EQ(terminus->getReadings().size(), 6);
+    EXPECT_FALSE(manager.busy());
+}
+
+TEST_F(TerminusManagerTest, windowIsShared)
+{
+    auto eids = addTermini(16, 4);
+    TerminusManager manager(event, dbusImplReq, handler, 8, 4, seconds(3600));
+    manager.discover(eids);
+    EXPECT_EQ(transport.inFlight.size(), 4);
+    transport.run(handler);
+    EXPECT_EQ(transport.maxInFlight, 4);
+    for (auto eid : eids)
+    {
+        EXPECT_TRUE(manager.getTerminus(eid)->synced());
+    }
+}
+
+TEST_F(TerminusManagerTest, fairShare)
+{
+    // One terminus with many PDRs does not hold up the others
+    auto big = addTermini(1, 200, 10);
+    auto small = addTermini(7, 2, 20);
+    auto eids = big;
+    eids.insert(eids.end(), small.begin(), small.end());
+
+    TerminusManager manager(event, dbusImplReq, handler, 8, 2, seconds(3600));
+    manager.discover(eids);
+    transport.run(handler);
+
+    for (auto eid : small)
+    {
+        EXPECT_TRUE(manager.getTerminus(eid)->synced());
+        EXPECT_LT(transport.lastResponse.at(eid) * 5,
+                  transport.lastResponse.at(big[0]));
+    }
+    EXPECT_TRUE(manager.getTerminus(big[0])->synced());
+}
+
+TEST_F(TerminusManagerTest, removedTerminus)
+{
+    auto eids = addTermini(2, 4);
+    TerminusManager manager(event, dbusImplReq, handler, 8, 1, seconds(3600));
+    manager.discover(eids);
+
+    // The request in flight to the removed terminus is dropped with its
+    // request slots, the other terminus takes the window
+    manager.remove({eids[0]});
+    EXPECT_TRUE(manager.busy());
+    EXPECT_EQ(transport.inFlight.size(), 2);
+    transport.run(handler);
+    EXPECT_EQ(manager.getTerminus(eids[0]), nullptr);
+    EXPECT_TRUE(manager.getTerminus(eids[1])->synced());
+    EXPECT_FALSE(manager.busy());
+
+    // Added back, it is synced from scratch
+    manager.discover({eids[0]});
+    transport.run(handler);
+    EXPECT_EQ(manager.size(), 2);
+    EXPECT_TRUE(manager.getTerminus(eids[0])->synced());
+}
+
+TEST_F(TerminusManagerTest, rediscoveredTerminus)
+{
+    auto eids = addTermini(1, 4);
+    TerminusManager manager(event, dbusImplReq, handler, 8, 8, seconds(3600));
+    manager.discover(eids);
+    transport.run(handler);
+    ASSERT_TRUE(manager.getTerminus(eids[0])->synced());
+
+    // The PDRs of the terminus changed while it was away
+    transport.termini.at(eids[0]) = FakeTerminus(eids[0], 6);
+    manager.discover(eids);
+    EXPECT_TRUE(manager.busy());
+    transport.run(handler);
+    EXPECT_EQ(manager.size(), 1);
+    EXPECT_TRUE(manager.getTerminus(eids[0])->synced());
+    EXPECT_EQ(manager.getTerminus(eids[0])->getStateSensors().size(), 6);
+}
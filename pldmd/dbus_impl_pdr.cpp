@@ -15,12 +15,12 @@ namespace pldm
 namespace dbus_api
 {
 
-std::vector<std::vector<uint8_t>> Pdr::findStateEffecterPDR(uint8_t tid,
-                                                            uint16_t entityID,
-                                                            uint16_t stateSetId)
+std::vector<std::vector<uint8_t>>
+    Pdr::findStateEffecterPDR(uint8_t /*tid*/, uint16_t entityID,
+                              uint16_t stateSetId)
 {
     auto pdrs =
-        pldm::utils::findStateEffecterPDR(tid, entityID, stateSetId, pdrRepo);
+        stateIndex.find(PLDM_STATE_EFFECTER_PDR, {entityID, stateSetId});
 
     if (pdrs.empty())
     {
@@ -31,10 +31,10 @@ std::vector<std::vector<uint8_t>> Pdr::findStateEffecterPDR(uint8_t tid,
 }
 
 std::vector<std::vector<uint8_t>>
-    Pdr::findStateSensorPDR(uint8_t tid, uint16_t entityID, uint16_t stateSetId)
+    Pdr::findStateSensorPDR(uint8_t /*tid*/, uint16_t entityID,
+                            uint16_t stateSetId)
 {
-    auto pdrs =
-        pldm::utils::findStateSensorPDR(tid, entityID, stateSetId, pdrRepo);
+    auto pdrs = stateIndex.find(PLDM_STATE_SENSOR_PDR, {entityID, stateSetId});
     if (pdrs.empty())
     {
         throw ResourceNotFound();
@@ -3,6 +3,7 @@
 #include "libpldm/pdr.h"
 #include "libpldm/platform.h"
 
+#include "common/utils.hpp"
 #include "xyz/openbmc_project/PLDM/PDR/server.hpp"
 
 #include <sdbusplus/bus.hpp>
@@ -41,7 +42,7 @@ class Pdr : public PdrIntf
     Pdr(sdbusplus::bus::bus& bus, const std::string& path,
         const pldm_pdr* repo) :
         PdrIntf(bus, path.c_str(), repo),
-        pdrRepo(repo){};
+        pdrRepo(repo), stateIndex(repo){};
 
     /** @brief Implementation for PdrIntf.FindStateEffecterPDR
      *  @param[in] tid - PLDM terminus ID.
@@ -64,6 +65,9 @@ class Pdr : public PdrIntf
   private:
     /** @brief pointer to BMC's primary PDR repo */
     const pldm_pdr* pdrRepo;
+
+    /** @brief index of the state effecter and sensor PDRs of the repo */
+    pldm::utils::StatePDRIndex stateIndex;
 };
 
 } // namespace dbus_api
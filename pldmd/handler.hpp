@@ -3,8 +3,12 @@
 #include "libpldm/base.h"
 
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <map>
+#include <set>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace pldm
@@ -19,6 +23,7 @@ using Response = std::vector<uint8_t>;
 class CmdHandler;
 using HandlerFunc =
     std::function<Response(const pldm_msg* request, size_t reqMsgLen)>;
+using EpochFunc = std::function<uint64_t()>;
 
 class CmdHandler
 {
@@ -33,7 +38,22 @@ class CmdHandler
     Response handle(Command pldmCommand, const pldm_msg* request,
                     size_t reqMsgLen)
     {
-        return handlers.at(pldmCommand)(request, reqMsgLen);
+        auto epoch = memoized.find(pldmCommand);
+        if (epoch == memoized.end())
+        {
+            return handlers.at(pldmCommand)(request, reqMsgLen);
+        }
+        return handleMemoized(pldmCommand, epoch->second, request, reqMsgLen);
+    }
+
+    /** @brief Check if a PLDM command can be handled on a worker thread
+     *
+     *  @param[in] pldmCommand - PLDM command code
+     *  @return true if the command handler is offloadable
+     */
+    bool isOffloadable(Command pldmCommand) const
+    {
+        return offloadable.contains(pldmCommand);
     }
 
     /** @brief Create a response message containing only cc
@@ -58,6 +78,87 @@ class CmdHandler
      *         classes.
      */
     std::map<Command, HandlerFunc> handlers;
+
+    /** @brief PLDM commands whose handlers can run on a worker thread, they
+     *         must neither use the D-Bus connection nor touch state owned by
+     *         the event loop without locking it - to be populated by derived
+     *         classes.
+     */
+    std::set<Command> offloadable;
+
+    /** @brief PLDM commands whose responses are reused, mapped to the epoch
+     *         of the state they are built from. A response is sent again to
+     *         the same request, with the instance ID of the new request, for
+     *         as long as the epoch does not change. The handlers must have no
+     *         side effects, and the commands must not be offloadable - to be
+     *         populated by derived classes.
+     */
+    std::map<Command, EpochFunc> memoized;
+
+  private:
+    /** @struct MemoizedResponse
+     *
+     *  A response kept for a memoized command
+     */
+    struct MemoizedResponse
+    {
+        uint64_t epoch;    //!< epoch the response was built in
+        Response response; //!< the response
+    };
+
+    /** @brief Number of responses kept per command at most */
+    static constexpr size_t maxMemoizedResponses = 32;
+
+    /** @brief Reuse the response to a memoized command, or build it and keep
+     *         it if it is successful
+     *
+     *  @param[in] pldmCommand - PLDM command code
+     *  @param[in] epoch - epoch of the state the response is built from
+     *  @param[in] request - PLDM request message
+     *  @param[in] reqMsgLen - PLDM request message size
+     *  @return PLDM response message
+     */
+    Response handleMemoized(Command pldmCommand, const EpochFunc& epoch,
+                            const pldm_msg* request, size_t reqMsgLen)
+    {
+        auto& responses = memoizedResponses[pldmCommand];
+        std::string_view key(reinterpret_cast<const char*>(request->payload),
+                             reqMsgLen);
+        auto it = responses.find(key);
+        if (it != responses.end() && it->second.epoch == epoch())
+        {
+            auto response = it->second.response;
+            reinterpret_cast<pldm_msg*>(response.data())->hdr.instance_id =
+                request->hdr.instance_id;
+            return response;
+        }
+
+        auto response = handlers.at(pldmCommand)(request, reqMsgLen);
+        // The handler may have built the state the epoch stands for
+        if (response.size() > sizeof(pldm_msg_hdr) &&
+            response[sizeof(pldm_msg_hdr)] == PLDM_SUCCESS)
+        {
+            if (it != responses.end())
+            {
+                it->second = {epoch(), response};
+            }
+            else
+            {
+                if (responses.size() >= maxMemoizedResponses)
+                {
+                    responses.clear();
+                }
+                responses.emplace(key, MemoizedResponse{epoch(), response});
+            }
+        }
+        return response;
+    }
+
+    /** @brief The successful responses of the memoized commands, keyed by
+     *         the request payload
+     */
+    std::map<Command, std::map<std::string, MemoizedResponse, std::less<>>>
+        memoizedResponses;
 };
 
 } // namespace responder
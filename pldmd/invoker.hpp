@@ -42,6 +42,19 @@ class Invoker
         return handlers.at(pldmType)->handle(pldmCommand, request, reqMsgLen);
     }
 
+    /** @brief Check if a PLDM command can be handled on a worker thread
+     *
+     *  @param[in] pldmType - PLDM type code
+     *  @param[in] pldmCommand - PLDM command code
+     *  @return true if a handler is registered for the command and is
+     *          offloadable
+     */
+    bool isOffloadable(Type pldmType, Command pldmCommand) const
+    {
+        auto it = handlers.find(pldmType);
+        return it != handlers.end() && it->second->isOffloadable(pldmCommand);
+    }
+
   private:
     std::map<Type, std::unique_ptr<CmdHandler>> handlers;
 };
@@ -4,11 +4,19 @@
 #include "libpldm/platform.h"
 
 #include "common/flight_recorder.hpp"
+#include "common/logger.hpp"
+#include "common/transport.hpp"
 #include "common/utils.hpp"
 #include "dbus_impl_requester.hpp"
+#include "fw-update/inventory_manager.hpp"
+#include "fw-update/update_manager.hpp"
+#include "fw-update/watch.hpp"
 #include "invoker.hpp"
+#include "platform-mc/mctp_discovery.hpp"
+#include "platform-mc/terminus_manager.hpp"
 #include "requester/handler.hpp"
 #include "requester/request.hpp"
+#include "worker_pool.hpp"
 
 #include <err.h>
 #include <getopt.h>
@@ -16,7 +24,6 @@
 #include <stdlib.h>
 #include <sys/socket.h>
 #include <sys/types.h>
-#include <sys/un.h>
 #include <unistd.h>
 
 #include <sdeventplus/event.hpp>
@@ -26,6 +33,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -35,6 +43,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <system_error>
 #include <vector>
 
 #ifdef LIBPLDMRESPONDER
@@ -59,7 +68,9 @@
 #include "oem/ibm/host-bmc/host_lamp_test.hpp"
 #endif
 
-constexpr uint8_t MCTP_MSG_TYPE_PLDM = 1;
+// Requests queued or running on the worker pool, per worker thread, beyond
+// which the offloadable requests are handled on the event loop.
+constexpr size_t MAX_OFFLOADED_REQUESTS_PER_WORKER = 4;
 
 using namespace pldm;
 using namespace sdeventplus;
@@ -68,6 +79,7 @@ using namespace pldm::responder;
 using namespace pldm::utils;
 using sdeventplus::source::Signal;
 using namespace pldm::flightrecorder;
+using pldm::transport::Transport;
 
 void interruptFlightRecorderCallBack(Signal& /*signal*/,
                                      const struct signalfd_siginfo*)
@@ -79,18 +91,17 @@ void interruptFlightRecorderCallBack(Signal& /*signal*/,
 }
 
 static std::optional<Response>
-    processRxMsg(const std::vector<uint8_t>& requestMsg, Invoker& invoker,
-                 requester::Handler<requester::Request>& handler)
+    processRxMsg(const transport::Message& requestMsg, Invoker& invoker,
+                 requester::Handler<requester::Request>& handler,
+                 fw_update::UpdateManager& fwUpdateManager)
 {
-    using type = uint8_t;
-    uint8_t eid = requestMsg[0];
+    mctp_eid_t eid = requestMsg.eid;
 
     pldm_header_info hdrFields{};
-    auto hdr = reinterpret_cast<const pldm_msg_hdr*>(
-        requestMsg.data() + sizeof(eid) + sizeof(type));
+    auto hdr = reinterpret_cast<const pldm_msg_hdr*>(requestMsg.pldm.data());
     if (PLDM_SUCCESS != unpack_pldm_header(hdr, &hdrFields))
     {
-        std::cerr << "Empty PLDM request header \n";
+        logging::error("Empty PLDM request header");
         return std::nullopt;
     }
 
@@ -98,12 +109,23 @@ static std::optional<Response>
     {
         Response response;
         auto request = reinterpret_cast<const pldm_msg*>(hdr);
-        size_t requestLen = requestMsg.size() - sizeof(struct pldm_msg_hdr) -
-                            sizeof(eid) - sizeof(type);
+        size_t requestLen =
+            requestMsg.pldm.size() - sizeof(struct pldm_msg_hdr);
         try
         {
-            response = invoker.handle(hdrFields.pldm_type, hdrFields.command,
-                                      request, requestLen);
+            // The firmware update requests are tied to the FD being updated,
+            // so they are routed with the EID to the update agent.
+            if (hdrFields.pldm_type == PLDM_FWUP)
+            {
+                response = fwUpdateManager.handleRequest(
+                    eid, hdrFields.command, request, requestLen);
+            }
+            else
+            {
+                response = invoker.handle(hdrFields.pldm_type,
+                                          hdrFields.command, request,
+                                          requestLen);
+            }
         }
         catch (const std::out_of_range& e)
         {
@@ -117,7 +139,7 @@ static std::optional<Response>
             header.command = hdrFields.command;
             if (PLDM_SUCCESS != pack_pldm_header(&header, responseHdr))
             {
-                std::cerr << "Failed adding response header \n";
+                logging::error("Failed adding response header");
                 return std::nullopt;
             }
             response.insert(response.end(), completion_code);
@@ -127,76 +149,175 @@ static std::optional<Response>
     else if (PLDM_RESPONSE == hdrFields.msg_type)
     {
         auto response = reinterpret_cast<const pldm_msg*>(hdr);
-        size_t responseLen = requestMsg.size() - sizeof(struct pldm_msg_hdr) -
-                             sizeof(eid) - sizeof(type);
+        size_t responseLen =
+            requestMsg.pldm.size() - sizeof(struct pldm_msg_hdr);
         handler.handleResponse(eid, hdrFields.instance, hdrFields.pldm_type,
                                hdrFields.command, response, responseLen);
     }
     return std::nullopt;
 }
 
+/** @brief Hand a request to the worker pool if its command handler is
+ *         offloadable
+ *
+ *  @param[in] requestMsg - the request, moved to the worker pool if offloaded
+ *  @param[in] invoker - PLDM command handlers
+ *  @param[in] workerPool - worker pool
+ *  @param[in] completion - called from the event loop with the response
+ *
+ *  @return true if the request is offloaded, false if it has to be processed
+ *          on the event loop
+ */
+static bool offloadRxMsg(transport::Message& requestMsg, Invoker& invoker,
+                         WorkerPool& workerPool,
+                         WorkerPool::Completion completion)
+{
+    if (workerPool.busy())
+    {
+        return false;
+    }
+
+    pldm_header_info hdrFields{};
+    auto hdr = reinterpret_cast<const pldm_msg_hdr*>(requestMsg.pldm.data());
+    if (PLDM_SUCCESS != unpack_pldm_header(hdr, &hdrFields) ||
+        PLDM_RESPONSE == hdrFields.msg_type ||
+        !invoker.isOffloadable(hdrFields.pldm_type, hdrFields.command))
+    {
+        return false;
+    }
+
+    workerPool.submit(
+        [&invoker, requestMsg = std::move(requestMsg.pldm), hdrFields]() {
+            auto request = reinterpret_cast<const pldm_msg*>(requestMsg.data());
+            size_t requestLen = requestMsg.size() - sizeof(struct pldm_msg_hdr);
+            return invoker.handle(hdrFields.pldm_type, hdrFields.command,
+                                  request, requestLen);
+        },
+        std::move(completion));
+    return true;
+}
+
+/** @brief Send a response to the endpoint the request came from
+ *
+ *  @param[in] transport - MCTP transport
+ *  @param[in] eid - endpoint ID the request came from
+ *  @param[in] tag - message tag of the request
+ *  @param[in] response - PLDM response message
+ *  @param[in] verbose - print the response
+ */
+static void sendResponse(Transport& transport, mctp_eid_t eid, uint8_t tag,
+                         Response&& response, bool verbose)
+{
+    FlightRecorder::GetInstance().saveRecord(response, true);
+    if (verbose)
+    {
+        printBuffer(Tx, response);
+    }
+
+    auto rc = transport.sendResponse(eid, tag, std::move(response));
+    if (rc < 0)
+    {
+        logging::error("Failed to send the response, RC= ", rc);
+    }
+}
+
 void optionUsage(void)
 {
     std::cerr << "Usage: pldmd [options]\n";
     std::cerr << "Options:\n";
     std::cerr
         << "  --verbose=<0/1>  0 - Disable verbosity, 1 - Enable verbosity\n";
-    std::cerr << "Defaulted settings:  --verbose=0 \n";
+    std::cerr << "  --workers=<n>    Number of threads for the offloadable "
+                 "command handlers, 0 - Handle all the commands on the event "
+                 "loop\n";
+    std::cerr << "  --transport=<mctp-demux/af-mctp>  MCTP transport, "
+                 "mctp-demux - through the mctp-demux daemon, af-mctp - "
+                 "kernel AF_MCTP socket\n";
+    std::cerr << "Defaulted settings:  --verbose=0 --workers=0 "
+                 "--transport=mctp-demux \n";
 }
 
 int main(int argc, char** argv)
 {
 
     bool verbose = false;
+    size_t workers = 0;
+    auto transportType = transport::Type::MctpDemux;
     static struct option long_options[] = {
-        {"verbose", required_argument, 0, 'v'}, {0, 0, 0, 0}};
-
-    auto argflag = getopt_long(argc, argv, "v:", long_options, nullptr);
-    switch (argflag)
+        {"verbose", required_argument, 0, 'v'},
+        {"workers", required_argument, 0, 'w'},
+        {"transport", required_argument, 0, 't'},
+        {0, 0, 0, 0}};
+
+    int argflag;
+    while ((argflag = getopt_long(argc, argv, "v:w:t:", long_options,
+                                  nullptr)) != -1)
     {
-        case 'v':
-            switch (std::stoi(optarg))
+        switch (argflag)
+        {
+            case 'v':
+                switch (std::stoi(optarg))
+                {
+                    case 0:
+                        verbose = false;
+                        break;
+                    case 1:
+                        verbose = true;
+                        break;
+                    default:
+                        optionUsage();
+                        exit(EXIT_FAILURE);
+                }
+                break;
+            case 'w':
+            {
+                auto value = std::stoi(optarg);
+                if (value < 0)
+                {
+                    optionUsage();
+                    exit(EXIT_FAILURE);
+                }
+                workers = value;
+                break;
+            }
+            case 't':
             {
-                case 0:
-                    verbose = false;
-                    break;
-                case 1:
-                    verbose = true;
-                    break;
-                default:
+                auto type = transport::toType(optarg);
+                // The loopback transport is only for the tests
+                if (!type || *type == transport::Type::Loopback)
+                {
                     optionUsage();
                     exit(EXIT_FAILURE);
+                }
+                transportType = *type;
+                break;
             }
-            break;
-        case -1:
-            break;
-        default:
-            exit(EXIT_FAILURE);
+            default:
+                exit(EXIT_FAILURE);
+        }
     }
 
-    /* Create local socket. */
     int returnCode = 0;
-    int sockfd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
-    if (-1 == sockfd)
+    std::unique_ptr<Transport> mctpTransport;
+    try
     {
-        returnCode = -errno;
-        std::cerr << "Failed to create the socket, RC= " << returnCode << "\n";
-        exit(EXIT_FAILURE);
+        if (transportType == transport::Type::AfMctp)
+        {
+            mctpTransport = std::make_unique<transport::AfMctp>(true);
+        }
+        else
+        {
+            mctpTransport = std::make_unique<transport::MctpDemux>();
+        }
     }
-    socklen_t optlen;
-    int currentSendbuffSize;
-
-    // Get Current send buffer size
-    optlen = sizeof(currentSendbuffSize);
-
-    int res = getsockopt(sockfd, SOL_SOCKET, SO_SNDBUF, &currentSendbuffSize,
-                         &optlen);
-    if (res == -1)
+    catch (const std::system_error& e)
     {
-        std::cerr << "Error calling setsockopt. RC = " << res
-                  << ", errno = " << errno << std::endl;
+        std::cerr << e.what() << ", RC= " << -e.code().value() << "\n";
+        exit(EXIT_FAILURE);
     }
+    int sockfd = mctpTransport->getFd();
     auto event = Event::get_default();
+    logging::getLogger().attach(event);
     auto& bus = pldm::utils::DBusHandler::getBus();
     sdbusplus::server::manager::manager objManager(
         bus, "/xyz/openbmc_project/software");
@@ -209,8 +330,13 @@ int main(int argc, char** argv)
     dbus_api::Requester dbusImplReq(bus, "/xyz/openbmc_project/pldm");
 
     Invoker invoker{};
-    requester::Handler<requester::Request> reqHandler(
-        sockfd, event, dbusImplReq, currentSendbuffSize, verbose);
+    requester::Handler<requester::Request> reqHandler(*mctpTransport, event,
+                                                      dbusImplReq, verbose);
+    fw_update::InventoryManager fwInventoryManager(dbusImplReq, reqHandler);
+    fw_update::UpdateManager fwUpdateManager(event, dbusImplReq, reqHandler,
+                                             MAXIMUM_TRANSFER_SIZE);
+    platform_mc::TerminusManager terminusManager(event, dbusImplReq,
+                                                 reqHandler, BMC_EID);
 
 #ifdef LIBPLDMRESPONDER
     using namespace pldm::state_sensor;
@@ -268,7 +394,7 @@ int main(int argc, char** argv)
         hostEffecterParser =
             std::make_unique<pldm::host_effecters::HostEffecterParser>(
                 &dbusImplReq, sockfd, pdrRepo.get(), &dbusHandler,
-                HOST_JSONS_DIR, &reqHandler);
+                HOST_JSONS_DIR, &reqHandler, event);
         hostPDRHandler = std::make_shared<HostPDRHandler>(
             sockfd, hostEID, event, pdrRepo.get(), EVENTS_JSONS_DIR,
             entityTree.get(), bmcEntityTree.get(), hostEffecterParser.get(),
@@ -319,50 +445,63 @@ int main(int argc, char** argv)
 
 #endif
 
-    pldm::utils::CustomFD socketFd(sockfd);
-
-    struct sockaddr_un addr
-    {};
-    addr.sun_family = AF_UNIX;
-    const char path[] = "\0mctp-mux";
-    memcpy(addr.sun_path, path, sizeof(path) - 1);
-    int result = connect(socketFd(), reinterpret_cast<struct sockaddr*>(&addr),
-                         sizeof(path) + sizeof(addr.sun_family) - 1);
-    if (-1 == result)
+    std::vector<mctp_eid_t> unmanagedEids{BMC_EID};
+#ifdef LIBPLDMRESPONDER
+    // The host is managed by the host PDR handler
+    unmanagedEids.push_back(hostEID);
+#endif
+    platform_mc::MctpDiscovery mctpDiscovery(
+        pldm::utils::DBusHandler(), std::move(unmanagedEids),
+        [&terminusManager,
+         &fwInventoryManager](const std::vector<mctp_eid_t>& eids) {
+            terminusManager.discover(eids);
+            fwInventoryManager.discover(eids);
+        },
+        [&terminusManager,
+         &fwInventoryManager](const std::vector<mctp_eid_t>& eids) {
+            terminusManager.remove(eids);
+            fwInventoryManager.remove(eids);
+        });
+
+    // A package written to the package directory updates the firmware
+    // devices it matches
+    std::unique_ptr<fw_update::Watch> fwPackageWatch;
+    try
     {
-        returnCode = -errno;
-        std::cerr << "Failed to connect to the socket, RC= " << returnCode
-                  << "\n";
-        exit(EXIT_FAILURE);
+        fwPackageWatch = std::make_unique<fw_update::Watch>(
+            event, FW_UPDATE_PACKAGE_DIR,
+            [&fwUpdateManager,
+             &fwInventoryManager](const std::filesystem::path& path) {
+                fwUpdateManager.processPackage(
+                    path, fwInventoryManager.getDescriptorMap());
+            });
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Failed to watch the firmware update packages, ERROR="
+                  << e.what() << "\n";
     }
 
-    result = write(socketFd(), &MCTP_MSG_TYPE_PLDM, sizeof(MCTP_MSG_TYPE_PLDM));
-    if (-1 == result)
+    // Offloaded command handlers run on the worker pool, it is created once
+    // all the handlers are registered and is stopped before they go away.
+    std::unique_ptr<WorkerPool> workerPool;
+    if (workers)
     {
-        returnCode = -errno;
-        std::cerr << "Failed to send message type as pldm to mctp, RC= "
-                  << returnCode << "\n";
-        exit(EXIT_FAILURE);
+        workerPool = std::make_unique<WorkerPool>(
+            event, workers, workers * MAX_OFFLOADED_REQUESTS_PER_WORKER);
     }
 
-    auto callback = [verbose, &invoker, &reqHandler, currentSendbuffSize](
-                        IO& io, int fd, uint32_t revents) mutable {
+    auto callback = [verbose, &invoker, &reqHandler, &fwUpdateManager,
+                     &workerPool, &mctpTransport](IO& io, int /*fd*/,
+                                                  uint32_t revents) {
         if (!(revents & EPOLLIN))
         {
             return;
         }
 
-        // Outgoing message.
-        struct iovec iov[2]{};
-
-        // This structure contains the parameter information for the response
-        // message.
-        struct msghdr msg
-        {};
-
-        int returnCode = 0;
-        ssize_t peekedLength = recv(fd, nullptr, 0, MSG_PEEK | MSG_TRUNC);
-        if (0 == peekedLength)
+        transport::Message requestMsg{};
+        int returnCode = mctpTransport->recv(requestMsg);
+        if (-EPIPE == returnCode)
         {
             // MCTP daemon has closed the socket this daemon is connected to.
             // This may or may not be an error scenario, in either case the
@@ -371,89 +510,48 @@ int main(int argc, char** argv)
             // failure code.
             io.get_event().exit(0);
         }
-        else if (peekedLength <= -1)
+        else if (-EBADMSG == returnCode)
         {
-            returnCode = -errno;
-            std::cerr << "recv system call failed, RC= " << returnCode << "\n";
+            // Skip this message and continue.
+            logging::warning("Encountered Non-PLDM type message");
+        }
+        else if (returnCode < 0)
+        {
+            logging::error("Failed to receive the message, RC= ", returnCode);
         }
         else
         {
-            std::vector<uint8_t> requestMsg(peekedLength);
-            auto recvDataLength = recv(
-                fd, static_cast<void*>(requestMsg.data()), peekedLength, 0);
-            if (recvDataLength == peekedLength)
+            FlightRecorder::GetInstance().saveRecord(requestMsg.pldm, false);
+            if (verbose)
             {
-                FlightRecorder::GetInstance().saveRecord(requestMsg, false);
-                if (verbose)
-                {
-                    printBuffer(Rx, requestMsg);
-                }
+                printBuffer(Rx, requestMsg.pldm);
+            }
 
-                if (MCTP_MSG_TYPE_PLDM != requestMsg[1])
-                {
-                    // Skip this message and continue.
-                    std::cerr << "Encountered Non-PLDM type message"
-                              << "\n";
-                }
-                else
+            auto send = [&mctpTransport, eid = requestMsg.eid,
+                         tag = requestMsg.tag, verbose](Response&& response) {
+                sendResponse(*mctpTransport, eid, tag, std::move(response),
+                             verbose);
+            };
+
+            // An offloaded request is answered once the worker pool is done
+            // with it, the others are processed here.
+            if (!workerPool ||
+                !offloadRxMsg(requestMsg, invoker, *workerPool, send))
+            {
+                // process message and send response
+                auto response = processRxMsg(requestMsg, invoker, reqHandler,
+                                             fwUpdateManager);
+                if (response.has_value())
                 {
-                    // process message and send response
-                    auto response =
-                        processRxMsg(requestMsg, invoker, reqHandler);
-                    if (response.has_value())
-                    {
-                        FlightRecorder::GetInstance().saveRecord(*response,
-                                                                 true);
-                        if (verbose)
-                        {
-                            printBuffer(Tx, *response);
-                        }
-
-                        iov[0].iov_base = &requestMsg[0];
-                        iov[0].iov_len =
-                            sizeof(requestMsg[0]) + sizeof(requestMsg[1]);
-                        iov[1].iov_base = (*response).data();
-                        iov[1].iov_len = (*response).size();
-
-                        msg.msg_iov = iov;
-                        msg.msg_iovlen = sizeof(iov) / sizeof(iov[0]);
-                        if (currentSendbuffSize >= 0 &&
-                            (size_t)currentSendbuffSize < (*response).size())
-                        {
-                            currentSendbuffSize = (*response).size();
-                            int res = setsockopt(fd, SOL_SOCKET, SO_SNDBUF,
-                                                 &currentSendbuffSize,
-                                                 sizeof(currentSendbuffSize));
-                            if (res == -1)
-                                std::cerr
-                                    << "Tx: Error calling setsockopt. RC = "
-                                    << res << ", errno = " << errno
-                                    << std::endl;
-                        }
-
-                        int result = sendmsg(fd, &msg, 0);
-                        if (-1 == result)
-                        {
-                            returnCode = -errno;
-                            std::cerr << "sendto system call failed, RC= "
-                                      << returnCode << "\n";
-                        }
-                    }
+                    send(std::move(*response));
                 }
             }
-            else
-            {
-                std::cerr
-                    << "Failure to read peeked length packet. peekedLength= "
-                    << peekedLength << " recvDataLength=" << recvDataLength
-                    << "\n";
-            }
         }
     };
 
     bus.attach_event(event.get(), SD_EVENT_PRIORITY_NORMAL);
     bus.request_name("xyz.openbmc_project.PLDM");
-    IO io(event, socketFd(), EPOLLIN, std::move(callback));
+    IO io(event, sockfd, EPOLLIN, std::move(callback));
 #ifdef LIBPLDMRESPONDER
     if (hostPDRHandler)
     {
@@ -0,0 +1,133 @@
+#include "worker_pool.hpp"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <iostream>
+#include <system_error>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+WorkerPool::WorkerPool(sdeventplus::Event& event, size_t workers,
+                       size_t maxPending) :
+    maxPending(maxPending)
+{
+    eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventFd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Failed to create the worker pool eventfd");
+    }
+    io = std::make_unique<sdeventplus::source::IO>(
+        event, eventFd, EPOLLIN,
+        [this](sdeventplus::source::IO&, int, uint32_t) {
+            processCompletions();
+        });
+
+    threads.reserve(workers);
+    for (size_t i = 0; i < workers; ++i)
+    {
+        threads.emplace_back(&WorkerPool::run, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    io.reset();
+    close(eventFd);
+}
+
+void WorkerPool::submit(Job job, Completion completion)
+{
+    ++pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.emplace_back(std::move(job), std::move(completion));
+    }
+    cv.notify_one();
+}
+
+void WorkerPool::run()
+{
+    while (true)
+    {
+        std::pair<Job, Completion> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping)
+            {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        Response response;
+        try
+        {
+            response = job.first();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Offloaded PLDM command handler failed, ERROR="
+                      << e.what() << "\n";
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.emplace_back(std::move(job.second), std::move(response));
+        }
+        uint64_t one = 1;
+        if (write(eventFd, &one, sizeof(one)) != sizeof(one))
+        {
+            std::cerr << "Failed to signal the worker pool eventfd, ERRNO="
+                      << errno << "\n";
+        }
+    }
+}
+
+void WorkerPool::processCompletions()
+{
+    uint64_t count = 0;
+    if (read(eventFd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+    {
+        std::cerr << "Failed to read the worker pool eventfd, ERRNO=" << errno
+                  << "\n";
+    }
+
+    std::deque<std::pair<Completion, Response>> finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.swap(done);
+    }
+    for (auto& [completion, response] : finished)
+    {
+        --pending;
+        // A handler that failed has no response, the requester times out
+        // as it would have if the daemon had failed to send it.
+        if (!response.empty())
+        {
+            completion(std::move(response));
+        }
+    }
+}
+
+} // namespace responder
+
+} // namespace pldm
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "handler.hpp"
+
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+/** @class WorkerPool
+ *
+ *  @brief Bounded pool of threads to run the offloadable command handlers
+ *
+ *  A job runs on one of the worker threads and produces a PLDM response. The
+ *  finished jobs are posted back to the event loop through an eventfd, where
+ *  their completion is called in the order the jobs finished, so a slow
+ *  handler does not hold up the responses of the requests received after it.
+ *
+ *  Jobs are only submitted from the event loop, and must not touch state
+ *  owned by the event loop without locking it.
+ */
+class WorkerPool
+{
+  public:
+    using Job = std::function<Response()>;
+    using Completion = std::function<void(Response&& response)>;
+
+    WorkerPool() = delete;
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+
+    /** @brief Constructor
+     *
+     *  @param[in] event - event loop the completions are called from
+     *  @param[in] workers - number of worker threads
+     *  @param[in] maxPending - maximum number of jobs queued or running
+     */
+    WorkerPool(sdeventplus::Event& event, size_t workers, size_t maxPending);
+
+    /** @brief Stop the worker threads, the jobs not started are dropped and
+     *         the completions not yet called are not called
+     */
+    ~WorkerPool();
+
+    /** @brief Check if the pool can't take another job */
+    bool busy() const
+    {
+        return pending >= maxPending;
+    }
+
+    /** @brief Get the number of jobs queued, running or waiting for their
+     *         completion to be called
+     */
+    size_t getPending() const
+    {
+        return pending;
+    }
+
+    /** @brief Queue a job, the pool must not be busy
+     *
+     *  @param[in] job - the job, run on a worker thread
+     *  @param[in] completion - called from the event loop with the response
+     *                          of the job
+     */
+    void submit(Job job, Completion completion);
+
+  private:
+    /** @brief Run the jobs, until the pool is stopped */
+    void run();
+
+    /** @brief Call the completions of the finished jobs, in the event loop */
+    void processCompletions();
+
+    const size_t maxPending;
+
+    /** @brief Jobs queued or running, and completions not yet called; only
+     *         accessed from the event loop
+     */
+    size_t pending = 0;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+    std::deque<std::pair<Job, Completion>> jobs;
+    std::deque<std::pair<Completion, Response>> done;
+
+    int eventFd = -1;
+    std::unique_ptr<sdeventplus::source::IO> io;
+    std::vector<std::thread> threads;
+};
+
+} // namespace responder
+
+} // namespace pldm
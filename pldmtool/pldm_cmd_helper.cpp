@@ -199,9 +199,13 @@ int CommandInterface::pldmSendRecv(std::vector<uint8_t>& requestMsg,
         printBuffer(Tx, requestMsg);
     }
 
-    if (mctp_eid != PLDM_ENTITY_ID)
+    // The kernel routes the messages to any endpoint, including the local
+    // one, the mctp-demux daemon loops back the messages to the local
+    // endpoint.
+    bool afMctp = (transport == "af-mctp");
+    if (afMctp || mctp_eid != PLDM_ENTITY_ID)
     {
-        int fd = pldm_open();
+        int fd = afMctp ? pldm_open_af_mctp() : pldm_open();
         if (-1 == fd)
         {
             std::cerr << "failed to init mctp "
@@ -18,6 +18,7 @@
 #include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <string>
 #include <utility>
 
 namespace pldmtool
@@ -82,9 +83,12 @@ class CommandInterface
                               CLI::App* app) :
         pldmType(type),
         commandName(name), mctp_eid(PLDM_ENTITY_ID), pldmVerbose(false),
-        instanceId(0)
+        transport("mctp-demux"), instanceId(0)
     {
         app->add_option("-m,--mctp_eid", mctp_eid, "MCTP endpoint ID");
+        app->add_option("-t,--transport", transport,
+                        "MCTP transport, mctp-demux or af-mctp")
+            ->check(CLI::IsMember({"mctp-demux", "af-mctp"}));
         app->add_flag("-v, --verbose", pldmVerbose);
         app->callback([&]() { exec(); });
     }
@@ -106,6 +110,7 @@ class CommandInterface
     const std::string commandName;
     uint8_t mctp_eid;
     bool pldmVerbose;
+    std::string transport;
 
   protected:
     uint8_t instanceId;
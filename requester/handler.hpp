@@ -5,22 +5,23 @@
 #include "libpldm/base.h"
 #include "libpldm/requester/pldm.h"
 
+#include "common/logger.hpp"
 #include "common/types.hpp"
 #include "pldmd/dbus_impl_requester.hpp"
+#include "pldmd/instance_id.hpp"
+#include "prepared_request.hpp"
 #include "request.hpp"
 
-#include <sys/socket.h>
-
 #include <function2/function2.hpp>
 #include <sdbusplus/timer.hpp>
 #include <sdeventplus/event.hpp>
 #include <sdeventplus/source/event.hpp>
 
-#include <cassert>
+#include <array>
 #include <chrono>
 #include <memory>
-#include <tuple>
 #include <unordered_map>
+#include <vector>
 
 namespace pldm
 {
@@ -28,40 +29,6 @@ namespace pldm
 namespace requester
 {
 
-/** @struct RequestKey
- *
- *  RequestKey uniquely identifies the PLDM request message to match it with the
- *  response and a combination of MCTP endpoint ID, PLDM instance ID, PLDM type
- *  and PLDM command is the key.
- */
-struct RequestKey
-{
-    mctp_eid_t eid;     //!< MCTP endpoint ID
-    uint8_t instanceId; //!< PLDM instance ID
-    uint8_t type;       //!< PLDM type
-    uint8_t command;    //!< PLDM command
-
-    bool operator==(const RequestKey& e) const
-    {
-        return ((eid == e.eid) && (instanceId == e.instanceId) &&
-                (type == e.type) && (command == e.command));
-    }
-};
-
-/** @struct RequestKeyHasher
- *
- *  This is a simple hash function, since the instance ID generator API
- *  generates unique instance IDs for MCTP endpoint ID.
- */
-struct RequestKeyHasher
-{
-    std::size_t operator()(const RequestKey& key) const
-    {
-        return (key.eid << 24 | key.instanceId << 16 | key.type << 8 |
-                key.command);
-    }
-};
-
 using ResponseHandler = fu2::unique_function<void(
     mctp_eid_t eid, const pldm_msg* response, size_t respMsgLen)>;
 
@@ -74,6 +41,10 @@ using ResponseHandler = fu2::unique_function<void(
  *  received within the instance ID expiration interval or any other failure the
  *  response handler is invoked with the empty response.
  *
+ *  A request in flight is held in a slot of its endpoint, indexed by the
+ *  instance ID. The slots keep their request object and timers once created,
+ *  so that registering a request in the steady state allocates nothing.
+ *
  * @tparam RequestInterface - Request class type
  */
 template <class RequestInterface>
@@ -90,7 +61,7 @@ class Handler
 
     /** @brief Constructor
      *
-     *  @param[in] fd - fd of MCTP communications socket
+     *  @param[in] transport - MCTP transport the requests are sent on
      *  @param[in] event - reference to PLDM daemon's main event loop
      *  @param[in] requester - reference to Requester object
      *  @param[in] verbose - verbose tracing flag
@@ -99,16 +70,15 @@ class Handler
      *  @param[in] responseTimeOut - time to wait between each retry
      */
     explicit Handler(
-        int fd, sdeventplus::Event& event, pldm::dbus_api::Requester& requester,
-        int currentSendbuffSize, bool verbose,
+        pldm::transport::Transport& transport, sdeventplus::Event& event,
+        pldm::dbus_api::Requester& requester, bool verbose,
         std::chrono::seconds instanceIdExpiryInterval =
             std::chrono::seconds(INSTANCE_ID_EXPIRATION_INTERVAL),
         uint8_t numRetries = static_cast<uint8_t>(NUMBER_OF_REQUEST_RETRIES),
         std::chrono::milliseconds responseTimeOut =
             std::chrono::milliseconds(RESPONSE_TIME_OUT)) :
-        fd(fd),
-        event(event), requester(requester),
-        currentSendbuffSize(currentSendbuffSize), verbose(verbose),
+        transport(transport),
+        event(event), requester(requester), verbose(verbose),
         instanceIdExpiryInterval(instanceIdExpiryInterval),
         numRetries(numRetries), responseTimeOut(responseTimeOut)
     {}
@@ -128,76 +98,83 @@ class Handler
                         uint8_t command, pldm::Request&& requestMsg,
                         ResponseHandler&& responseHandler)
     {
-        RequestKey key{eid, instanceId, type, command};
+        auto slot = getSlot(eid, instanceId);
+        if (!slot)
+        {
+            return PLDM_ERROR;
+        }
+        slot->request->getRequestMsg() = std::move(requestMsg);
+        return startRequest(eid, instanceId, type, command, *slot,
+                            std::move(responseHandler));
+    }
 
-        auto instanceIdExpiryCallBack = [key, this](void) {
-            if (this->handlers.contains(key))
-            {
-                std::cerr << "Response not received for the request, instance "
-                             "ID expired."
-                          << " EID = " << (unsigned)key.eid
-                          << " INSTANCE_ID = " << (unsigned)key.instanceId
-                          << " TYPE = " << (unsigned)key.type
-                          << " COMMAND = " << (unsigned)key.command << "\n";
-                auto& [request, responseHandler, timerInstance] =
-                    this->handlers[key];
-                request->stop();
-                auto rc = timerInstance->stop();
-                if (rc)
-                {
-                    std::cerr
-                        << "Failed to stop the instance ID expiry timer. RC = "
-                        << rc << "\n";
-                }
-                // Call response handler with an empty response to indicate no
-                // response
-                responseHandler(key.eid, nullptr, 0);
-                this->removeRequestContainer.emplace(
-                    key, std::make_unique<sdeventplus::source::Defer>(
-                             event, std::bind(&Handler::removeRequestEntry,
-                                              this, key)));
-            }
-            else
-            {
-                // This condition is not possible, if a response is received
-                // before the instance ID expiry, then the response handler
-                // is executed and the entry will be removed.
-                assert(false);
-            }
-        };
+    /** @brief Register a PLDM request message from a prepared request, the
+     *         message is copied into the buffer of the slot
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *  @param[in] instanceId - instance ID to match request and response
+     *  @param[in] prepared - the prepared request message
+     *  @param[in] responseHandler - Response handler for this request
+     *
+     *  @return return PLDM_SUCCESS on success and PLDM_ERROR otherwise
+     */
+    int registerRequest(mctp_eid_t eid, uint8_t instanceId,
+                        const PreparedRequest& prepared,
+                        ResponseHandler&& responseHandler)
+    {
+        auto slot = getSlot(eid, instanceId);
+        if (!slot)
+        {
+            return PLDM_ERROR;
+        }
+        prepared.copyTo(instanceId, slot->request->getRequestMsg());
+        return startRequest(eid, instanceId, prepared.getType(),
+                            prepared.getCommand(), *slot,
+                            std::move(responseHandler));
+    }
 
-        auto request = std::make_unique<RequestInterface>(
-            fd, eid, event, std::move(requestMsg), numRetries, responseTimeOut,
-            currentSendbuffSize, verbose);
-        auto timer = std::make_unique<phosphor::Timer>(
-            event.get(), instanceIdExpiryCallBack);
+    /** @brief Create the request slots of an endpoint up front
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     */
+    void reserveSlots(mctp_eid_t eid)
+    {
+        for (uint8_t instanceId = 0; instanceId < maxInstanceIds; ++instanceId)
+        {
+            getSlot(eid, instanceId);
+        }
+    }
 
-        auto rc = request->start();
-        if (rc)
+    /** @brief Release the request slots of an endpoint that went away. The
+     *         requests in flight are stopped and their response handlers
+     *         invoked with an empty response, as on the instance ID expiry.
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     */
+    void releaseSlots(mctp_eid_t eid)
+    {
+        auto endpoint = slots.find(eid);
+        if (endpoint == slots.end())
         {
-            requester.markFree(eid, instanceId);
-            std::cerr << "Failure to send the PLDM request message"
-                      << "\n";
-            return rc;
+            return;
         }
 
-        try
+        std::vector<ResponseHandler> responseHandlers;
+        for (uint8_t instanceId = 0; instanceId < maxInstanceIds; ++instanceId)
         {
-            timer->start(duration_cast<std::chrono::microseconds>(
-                instanceIdExpiryInterval));
+            auto& slot = endpoint->second[instanceId];
+            if (slot.active)
+            {
+                responseHandlers.emplace_back(releaseSlot(slot));
+                requester.markFree(eid, instanceId);
+            }
         }
-        catch (const std::runtime_error& e)
+        // The handlers may send new requests to the endpoint
+        slots.erase(endpoint);
+        for (auto& responseHandler : responseHandlers)
         {
-            requester.markFree(eid, instanceId);
-            std::cerr << "Failed to start the instance ID expiry timer. RC = "
-                      << e.what() << "\n";
-            return PLDM_ERROR;
+            responseHandler(eid, nullptr, 0);
         }
-
-        handlers.emplace(key, std::make_tuple(std::move(request),
-                                              std::move(responseHandler),
-                                              std::move(timer)));
-        return rc;
     }
 
     /** @brief Handle PLDM response message
@@ -213,37 +190,27 @@ class Handler
                         uint8_t command, const pldm_msg* response,
                         size_t respMsgLen)
     {
-        RequestKey key{eid, instanceId, type, command};
-        if (handlers.contains(key))
+        auto endpoint = slots.find(eid);
+        if (endpoint != slots.end() && instanceId < maxInstanceIds)
         {
-            auto& [request, responseHandler, timerInstance] = handlers[key];
-            request->stop();
-            auto rc = timerInstance->stop();
-            if (rc)
+            auto& slot = endpoint->second[instanceId];
+            if (slot.active && slot.type == type && slot.command == command)
             {
-                std::cerr
-                    << "Failed to stop the instance ID expiry timer. RC = "
-                    << rc << "\n";
+                auto responseHandler = releaseSlot(slot);
+                responseHandler(eid, response, respMsgLen);
             }
-            responseHandler(eid, response, respMsgLen);
-            requester.markFree(key.eid, key.instanceId);
-            handlers.erase(key);
-        }
-        else
-        {
-            // Got a response for a PLDM request message not registered with the
-            // request handler, so freeing up the instance ID, this can be other
-            // OpenBMC applications relying on PLDM D-Bus apis like
-            // openpower-occ-control and softoff
-            requester.markFree(key.eid, key.instanceId);
         }
+        // A response for a PLDM request message not registered with the
+        // request handler frees up the instance ID as well, this can be other
+        // OpenBMC applications relying on PLDM D-Bus apis like
+        // openpower-occ-control and softoff
+        requester.markFree(eid, instanceId);
     }
 
   private:
-    int fd; //!< file descriptor of MCTP communications socket
+    pldm::transport::Transport& transport; //!< MCTP transport
     sdeventplus::Event& event; //!< reference to PLDM daemon's main event loop
     pldm::dbus_api::Requester& requester; //!< reference to Requester object
-    int currentSendbuffSize;              //!< current Send Buffer size
     bool verbose;                         //!< verbose tracing flag
     std::chrono::seconds
         instanceIdExpiryInterval; //!< Instance ID expiration interval
@@ -251,37 +218,143 @@ class Handler
     std::chrono::milliseconds
         responseTimeOut; //!< time to wait between each retry
 
-    /** @brief Container for storing the details of the PLDM request
-     *         message, handler for the corresponding PLDM response and the
-     *         timer object for the Instance ID expiration
+    /** @struct RequestSlot
+     *
+     *  The PLDM request message in flight with an instance ID, the handler for
+     *  the corresponding PLDM response and the timer for the Instance ID
+     *  expiration
      */
-    using RequestValue =
-        std::tuple<std::unique_ptr<RequestInterface>, ResponseHandler,
-                   std::unique_ptr<phosphor::Timer>>;
+    struct RequestSlot
+    {
+        std::unique_ptr<RequestInterface> request; //!< request, with retries
+        ResponseHandler responseHandler;          //!< response handler
+        std::unique_ptr<phosphor::Timer> timer;   //!< instance ID expiry timer
+        uint8_t type = 0;                         //!< PLDM type
+        uint8_t command = 0;                      //!< PLDM command
+        bool active = false; //!< whether the request is in flight
+    };
 
-    /** @brief Container for storing the PLDM request entries */
-    std::unordered_map<RequestKey, RequestValue, RequestKeyHasher> handlers;
+    /** @brief The request slots of the endpoints */
+    std::unordered_map<mctp_eid_t, std::array<RequestSlot, maxInstanceIds>>
+        slots;
 
-    /** @brief Container to store information about the request entries to be
-     *         removed after the instance ID timer expires
+    /** @brief Get the request slot of an instance ID, it is created on first
+     *         use
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *  @param[in] instanceId - instance ID of the request
+     *
+     *  @return the slot, nullptr if it is in use
      */
-    std::unordered_map<RequestKey, std::unique_ptr<sdeventplus::source::Defer>,
-                       RequestKeyHasher>
-        removeRequestContainer;
+    RequestSlot* getSlot(mctp_eid_t eid, uint8_t instanceId)
+    {
+        if (instanceId >= maxInstanceIds)
+        {
+            logging::error("Invalid instance ID for the PLDM request. EID = ",
+                           eid, " INSTANCE_ID = ", instanceId);
+            return nullptr;
+        }
+        auto& slot = slots[eid][instanceId];
+        if (slot.active)
+        {
+            logging::error(
+                "PLDM request already in flight with the instance ID. EID = ",
+                eid, " INSTANCE_ID = ", instanceId);
+            return nullptr;
+        }
+        if (!slot.request)
+        {
+            slot.request = std::make_unique<RequestInterface>(
+                transport, eid, event, pldm::Request{}, numRetries,
+                responseTimeOut, verbose);
+            slot.timer = std::make_unique<phosphor::Timer>(
+                event.get(),
+                std::bind(&Handler::instanceIdExpired, this, eid, instanceId));
+        }
+        return &slot;
+    }
 
-    /** @brief Remove request entry for which the instance ID expired
+    /** @brief Send the request of a slot and arm its timers
      *
-     *  @param[in] key - key for the Request
+     *  @return return PLDM_SUCCESS on success and PLDM_ERROR otherwise
      */
-    void removeRequestEntry(RequestKey key)
+    int startRequest(mctp_eid_t eid, uint8_t instanceId, uint8_t type,
+                     uint8_t command, RequestSlot& slot,
+                     ResponseHandler&& responseHandler)
     {
-        if (removeRequestContainer.contains(key))
+        auto rc = slot.request->start();
+        if (rc)
         {
-            removeRequestContainer[key].reset();
-            requester.markFree(key.eid, key.instanceId);
-            handlers.erase(key);
-            removeRequestContainer.erase(key);
+            requester.markFree(eid, instanceId);
+            logging::error("Failure to send the PLDM request message");
+            return rc;
         }
+
+        try
+        {
+            slot.timer->start(duration_cast<std::chrono::microseconds>(
+                instanceIdExpiryInterval));
+        }
+        catch (const std::runtime_error& e)
+        {
+            slot.request->stop();
+            requester.markFree(eid, instanceId);
+            logging::error("Failed to start the instance ID expiry timer. "
+                           "RC = ",
+                           e.what());
+            return PLDM_ERROR;
+        }
+
+        slot.type = type;
+        slot.command = command;
+        slot.responseHandler = std::move(responseHandler);
+        slot.active = true;
+        return rc;
+    }
+
+    /** @brief Stop the timers of a slot and free it for the next request
+     *
+     *  @param[in] slot - the request slot
+     *
+     *  @return the response handler of the request
+     */
+    ResponseHandler releaseSlot(RequestSlot& slot)
+    {
+        slot.request->stop();
+        auto rc = slot.timer->stop();
+        if (rc)
+        {
+            logging::error("Failed to stop the instance ID expiry timer. RC = ",
+                           rc);
+        }
+        slot.active = false;
+        return std::move(slot.responseHandler);
+    }
+
+    /** @brief Call the response handler with an empty response when the
+     *         instance ID expires, and free the instance ID
+     *
+     *  @param[in] eid - endpoint ID of the remote MCTP endpoint
+     *  @param[in] instanceId - instance ID of the request
+     */
+    void instanceIdExpired(mctp_eid_t eid, uint8_t instanceId)
+    {
+        auto& slot = slots[eid][instanceId];
+        if (!slot.active)
+        {
+            // The response was handled as the timer expired
+            return;
+        }
+        logging::error("Response not received for the request, instance ID "
+                       "expired. EID = ",
+                       eid, " INSTANCE_ID = ", instanceId,
+                       " TYPE = ", slot.type, " COMMAND = ", slot.command);
+
+        // Call response handler with an empty response to indicate no
+        // response
+        auto responseHandler = releaseSlot(slot);
+        responseHandler(eid, nullptr, 0);
+        requester.markFree(eid, instanceId);
     }
 };
 
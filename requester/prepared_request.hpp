@@ -0,0 +1,102 @@
+#pragma once
+
+#include "libpldm/base.h"
+
+#include "common/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace pldm
+{
+
+namespace requester
+{
+
+/** @class PreparedRequest
+ *
+ *  A PLDM request message for a command that is sent over and over. The
+ *  fields that don't change are encoded once, only the instance ID and the
+ *  fields that vary are patched in for each request.
+ */
+class PreparedRequest
+{
+  public:
+    PreparedRequest() = delete;
+
+    /** @brief Constructor
+     *
+     *  @param[in] type - PLDM type
+     *  @param[in] command - PLDM command
+     *  @param[in] payloadLength - length of the request payload
+     */
+    PreparedRequest(uint8_t type, uint8_t command, size_t payloadLength) :
+        type(type), command(command),
+        requestMsg(sizeof(pldm_msg_hdr) + payloadLength)
+    {}
+
+    /** @brief Encode the request message
+     *
+     *  @param[in] encoder - called with an instance ID and the message to
+     *                       encode it into, returns a PLDM completion code
+     *
+     *  @return PLDM completion code of the encoder
+     */
+    template <typename Encoder>
+    int encode(Encoder&& encoder)
+    {
+        return encoder(0, reinterpret_cast<pldm_msg*>(requestMsg.data()));
+    }
+
+    /** @brief Patch an integer field of the payload, PLDM fields are little
+     *         endian
+     *
+     *  @param[in] offset - offset of the field in the payload
+     *  @param[in] value - value of the field
+     */
+    template <typename T>
+    void setField(size_t offset, T value)
+    {
+        static_assert(std::is_integral_v<T>);
+        auto field = requestMsg.data() + sizeof(pldm_msg_hdr) + offset;
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            field[i] = static_cast<uint8_t>(
+                static_cast<std::make_unsigned_t<T>>(value) >> (8 * i));
+        }
+    }
+
+    /** @brief Copy the request message, the buffer copied into is reused
+     *
+     *  @param[in] instanceId - instance ID of the request
+     *  @param[out] request - the request message
+     */
+    void copyTo(uint8_t instanceId, pldm::Request& request) const
+    {
+        request.assign(requestMsg.begin(), requestMsg.end());
+        reinterpret_cast<pldm_msg*>(request.data())->hdr.instance_id =
+            instanceId;
+    }
+
+    /** @brief Get the PLDM type */
+    uint8_t getType() const
+    {
+        return type;
+    }
+
+    /** @brief Get the PLDM command */
+    uint8_t getCommand() const
+    {
+        return command;
+    }
+
+  private:
+    uint8_t type;             //!< PLDM type
+    uint8_t command;          //!< PLDM command
+    pldm::Request requestMsg; //!< the encoded request message
+};
+
+} // namespace requester
+
+} // namespace pldm
@@ -4,11 +4,10 @@
 #include "libpldm/requester/pldm.h"
 
 #include "common/flight_recorder.hpp"
+#include "common/transport.hpp"
 #include "common/types.hpp"
 #include "common/utils.hpp"
 
-#include <sys/socket.h>
-
 #include <sdbusplus/timer.hpp>
 #include <sdeventplus/event.hpp>
 
@@ -53,12 +52,14 @@ class RequestRetryTimer
         timer(event.get(), std::bind_front(&RequestRetryTimer::callback, this))
     {}
 
-    /** @brief Starts the request flow and arms the timer for request retries
+    /** @brief Starts the request flow and arms the timer for request retries,
+     *         a stopped request can be started again
      *
      *  @return return PLDM_SUCCESS on success and PLDM_ERROR otherwise
      */
     int start()
     {
+        retriesLeft = numRetries;
         auto rc = send();
         if (rc)
         {
@@ -97,6 +98,7 @@ class RequestRetryTimer
   protected:
     sdeventplus::Event& event; //!< reference to PLDM daemon's main event loop
     uint8_t numRetries;        //!< number of request retries
+    uint8_t retriesLeft = 0;   //!< number of retries left for the request
     std::chrono::milliseconds
         timeout;           //!< time to wait between each retry in milliseconds
     phosphor::Timer timer; //!< manages starting timers and handling timeouts
@@ -110,7 +112,7 @@ class RequestRetryTimer
     /** @brief Callback function invoked when the timeout happens */
     void callback()
     {
-        if (numRetries--)
+        if (retriesLeft--)
         {
             send();
         }
@@ -124,7 +126,7 @@ class RequestRetryTimer
 /** @class Request
  *
  *  The concrete implementation of RequestIntf. This class implements the send()
- *  to send the PLDM request message over MCTP socket.
+ *  to send the PLDM request message over the MCTP transport.
  *  This class encapsulates the PLDM request message, the number of times the
  *  request needs to retried if the response is not received and the amount of
  *  time to wait between each retry. It provides APIs to start and stop the
@@ -142,7 +144,7 @@ class Request final : public RequestRetryTimer
 
     /** @brief Constructor
      *
-     *  @param[in] fd - fd of the MCTP communication socket
+     *  @param[in] transport - MCTP transport the request is sent on
      *  @param[in] eid - endpoint ID of the remote MCTP endpoint
      *  @param[in] event - reference to PLDM daemon's main event loop
      *  @param[in] requestMsg - PLDM request message
@@ -150,23 +152,32 @@ class Request final : public RequestRetryTimer
      *  @param[in] timeout - time to wait between each retry in milliseconds
      *  @param[in] verbose - verbose tracing flag
      */
-    explicit Request(int fd, mctp_eid_t eid, sdeventplus::Event& event,
-                     pldm::Request&& requestMsg, uint8_t numRetries,
-                     std::chrono::milliseconds timeout,
-                     size_t currentSendbuffSize, bool verbose) :
+    explicit Request(pldm::transport::Transport& transport, mctp_eid_t eid,
+                     sdeventplus::Event& event, pldm::Request&& requestMsg,
+                     uint8_t numRetries, std::chrono::milliseconds timeout,
+                     bool verbose) :
         RequestRetryTimer(event, numRetries, timeout),
-        fd(fd), eid(eid), requestMsg(std::move(requestMsg)),
-        currentSendbuffSize(currentSendbuffSize), verbose(verbose)
+        transport(transport), eid(eid), requestMsg(std::move(requestMsg)),
+        verbose(verbose)
     {}
 
+    /** @brief Get the PLDM request message, the request is sent again with
+     *         the message set here when it is started again
+     *
+     *  @return the PLDM request message
+     */
+    pldm::Request& getRequestMsg()
+    {
+        return requestMsg;
+    }
+
   private:
-    int fd;                   //!< file descriptor of MCTP communications socket
+    pldm::transport::Transport& transport; //!< MCTP transport
     mctp_eid_t eid;           //!< endpoint ID of the remote MCTP endpoint
     pldm::Request requestMsg; //!< PLDM request message
-    mutable int currentSendbuffSize; //!< current Send Buffer size
-    bool verbose;                    //!< verbose tracing flag
+    bool verbose;             //!< verbose tracing flag
 
-    /** @brief Sends the PLDM request message on the socket
+    /** @brief Sends the PLDM request message on the transport
      *
      *  @return return PLDM_SUCCESS on success and PLDM_ERROR otherwise
      */
@@ -178,22 +189,11 @@ class Request final : public RequestRetryTimer
         }
         pldm::flightrecorder::FlightRecorder::GetInstance().saveRecord(
             requestMsg, true);
-        if (currentSendbuffSize >= 0 &&
-            (size_t)currentSendbuffSize < requestMsg.size())
-        {
-            currentSendbuffSize = requestMsg.size();
-            int res =
-                setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &currentSendbuffSize,
-                           sizeof(currentSendbuffSize));
-            if (res == -1)
-                std::cerr << "Requester : Error calling setsockopt. RC = "
-                          << res << ", errno = " << errno << std::endl;
-        }
-        auto rc = pldm_send(eid, fd, requestMsg.data(), requestMsg.size());
+        auto rc =
+            transport.sendRequest(eid, requestMsg.data(), requestMsg.size());
         if (rc < 0)
         {
-            std::cerr << "Failed to send PLDM message. RC = " << rc
-                      << ", errno = " << errno << "\n";
+            std::cerr << "Failed to send PLDM message. RC = " << rc << "\n";
             return PLDM_ERROR;
         }
         return PLDM_SUCCESS;
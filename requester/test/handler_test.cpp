@@ -22,14 +22,14 @@ class HandlerTest : public testing::Test
 {
   protected:
     HandlerTest() :
-        event(sdeventplus::Event::get_default()),
+        event(sdeventplus::Event::get_default()), transport(eid),
         dbusImplReq(pldm::utils::DBusHandler::getBus(),
                     "/xyz/openbmc_project/pldm")
     {}
 
-    int fd = 0;
     mctp_eid_t eid = 0;
     sdeventplus::Event event;
+    pldm::transport::Loopback transport;
     pldm::dbus_api::Requester dbusImplReq;
 
     /** @brief This function runs the sd_event_run in a loop till all the events
@@ -75,7 +75,7 @@ class HandlerTest : public testing::Test
 TEST_F(HandlerTest, singleRequestResponseScenario)
 {
     Handler<NiceMock<MockRequest>> reqHandler(
-        fd, event, dbusImplReq, false, 90000, seconds(1), 2, milliseconds(100));
+        transport, event, dbusImplReq, false, seconds(1), 2, milliseconds(100));
     pldm::Request request{};
     auto instanceId = dbusImplReq.getInstanceId(eid);
     auto rc = reqHandler.registerRequest(
@@ -97,7 +97,7 @@ TEST_F(HandlerTest, singleRequestResponseScenario)
 TEST_F(HandlerTest, singleRequestInstanceIdTimerExpired)
 {
     Handler<NiceMock<MockRequest>> reqHandler(
-        fd, event, dbusImplReq, false, 90000, seconds(1), 2, milliseconds(100));
+        transport, event, dbusImplReq, false, seconds(1), 2, milliseconds(100));
     pldm::Request request{};
     auto instanceId = dbusImplReq.getInstanceId(eid);
     auto rc = reqHandler.registerRequest(
@@ -117,7 +117,7 @@ TEST_F(HandlerTest, singleRequestInstanceIdTimerExpired)
 TEST_F(HandlerTest, multipleRequestResponseScenario)
 {
     Handler<NiceMock<MockRequest>> reqHandler(
-        fd, event, dbusImplReq, false, 90000, seconds(2), 2, milliseconds(100));
+        transport, event, dbusImplReq, false, seconds(2), 2, milliseconds(100));
     pldm::Request request{};
     auto instanceId = dbusImplReq.getInstanceId(eid);
     auto rc = reqHandler.registerRequest(
@@ -151,3 +151,35 @@ TEST_F(HandlerTest, multipleRequestResponseScenario)
     EXPECT_EQ(callbackCount, 2);
     EXPECT_EQ(instanceId, dbusImplReq.getInstanceId(eid));
 }
+
+TEST_F(HandlerTest, releaseSlots)
+{
+    Handler<NiceMock<MockRequest>> reqHandler(
+        transport, event, dbusImplReq, false, seconds(1), 2, milliseconds(100));
+    reqHandler.reserveSlots(eid);
+    pldm::Request request{};
+    auto instanceId = dbusImplReq.getInstanceId(eid);
+    auto rc = reqHandler.registerRequest(
+        eid, instanceId, 0, 0, std::move(request),
+        std::move(std::bind_front(&HandlerTest::pldmResponseCallBack, this)));
+    EXPECT_EQ(rc, PLDM_SUCCESS);
+
+    // The request in flight gets an empty response and its instance ID is
+    // freed
+    reqHandler.releaseSlots(eid);
+    EXPECT_EQ(nullResponse, true);
+    EXPECT_EQ(callbackCount, 1);
+    EXPECT_EQ(instanceId, dbusImplReq.getInstanceId(eid));
+
+    // The instance ID does not expire afterwards
+    waitEventExpiry(milliseconds(500));
+    EXPECT_EQ(callbackCount, 1);
+
+    // A response for the released request is not handed over
+    pldm::Response response(sizeof(pldm_msg_hdr) + sizeof(uint8_t));
+    auto responsePtr = reinterpret_cast<const pldm_msg*>(response.data());
+    reqHandler.handleResponse(eid, instanceId, 0, 0, responsePtr,
+                              sizeof(response));
+    EXPECT_EQ(validResponse, false);
+    EXPECT_EQ(callbackCount, 1);
+}
@@ -14,14 +14,21 @@ namespace requester
 class MockRequest : public RequestRetryTimer
 {
   public:
-    MockRequest(int /*fd*/, mctp_eid_t /*eid*/, sdeventplus::Event& event,
+    MockRequest(pldm::transport::Transport& /*transport*/,
+                mctp_eid_t /*eid*/, sdeventplus::Event& event,
                 pldm::Request&& /*requestMsg*/, uint8_t numRetries,
-                std::chrono::milliseconds responseTimeOut,
-                size_t /*currentSendbuffSize*/, bool /*verbose*/) :
+                std::chrono::milliseconds responseTimeOut, bool /*verbose*/) :
         RequestRetryTimer(event, numRetries, responseTimeOut)
     {}
 
     MOCK_METHOD(int, send, (), (const, override));
+
+    pldm::Request& getRequestMsg()
+    {
+        return requestMsg;
+    }
+
+    pldm::Request requestMsg;
 };
 
 } // namespace requester
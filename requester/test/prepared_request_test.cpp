@@ -0,0 +1,205 @@
+#include "libpldm/base.h"
+#include "libpldm/platform.h"
+
+#include "common/types.hpp"
+#include "common/utils.hpp"
+#include "pldmd/dbus_impl_requester.hpp"
+#include "requester/handler.hpp"
+#include "requester/prepared_request.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::requester;
+using namespace std::chrono;
+
+namespace
+{
+
+std::atomic<size_t> allocations{0};
+
+} // namespace
+
+void* operator new(size_t size)
+{
+    ++allocations;
+    if (auto ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+/** @class NullRequest
+ *
+ *  Request that is never sent, for measuring the cost of the request handler
+ */
+class NullRequest : public RequestRetryTimer
+{
+  public:
+    NullRequest(pldm::transport::Transport& /*transport*/, mctp_eid_t /*eid*/,
+                sdeventplus::Event& event, pldm::Request&& requestMsg,
+                uint8_t numRetries, milliseconds responseTimeOut,
+                bool /*verbose*/) :
+        RequestRetryTimer(event, numRetries, responseTimeOut),
+        requestMsg(std::move(requestMsg))
+    {}
+
+    pldm::Request& getRequestMsg()
+    {
+        return requestMsg;
+    }
+
+    pldm::Request requestMsg;
+
+  private:
+    int send() const override
+    {
+        return PLDM_SUCCESS;
+    }
+};
+
+class PreparedRequestTest : public testing::Test
+{
+  protected:
+    PreparedRequestTest() :
+        event(sdeventplus::Event::get_default()), transport(eid),
+        dbusImplReq(pldm::utils::DBusHandler::getBus(),
+                    "/xyz/openbmc_project/pldm"),
+        handler(transport, event, dbusImplReq, false, seconds(5), 0,
+                seconds(1)),
+        request(PLDM_PLATFORM, PLDM_GET_STATE_SENSOR_READINGS,
+                PLDM_GET_STATE_SENSOR_READINGS_REQ_BYTES),
+        response(sizeof(pldm_msg_hdr) + 1)
+    {
+        request.encode([](uint8_t instanceId, pldm_msg* msg) {
+            bitfield8_t rearm{};
+            return encode_get_state_sensor_readings_req(instanceId, 0, rearm,
+                                                        0, msg);
+        });
+    }
+
+    /** @brief Send a request and handle its response
+     *
+     *  @param[in] sensorId - sensor ID of the request
+     */
+    void cycle(uint16_t sensorId)
+    {
+        auto instanceId = dbusImplReq.getInstanceId(eid);
+        request.setField<uint16_t>(0, sensorId);
+        auto rc = handler.registerRequest(
+            eid, instanceId, request,
+            [this](mctp_eid_t, const pldm_msg*, size_t) { ++responses; });
+        ASSERT_EQ(rc, PLDM_SUCCESS);
+        handler.handleResponse(
+            eid, instanceId, PLDM_PLATFORM, PLDM_GET_STATE_SENSOR_READINGS,
+            reinterpret_cast<const pldm_msg*>(response.data()), 1);
+    }
+
+    mctp_eid_t eid = 0;
+    sdeventplus::Event event;
+    pldm::transport::Loopback transport;
+    pldm::dbus_api::Requester dbusImplReq;
+    Handler<NullRequest> handler;
+    PreparedRequest request;
+    pldm::Response response;
+    size_t responses = 0;
+};
+
+TEST(PreparedRequest, patchedFields)
+{
+    PreparedRequest request(PLDM_PLATFORM, PLDM_GET_STATE_SENSOR_READINGS,
+                            PLDM_GET_STATE_SENSOR_READINGS_REQ_BYTES);
+    auto rc = request.encode([](uint8_t instanceId, pldm_msg* msg) {
+        bitfield8_t rearm{};
+        rearm.byte = 0x5;
+        return encode_get_state_sensor_readings_req(instanceId, 0, rearm, 0,
+                                                    msg);
+    });
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    request.setField<uint16_t>(0, 0x1234);
+
+    pldm::Request msg;
+    request.copyTo(7, msg);
+    ASSERT_EQ(msg.size(), sizeof(pldm_msg_hdr) +
+                              PLDM_GET_STATE_SENSOR_READINGS_REQ_BYTES);
+
+    // Matches the message encoded in full
+    pldm::Request expected(msg.size());
+    bitfield8_t rearm{};
+    rearm.byte = 0x5;
+    encode_get_state_sensor_readings_req(
+        7, 0x1234, rearm, 0, reinterpret_cast<pldm_msg*>(expected.data()));
+    EXPECT_EQ(msg, expected);
+    EXPECT_EQ(request.getType(), PLDM_PLATFORM);
+    EXPECT_EQ(request.getCommand(), PLDM_GET_STATE_SENSOR_READINGS);
+}
+
+TEST_F(PreparedRequestTest, slotReused)
+{
+    auto instanceId = dbusImplReq.getInstanceId(eid);
+    auto rc = handler.registerRequest(
+        eid, instanceId, request,
+        [this](mctp_eid_t, const pldm_msg*, size_t) { ++responses; });
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+
+    // The instance ID is in flight
+    rc = handler.registerRequest(
+        eid, instanceId, request,
+        [this](mctp_eid_t, const pldm_msg*, size_t) { ++responses; });
+    EXPECT_EQ(rc, PLDM_ERROR);
+
+    // Not the command of the request
+    handler.handleResponse(eid, instanceId, PLDM_PLATFORM,
+                           PLDM_SET_STATE_EFFECTER_STATES,
+                           reinterpret_cast<const pldm_msg*>(response.data()),
+                           1);
+    EXPECT_EQ(responses, 0);
+
+    handler.handleResponse(
+        eid, instanceId, PLDM_PLATFORM, PLDM_GET_STATE_SENSOR_READINGS,
+        reinterpret_cast<const pldm_msg*>(response.data()), 1);
+    EXPECT_EQ(responses, 1);
+
+    // The slot takes the next request with the instance ID
+    EXPECT_EQ(instanceId, dbusImplReq.getInstanceId(eid));
+    rc = handler.registerRequest(
+        eid, instanceId, request,
+        [this](mctp_eid_t, const pldm_msg*, size_t) { ++responses; });
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    handler.handleResponse(
+        eid, instanceId, PLDM_PLATFORM, PLDM_GET_STATE_SENSOR_READINGS,
+        reinterpret_cast<const pldm_msg*>(response.data()), 1);
+    EXPECT_EQ(responses, 2);
+}
+
+TEST_F(PreparedRequestTest, noAllocationsInSteadyState)
+{
+    handler.reserveSlots(eid);
+    for (uint16_t i = 0; i < pldm::maxInstanceIds; ++i)
+    {
+        cycle(i);
+    }
+
+    auto before = allocations.load();
+    for (uint16_t i = 0; i < 1000; ++i)
+    {
+        cycle(i);
+    }
+    EXPECT_EQ(allocations.load() - before, 0);
+    EXPECT_EQ(responses, 1000 + pldm::maxInstanceIds);
+}
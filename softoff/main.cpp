@@ -1,12 +1,12 @@
+#include "common/logger.hpp"
 #include "common/utils.hpp"
 #include "softoff.hpp"
 
-#include <iostream>
-
 int main()
 {
     // Get a default event loop
     auto event = sdeventplus::Event::get_default();
+    pldm::logging::getLogger().attach(event);
 
     // Get a handle to system D-Bus.
     auto& bus = pldm::utils::DBusHandler::getBus();
@@ -18,15 +18,15 @@ int main()
 
     if (softPower.isError())
     {
-        std::cerr << "Host failed to gracefully shutdown, exiting "
-                     "pldm-softpoweroff app\n";
+        pldm::logging::error("Host failed to gracefully shutdown, exiting "
+                             "pldm-softpoweroff app");
         return -1;
     }
 
     if (softPower.isCompleted())
     {
-        std::cerr << "Host current state is not Running, exiting "
-                     "pldm-softpoweroff app\n";
+        pldm::logging::info("Host current state is not Running, exiting "
+                            "pldm-softpoweroff app");
         return 0;
     }
 
@@ -34,8 +34,9 @@ int main()
     // wait the host gracefully shutdown.
     if (softPower.hostSoftOff(event))
     {
-        std::cerr << "pldm-softpoweroff:Failure in sending soft off request to "
-                     "the host. Exiting pldm-softpoweroff app\n";
+        pldm::logging::error("pldm-softpoweroff:Failure in sending soft off "
+                             "request to the host. Exiting pldm-softpoweroff "
+                             "app");
 
         return -1;
     }
@@ -44,10 +45,8 @@ int main()
     {
         pldm::utils::reportError(
             "pldm soft off: Waiting for the host soft off timeout");
-        std::cerr
-            << "PLDM host soft off: ERROR! Wait for the host soft off timeout."
-            << "Exit the pldm-softpoweroff "
-            << "\n";
+        pldm::logging::error("PLDM host soft off: ERROR! Wait for the host "
+                             "soft off timeout. Exit the pldm-softpoweroff");
         return -1;
     }
 
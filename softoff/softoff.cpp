@@ -7,6 +7,7 @@
 #include "libpldm/requester/pldm.h"
 #include "libpldm/state_set.h"
 
+#include "common/logger.hpp"
 #include "common/utils.hpp"
 
 #include <sdbusplus/bus.hpp>
@@ -16,7 +17,6 @@
 #include <sdeventplus/source/time.hpp>
 
 #include <array>
-#include <iostream>
 
 namespace pldm
 {
@@ -48,8 +48,8 @@ SoftPowerOff::SoftPowerOff(sdbusplus::bus::bus& bus, sd_event* event) :
     auto rc = getEffecterID();
     if (completed)
     {
-        std::cerr
-            << "pldm-softpoweroff: effecter to initiate softoff not found \n";
+        logging::error(
+            "pldm-softpoweroff: effecter to initiate softoff not found");
         return;
     }
     else if (rc != PLDM_SUCCESS)
@@ -61,9 +61,8 @@ SoftPowerOff::SoftPowerOff(sdbusplus::bus::bus& bus, sd_event* event) :
     rc = getSensorInfo();
     if (rc != PLDM_SUCCESS)
     {
-        std::cerr << "Message get Sensor PDRs error. PLDM "
-                     "error code = "
-                  << std::hex << std::showbase << rc << "\n";
+        logging::error("Message get Sensor PDRs error. PLDM error code = ",
+                       logging::hex(rc));
         hasError = true;
         return;
     }
@@ -99,7 +98,7 @@ int SoftPowerOff::getHostState()
     }
     catch (const std::exception& e)
     {
-        std::cerr << "PLDM host soft off: Can't get current host state.\n";
+        logging::error("PLDM host soft off: Can't get current host state.");
         hasError = true;
         return PLDM_ERROR;
     }
@@ -126,8 +125,8 @@ void SoftPowerOff::hostSoftOffComplete(sdbusplus::message::message& msg)
         auto rc = timer.stop();
         if (rc < 0)
         {
-            std::cerr << "PLDM soft off: Failure to STOP the timer. ERRNO="
-                      << rc << "\n";
+            logging::error("PLDM soft off: Failure to STOP the timer. ERRNO=",
+                           rc);
         }
 
         // This marks the completion of pldm soft power off.
@@ -171,8 +170,7 @@ int SoftPowerOff::getEffecterID()
     }
     catch (const sdbusplus::exception::exception& e)
     {
-        std::cerr << "PLDM soft off: Error get VMM PDR,ERROR=" << e.what()
-                  << "\n";
+        logging::error("PLDM soft off: Error get VMM PDR,ERROR=", e.what());
         VMMPdrExist = false;
     }
 
@@ -201,9 +199,8 @@ int SoftPowerOff::getEffecterID()
 
         if (sysFwResponse.size() == 0)
         {
-            std::cerr
-                << "No effecter ID has been found that matches the criteria"
-                << "\n";
+            logging::error(
+                "No effecter ID has been found that matches the criteria");
             return PLDM_ERROR;
         }
 
@@ -217,8 +214,8 @@ int SoftPowerOff::getEffecterID()
     }
     catch (const sdbusplus::exception::exception& e)
     {
-        std::cerr << "PLDM soft off: Error get system firmware PDR,ERROR="
-                  << e.what() << "\n";
+        logging::error("PLDM soft off: Error get system firmware PDR,ERROR=",
+                       e.what());
         completed = true;
         return PLDM_ERROR;
     }
@@ -249,9 +246,8 @@ int SoftPowerOff::getSensorInfo()
 
         if (Response.size() == 0)
         {
-            std::cerr
-                << "No sensor PDR has been found that matches the criteria"
-                << "\n";
+            logging::error(
+                "No sensor PDR has been found that matches the criteria");
             return PLDM_ERROR;
         }
 
@@ -261,7 +257,7 @@ int SoftPowerOff::getSensorInfo()
             pdr = reinterpret_cast<pldm_state_sensor_pdr*>(rep.data());
             if (!pdr)
             {
-                std::cerr << "Failed to get state sensor PDR.\n";
+                logging::error("Failed to get state sensor PDR.");
                 return PLDM_ERROR;
             }
         }
@@ -290,8 +286,8 @@ int SoftPowerOff::getSensorInfo()
     }
     catch (const sdbusplus::exception::exception& e)
     {
-        std::cerr << "PLDM soft off: Error get State Sensor PDR,ERROR="
-                  << e.what() << "\n";
+        logging::error("PLDM soft off: Error get State Sensor PDR,ERROR=",
+                       e.what());
         return PLDM_ERROR;
     }
 
@@ -336,8 +332,8 @@ int SoftPowerOff::hostSoftOff(sdeventplus::Event& event)
     }
     catch (const sdbusplus::exception::exception& e)
     {
-        std::cerr << "PLDM soft off: Error get instanceID,ERROR=" << e.what()
-                  << "\n";
+        logging::error("PLDM soft off: Error get instanceID,ERROR=",
+                       e.what());
         return PLDM_ERROR;
     }
 
@@ -351,8 +347,8 @@ int SoftPowerOff::hostSoftOff(sdeventplus::Event& event)
         instanceID, effecterID, effecterCount, &stateField, request);
     if (rc != PLDM_SUCCESS)
     {
-        std::cerr << "Message encode failure. PLDM error code = " << std::hex
-                  << std::showbase << rc << "\n";
+        logging::error("Message encode failure. PLDM error code = ",
+                       logging::hex(rc));
         return PLDM_ERROR;
     }
 
@@ -360,8 +356,7 @@ int SoftPowerOff::hostSoftOff(sdeventplus::Event& event)
     int fd = pldm_open();
     if (-1 == fd)
     {
-        std::cerr << "Failed to connect to mctp demux daemon"
-                  << "\n";
+        logging::error("Failed to connect to mctp demux daemon");
         return PLDM_ERROR;
     }
 
@@ -370,9 +365,9 @@ int SoftPowerOff::hostSoftOff(sdeventplus::Event& event)
                                    Timer::TimePoint /*time*/) {
         if (!responseReceived)
         {
-            std::cerr << "PLDM soft off: ERROR! Can't get the response for the "
-                         "PLDM request msg. Time out!\n"
-                      << "Exit the pldm-softpoweroff\n";
+            logging::error("PLDM soft off: ERROR! Can't get the response for "
+                           "the PLDM request msg. Time out! Exit the "
+                           "pldm-softpoweroff");
             exit(-1);
         }
         return;
@@ -404,9 +399,8 @@ int SoftPowerOff::hostSoftOff(sdeventplus::Event& event)
         // sent out
         io.set_enabled(Enabled::Off);
         auto response = reinterpret_cast<pldm_msg*>(responseMsgPtr.get());
-        std::cerr << "Getting the response. PLDM RC = " << std::hex
-                  << std::showbase
-                  << static_cast<uint16_t>(response->payload[0]) << "\n";
+        logging::info("Getting the response. PLDM RC = ",
+                      logging::hex(response->payload[0]));
 
         responseReceived = true;
 
@@ -418,15 +412,16 @@ int SoftPowerOff::hostSoftOff(sdeventplus::Event& event)
         auto ret = startTimer(timeMicroseconds);
         if (ret < 0)
         {
-            std::cerr << "Failure to start Host soft off wait timer, ERRNO = "
-                      << ret << "Exit the pldm-softpoweroff\n";
+            logging::error("Failure to start Host soft off wait timer, "
+                           "ERRNO = ",
+                           ret, " Exit the pldm-softpoweroff");
             exit(-1);
         }
         else
         {
-            std::cerr << "Timer started waiting for host soft off, "
-                         "TIMEOUT_IN_SEC = "
-                      << SOFTOFF_TIMEOUT_SECONDS << "\n";
+            logging::info("Timer started waiting for host soft off, "
+                          "TIMEOUT_IN_SEC = ",
+                          SOFTOFF_TIMEOUT_SECONDS);
         }
         return;
     };
@@ -436,8 +431,8 @@ int SoftPowerOff::hostSoftOff(sdeventplus::Event& event)
     rc = pldm_send(mctpEID, fd, requestMsg.data(), requestMsg.size());
     if (0 > rc)
     {
-        std::cerr << "Failed to send message/receive response. RC = " << rc
-                  << ", errno = " << errno << "\n";
+        logging::error("Failed to send message/receive response. RC = ", rc,
+                       ", errno = ", errno);
         return PLDM_ERROR;
     }
 
@@ -450,9 +445,9 @@ int SoftPowerOff::hostSoftOff(sdeventplus::Event& event)
         }
         catch (const sdeventplus::SdEventError& e)
         {
-            std::cerr
-                << "PLDM host soft off: Failure in processing request.ERROR= "
-                << e.what() << "\n";
+            logging::error(
+                "PLDM host soft off: Failure in processing request.ERROR= ",
+                e.what());
             return PLDM_ERROR;
         }
     }
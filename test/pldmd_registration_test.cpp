@@ -2,7 +2,10 @@
 
 #include "pldmd/invoker.hpp"
 
+#include <algorithm>
+#include <iterator>
 #include <stdexcept>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -20,6 +23,7 @@ class TestHandler : public CmdHandler
                          [this](const pldm_msg* request, size_t payloadLength) {
                              return this->handle(request, payloadLength);
                          });
+        offloadable.emplace(testCmd);
     }
 
     Response handle(const pldm_msg* /*request*/, size_t /*payloadLength*/)
@@ -28,6 +32,32 @@ class TestHandler : public CmdHandler
     }
 };
 
+/** @class MemoHandler
+ *
+ *  Answers with the request payload and the number of responses built, the
+ *  responses are memoized
+ */
+class MemoHandler : public CmdHandler
+{
+  public:
+    MemoHandler()
+    {
+        handlers.emplace(testCmd,
+                         [this](const pldm_msg* request, size_t payloadLength) {
+                             ++built;
+                             Response response(sizeof(pldm_msg_hdr));
+                             std::copy_n(request->payload, payloadLength,
+                                         std::back_inserter(response));
+                             response.push_back(built);
+                             return response;
+                         });
+        memoized.emplace(testCmd, [this] { return epoch; });
+    }
+
+    uint8_t built = 0;
+    uint64_t epoch = 0;
+};
+
 TEST(CcOnlyResponse, testEncode)
 {
     std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr));
@@ -58,3 +88,66 @@ TEST(Registration, testFailure)
     ASSERT_THROW(invoker.handle(testType, badCmd, nullptr, 0),
                  std::out_of_range);
 }
+
+TEST(Registration, testOffloadable)
+{
+    Invoker invoker{};
+    EXPECT_FALSE(invoker.isOffloadable(testType, testCmd));
+    invoker.registerHandler(testType, std::make_unique<TestHandler>());
+    EXPECT_TRUE(invoker.isOffloadable(testType, testCmd));
+    EXPECT_FALSE(invoker.isOffloadable(testType, 0xFE));
+}
+
+/** @brief Handle a request to the memoized test command
+ *
+ *  @return the response
+ */
+static Response memoRequest(MemoHandler& handler, uint8_t instanceId,
+                            std::vector<uint8_t> payload)
+{
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr));
+    requestMsg.insert(requestMsg.end(), payload.begin(), payload.end());
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    request->hdr.instance_id = instanceId;
+    return handler.handle(testCmd, request, payload.size());
+}
+
+TEST(Memoization, responseReused)
+{
+    MemoHandler handler;
+    auto response = memoRequest(handler, 1, {PLDM_SUCCESS, 7});
+    EXPECT_EQ(response.back(), 1);
+
+    // Sent again with the instance ID of the request
+    response = memoRequest(handler, 2, {PLDM_SUCCESS, 7});
+    EXPECT_EQ(handler.built, 1);
+    EXPECT_EQ(response.back(), 1);
+    EXPECT_EQ(reinterpret_cast<pldm_msg*>(response.data())->hdr.instance_id,
+              2);
+
+    // Another request payload
+    response = memoRequest(handler, 3, {PLDM_SUCCESS, 8});
+    EXPECT_EQ(handler.built, 2);
+    EXPECT_EQ(response.back(), 2);
+}
+
+TEST(Memoization, epochChanged)
+{
+    MemoHandler handler;
+    memoRequest(handler, 1, {PLDM_SUCCESS});
+    handler.epoch = 1;
+    auto response = memoRequest(handler, 1, {PLDM_SUCCESS});
+    EXPECT_EQ(handler.built, 2);
+    EXPECT_EQ(response.back(), 2);
+    memoRequest(handler, 1, {PLDM_SUCCESS});
+    EXPECT_EQ(handler.built, 2);
+}
+
+TEST(Memoization, errorsNotReused)
+{
+    // The first payload byte is the completion code of the response
+    MemoHandler handler;
+    memoRequest(handler, 1, {PLDM_ERROR});
+    memoRequest(handler, 1, {PLDM_ERROR});
+    EXPECT_EQ(handler.built, 2);
+}
@@ -0,0 +1,258 @@
+#include "libpldm/base.h"
+
+#include "pldmd/invoker.hpp"
+#include "pldmd/worker_pool.hpp"
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm;
+using namespace pldm::responder;
+using namespace std::chrono;
+
+class WorkerPoolTest : public testing::Test
+{
+  protected:
+    WorkerPoolTest() : event(sdeventplus::Event::get_default())
+    {}
+
+    /** @brief Run the event loop until the pool is done with all its jobs */
+    void runUntilDone(WorkerPool& pool)
+    {
+        auto deadline = steady_clock::now() + seconds(5);
+        while (pool.getPending() && steady_clock::now() < deadline)
+        {
+            sd_event_run(event.get(), 10000);
+        }
+    }
+
+    static WorkerPool::Job sleepingJob(milliseconds duration, uint8_t tag)
+    {
+        return [duration, tag]() {
+            std::this_thread::sleep_for(duration);
+            return Response{tag};
+        };
+    }
+
+    sdeventplus::Event event;
+};
+
+TEST_F(WorkerPoolTest, CompletionOrder)
+{
+    WorkerPool pool(event, 2, 8);
+    std::vector<uint8_t> completed;
+    auto completion = [&completed](Response&& response) {
+        completed.emplace_back(response[0]);
+    };
+
+    pool.submit(sleepingJob(milliseconds(150), 1), completion);
+    pool.submit(sleepingJob(milliseconds(10), 2), completion);
+    EXPECT_EQ(pool.getPending(), 2);
+
+    runUntilDone(pool);
+    EXPECT_EQ(completed, std::vector<uint8_t>({2, 1}));
+}
+
+TEST_F(WorkerPoolTest, Bounded)
+{
+    WorkerPool pool(event, 1, 2);
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    size_t completed = 0;
+    auto completion = [&completed](Response&&) { ++completed; };
+    auto blockingJob = [released]() {
+        released.wait();
+        return Response{0};
+    };
+
+    EXPECT_FALSE(pool.busy());
+    pool.submit(blockingJob, completion);
+    pool.submit(blockingJob, completion);
+    EXPECT_TRUE(pool.busy());
+
+    release.set_value();
+    runUntilDone(pool);
+    EXPECT_FALSE(pool.busy());
+    EXPECT_EQ(completed, 2);
+}
+
+TEST_F(WorkerPoolTest, FailedJob)
+{
+    WorkerPool pool(event, 1, 2);
+    size_t completed = 0;
+    pool.submit([]() -> Response { throw std::runtime_error("failed"); },
+                [&completed](Response&&) { ++completed; });
+
+    runUntilDone(pool);
+    EXPECT_EQ(pool.getPending(), 0);
+    EXPECT_EQ(completed, 0);
+}
+
+/** @class LatencyHandler
+ *
+ *  A slow command, offloadable, that holds its worker until it is released,
+ *  and a fast command handled on the event loop
+ */
+class LatencyHandler : public CmdHandler
+{
+  public:
+    static constexpr Command slowCmd = 0x01;
+    static constexpr Command fastCmd = 0x02;
+
+    explicit LatencyHandler(std::shared_future<void> released)
+    {
+        handlers.emplace(slowCmd,
+                         [released](const pldm_msg* request, size_t) {
+                             released.wait();
+                             return ccOnlyResponse(request, PLDM_SUCCESS);
+                         });
+        offloadable.emplace(slowCmd);
+        handlers.emplace(fastCmd, [](const pldm_msg* request, size_t) {
+            return ccOnlyResponse(request, PLDM_SUCCESS);
+        });
+    }
+};
+
+static std::vector<uint8_t> makeRequest(uint8_t instanceId, Command command)
+{
+    std::vector<uint8_t> request(sizeof(pldm_msg_hdr));
+    pldm_header_info header{};
+    header.msg_type = PLDM_REQUEST;
+    header.instance = instanceId;
+    header.pldm_type = PLDM_OEM;
+    header.command = command;
+    pack_pldm_header(&header, reinterpret_cast<pldm_msg_hdr*>(request.data()));
+    return request;
+}
+
+TEST_F(WorkerPoolTest, FastCommandLatency)
+{
+    // The requests are received on the event loop like pldmd does, the slow
+    // commands are offloaded and hold all the workers while the fast ones are
+    // sent. The fast ones are answered inline, their latency must not include
+    // the slow ones.
+    constexpr size_t workers = 2;
+    constexpr size_t slowCount = 4;
+    constexpr size_t fastCount = 200;
+
+    std::promise<void> release;
+    Invoker invoker;
+    invoker.registerHandler(PLDM_OEM, std::make_unique<LatencyHandler>(
+                                          release.get_future().share()));
+    WorkerPool pool(event, workers, 8);
+
+    std::array<int, 2> sockets{};
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sockets.data()), 0);
+    timeval timeout{5, 0};
+    setsockopt(sockets[1], SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    size_t fastInline = 0;
+    auto send = [fd = sockets[0]](const Response& response) {
+        ::send(fd, response.data(), response.size(), 0);
+    };
+    sdeventplus::source::IO io(
+        event, sockets[0], EPOLLIN,
+        [&](sdeventplus::source::IO&, int fd, uint32_t) {
+            std::vector<uint8_t> request(64);
+            auto length = recv(fd, request.data(), request.size(), 0);
+            ASSERT_GE(length, static_cast<ssize_t>(sizeof(pldm_msg_hdr)));
+            request.resize(length);
+            auto msg = reinterpret_cast<const pldm_msg*>(request.data());
+            auto type = msg->hdr.type;
+            auto command = msg->hdr.command;
+            if (!pool.busy() && invoker.isOffloadable(type, command))
+            {
+                pool.submit(
+                    [&invoker, request, type, command]() {
+                        return invoker.handle(
+                            type, command,
+                            reinterpret_cast<const pldm_msg*>(request.data()),
+                            request.size() - sizeof(pldm_msg_hdr));
+                    },
+                    send);
+                return;
+            }
+            // The slow commands are all still running, or queued
+            EXPECT_EQ(pool.getPending(), slowCount);
+            ++fastInline;
+            send(invoker.handle(type, command, msg,
+                                request.size() - sizeof(pldm_msg_hdr)));
+        });
+
+    std::vector<microseconds> latencies;
+    std::vector<Command> slowResponses;
+    std::atomic<bool> clientDone = false;
+    std::thread client([&, fd = sockets[1]]() {
+        std::array<uint8_t, 64> response{};
+        auto command = [&response]() {
+            return reinterpret_cast<const pldm_msg*>(response.data())
+                ->hdr.command;
+        };
+        uint8_t instanceId = 0;
+        for (size_t i = 0; i < slowCount; ++i)
+        {
+            auto request =
+                makeRequest(instanceId++ % 32, LatencyHandler::slowCmd);
+            ::send(fd, request.data(), request.size(), 0);
+        }
+        for (size_t i = 0; i < fastCount; ++i)
+        {
+            auto request =
+                makeRequest(instanceId++ % 32, LatencyHandler::fastCmd);
+            auto sent = steady_clock::now();
+            ::send(fd, request.data(), request.size(), 0);
+            if (recv(fd, response.data(), response.size(), 0) <= 0 ||
+                command() != LatencyHandler::fastCmd)
+            {
+                break;
+            }
+            latencies.emplace_back(
+                duration_cast<microseconds>(steady_clock::now() - sent));
+        }
+        release.set_value();
+        for (size_t i = 0; i < slowCount; ++i)
+        {
+            if (recv(fd, response.data(), response.size(), 0) <= 0)
+            {
+                break;
+            }
+            slowResponses.emplace_back(command());
+        }
+        clientDone = true;
+    });
+
+    auto deadline = steady_clock::now() + seconds(10);
+    while (!clientDone && steady_clock::now() < deadline)
+    {
+        sd_event_run(event.get(), 10000);
+    }
+    client.join();
+    runUntilDone(pool);
+    close(sockets[0]);
+    close(sockets[1]);
+
+    EXPECT_EQ(fastInline, fastCount);
+    EXPECT_EQ(slowResponses,
+              std::vector<Command>(slowCount, LatencyHandler::slowCmd));
+    ASSERT_EQ(latencies.size(), fastCount);
+    std::sort(latencies.begin(), latencies.end());
+    auto p99 = latencies[latencies.size() * 99 / 100];
+    EXPECT_LT(p99, milliseconds(50));
+}